@@ -58,6 +58,7 @@ public:
 	ArchiveFile& operator=(const ArchiveFile&) = delete;
 
 	virtual Bool					getFileInfo( const AsciiString& filename, FileInfo *fileInfo) const = 0;	///< fill in the fileInfo struct with info about the file requested.
+	virtual Bool					getFileOffset( const AsciiString& filename, UnsignedInt *offset ) const;	///< where the file's data starts within the archive file.
 	virtual File*					openFile( const Char *filename, Int access = 0) = 0;	///< Open the specified file within the archive file
 	virtual void					closeAllFiles( void ) = 0;									///< Close all file opened in this archive file
 	virtual AsciiString		getName( void ) = 0;												///< Returns the name of the archive file
@@ -66,12 +67,13 @@ public:
 	virtual void					close( void ) = 0;													///< Close this archive file
 	void									attachFile(File *file);
 
-	void									getFileListInDirectory(const AsciiString& currentDirectory, const AsciiString& originalDirectory, const AsciiString& searchName, FilenameList &filenameList, Bool searchSubdirectories) const;
+	virtual void					getFileListInDirectory(const AsciiString& currentDirectory, const AsciiString& originalDirectory, const AsciiString& searchName, FilenameList &filenameList, Bool searchSubdirectories) const;
 	void									getFileListInDirectory(const DetailedArchivedDirectoryInfo *dirInfo, const AsciiString& currentDirectory, const AsciiString& searchName, FilenameList &filenameList, Bool searchSubdirectories) const;
 
 	void									addFile(const AsciiString& path, const ArchivedFileInfo *fileInfo); ///< add this file to our directory tree.
 
 protected:
+	static Bool						SearchStringMatches(AsciiString str, AsciiString searchString);	///< match str against a search string using * and ? wildcards.
 	const ArchivedFileInfo *		getArchivedFileInfo(const AsciiString& filename) const;	///< return the ArchivedFileInfo from the directory tree.
 
 	File *m_file {}; ///< file pointer to the archive file on disk.  Kept open so we don't have to continuously open and close the file all the time.
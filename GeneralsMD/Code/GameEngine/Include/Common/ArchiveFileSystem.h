@@ -167,6 +167,7 @@ class ArchiveFileSystem : public SubsystemInterface
 
 	void					getFileListInDirectory(const AsciiString& currentDirectory, const AsciiString& originalDirectory, const AsciiString& searchName, FilenameList &filenameList, Bool searchSubdirectories) const; ///< search the given directory for files matching the searchName (egs. *.ini, *.rep).  Possibly search subdirectories.  Scans each Archive file.
 	Bool					getFileInfo(const AsciiString& filename, FileInfo *fileInfo) const; ///< see FileSystem.h
+	Bool					getFileLocation(const AsciiString& filename, AsciiString *archivePath, UnsignedInt *offset, FileInfo *fileInfo) const; ///< see FileSystem.h
 	
 	virtual Bool			loadBigFilesFromDirectory(AsciiString dir, AsciiString fileMask, Bool overwrite = FALSE) = 0;
 
@@ -32,6 +32,7 @@
 #define _CRC_H_
 
 #include "Lib/BaseType.h"
+#include "Common/CRCEngine.h"
 // #include "winsock2.h" // for htonl
 
 #ifdef _DEBUG
@@ -58,52 +59,12 @@ private:
 class CRC
 {
 public:
-	CRC(void) { crc=0; }
+	CRC(void) { }
 
   /// Compute the CRC for a buffer, added into current CRC
-	__forceinline void computeCRC( const void *buf, Int len )
+	inline void computeCRC( const void *buf, Int len )
   {
-    if (!buf||len<1)
-      return;
-    
-    /* C++ version left in for reference purposes
-	  for (UnsignedByte *uintPtr=(UnsignedByte *)buf;len>0;len--,uintPtr++)
-    {
-    	int hibit;
-    	if (crc & 0x80000000) 
-      {
-		    hibit = 1;
-	    } 
-      else 
-      {
-		    hibit = 0;
-	    }
-
-	    crc <<= 1;
-	    crc += *uintPtr;
-	    crc += hibit;
-    }
-    */
-
-    // ASM version, verified by comparing resulting data with C++ version data
-    unsigned *crcPtr=&crc;
-    _asm
-    {
-      mov esi,[buf]
-      mov ecx,[len]
-      dec ecx
-      mov edi,[crcPtr]
-      mov ebx,dword ptr [edi]
-      xor eax,eax
-    lp:
-      mov al,byte ptr [esi]
-      shl ebx,1
-      inc esi
-      adc ebx,eax
-      dec ecx
-      jns lp
-      mov dword ptr [edi],ebx
-    };
+    crc = CRCEngine::foldBytes(crc, buf, len);
   }
 
   /// Clears the CRC to 0
@@ -119,7 +80,7 @@ public:
   }
 
 private:
-	UnsignedInt crc;
+	UnsignedInt crc {};
 };
 
 #endif
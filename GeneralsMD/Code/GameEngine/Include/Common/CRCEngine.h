@@ -0,0 +1,78 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// FILE: CRCEngine.h //////////////////////////////////////////////////////////////////////////////
+// Desc:   Portable implementation of the game's rotate-and-add checksum.
+//
+//         Both CRC (bytes) and XferCRC (32 bit words) fold their input the same way: rotate the
+//         running value left one bit, then add the next value.  The original code did this with
+//         x86 assembly and htonl; these routines give bit-identical results on any host.
+//
+//         The fold is a single dependency chain (the carries out of the add don't commute with
+//         the rotate), so it can't be split across independent lanes and recombined.  The bulk
+//         routines instead keep loads and byte swaps off that chain and unroll it, which leaves
+//         one rotate and one add per value.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#ifndef __CRCENGINE_H_
+#define __CRCENGINE_H_
+
+// INCLUDES ///////////////////////////////////////////////////////////////////////////////////////
+#include <bit>
+#include <cstring>
+#include <vector>
+#include "Lib/BaseType.h"
+
+//-------------------------------------------------------------------------------------------------
+class CRCEngine
+{
+public:
+
+	/// one step of the fold
+	static inline UnsignedInt fold( UnsignedInt crc, UnsignedInt val ) { return std::rotl(crc, 1) + val; }
+
+	/// the four bytes at 'p' as a big endian word, which is the order XferCRC folds words in
+	static inline UnsignedInt loadWord( const UnsignedByte *p )
+	{
+		UnsignedInt val;
+		memcpy(&val, p, sizeof(val));
+		if constexpr (std::endian::native == std::endian::little)
+			val = std::byteswap(val);
+		return val;
+	}
+
+	/// network byte order of a host value, as htonl would give
+	static inline UnsignedInt toNetwork( UnsignedInt val )
+	{
+		if constexpr (std::endian::native == std::endian::little)
+			return std::byteswap(val);
+		else
+			return val;
+	}
+
+	static UnsignedInt foldBytes( UnsignedInt crc, const void *buf, Int len );						///< CRC::computeCRC
+	static UnsignedInt foldXferData( UnsignedInt crc, const void *data, UnsignedInt dataSize );	///< XferCRC::xferImplementation
+	static UnsignedInt foldWords( UnsignedInt crc, const UnsignedInt *words, UnsignedInt count );	///< words already in fold order
+
+	/// append the words foldXferData would fold for this data, without folding them
+	static void appendXferWords( std::vector<UnsignedInt>& words, const void *data, UnsignedInt dataSize );
+};
+
+#endif // __CRCENGINE_H_
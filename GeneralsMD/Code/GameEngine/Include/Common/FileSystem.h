@@ -133,6 +133,7 @@ public:
 	Bool doesFileExist(const Char *filename) const;								///< returns TRUE if the file exists.  filename should have no directory.
 	void getFileListInDirectory(const AsciiString& directory, const AsciiString& searchName, FilenameList &filenameList, Bool searchSubdirectories) const; ///< search the given directory for files matching the searchName (egs. *.ini, *.rep).  Possibly search subdirectories.
 	Bool getFileInfo(const AsciiString& filename, FileInfo *fileInfo) const; ///< fills in the FileInfo struct for the file given. returns TRUE if successful.
+	Bool getFileLocation(const AsciiString& filename, AsciiString *archivePath, UnsignedInt *offset, FileInfo *fileInfo) const; ///< where openFile() would read the file from: the archive holding it (empty for a loose file) and the offset of its data there. FileInfo's timestamp is the archive's. returns TRUE if the file exists.
 
 	Bool createDirectory(AsciiString directory); ///< create a directory of the given name.
 
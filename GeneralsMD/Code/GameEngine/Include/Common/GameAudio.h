@@ -49,6 +49,7 @@
 #include "Common/INI.h"
 #include "Common/STLTypedefs.h"
 #include "Common/SubsystemInterface.h"
+#include "Common/AudioHandleSpecialValues.h"
 
 
 // Forward Declarations
@@ -221,6 +222,10 @@ class AudioManager : public SubsystemInterface
 		virtual UnsignedInt getNum3DSamples( void ) const = 0;
 		virtual UnsignedInt getNumStreams( void ) const = 0;
 
+		// Device Dependent decode cache counters, for ReplayBenchmark. Devices without one report nothing.
+		virtual void resetCacheStats( void ) {}
+		virtual AsciiString reportCacheStats( Int /*frames*/ ) const { return AsciiString::TheEmptyString; }
+
 		// Device Dependent calls to determine sound prioritization info
 		virtual Bool doesViolateLimit( AudioEventRTS *event ) const = 0;
 		virtual Bool isPlayingLowerPriority( AudioEventRTS *event ) const = 0;
@@ -379,6 +384,64 @@ class AudioManager : public SubsystemInterface
 		Bool m_disallowSpeech			: 1 {};
 };
 
+//-------------------------------------------------------------------------------------------------
+/** An audio device that never makes a sound, for running the game without audio hardware
+	* (see -headless).  INI audio data is still loaded, so anything that looks up event info
+	* behaves as usual; requests to play audio are simply dropped. */
+//-------------------------------------------------------------------------------------------------
+class AudioManagerDummy : public AudioManager
+{
+	public:
+#if defined(_DEBUG) || defined(_INTERNAL)
+		virtual void audioDebugDisplay(DebugDisplayInterface *, void *, FILE * = NULL ) {}
+#endif
+		virtual void stopAudio( AudioAffect ) {}
+		virtual void pauseAudio( AudioAffect ) {}
+		virtual void resumeAudio( AudioAffect ) {}
+		virtual void pauseAmbient( Bool ) {}
+		virtual AudioHandle addAudioEvent( const AudioEventRTS * ) { return AHSV_NoSound; }
+		virtual void killAudioEventImmediately( AudioHandle ) {}
+		virtual void nextMusicTrack( void ) {}
+		virtual void prevMusicTrack( void ) {}
+		virtual Bool isMusicPlaying( void ) const { return FALSE; }
+		virtual Bool hasMusicTrackCompleted( const AsciiString&, Int ) const { return FALSE; }
+		virtual AsciiString getMusicTrackName( void ) const { return AsciiString::TheEmptyString; }
+		virtual void openDevice( void ) {}
+		virtual void closeDevice( void ) {}
+		virtual void *getDevice( void ) { return NULL; }
+		virtual void notifyOfAudioCompletion( uintptr_t, UnsignedInt ) {}
+		virtual UnsignedInt getProviderCount( void ) const { return 0; }
+		virtual AsciiString getProviderName( UnsignedInt ) const { return AsciiString::TheEmptyString; }
+		virtual UnsignedInt getProviderIndex( AsciiString ) const { return 0; }
+		virtual void selectProvider( UnsignedInt ) {}
+		virtual void unselectProvider( void ) {}
+		virtual UnsignedInt getSelectedProvider( void ) const { return 0; }
+		virtual void setSpeakerType( UnsignedInt ) {}
+		virtual UnsignedInt getSpeakerType( void ) { return 0; }
+		virtual UnsignedInt getNum2DSamples( void ) const { return 0; }
+		virtual UnsignedInt getNum3DSamples( void ) const { return 0; }
+		virtual UnsignedInt getNumStreams( void ) const { return 0; }
+		virtual Bool doesViolateLimit( AudioEventRTS * ) const { return FALSE; }
+		virtual Bool isPlayingLowerPriority( AudioEventRTS * ) const { return FALSE; }
+		virtual Bool isPlayingAlready( AudioEventRTS * ) const { return FALSE; }
+		virtual Bool isObjectPlayingVoice( UnsignedInt ) const { return FALSE; }
+		virtual void adjustVolumeOfPlayingAudio( AsciiString, Real ) {}
+		virtual void removePlayingAudio( AsciiString ) {}
+		virtual void removeAllDisabledAudio() {}
+		virtual Bool has3DSensitiveStreamsPlaying( void ) const { return FALSE; }
+		virtual void *getHandleForBink( void ) { return NULL; }
+		virtual void releaseHandleForBink( void ) {}
+		virtual void friend_forcePlayAudioEventRTS( const AudioEventRTS * ) {}
+		virtual void setPreferredProvider( AsciiString ) {}
+		virtual void setPreferredSpeaker( AsciiString ) {}
+		virtual Real getFileLengthMS( AsciiString ) const { return 0.0f; }
+		virtual void closeAnySamplesUsingFile( const void * ) {}
+		virtual Bool isMusicAlreadyLoaded( void ) const { return TRUE; }
+
+	protected:
+		virtual void setDeviceListenerPosition( void ) {}
+};
+
 extern AudioManager *TheAudio;
 
 #endif // __COMMON_GAMEAUDIO_H_
@@ -42,6 +42,7 @@
 
 // FORWARD REFERENCES /////////////////////////////////////////////////////////////////////////////
 class GameWindow;
+class SaveGameWriter;
 class WindowLayout;
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -165,7 +166,7 @@ public:
 	// subsystem interface
 	virtual void init( void );
 	virtual void reset( void );
-	virtual void update( void ) { }
+	virtual void update( void );										///< tells the player how background saves went
 
 	// save game methods
 	SaveCode saveGame( AsciiString filename, 
@@ -176,6 +177,12 @@ public:
 	SaveCode loadGame( AvailableGameInfo gameInfo );							 ///< load a save file
 	SaveGameInfo *getSaveGameInfo( void ) { return &m_gameInfo; }
 
+	// in-memory snapshots, used by the recorder to seek within replays
+	Bool saveToImage( std::vector<UnsignedByte>& image );						///< serialize the running game into image
+	Bool loadFromImage( const std::vector<UnsignedByte>& image );		///< reset the engine and restore a game saved by saveToImage
+
+	AsciiString reportSaveBenchmark( void );		///< for ReplayBenchmark: time a direct save against a background one and compare the files
+
 	// snapshot interaction
 	void addPostProcessSnapshot( Snapshot *snapshot );					///< add snapshot to post process laod	
 
@@ -238,6 +245,8 @@ private:
 
 	AvailableGameInfo *m_availableGames {};		///< list of available games we can save over or load from
 
+	SaveGameWriter *m_saveWriter {};					///< writes save files in the background, created on the first save
+
 	Bool m_isInLoadGame {}; // Brutal hack to allow bone pos validation while loading games
 };
 
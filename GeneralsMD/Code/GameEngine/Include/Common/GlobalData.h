@@ -511,6 +511,24 @@ public:
 		Bool				m_breakTheMovie;								///< The user has hit escape!
 		AsciiString m_modDir;
 		AsciiString m_modBIG;
+		Bool				m_useINICache;									///< replay pre-lexed INI files from the INI cache (-useINICache)
+		Bool				m_perfTrace;										///< write every perf timer scope to a trace file, in PERF_TIMERS builds (-perfTrace)
+		Bool				m_headless;											///< run the logic only, with no window, rendering or sound (-headless)
+		Bool				m_incrementalCRC;								///< only re-CRC objects that changed since the last logic CRC (-incrementalCRC)
+		Bool				m_compressSaveGames;						///< compress save files as they're written (-compressSaves)
+		Bool				m_useTextureCache;							///< keep decoded images in the user data directory for later runs (-textureCache)
+		Int					m_replaySnapshotInterval;				///< frames between in-memory snapshots during replay playback, 0 for none (-replaySnapshots)
+		Int					m_replaySnapshotBudgetMB;				///< memory the replay snapshot ring may hold, in megabytes (-replaySnapshotMB)
+		Int					m_replaySeekFrame;							///< seek a -headless replay back to this frame once it's a snapshot interval past it, 0 for none (-seekFrame)
+		Bool				m_partitionQueryBenchmark;			///< time range queries both ways during a -headless replay, and report them (-partitionQueryBenchmark)
+		Bool				m_corridorCacheBenchmark;				///< search again on every pathfind corridor cache hit during a -headless replay, and count any that differ (-corridorCacheBenchmark)
+		Bool				m_zoneBlockBenchmark;						///< run the zone block passes threaded and serially during a -headless replay, timing both and counting blocks that differ (-zoneBlockBenchmark)
+		Bool				m_iniParseBenchmark;						///< time the INI parse table lookups made while loading, then quit (-iniParseBenchmark)
+		Bool				m_nameKeyBenchmark;							///< time name key lookups against the old chained sockets once loaded, then quit (-nameKeyBenchmark)
+		Bool				m_ddsDecodeBenchmark;						///< decode every DXT image in the archives both ways, time the texture loader, then quit (-ddsDecodeBenchmark)
+		Int					m_scriptNameBenchmarkUnits;			///< time named unit lookups over this many names once loaded, then quit, 0 for none (-scriptNameBenchmark)
+		UnsignedInt	m_particleBenchmarkEmitters;		///< time particle updates over this many systems once loaded, then quit, 0 for none (-particleBenchmark)
+		UnsignedInt	m_particleBenchmarkFrames;			///< frames to time the -particleBenchmark systems for
 		//-allAdvice feature
 		//Bool m_allAdvice;
 
@@ -181,6 +181,9 @@ public:
 	static Bool isDeclarationOfType( AsciiString blockType, AsciiString blockName, char *bufferToCheck );
 	static Bool isEndOfBlock( char *bufferToCheck );
 
+	static void recordParseLookups( Bool record );		///< remember every parse table lookup from here on (-iniParseBenchmark)
+	static void reportParseLookupBenchmark( void );		///< time the remembered lookups indexed and linear, and print the result
+
 	// data type parsing (the highest level of what type of thing we're parsing)
 	static void parseObjectDefinition( INI *ini );
 	static void parseObjectReskinDefinition( INI *ini );
@@ -390,6 +393,8 @@ protected:
 	void unPrepFile();
 
 	void readLine( void );
+	Bool prepCachedFile( AsciiString filename, INILoadType loadType );
+	void readCachedLine( void );
 
 	File *m_file {};															///< file pointer of file currently loading
 
@@ -411,6 +416,8 @@ protected:
 	const char *m_sepsQuote {};									///< token to represent a quoted ascii string
 	const char *m_blockEndToken {};							///< token to represent end of data block
 	Bool m_endOfFile {};													///< TRUE when we've hit EOF
+	const char *m_cachedLine {};									///< next line record when replaying lines from TheINICache
+	const char *m_cachedLinesEnd {};							///< end of the line records being replayed
 #if defined(_DEBUG) || defined(_INTERNAL)
 	char m_curBlockStart[ INI_MAX_CHARS_PER_LINE ] {};	///< first line of cur block
 #endif
@@ -0,0 +1,109 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// FILE: INICache.h ///////////////////////////////////////////////////////////////////////////////
+// Desc:   Binary cache of pre-lexed INI files.
+//
+//         INI::readLine strips comments and control characters from every line one character
+//         at a time.  The cache keeps the result of that pass for each INI file, keyed by the
+//         file name and where the file lives (its archive, offset, size and timestamp), so a
+//         later launch can hand the lines straight to the parsers without opening the source.
+//         Tokenizing is still left to the parsers, since the separators they use depend on the
+//         field being parsed.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#ifndef __INICACHE_H_
+#define __INICACHE_H_
+
+// INCLUDES ///////////////////////////////////////////////////////////////////////////////////////
+#include "Common/STLTypedefs.h"
+#include "Common/AsciiString.h"
+
+//-------------------------------------------------------------------------------------------------
+/** Where an INI file was read from, as reported by FileSystem::getFileLocation.  If any of this
+	* changes (a loose file is edited, or an archive is replaced or patched) the entry is stale. */
+//-------------------------------------------------------------------------------------------------
+struct INICacheSource
+{
+	AsciiString				m_archive {};		///< archive holding the file, empty for a loose file
+	UnsignedInt				m_offset {};		///< start of the file's data within its archive
+	UnsignedInt64			m_size {};			///< size of the file
+	UnsignedInt64			m_timestamp {};	///< modification time of the loose file or of its archive
+
+	Bool operator==( const INICacheSource& that ) const
+	{
+		return m_offset == that.m_offset && m_size == that.m_size && m_timestamp == that.m_timestamp && m_archive == that.m_archive;
+	}
+};
+
+//-------------------------------------------------------------------------------------------------
+/** The lexed lines of one INI file.  m_lines holds one record per INI::readLine call: an
+	* UnsignedShort length followed by that many characters and a terminating null.  The last
+	* record is the one on which the reader hit end of file. */
+//-------------------------------------------------------------------------------------------------
+struct INICacheEntry
+{
+	INICacheSource		m_source {};		///< where the lines were lexed from
+	std::vector<char>	m_lines {};			///< line records
+};
+
+//-------------------------------------------------------------------------------------------------
+class INICache
+{
+public:
+
+	INICache();
+	~INICache();
+
+	// No copies allowed!
+	INICache(const INICache&) = delete;
+	INICache& operator=(const INICache&) = delete;
+
+	void load( void );																		///< read the cache file from the user data directory
+	void save( void );																		///< write the cache file back if anything was recorded
+
+	static Bool getSource( const AsciiString& filename, INICacheSource *source );	///< where TheFileSystem would read filename from
+
+	const INICacheEntry *find( const AsciiString& filename, const INICacheSource& source ) const;
+	const INICacheEntry *record( const AsciiString& filename, const INICacheSource& source, std::vector<char>& lines );
+
+	void addLoadTime( Bool fromCache, Real seconds );			///< accumulate time spent in INI::load
+	void reportTimings( void ) const;											///< print cold-parse vs. cached load times
+
+	static UnsignedInt hashBytes( const char *data, Int length, UnsignedInt hash = 2166136261u );
+
+private:
+
+	typedef std::map<AsciiString, INICacheEntry> INICacheMap;
+
+	AsciiString getCacheFilename( void ) const;
+
+	INICacheMap	m_entries {};
+	Bool				m_dirty {};
+
+	Int					m_parsedFiles {};
+	Int					m_cachedFiles {};
+	Real				m_parsedSeconds {};
+	Real				m_cachedSeconds {};
+};
+
+extern INICache *TheINICache;		///< only exists when -useINICache was given
+
+#endif // __INICACHE_H_
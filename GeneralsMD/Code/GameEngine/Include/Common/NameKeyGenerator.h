@@ -54,31 +54,6 @@ enum NameKeyType: int
 	FORCE_NAMEKEYTYPE_LONG	= 0x7fffffff	// a trick to ensure the NameKeyType is a 32-bit int
 };
 
-//-------------------------------------------------------------------------------------------------
-/** A bucket entry for the name key generator */
-//-------------------------------------------------------------------------------------------------
-class Bucket : public MemoryPoolObject
-{
-
-	MEMORY_POOL_GLUE_WITH_USERLOOKUP_CREATE( Bucket, "NameKeyBucketPool" );
-
-public:
-	
-	Bucket();
-//~Bucket();
-
-	// No copies allowed!
-	Bucket(const Bucket&) = delete;
-	Bucket& operator=(const Bucket&) = delete;
-
-	Bucket				*m_nextInSocket {};
-	NameKeyType		m_key {};
-	AsciiString		m_nameString {};
-};
-
-inline Bucket::Bucket() : m_nextInSocket(NULL), m_key(NAMEKEY_INVALID) { }
-inline Bucket::~Bucket() { }
-
 //------------------------------------------------------------------------------------------------- 
 /** This class implements the conversion of an arbitrary string into a unique
 	* integer "key". Calling the nameToKey() method with the same string is 
@@ -111,11 +86,18 @@ public:
 	NameKeyType nameToKey(const char* name);
 	NameKeyType nameToLowercaseKey(const char *name);
 
+	/// Same as nameToKey, for callers that already have calcHash(name), typically at compile time.
+	NameKeyType nameToKey(const char* name, UnsignedInt hash) { return findOrInsert(name, hash, FALSE); }
+
+	static constexpr UnsignedInt calcHash(const char* p);
+	static constexpr UnsignedInt calcLowercaseHash(const char* p);
+
+	void reportStatistics() const;							///< log table size and probe counts, in DEBUG_LOGGING builds
+	void reportBenchmark();											///< time every key's lookup against the old chained sockets, for -nameKeyBenchmark
+
 	/** 
 		given a key, return the name. this is almost never needed,
-		except for a few rare cases like object serialization. also
-		note that it's not particularly fast; it does a dumb linear
-		search for the key.
+		except for a few rare cases like object serialization.
 	*/
 	AsciiString keyToName(NameKeyType key);
 
@@ -124,19 +106,56 @@ public:
 
 private:
 
+	/// a slot in the open-addressed table; the full hash is kept so most mismatches never reach the string compare
+	struct Slot
+	{
+		UnsignedInt		m_hash {};
+		NameKeyType		m_key {NAMEKEY_INVALID};			///< NAMEKEY_INVALID when the slot is empty
+	};
+
 	enum
 	{
-		// socketcount should be prime, and not "close" to a power of 2, for best results.
-		SOCKET_COUNT = 45007
+		// must be a power of 2.  the INIs alone make about 20000 keys, so start above that.
+		INITIAL_SLOT_COUNT = 65536
 	};
 
+	NameKeyType findOrInsert(const char* name, UnsignedInt hash, Bool lowercase);
+	void grow();
 	void freeSockets();
 
-	Bucket*				m_sockets[SOCKET_COUNT];			///< Catalog of all Buckets already generated
+	std::vector<Slot>					m_slots {};				///< open-addressed, linear probed table of every key
+	std::vector<AsciiString>	m_names {};				///< name of each key, indexed by key - 1
+	std::vector<UnsignedInt>	m_hashes {};			///< hash each key was made with, indexed by key - 1
 	UnsignedInt		m_nextID {};											///< Next available ID
 
+	UnsignedInt		m_lookups {};												///< for reportStatistics
+	UnsignedInt		m_probes {};												///< slots looked at by all lookups
+
 };  // end class NameKeyGenerator
 
+//-------------------------------------------------------------------------------------------------
+inline constexpr UnsignedInt NameKeyGenerator::calcHash(const char* p)
+{
+	UnsignedInt result = 0;
+	while (*p)
+		result = (result << 5) + result + static_cast<UnsignedByte>(*p++);
+	return result;
+}
+
+//-------------------------------------------------------------------------------------------------
+inline constexpr UnsignedInt NameKeyGenerator::calcLowercaseHash(const char* p)
+{
+	UnsignedInt result = 0;
+	while (*p)
+	{
+		UnsignedByte c = static_cast<UnsignedByte>(*p++);
+		if (c >= 'A' && c <= 'Z')
+			c = static_cast<UnsignedByte>(c + ('a' - 'A'));
+		result = (result << 5) + result + c;
+	}
+	return result;
+}
+
 //------------------------------------------------------------------------------------------------- 
 //           Externals                                                     
 //------------------------------------------------------------------------------------------------- 
@@ -154,8 +173,9 @@ class StaticNameKey
 private:
 	mutable NameKeyType m_key;
 	const char* m_name;
+	UnsignedInt m_hash;
 public:
-	StaticNameKey(const char* p) : m_key(NAMEKEY_INVALID), m_name(p) {}
+	constexpr StaticNameKey(const char* p) : m_key(NAMEKEY_INVALID), m_name(p), m_hash(NameKeyGenerator::calcHash(p)) {}
 	NameKeyType key() const;
 	// ugh, this is a little hokey, but lets us pretend that a StaticNameKey == NameKeyType
 	inline operator NameKeyType() const { return key(); }
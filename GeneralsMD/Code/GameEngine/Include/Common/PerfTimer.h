@@ -31,12 +31,12 @@
 #ifndef __PERFTIMER_H__
 #define __PERFTIMER_H__
 
-#if defined(_DEBUG) || defined(_INTERNAL)
+#if defined(ENABLE_PERF_TIMERS)
 	/*
-		NOTE NOTE NOTE: never check this in with this enabled, since there is a nonzero time penalty
-		for running in this mode. Only enable it for local builds for testing purposes! (srj)
+		NOTE NOTE NOTE: there is a nonzero time penalty for running in this mode, so it is only
+		turned on by building with "make PERF_TIMERS=1". Never ship a build made that way! (srj)
 	*/
-	#define NO_PERF_TIMERS
+	#define PERF_TIMERS
 #else
 	#define NO_PERF_TIMERS
 #endif
@@ -56,9 +56,16 @@ class DebugDisplayInterface;
 //-------------------------------------------------------------------------------------------------
 //-------------------------------------------------------------------------------------------------
 
-#define NO_USE_QPF	// non-QPF is much faster.
-
 #if defined(PERF_TIMERS) || defined(DUMP_PERF_STATS)
+
+// on x86 the ticks are straight from the TSC (which every CPU we care about keeps invariant);
+// anywhere else they are nanoseconds of CLOCK_MONOTONIC_RAW.
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+	#define PERF_TIMER_USE_RDTSC
+	#include <x86intrin.h>
+#endif
+
 //-------------------------------------------------------------------------------------------------
 void InitPrecisionTimer();
 
@@ -66,21 +73,14 @@ void InitPrecisionTimer();
 void GetPrecisionTimerTicksPerSec(Int64* t);
 
 //-------------------------------------------------------------------------------------------------
-inline void GetPrecisionTimer([[maybe_unused]] Int64* t)
+inline void GetPrecisionTimer(Int64* t)
 {
-#ifdef USE_QPF
-	QueryPerformanceCounter((LARGE_INTEGER*)t);
+#ifdef PERF_TIMER_USE_RDTSC
+	*t = static_cast<Int64>(__rdtsc());
 #else
-	// CPUID is needed to force serialization of any previous instructions. 
-	// __asm 
-	// {
-	// 	// for now, I am commenting this out. It throws the timings off a bit more (up to .001%) jkmcd
-	// 	//		CPUID
-	// 	RDTSC
-	// 	MOV ECX,[t]
-	// 	MOV [ECX], EAX
-	// 	MOV [ECX+4], EDX
-	// }
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+	*t = static_cast<Int64>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
 #endif
 }
 #endif
@@ -99,8 +99,12 @@ public:
 	PerfGather( const char *identifier, Bool netOnly=true );
 	virtual ~PerfGather( );
 
-	__forceinline void startTimer();
-	__forceinline void stopTimer();
+	// No copies allowed!
+	PerfGather(const PerfGather&) = delete;
+	PerfGather& operator=(const PerfGather&) = delete;
+
+	inline void startTimer();
+	inline void stopTimer();
 
 	enum
 	{
@@ -115,46 +119,65 @@ public:
 	static void dumpAll(UnsignedInt frame);
 	static void displayGraph(UnsignedInt frame);
 
+	static void initPerfTrace(const char* fname);		///< also log every timed scope to fname.json, for chrome://tracing or Perfetto
+	static void flushPerfTrace();											///< write out the scopes every thread has recorded since the last flush
+	static void termPerfTrace();
+
+	static AsciiString reportTotals(Int frames);			///< every gather's time since clearTotals, worst first, for ReplayBenchmark
+	static void clearTotals();
+
 	void reset();
 
 private:
 
 	enum { MAX_ACTIVE_STACK = 256 };
-	static PerfGather* m_active[MAX_ACTIVE_STACK];
-	static PerfGather** m_activeHead;
+	enum { HISTOGRAM_BUCKETS = 24 };		///< bucket n counts frames that took [2^(n-1), 2^n) usec; bucket 0, under 1 usec
+
+	// each thread keeps its own stack of running timers; m_active[0] is always null.
+	static thread_local PerfGather* m_active[MAX_ACTIVE_STACK];
+	static thread_local Int m_activeDepth;
 	static Int64 s_stopStartOverhead;	// overhead for stop+start a timer
+	static Bool s_tracing;
 
 	static PerfGather*& getHeadPtr();
+	static void recordTraceEvent(const char *identifier, Int64 startTime, Int64 endTime);
+	static void writeHistograms();
 
 	void addToList();
 	void removeFromList();
-
-	const char*		m_identifier;
-	Int64					m_startTime;
-	Int64					m_runningTimeGross;
-	Int64					m_runningTimeNet;
-	Int						m_callCount;
-	PerfGather*		m_next;
-	PerfGather*		m_prev;
-	Bool					m_ignore;
-	Bool					m_netTimeOnly;
+	void addFrameToHistogram();
+
+	const char*		m_identifier {};
+	Int64					m_startTime {};
+	Int64					m_runningTimeGross {};
+	Int64					m_runningTimeNet {};
+	Int						m_callCount {};
+	PerfGather*		m_next {};
+	PerfGather*		m_prev {};
+	Bool					m_ignore {};
+	Bool					m_netTimeOnly {};
+	UnsignedInt		m_histogram[HISTOGRAM_BUCKETS] {};	///< frame (gross) times, over every frame dumped
+	Int64					m_totalTimeGross {};								///< summed by resetAll, since clearTotals
+	Int64					m_totalTimeNet {};
+	Int64					m_totalCallCount {};
 };
 
 //-------------------------------------------------------------------------------------------------
 void PerfGather::startTimer()
 {
-	*++m_activeHead = this;
+	m_active[++m_activeDepth] = this;
 	GetPrecisionTimer(&m_startTime);
 }
 
 //-------------------------------------------------------------------------------------------------
 void PerfGather::stopTimer()
 {
-	DEBUG_ASSERTCRASH(this != NULL, ("I am null, uh oh"));
-
 	Int64 runTime;
 	GetPrecisionTimer(&runTime);
 
+	if (s_tracing)
+		recordTraceEvent(m_identifier, m_startTime, runTime);
+
 	runTime -= m_startTime;
 
 	m_runningTimeGross += runTime;
@@ -163,18 +186,19 @@ void PerfGather::stopTimer()
 	++m_callCount;
 
 #ifdef _DEBUG
-	DEBUG_ASSERTCRASH(*m_activeHead != NULL, ("m_activeHead is null, uh oh"));
-	DEBUG_ASSERTCRASH(*m_activeHead == this, ("I am not the active timer, uh oh"));
-	DEBUG_ASSERTCRASH(m_activeHead >= &m_active[0] && m_activeHead <= &m_active[MAX_ACTIVE_STACK-1], ("active under/over flow"));
+	DEBUG_ASSERTCRASH(m_active[m_activeDepth] != NULL, ("m_activeHead is null, uh oh"));
+	DEBUG_ASSERTCRASH(m_active[m_activeDepth] == this, ("I am not the active timer, uh oh"));
+	DEBUG_ASSERTCRASH(m_activeDepth > 0 && m_activeDepth < MAX_ACTIVE_STACK, ("active under/over flow"));
 #endif
-	--m_activeHead;
+	--m_activeDepth;
 
-	if (*m_activeHead)
+	PerfGather *parent = m_active[m_activeDepth];
+	if (parent)
 	{
 		// don't add the time it took for us to actually get the ticks (in startTimer) to our parent...
-		(*m_activeHead)->m_runningTimeGross -= (s_stopStartOverhead);
-		if ((*m_activeHead)->m_netTimeOnly) {
-			(*m_activeHead)->m_runningTimeNet -= (runTime + s_stopStartOverhead);
+		parent->m_runningTimeGross -= (s_stopStartOverhead);
+		if (parent->m_netTimeOnly) {
+			parent->m_runningTimeNet -= (runTime + s_stopStartOverhead);
 		}
 	}
 }
@@ -189,8 +213,8 @@ class AutoPerfGather
 private:
 	PerfGather& m_g;
 public:
-	__forceinline AutoPerfGather(PerfGather& g);
-	__forceinline ~AutoPerfGather();
+	inline AutoPerfGather(PerfGather& g);
+	inline ~AutoPerfGather();
 };
 
 //-------------------------------------------------------------------------------------------------
@@ -213,14 +237,13 @@ private:
 	PerfGather& m_g;
 	Bool				m_oldIgnore;
 public:
-	__forceinline AutoPerfGatherIgnore(PerfGather& g);
-	__forceinline ~AutoPerfGatherIgnore();
+	inline AutoPerfGatherIgnore(PerfGather& g);
+	inline ~AutoPerfGatherIgnore();
 };
 
 //-------------------------------------------------------------------------------------------------
-AutoPerfGatherIgnore::AutoPerfGatherIgnore(PerfGather& g) : m_g(g)
+AutoPerfGatherIgnore::AutoPerfGatherIgnore(PerfGather& g) : m_g(g), m_oldIgnore(s_ignoring)
 {
-	m_oldIgnore = s_ignoring;
 	s_ignoring = true;
 
 	m_g.startTimer();
@@ -253,27 +276,34 @@ class PerfTimer
 public:
 	PerfTimer( const char *identifier, Bool crashWithInfo = true, Int startFrame = 0, Int endFrame = -1);
 	virtual ~PerfTimer( );
-	__forceinline void startTimer( void );
-	__forceinline void stopTimer( void );
+
+	// No copies allowed!
+	PerfTimer(const PerfTimer&) = delete;
+	PerfTimer& operator=(const PerfTimer&) = delete;
+
+	inline void startTimer( void );
+	inline void stopTimer( void );
 	
 protected:
-	Int64 m_startTime;
+	enum { NO_END_FRAME = 0xffffffff };	// (what an endFrame of -1 becomes)
+
+	Int64 m_startTime {};
 
 protected:
 	void outputInfo( void );
 	void showMetrics( void );
 
 protected:
-	const char *m_identifier;
-	Bool m_crashWithInfo;
-	UnsignedInt m_startFrame;
-	UnsignedInt m_endFrame;
-	UnsignedInt m_lastFrame;	// last frame we got data from
-	Bool m_outputInfo;
+	const char *m_identifier {};
+	Bool m_crashWithInfo {};
+	UnsignedInt m_startFrame {};
+	UnsignedInt m_endFrame {};
+	UnsignedInt m_lastFrame {};	// last frame we got data from
+	Bool m_outputInfo {};
 
 	// total running time so far.
-	Int64 m_runningTime;
-	Int m_callCount;
+	Int64 m_runningTime {};
+	Int m_callCount {};
 
 	friend void StatMetricsDisplay( DebugDisplayInterface *dd, void *, FILE *fp );
 	friend void EndStatMetricsDisplay( DebugDisplayInterface *dd, void *, FILE *fp );
@@ -283,7 +313,7 @@ protected:
 void PerfTimer::startTimer( void )
 {
 	UnsignedInt frm = (TheGameLogic ? TheGameLogic->getFrame() : m_startFrame);
-	if (frm >= m_startFrame && (m_endFrame == -1 || frm <= m_endFrame)) 
+	if (frm >= m_startFrame && (m_endFrame == NO_END_FRAME || frm <= m_endFrame)) 
 	{
 		GetPrecisionTimer(&m_startTime);
 	}
@@ -293,7 +323,7 @@ void PerfTimer::startTimer( void )
 void PerfTimer::stopTimer( void )
 {
 	UnsignedInt frm = (TheGameLogic ? TheGameLogic->getFrame() : m_startFrame);
-	if (frm >= m_startFrame && (m_endFrame == -1 || frm <= m_endFrame)) 
+	if (frm >= m_startFrame && (m_endFrame == NO_END_FRAME || frm <= m_endFrame)) 
 	{
 		Int64 tmp;
 		GetPrecisionTimer(&tmp);
@@ -303,12 +333,12 @@ void PerfTimer::stopTimer( void )
 	}
 	
 
-	if (TheGlobalData && TheGlobalData->m_showMetrics && m_endFrame > m_startFrame + PERFMETRICS_BETWEEN_METRICS) {
+	if (TheGlobalData && TheGlobalData->m_data.m_showMetrics && m_endFrame > m_startFrame + PERFMETRICS_BETWEEN_METRICS) {
 		m_endFrame = m_startFrame + PERFMETRICS_BETWEEN_METRICS;
 	}
 
 	if (m_endFrame > 0 && frm >= m_endFrame) {
-		if (TheGlobalData->m_showMetrics) {
+		if (TheGlobalData->m_data.m_showMetrics) {
 			showMetrics();
 		}
 
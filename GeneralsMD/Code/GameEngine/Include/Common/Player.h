@@ -161,12 +161,46 @@ public:
 	PlayerRelationMap( void );
 	// virtual destructor provided by memory pool object
 
-	/** @todo I'm jsut wrappign this up in a nice snapshot object, we really should isolate
-		* m_map from public access and make access methods for our operations */
-	PlayerRelationMapType m_map {};
+	Bool isEmpty( void ) const { return m_map.empty(); }
+
+	/// Looks up the relationship with a player, if there is one.  Player indices are all in range in
+	/// practice, so this is normally a bit test and an array load rather than a hash lookup.
+	Bool findRelationship( PlayerIndex playerIndex, Relationship *r ) const
+	{
+		if( (UnsignedInt)playerIndex < MAX_PLAYER_COUNT )
+		{
+			if( s_checkDenseCopies )
+				checkDenseCopy( playerIndex );
+			if( (m_hasRelation & (1u << playerIndex)) == 0 )
+				return FALSE;
+			*r = m_relations[ playerIndex ];
+			return TRUE;
+		}
+		PlayerRelationMapType::const_iterator it = m_map.find( playerIndex );
+		if( it == m_map.end() )
+			return FALSE;
+		*r = (*it).second;
+		return TRUE;
+	}
+
+	void setRelationship( PlayerIndex playerIndex, Relationship r );
+	Bool removeRelationship( PlayerIndex playerIndex );	///< false if there was none
+	Bool clear( void );									///< false if there were none
+
+	static AsciiString reportDenseCopyChecks( Int frames );	///< for ReplayBenchmark
+	static void resetDenseCopyChecks( void );				///< zero the counts and start checking every dense lookup
 
 protected:
 
+	void checkDenseCopy( PlayerIndex playerIndex ) const;	///< count whether the table and the map agree about playerIndex
+
+	static Bool s_checkDenseCopies;						///< set while a ReplayBenchmark is running; the check costs a hash lookup
+
+	PlayerRelationMapType m_map {};						///< what gets saved
+	Relationship m_relations[ MAX_PLAYER_COUNT ] {};	///< m_map, for the player indices that are in range
+	UnsignedInt m_hasRelation {};						///< bit per player index that m_relations holds
+
+
 	virtual void crc( Xfer *xfer );
 	virtual void xfer( Xfer *xfer );
 	virtual void loadPostProcess( void );
@@ -485,6 +519,13 @@ public:
 		simply returns the number of objects owned by this player with a specific KindOfMaskType
 	*/
 	Int countObjects(KindOfMaskType setMask, KindOfMaskType clearMask);
+
+	/// the counts behind the queries above; kept up to date by our teams as their members change
+	ObjectCensus& friend_getObjectCensus() { return m_objectCensus; }
+	void rebuildObjectCensus();		///< recompute from our teams' censuses
+#ifdef _DEBUG
+	void verifyObjectCensus() const;	///< recount every object we own and crash if the census doesn't agree
+#endif
 	
 	/// Returns the closest of a given type to the given object
 	Object *findClosestByKindOf( Object *queryObject, KindOfMaskType setMask, KindOfMaskType clearMask );
@@ -784,6 +825,7 @@ private:
 	UnicodeString					m_generalName {};		///< (SAVE) This is the name of the general the player is allowed to change.
 	
 	PlayerTeamList					m_playerTeamPrototypes {};				///< ALL the teams we control, via prototype
+	ObjectCensus					m_objectCensus {};								///< (NO-SAVE) sum of the censuses of all the teams above
 	PlayerRelationMap				*m_playerRelations {};						///< allies & enemies
 	TeamRelationMap					*m_teamRelations {};							///< allies & enemies
 	
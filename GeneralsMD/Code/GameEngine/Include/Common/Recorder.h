@@ -27,6 +27,7 @@
 
 #include "Common/MessageStream.h"
 #include "GameNetwork/GameInfo.h"
+#include <chrono>
 #include <ctime>
 
 /**
@@ -53,6 +54,8 @@ enum RecorderModeType {
 };
 
 class CRCInfo;
+class ReplaySnapshotRing;
+struct ReplaySnapshot;
 
 class RecorderClass : public SubsystemInterface {
 public:
@@ -76,6 +79,10 @@ public:
 	Bool testVersionPlayback(AsciiString filename);   ///< Returns if the playback is a valid playback file for this version or not.
 	AsciiString getCurrentReplayFilename( void );			///< valid during playback only
 	void stopPlayback();															///< Stops playback.  Its fine to call this even if not playing back a file.
+	Bool seekPlayback(UnsignedInt frame);							///< Jump playback to frame, restoring a snapshot if it's behind us.
+	Bool isSeeking() const { return m_seekTarget != 0; }	///< Is playback being run forward to a seek target.
+	AsciiString reportSeekTimings() const;						///< snapshot and seek times since the last reset, for ReplayBenchmark
+	void resetSeekTimings();
 #if defined _DEBUG || defined _INTERNAL
 	Bool analyzeReplay( AsciiString filename );
 	Bool isAnalysisInProgress( void );
@@ -144,6 +151,9 @@ protected:
 
 	void cullBadCommands();														///< prevent the user from giving mouse commands that he shouldn't be able to do during playback.
 
+	void takeSnapshot(UnsignedInt frame);							///< Save the game into the snapshot ring.
+	Bool restoreSnapshot(const ReplaySnapshot& snapshot);	///< Load a snapshot and point playback at its place in the file.
+
 	FILE *m_file {};
 	AsciiString m_fileName {};
 	Int m_currentFilePosition {};
@@ -158,6 +168,17 @@ protected:
 	Int m_originalGameMode {}; // valid in replays
 
 	UnsignedInt m_nextFrame {};												///< The Frame that the next message is to be executed on.  This can be -1.
+
+	ReplaySnapshotRing *m_snapshots {};								///< only exists when -replaySnapshots was given
+	UnsignedInt m_seekTarget {};											///< frame a seek is running forward to, 0 when not seeking
+	std::chrono::steady_clock::time_point m_seekStart {};
+	Int m_snapshotsTaken {};													///< the rest are for reportSeekTimings
+	Real m_snapshotMilliseconds {};
+	Int m_seeksRestored {};
+	Real m_seekRestoreMilliseconds {};
+	Int m_seeksFinished {};
+	Real m_seekMilliseconds {};												///< restore and running forward, for the seeks that reached their target
+	Bool m_restoringSnapshot {};											///< keeps reset() from ending playback while a snapshot loads
 };
 
 extern RecorderClass *TheRecorder;
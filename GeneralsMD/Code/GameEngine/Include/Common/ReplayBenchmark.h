@@ -0,0 +1,70 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// FILE: ReplayBenchmark.h ////////////////////////////////////////////////////////////////////////
+// Desc:   Times a headless replay playback.
+//
+//         With -headless -file foo.rep the engine plays the replay back as fast as the logic
+//         can run it.  This watches the playback, and when it finishes prints the logic frame
+//         rate, the time each subsystem spent updating, and the final logic CRC, then quits.
+//         Add -headlessAudio to keep the audio manager running and report its decode cache.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#ifndef __REPLAYBENCHMARK_H_
+#define __REPLAYBENCHMARK_H_
+
+// INCLUDES ///////////////////////////////////////////////////////////////////////////////////////
+#include "Common/AsciiString.h"
+
+//-------------------------------------------------------------------------------------------------
+class ReplayBenchmark
+{
+public:
+
+	ReplayBenchmark( const AsciiString& replayFile );
+	~ReplayBenchmark();
+
+	// No copies allowed!
+	ReplayBenchmark(const ReplayBenchmark&) = delete;
+	ReplayBenchmark& operator=(const ReplayBenchmark&) = delete;
+
+	void update( void );										///< call once per engine frame
+	void abort( const char *reason );				///< report that the replay could not be run, and quit
+
+	Bool isRunning( void ) const { return m_running; }
+
+private:
+
+	void start( void );
+	void finish( void );
+
+	AsciiString		m_replayFile {};
+	UnsignedInt		m_frameDuration {};			///< length of the replay, from its header (0 if unknown)
+	UnsignedInt		m_startFrame {};
+	UnsignedInt		m_seekedFrames {};			///< frames played twice because -seekFrame went back over them
+	Bool					m_seekTried {};
+	Int64					m_startNanos {};
+	Bool					m_running {};
+	Bool					m_done {};
+};
+
+extern ReplayBenchmark *TheReplayBenchmark;		///< only exists for -headless runs of a replay
+
+#endif // __REPLAYBENCHMARK_H_
@@ -0,0 +1,77 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// FILE: ReplaySnapshotRing.h /////////////////////////////////////////////////////////////////////
+// Desc:   Bounded ring of in-memory game snapshots taken during replay playback.
+//
+//         The recorder saves the whole game through GameState::saveToImage every so many frames.
+//         To seek, it restores the nearest snapshot at or before the target frame and runs the
+//         logic forward from there, rather than replaying the file from frame zero.  When the
+//         ring is over its count or memory budget the oldest snapshot is dropped.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#ifndef __REPLAY_SNAPSHOT_RING_H_
+#define __REPLAY_SNAPSHOT_RING_H_
+
+// INCLUDES ///////////////////////////////////////////////////////////////////////////////////////
+#include <vector>
+
+//-------------------------------------------------------------------------------------------------
+struct ReplaySnapshot
+{
+	UnsignedInt								m_frame {};					///< logic frame the snapshot was taken at
+	long											m_filePos {};				///< replay file offset just past the next command's frame number
+	UnsignedInt								m_nextFrame {};			///< frame of the next command in the replay file
+	std::vector<UnsignedByte>	m_image {};					///< the saved game
+	Real											m_captureMilliseconds {};
+};
+
+//-------------------------------------------------------------------------------------------------
+class ReplaySnapshotRing
+{
+
+public:
+
+	ReplaySnapshotRing( Int maxSnapshots, size_t maxBytes );
+
+	void clear( void );
+
+	/// add a snapshot, swapping its image out of 'snapshot' and dropping the oldest ones to stay in budget
+	void add( ReplaySnapshot& snapshot );
+
+	Bool has( UnsignedInt frame ) const;															///< is there a snapshot of exactly this frame
+	const ReplaySnapshot *findAtOrBefore( UnsignedInt frame ) const;	///< latest snapshot not after frame, or NULL
+
+	Int getCount( void ) const { return m_count; }
+	size_t getBytes( void ) const { return m_bytes; }
+
+private:
+
+	void dropOldest( void );
+
+	std::vector<ReplaySnapshot>	m_slots {};				///< fixed size ring
+	Int													m_head {};				///< slot of the oldest snapshot
+	Int													m_count {};
+	size_t											m_bytes {};				///< total size of the held images
+	size_t											m_maxBytes {};
+
+};
+
+#endif // __REPLAY_SNAPSHOT_RING_H_
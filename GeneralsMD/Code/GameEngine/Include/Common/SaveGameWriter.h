@@ -0,0 +1,101 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// FILE: SaveGameWriter.h /////////////////////////////////////////////////////////////////////////
+// Desc:   Writes finished save game images to disk on a background thread.
+//
+//         GameState serializes a save into memory with XferSaveMemory and hands the image over
+//         here, so the main thread never waits on compression or the disk.  Each image is
+//         optionally compressed, written to a temporary file beside its destination and renamed
+//         into place, so a crash mid-write leaves the previous save intact.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#ifndef __SAVE_GAME_WRITER_H_
+#define __SAVE_GAME_WRITER_H_
+
+// INCLUDES ///////////////////////////////////////////////////////////////////////////////////////
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Common/AsciiString.h"
+#include "Compression.h"
+
+//-------------------------------------------------------------------------------------------------
+class SaveGameWriter
+{
+
+public:
+
+	SaveGameWriter( void );
+	~SaveGameWriter( void );															///< finishes any queued writes
+
+	// No copies allowed!
+	SaveGameWriter(const SaveGameWriter&) = delete;
+	SaveGameWriter& operator=(const SaveGameWriter&) = delete;
+
+	/// queue 'image' to be written to 'filepath'.  The image is swapped out, leaving 'image' empty.
+	void write( const AsciiString& filepath, std::vector<UnsignedByte>& image, CompressionType compression );
+
+	void flush( void );																		///< wait until every queued image is on disk
+	Bool isPending( const AsciiString& filepath );				///< is a write to this file queued or in progress
+	Int reportFinishedWrites( std::vector<AsciiString> *failedFiles = NULL );	///< log writes finished since the last call and free their images, returns how many succeeded
+
+private:
+
+	struct Job
+	{
+		std::string								m_filepath {};			///< not AsciiString, its reference counts aren't thread safe
+		std::vector<UnsignedByte>	m_image {};
+		std::vector<UnsignedByte>	m_compressed {};		///< sized on the main thread, empty if not compressing
+		CompressionType						m_compression {COMPRESSION_NONE};
+	};
+
+	struct Result
+	{
+		std::string								m_filepath {};
+		size_t										m_imageSize {};				///< uncompressed size
+		size_t										m_writtenSize {};			///< size on disk
+		Real											m_compressMilliseconds {};
+		Real											m_writeMilliseconds {};
+		Bool											m_ok {};
+		std::vector<UnsignedByte>	m_image {};						///< the job's buffers, handed back so the main thread frees them
+		std::vector<UnsignedByte>	m_compressed {};
+	};
+
+	void threadMain( void );
+	static void writeJob( Job& job, Result& result );		///< runs on the writer thread, must not touch the engine
+
+	std::mutex								m_mutex {};
+	std::condition_variable		m_wake {};							///< signalled when a job is queued or we're quitting
+	std::condition_variable		m_idle {};							///< signalled when the queue drains
+	std::deque<Job>						m_jobs {};
+	std::vector<Result>				m_results {};
+	std::string								m_activeFilepath {};		///< file the thread is writing right now
+	Bool											m_busy {};
+	Bool											m_quit {};
+	std::thread								m_thread {};						///< started on the first write
+
+};
+
+#endif // __SAVE_GAME_WRITER_H_
+
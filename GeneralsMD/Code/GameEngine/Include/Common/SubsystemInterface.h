@@ -131,8 +131,22 @@ protected:
 	Bool m_dumpUpdate;
 	Bool m_dumpDraw;
 #else 
-	inline void UPDATE(void) {update();}
+	inline void UPDATE(void) { if (s_timeUpdates) timedUpdate(); else update(); }
 	inline void DRAW(void) {draw();}
+
+	static void setTimeUpdates(Bool on) {s_timeUpdates = on;}	///< accumulate update() times, for benchmarking
+	Int64 getUpdateNanosGross(void) const {return m_updateNanosGross;}	///< including nested subsystem updates
+	Int64 getUpdateNanosNet(void) const {return m_updateNanosNet;}			///< excluding nested subsystem updates
+	Int getUpdateCount(void) const {return m_updateCount;}
+	void clearUpdateTimes(void) {m_updateNanosGross = 0; m_updateNanosNet = 0; m_updateCount = 0;}
+protected:
+	void timedUpdate(void);
+
+	static Bool s_timeUpdates;
+	static Int64 s_nestedUpdateNanos;	///< time spent in updates nested inside the current one
+	Int64 m_updateNanosGross {};
+	Int64 m_updateNanosNet {};
+	Int m_updateCount {};
 #endif
 protected:
 	AsciiString m_name {};
@@ -158,6 +172,9 @@ public:
 	void shutdownAll();
 #ifdef DUMP_PERF_STATS
  	AsciiString dumpTimesForAll();
+#else
+	void clearUpdateTimesForAll();
+	AsciiString reportUpdateTimesForAll(Int frames);
 #endif
 
 private:
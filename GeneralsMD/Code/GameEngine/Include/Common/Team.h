@@ -69,6 +69,69 @@ protected:
 
 };
 
+// ------------------------------------------------------------------------------------------------
+/**
+	Running counts of the objects on a team (or controlled by a player), kept per exact ThingTemplate
+	and split by dead / under construction, so the count queries don't have to walk every member.
+	A team only holds a handful of distinct templates, so they live in a small vector and are
+	matched with isEquivalentTo at query time, just as the member walk did.
+*/
+class ObjectCensus
+{
+public:
+
+	enum
+	{
+		CENSUS_DEAD									= 0x01,
+		CENSUS_UNDER_CONSTRUCTION		= 0x02,
+		CENSUS_STATE_COUNT					= 4
+	};
+
+	static UnsignedByte getCensusState( const Object *obj );	///< which bucket obj belongs in right now
+
+	void add( const ThingTemplate *tmpl, UnsignedByte state, Int count = 1 );
+	void remove( const ThingTemplate *tmpl, UnsignedByte state ) { add( tmpl, state, -1 ); }
+	void addCensus( const ObjectCensus& that, Int sign );	///< sign is 1 to add all of that's counts, -1 to take them away
+	void clear();
+	Bool isEmpty() const { return m_entries.empty(); }
+	Bool isSameAs( const ObjectCensus& that ) const;
+
+	/// adds to counts, the same way Team::countObjectsByThingTemplate always has
+	void countObjectsByThingTemplate( Int numTmplates, const ThingTemplate* const* things, Bool ignoreDead, Int *counts, Bool ignoreUnderConstruction ) const;
+	Int countBuildings() const { return m_buildingCount; }
+	Int countObjects( KindOfMaskType setMask, KindOfMaskType clearMask ) const;
+
+#ifdef _DEBUG
+	/// The debug recount walks every member, so the count queries only ask for one about once a
+	/// second.  True if this census is due one on frame, which it then counts as done.
+	Bool isVerifyDue( UnsignedInt frame ) const
+	{
+		// unsigned, so a frame that went backwards (a new game, a load) is due straight away
+		if( m_verified && frame - m_verifiedFrame < (UnsignedInt)LOGICFRAMES_PER_SECOND )
+			return FALSE;
+		m_verified = TRUE;
+		m_verifiedFrame = frame;
+		return TRUE;
+	}
+#endif
+
+private:
+
+	struct Entry
+	{
+		const ThingTemplate *m_template;
+		Int m_count[ CENSUS_STATE_COUNT ];
+		Int m_total;
+	};
+
+	std::vector<Entry> m_entries {};	///< entries are dropped when their total reaches zero
+	Int m_buildingCount {};						///< total of the KINDOF_STRUCTURE entries
+#ifdef _DEBUG
+	mutable Bool m_verified {};				///< see isVerifyDue
+	mutable UnsignedInt m_verifiedFrame {};	///< frame of the last debug recount
+#endif
+};
+
 // ------------------------------------------------------------------------------------------------
 typedef void (*ObjectIterateFunc)( Object *obj, void *userData );		///< callback type for iterating objects
 
@@ -233,6 +296,8 @@ private:
 
 	std::list< ObjectID >	m_xferMemberIDList {};		///< list for post processing and restoring object pointers after a load
 
+	ObjectCensus			m_census {};				///< running counts of our members, see countObjectsByThingTemplate
+
 protected:
 
 	// snapshot methods
@@ -411,6 +476,20 @@ public:
 	*/
 	Int countObjects(KindOfMaskType setMask, KindOfMaskType clearMask);
 
+	/**
+		keep the team's (and its controlling player's) object census up to date. Objects call these
+		when they join or leave the team, and whenever they die or finish construction.
+	*/
+	void addMemberToCensus( Object *obj );
+	void removeMemberFromCensus( Object *obj );
+	void updateMemberCensus( Object *obj );
+	const ObjectCensus& getObjectCensus() const { return m_census; }
+
+#ifdef _DEBUG
+	/// recount the members and crash if the census doesn't agree
+	void verifyObjectCensus() const;
+#endif
+
 	/**
 		This Team will heal all its members
 	*/
@@ -345,6 +345,36 @@ public:
 	Bool clearAiModuleInfo();
 };
 
+//-------------------------------------------------------------------------------------------------
+/** The module interfaces Objects are asked for all the time, which ModuleInterfaceLayout indexes */
+//-------------------------------------------------------------------------------------------------
+enum ObjectInterfaceType: int
+{
+	OBJECT_INTERFACE_PRODUCTION_UPDATE,
+	OBJECT_INTERFACE_DOCK_UPDATE,
+	OBJECT_INTERFACE_UPDATE_EXIT,
+	OBJECT_INTERFACE_SPAWN_BEHAVIOR,
+	OBJECT_INTERFACE_PROJECTILE_UPDATE,
+	OBJECT_INTERFACE_SLAVED_UPDATE,
+
+	OBJECT_INTERFACE_COUNT
+};
+
+//-------------------------------------------------------------------------------------------------
+/** Where in an Object's module array the modules behind those interfaces are.  Every Object of a
+	* template builds the same array, so this is worked out by the first one created and shared. */
+//-------------------------------------------------------------------------------------------------
+struct ModuleInterfaceLayout
+{
+	enum { NO_MODULE = -1 };
+
+	Bool				m_computed {};
+	std::vector<NameKeyType>	m_moduleNames {};					///< each slot's module name, to spot an Object whose array came out differently
+	Short				m_slot[ OBJECT_INTERFACE_COUNT ] {};		///< first module with the interface, or NO_MODULE
+	std::vector<Short>	m_specialPowerSlots {};						///< every module with a SpecialPowerModuleInterface, in order
+	std::vector<Short>	m_specialPowerUpdateSlots {};				///< every module with a SpecialPowerUpdateInterface, in order
+};
+
 //-------------------------------------------------------------------------------------------------
 /** Definition of a thing template to read from our game data framework */
 //-------------------------------------------------------------------------------------------------
@@ -445,6 +475,8 @@ public:
 	UnsignedInt getOcclusionDelay(void) const { return m_ini.m_occlusionDelay;}
 	
 	const ModuleInfo& getBehaviorModuleInfo() const { return m_ini.m_behaviorModuleInfo; }
+	const ModuleInterfaceLayout& getModuleInterfaceLayout() const { return m_moduleInterfaceLayout; }
+	void friend_setModuleInterfaceLayout( const ModuleInterfaceLayout& layout ) const { m_moduleInterfaceLayout = layout; }
 	const ModuleInfo& getDrawModuleInfo() const { return m_ini.m_drawModuleInfo; }
 	const ModuleInfo& getClientUpdateModuleInfo() const { return m_ini.m_clientUpdateModuleInfo; }
 
@@ -785,6 +817,7 @@ private:
 	ArmorTemplateSetFinder		m_armorTemplateSetFinder {};		///< helper to allow us to find the best sets, quickly
 	PerUnitSoundMap				m_perUnitSounds {};					///< An additional set of sounds that only apply for this template.
 	PerUnitFXMap				m_perUnitFX {};						///< An additional set of fx that only apply for this template.
+	mutable ModuleInterfaceLayout	m_moduleInterfaceLayout {};		///< filled in by the first Object created; not copied with the template
 
 	friend class ThingFactory;
 	friend class AIUpdateModuleData;
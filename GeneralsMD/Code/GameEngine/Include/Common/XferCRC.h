@@ -33,6 +33,7 @@
 #define __XFERCRC_H_
 
 // USER INCLUDES //////////////////////////////////////////////////////////////////////////////////
+#include <vector>
 #include "Common/Xfer.h"
 
 // FORWARD REFERENCES /////////////////////////////////////////////////////////////////////////////
@@ -48,6 +49,10 @@ public:
 	XferCRC( void );
 	virtual ~XferCRC( void );
 
+	// No copies allowed!
+	XferCRC(const XferCRC&) = delete;
+	XferCRC& operator=(const XferCRC&) = delete;
+
 	// Xfer methods
 	virtual void open( AsciiString identifier );		///< start a CRC session with this xfer instance
 	virtual void close( void );											///< stop CRC session
@@ -60,13 +65,18 @@ public:
 	// Xfer CRC methods
 	virtual UnsignedInt getCRC( void );										///< get computed CRC in network byte order
 
+	/// also append every word folded from now on to 'capture' (NULL to stop)
+	void setCapture( std::vector<UnsignedInt> *capture ) { m_capture = capture; }
+	void addCRCWords( const UnsignedInt *words, UnsignedInt count );	///< fold previously captured words
+
 protected:
 
-	virtual void xferImplementation( void *data, UnsignedInt dataSize );
+	virtual void xferImplementation( void *data, Int dataSize );
 
 	void addCRC( UnsignedInt val );								///< CRC a 4-byte block
 
 	UnsignedInt m_crc {};
+	std::vector<UnsignedInt> *m_capture {};				///< where folded words are collected, if anywhere
 
 };
 
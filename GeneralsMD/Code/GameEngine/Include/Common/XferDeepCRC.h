@@ -64,7 +64,7 @@ public:
 
 protected:
 
-	virtual void xferImplementation( void *data, UnsignedInt dataSize );
+	virtual void xferImplementation( void *data, Int dataSize );
 
 	FILE * m_fileFP {};																			///< pointer to file
 };
@@ -34,6 +34,7 @@
 
 // USER INCLUDES //////////////////////////////////////////////////////////////////////////////////
 #include <stdio.h>
+#include <vector>
 #include "Common/Xfer.h"
 
 // FOWARD REFERNCES ///////////////////////////////////////////////////////////////////////////////
@@ -53,8 +54,9 @@ public:
 	XferLoad(const XferLoad&) = delete;
 	XferLoad& operator=(const XferLoad&) = delete;
 
-	virtual void open( AsciiString identifier );				///< open file for writing
+	virtual void open( AsciiString identifier );				///< open file for reading, compressed or not
 	virtual void close( void );													///< close file
+	void openImage( AsciiString identifier, const std::vector<UnsignedByte>& image );	///< read from an in-memory image instead of a file
 	virtual Int beginBlock( void );														///< read placeholder block size
 	virtual void endBlock( void );											///< reading an end block is a no-op
 	virtual void skip( Int dataSize );									///< skip forward dataSize bytes in file
@@ -69,7 +71,8 @@ protected:
 
 	virtual void xferImplementation( void *data, Int dataSize );		///< the xfer implementation
 
-	FILE * m_fileFP;																					///< pointer to file
+	FILE * m_fileFP {};																				///< pointer to file
+	std::vector<UnsignedByte> m_image {};															///< decompressed file contents, when the file was compressed
 
 };
 
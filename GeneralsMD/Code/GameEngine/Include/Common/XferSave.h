@@ -73,8 +73,8 @@ protected:
 
 	virtual void xferImplementation( void *data, Int dataSize );		///< the xfer implementation
 
-	FILE * m_fileFP;																			///< pointer to file
-	XferBlockData *m_blockStack;													///< stack of block data
+	FILE * m_fileFP {};																		///< pointer to file
+	XferBlockData *m_blockStack {};												///< stack of block data
 
 };
 
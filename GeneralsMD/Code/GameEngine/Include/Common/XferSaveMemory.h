@@ -0,0 +1,72 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// FILE: XferSaveMemory.h /////////////////////////////////////////////////////////////////////////
+// Desc:   Xfer save implementation that builds the file image in memory.
+//
+//         Produces exactly the bytes XferSave would write, but block sizes are patched in the
+//         buffer rather than by seeking back through a file, and nothing touches the disk.  The
+//         finished image is usually handed to the SaveGameWriter to be written in the background.
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#ifndef __XFER_SAVE_MEMORY_H_
+#define __XFER_SAVE_MEMORY_H_
+
+// USER INCLUDES //////////////////////////////////////////////////////////////////////////////////
+#include <vector>
+#include "Common/XferSave.h"
+
+//-------------------------------------------------------------------------------------------------
+/** XferSave's string and snapshot handling is inherited, so the file format can't drift between
+	* the two; only the low level writes are replaced. */
+//-------------------------------------------------------------------------------------------------
+class XferSaveMemory : public XferSave
+{
+
+public:
+
+	XferSaveMemory( void );
+	virtual ~XferSaveMemory( void );
+
+	// No copies allowed!
+	XferSaveMemory(const XferSaveMemory&) = delete;
+	XferSaveMemory& operator=(const XferSaveMemory&) = delete;
+
+	// Xfer methods
+	virtual void open( AsciiString identifier );		///< start a new image, identifier names it in errors
+	virtual void close( void );											///< finish the image
+	virtual Int beginBlock( void );									///< write placeholder block size
+	virtual void endBlock( void );									///< patch the size of the last begun block
+	virtual void skip( Int dataSize );							///< pad with zeros, as seeking past the end of a file would
+
+	std::vector<UnsignedByte>& getImage( void ) { return m_image; }		///< the image so far, complete after close()
+
+protected:
+
+	virtual void xferImplementation( void *data, Int dataSize );		///< append to the image
+
+	std::vector<UnsignedByte> m_image {};						///< the file image
+	std::vector<size_t> m_blockStack {};						///< offsets of the open block size placeholders
+	Bool m_isOpen {};
+
+};
+
+#endif // __XFER_SAVE_MEMORY_H_
+
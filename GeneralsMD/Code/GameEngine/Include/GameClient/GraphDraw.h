@@ -71,14 +71,18 @@ class GraphDraw
 		GraphDraw();
 		virtual ~GraphDraw();
 
+		// No copies allowed!
+		GraphDraw(const GraphDraw&) = delete;
+		GraphDraw& operator=(const GraphDraw&) = delete;
+
 		void addEntry(AsciiString str, Real val);
 		// Called during begin/end
 		void render();
 		void clear();
 
 	protected:
-		VecGraphEntries m_graphEntries;
-		DisplayString *m_displayStrings[MAX_GRAPH_VALUES];
+		VecGraphEntries m_graphEntries {};
+		DisplayString *m_displayStrings[MAX_GRAPH_VALUES] {};
 };
 
 extern GraphDraw *TheGraphDraw;
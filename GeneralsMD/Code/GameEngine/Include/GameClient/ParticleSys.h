@@ -33,6 +33,7 @@
 #define _PARTICLE_SYS_H_
 
 #include <stdio.h>
+#include <vector>
 #include "Common/AsciiString.h"
 #include "Common/File.h"
 #include "Common/GameMemory.h"
@@ -49,6 +50,8 @@
  
 class Particle;
 class ParticleSystem;
+struct ParticleUpdateContext;
+class ParticleStore;
 class ParticleSystemManager;
 class Drawable;
 class Object;
@@ -175,19 +178,20 @@ public:
 	Particle(const Particle&) = delete;
 	Particle& operator=(const Particle&) = delete;
 
-	inline Bool update( void );												///< update this particle's behavior - return false if dead
-	void doWindMotion( void );									///< do wind motion (if present) from particle system
+	/// the one-at-a-time update, run on this particle's own fields rather than its ParticleStore
+	/// slot; ParticleSystem::update doesn't use it, -particleBenchmark times the store against it
+	inline Bool update( const ParticleUpdateContext &context );
 
 	void applyForce( const Coord3D *force );		///< add the given acceleration
 
-	inline const Coord3D *getPosition( void ) { return &m_pos; }
-	inline Real getSize( void ) { return m_size; }
-	inline Real getAngle( void ) { return m_angleZ; }
-	inline Real getAlpha( void ) { return m_alpha; }
-	inline const RGBColor *getColor( void ) { return &m_color; }
-	inline void setColor( RGBColor *color ) { m_color = *color; }
+	// these go to our slot in the system's ParticleStore, see below ParticleSystem
+	inline const Coord3D *getPosition( void );
+	inline Real getSize( void );
+	inline Real getAngle( void );
+	inline Real getAlpha( void );
+	inline const RGBColor *getColor( void );
+	inline void setColor( RGBColor *color );
 
-	inline Bool isInvisible( void );										///< return true if this particle is invisible
 	inline Bool isCulled (void) {return m_isCulled;}				///< return true if the particle falls off the edge of the screen
 	inline void setIsCulled (Bool enable) { m_isCulled = enable;}		///< set particle to not visible because it's outside view frustum
 
@@ -207,7 +211,11 @@ protected:
 	virtual void xfer( Xfer *xfer );
 	virtual void loadPostProcess( void );
 
+	friend class ParticleStore;
+
 	void computeAlphaRate( void );							///< compute alpha rate to get to next key
+	inline void doWindMotion( const ParticleUpdateContext &context );	///< do wind motion using per-frame system state
+	inline Bool isInvisible( const ParticleUpdateContext &context );	///< isInvisible for the system's shader type
 	void computeColorRate( void );							///< compute color change to get to next key
 
 public:
@@ -237,6 +245,8 @@ protected:
 
 
 	Bool					m_isCulled {};														///< status of particle relative to screen bounds
+
+	Int						m_storeSlot {};														///< our slot in m_system's ParticleStore, while we're in its list
 public:
 	Bool					m_inSystemList {};
 	Bool					m_inOverallList {};
@@ -491,6 +501,108 @@ public:
 };
 
 
+/**
+ * Everything a particle's update needs from its system that is the same for every particle
+ * of that system on a given frame.  ParticleSystem::update fills this in once and runs all of
+ * its particles against it, rather than having each particle query the system, the client
+ * frame and (for wind) the attached Object or Drawable on its own.
+ */
+struct ParticleUpdateContext
+{
+	Coord3D m_driftVelocity {};									///< drift velocity of the system
+	Real m_gravity {};														///< acceleration along global Z
+	Bool m_hasWind {};														///< true if the system uses wind motion
+	Coord3D m_windCenter {};											///< world position the wind force falls off from
+	Real m_windCos {};														///< cosine of the system's wind angle
+	Real m_windSin {};														///< sine of the system's wind angle
+	Bool m_updateAlpha {};												///< false for additive systems, whose alpha is unused
+	ParticleSystemInfo::ParticleShaderType m_shaderType {};	///< shader of the system, for the visibility test
+	UnsignedInt m_frame {};											///< current client frame
+};
+
+/**
+ * The state of every particle in a ParticleSystem that changes from frame to frame, kept one
+ * array per field so ParticleSystem::update can integrate four particles at a time.  Each
+ * Particle in the system's list owns a slot, and the slot is the real copy of its state: the
+ * Particle's own fields are only brought up to date for xfer (and for the old one-at-a-time
+ * update, which -particleBenchmark still runs for comparison).  Removing a particle moves the
+ * last slot into its place, so slots aren't in list order.
+ *
+ * The keyframes stay with the Particle; a slot only keeps which key is next and the frame it's
+ * due on (0 once there are no more), so only particles that reach a key this frame go back to
+ * their Particle for it.
+ */
+class ParticleStore
+{
+public:
+
+	ParticleStore() {}
+
+	void add( Particle *p );							///< give p the next slot, holding the state in its fields
+	void remove( Particle *p );						///< free p's slot, moving the last slot into it
+	void load( Particle *p );							///< copy p's fields into its slot
+	void save( Particle *p ) const;				///< copy p's slot into its fields
+	Bool matches( const Particle *p ) const;	///< true if p's fields are exactly its slot (-particleBenchmark)
+
+	Int getCount( void ) const { return (Int)m_particles.size(); }
+
+	/// one frame of every particle, adding the ones that died to 'dead' rather than deleting them
+	void update( const ParticleUpdateContext &context, std::vector<Particle *> &dead );
+
+	inline void getPosition( Int slot, Coord3D *pos ) const { pos->x = m_posX[(size_t)slot]; pos->y = m_posY[(size_t)slot]; pos->z = m_posZ[(size_t)slot]; }
+	inline Real getSize( Int slot ) const { return m_size[(size_t)slot]; }
+	inline Real getAngle( Int slot ) const { return m_angle[(size_t)slot]; }
+	inline Real getAlpha( Int slot ) const { return m_alpha[(size_t)slot]; }
+	inline void getColor( Int slot, RGBColor *color ) const { color->red = m_red[(size_t)slot]; color->green = m_green[(size_t)slot]; color->blue = m_blue[(size_t)slot]; }
+	inline void setColor( Int slot, const RGBColor *color ) { m_red[(size_t)slot] = color->red; m_green[(size_t)slot] = color->green; m_blue[(size_t)slot] = color->blue; }
+	inline void addAccel( Int slot, const Coord3D *accel ) { m_accelX[(size_t)slot] += accel->x; m_accelY[(size_t)slot] += accel->y; m_accelZ[(size_t)slot] += accel->z; }
+
+private:
+
+	template <typename FN> void forEachArray( FN fn );		///< call fn on every per-slot array
+
+	Bool updateSlot( size_t i, const ParticleUpdateContext &context );	///< update one slot, return true if it died
+	void advanceAlphaKey( size_t i );			///< slot i reached its next alpha key
+	void advanceColorKey( size_t i );			///< slot i reached its next color key
+	Bool isInvisible( size_t i, const ParticleUpdateContext &context ) const;
+
+	std::vector<Particle *>		m_particles {};		///< owner of each slot
+
+	std::vector<Real>					m_posX {};
+	std::vector<Real>					m_posY {};
+	std::vector<Real>					m_posZ {};
+	std::vector<Real>					m_velX {};
+	std::vector<Real>					m_velY {};
+	std::vector<Real>					m_velZ {};
+	std::vector<Real>					m_accelX {};
+	std::vector<Real>					m_accelY {};
+	std::vector<Real>					m_accelZ {};
+	std::vector<Real>					m_velDamping {};
+	std::vector<Real>					m_angle {};
+	std::vector<Real>					m_angularRate {};
+	std::vector<Real>					m_angularDamping {};
+	std::vector<Real>					m_size {};
+	std::vector<Real>					m_sizeRate {};
+	std::vector<Real>					m_sizeRateDamping {};
+	std::vector<Real>					m_alpha {};
+	std::vector<Real>					m_alphaRate {};
+	std::vector<Real>					m_red {};
+	std::vector<Real>					m_green {};
+	std::vector<Real>					m_blue {};
+	std::vector<Real>					m_redRate {};
+	std::vector<Real>					m_greenRate {};
+	std::vector<Real>					m_blueRate {};
+	std::vector<Real>					m_colorScale {};
+	std::vector<Real>					m_windRandomness {};
+	std::vector<UnsignedInt>	m_lifetimeLeft {};
+	std::vector<UnsignedInt>	m_createTimestamp {};
+	std::vector<Int>					m_alphaTargetKey {};
+	std::vector<UnsignedInt>	m_alphaKeyFrame {};			///< frame the next alpha key is due, 0 if none
+	std::vector<Int>					m_colorTargetKey {};
+	std::vector<UnsignedInt>	m_colorKeyFrame {};			///< frame the next color key is due, 0 if none
+	std::vector<UnsignedByte>	m_upTowardsEmitter {};		///< nonzero if the particle turns to face its emitter
+};
+
 /**
  * A ParticleSystemTemplate, used by the ParticleSystemManager to instantiate ParticleSystems.
  */
@@ -534,6 +646,9 @@ protected:
 	// This has to be mutable because of the delayed initialization thing in createSlaveSystem
 	mutable const ParticleSystemTemplate *m_slaveTemplate {};		///< if non-NULL, use this to create a slave system
 
+	// Dead systems of this template, detached and waiting to be reused by createParticleSystem
+	mutable std::vector<ParticleSystem *>	m_freeSystems {};
+
 	// template attribute data inherited from ParticleSystemInfo class
 
 	friend class INI;
@@ -577,6 +692,7 @@ public:
 
 	virtual Bool update( Int localPlayerIndex );								///< update this particle system, return false if dead
 	void updateWindMotion( void );							///< update wind motion
+	void getUpdateContext( ParticleUpdateContext *context );	///< gather the per-frame state particle updates depend on
 
 	void setControlParticle( Particle *p );			///< set control particle
 
@@ -640,6 +756,8 @@ public:
 	// @todo Const this jkmcd
 	Particle *getFirstParticle( void ) { return m_systemParticlesHead; }
 
+	ParticleStore &getParticleStore( void ) { return m_store; }	///< the per-frame state of our particles
+
 	void addParticle( Particle *particleToAdd );
 	/// when a particle dies, it calls this method - ONLY FOR USE BY PARTICLE
 	void removeParticle( Particle *p );
@@ -675,12 +793,18 @@ protected:
 	const Coord3D *computeParticleVelocity( const Coord3D *pos );	///< compute a velocity vector based on emission properties
 	const Coord3D *computePointOnUnitSphere( void );	///< compute a random point on a unit sphere
 
+	friend class ParticleSystemManager;					///< recycles systems through init() and detach()
+
+	void init( const ParticleSystemTemplate *sysTemplate, ParticleSystemID id, Bool createSlaves );	///< (re)initialize from a template
+	void detach( void );																///< destroy our particles and unlink from everything
+
 protected:
 
 	Particle *						m_systemParticlesHead {};
 	Particle *						m_systemParticlesTail {};
 
 	UnsignedInt						m_particleCount {};			///< current count of particles for this system
+	ParticleStore					m_store {};					///< the state of every particle in the list
 	ParticleSystemID				m_systemID {};				///< unique id given to this system from the particle system manager
 
 	DrawableID						m_attachedToDrawableID {};	///< if non-zero, system is parented to this Drawable
@@ -729,6 +853,14 @@ protected:
 
 };
 
+//--------------------------------------------------------------------------------------------------------------
+inline const Coord3D *Particle::getPosition( void ) { m_system->getParticleStore().getPosition( m_storeSlot, &m_pos ); return &m_pos; }
+inline Real Particle::getSize( void ) { return m_system->getParticleStore().getSize( m_storeSlot ); }
+inline Real Particle::getAngle( void ) { return m_system->getParticleStore().getAngle( m_storeSlot ); }
+inline Real Particle::getAlpha( void ) { return m_system->getParticleStore().getAlpha( m_storeSlot ); }
+inline const RGBColor *Particle::getColor( void ) { m_system->getParticleStore().getColor( m_storeSlot, &m_color ); return &m_color; }
+inline void Particle::setColor( RGBColor *color ) { m_system->getParticleStore().setColor( m_storeSlot, color ); }
+
 
 //--------------------------------------------------------------------------------------------------------------
 /**
@@ -742,6 +874,7 @@ public:
 	typedef std::list<ParticleSystem*> ParticleSystemList;
 	typedef std::list<ParticleSystem*>::iterator ParticleSystemListIt;
 	typedef std::unordered_map<AsciiString, ParticleSystemTemplate *, rts::hash<AsciiString>, rts::equal_to<AsciiString> > TemplateMap;
+	typedef std::unordered_map<ParticleSystemID, ParticleSystemListIt> ParticleSystemIDMap;
 
 	ParticleSystemManager( void );
 	virtual ~ParticleSystemManager();
@@ -798,6 +931,12 @@ public:
 
 	UnsignedInt getParticleSystemCount( void ) const { return m_particleSystemCount; }
 
+	UnsignedInt getLookupCount( void ) const { return m_lookupCount; }		///< findParticleSystem calls so far
+	UnsignedInt getCreateCount( void ) const { return m_createCount; }		///< systems created so far
+	UnsignedInt getReuseCount( void ) const { return m_reuseCount; }			///< systems created from a template's free list
+
+	void reportUpdateBenchmark( UnsignedInt emitters, UnsignedInt frames );	///< time the particle store against one-at-a-time updates (-particleBenchmark)
+
 	// @todo const this jkmcd
 	ParticleSystemList &getAllParticleSystems( void ) { return m_allParticleSystemList; }
 	
@@ -817,12 +956,18 @@ protected:
 	virtual void xfer( Xfer *xfer );
 	virtual void loadPostProcess( void );
 
+	enum { MAX_FREE_SYSTEMS_PER_TEMPLATE = 16 };
+
+	void releaseParticleSystem( ParticleSystem *sys );	///< recycle a dead system through its template's free list
+	void purgeFreeParticleSystems( void );							///< free every recycled system
+
 	Particle *m_allParticlesHead[ NUM_PARTICLE_PRIORITIES ];
 	Particle *m_allParticlesTail[ NUM_PARTICLE_PRIORITIES ];
 
 	ParticleSystemID m_uniqueSystemID {};					///< unique system ID to assign to each system created
 
 	ParticleSystemList m_allParticleSystemList {};
+	ParticleSystemIDMap m_systemsByID {};					///< every system in m_allParticleSystemList, by ID
 
 	UnsignedInt m_particleCount {};
 	UnsignedInt m_fieldParticleCount {}; ///< this does not need to be xfered, since it is evaluated every frame
@@ -831,6 +976,10 @@ protected:
 	UnsignedInt m_lastLogicFrameUpdate {};
 	Int m_localPlayerIndex {};	///<used to tell particle systems which particles can be skipped due to player shroud status
 
+	UnsignedInt m_lookupCount {};
+	UnsignedInt m_createCount {};
+	UnsignedInt m_reuseCount {};
+
 private:
 	TemplateMap m_templateMap {};		///< a hash map of all particle system templates
 };
@@ -43,6 +43,7 @@ class Object;
 class Weapon;
 class PathfindCell;
 class PathfindZoneManager;
+class ZoneBlockWorkers;
 
 // How close is close enough when moving.
 
@@ -216,6 +217,7 @@ enum {MAX_WALL_PIECES = 128};
 class PathfindCellInfo
 {
 	friend class PathfindCell;
+	friend class PathfindOpenList;
 public:
 	static void allocateCellInfos(void);
 	static void releaseCellInfos(void);
@@ -228,7 +230,10 @@ protected:
 	static PathfindCellInfo *s_firstFree;							///< 
 
 
-	PathfindCellInfo *m_nextOpen {}, *m_prevOpen {};						///< for A* "open" list, shared by closed list
+	PathfindCellInfo *m_nextOpen {}, *m_prevOpen {};						///< for A* "closed" list
+
+	Int m_openIndex {};																	///< position in the open list's heap
+	UnsignedInt m_openSequence {};												///< order in which this cell was put on the open list
 
 	PathfindCellInfo *m_pathParent {};												///< "parent" cell from pathfinder
 	PathfindCell *m_cell {};															///< Cell this info belongs to currently.
@@ -253,6 +258,46 @@ protected:
 	UnsignedInt m_closed:1 {};												///< place for marking this cell as on the closed list
 };
 
+/**
+ * The A* "open" list.  This is a binary heap of cell infos ordered by total cost, with ties going
+ * to whichever cell was put on the list first.  That is exactly the order the old sorted linked
+ * list gave, so searches expand cells in the same order as before.  Each info remembers where it
+ * sits in the heap, so a cell can be taken off the list from anywhere when its cost changes.
+ * The heap's storage is kept from one search to the next.
+ */
+class PathfindOpenList
+{
+public:
+	PathfindOpenList(void) { }
+
+	inline Bool empty(void) const { return m_heap.empty(); }
+	inline Int getCount(void) const { return (Int)m_heap.size(); }
+	inline PathfindCell *getNth(Int n) const { return m_heap[(size_t)n]->m_cell; }		///< heap order, not cost order
+	inline PathfindCell *getFirst(void) const { return m_heap.empty() ? NULL : m_heap.front()->m_cell; }	///< lowest cost cell
+
+	void reset(PathfindCell *start);							///< make start, prepared with startPathfind(), the only cell on the list
+	void clear(void);
+
+	void insert(PathfindCellInfo *info);
+	void remove(PathfindCellInfo *info);
+
+private:
+	static inline Bool isBefore(const PathfindCellInfo *a, const PathfindCellInfo *b)
+	{
+		if (a->m_totalCost != b->m_totalCost)
+			return a->m_totalCost < b->m_totalCost;
+		return a->m_openSequence < b->m_openSequence;
+	}
+
+	inline PathfindCellInfo *at(Int index) const { return m_heap[(size_t)index]; }
+	inline void place(PathfindCellInfo *info, Int index) { m_heap[(size_t)index] = info; info->m_openIndex = index; }
+	void siftUp(Int index);
+	void siftDown(Int index);
+
+	std::vector<PathfindCellInfo*> m_heap {};		///< binary heap, lowest cost first
+	UnsignedInt m_nextSequence {};							///< sequence number for the next insert
+};
+
 /**
  * This represents one cell in the pathfinding grid.
  * These cells categorize the world into idealized cellular states,
@@ -261,6 +306,7 @@ protected:
  */
 class PathfindCell
 {
+	friend class PathfindOpenList;
 public:
 
 	enum CellType
@@ -313,11 +359,11 @@ public:
 
 	UnsignedInt costSoFar( PathfindCell *parent );
 
-	/// put self on "open" list in ascending cost order, return new list
-	PathfindCell *putOnSortedOpenList( PathfindCell *list );		
+	/// put self on "open" list in ascending cost order
+	void putOnSortedOpenList( PathfindOpenList &list );		
 
 	/// remove self from "open" list
-	PathfindCell *removeFromOpenList( PathfindCell *list );		
+	void removeFromOpenList( PathfindOpenList &list );		
 
 	/// put self on "closed" list, return new list
 	PathfindCell *putOnClosedList( PathfindCell *list );		
@@ -328,8 +374,8 @@ public:
 	/// remove all cells from closed list.
 	static Int releaseClosedList( PathfindCell *list );	
 
-	/// remove all cells from closed list.
-	static Int releaseOpenList( PathfindCell *list );	
+	/// remove all cells from open list.
+	static Int releaseOpenList( PathfindOpenList &list );	
 
 	inline PathfindCell *getNextOpen(void) {return m_info->m_nextOpen?m_info->m_nextOpen->m_cell:NULL;}
 
@@ -467,6 +513,7 @@ struct TCheckMovementInfo;
  */
 class ZoneBlock
 {
+	friend class PathfindZoneManager;
 public: 
 
 	ZoneBlock();
@@ -477,6 +524,11 @@ public:
 	ZoneBlock& operator=(const ZoneBlock&) = delete;
 
 	void blockCalculateZones(	PathfindCell **map, PathfindLayer layers[], const IRegion2D &bounds);	///< Does zone calculations.  
+	void blockFindZoneRange(PathfindCell **map, const IRegion2D &bounds);						///< First half of blockCalculateZones, before allocateZones().
+	void blockCalculateEquivalencies(PathfindCell **map, const IRegion2D &bounds);	///< Second half of blockCalculateZones, after allocateZones().
+#ifdef _DEBUG
+	void blockCheckZones(PathfindCell **map, const IRegion2D &bounds) const;				///< Debug checks for the second half, which may run off the logic thread and so can't assert.
+#endif
 	zoneStorageType getEffectiveZone(LocomotorSurfaceTypeMask acceptableSurfaces, Bool crusher, zoneStorageType zone) const;
 
 	void clearMarkedPassable(void) {m_markedPassable = false;}
@@ -557,10 +609,23 @@ public:
 	void setBridge(Int cellX, Int cellY, Bool bridge);
 	Bool interactsWithBridge(Int cellX, Int cellY) const; 
 
+	/// Changes whenever zone connectivity may have changed.
+	UnsignedInt getZoneGeneration(void) const {return m_zoneGeneration;}
+	/// Append the index of every passable block to blocks.
+	void getPassableBlocks(std::vector<Int> &blocks) const;
+	/// Mark the blocks from getPassableBlocks() passable.
+	void setPassableBlocks(const std::vector<Int> &blocks);
+
+	AsciiString reportBlockPasses(Int frames) const;	///< Threaded against serial block passes, for ReplayBenchmark.
+
 private:
 	void allocateZones(void);
 	void freeZones(void);
 	void freeBlocks(void);
+	/// The per block passes of calculateZones, on the worker threads or not.  Returns the threads used.
+	Int calculateBlockZones(PathfindCell **map, const IRegion2D &globalBounds, Int xCount, Int yCount, Bool threaded);
+	/// Append block (x,y)'s zone range and equivalency tables to zones.
+	void getBlockZones(Int xBlock, Int yBlock, std::vector<zoneStorageType> &zones) const;
 
 private:
 	ZoneBlock			*m_blockOfZoneBlocks {};			///< Zone blocks - Info for hierarchical pathfinding at a "blocky" level.
@@ -576,6 +641,82 @@ private:
 	zoneStorageType *m_terrainZones {};
 	zoneStorageType *m_crusherZones {};
 	zoneStorageType *m_hierarchicalZones {};
+	UnsignedInt m_zoneGeneration {};					///< Bumped when zones are recalculated or marked dirty.
+	ZoneBlockWorkers *m_workers {};						///< Threads for the per block passes, started by the first map big enough to use them.
+
+	Int m_blockPassChecks {};								///< Block passes run both ways, for -zoneBlockBenchmark.
+	Int m_blockPassBlocks {};								///< Blocks compared between the two.
+	Int m_blockPassDiffered {};							///< Of those, how many came out differently.
+	Int m_blockPassThreads {};							///< Threads the last threaded run used.
+	Int64 m_threadedBlockNanos {};
+	Int64 m_serialBlockNanos {};
+};
+
+/**
+ * Key for a hierarchical search: the start and goal cells, plus everything else that steers the
+ * search.  Within one zone generation the search from one cell to another always opens up the
+ * same blocks, so a corridor found under this key is exactly what searching again would find.
+ */
+struct PathfindCorridorKey
+{
+	LocomotorSurfaceTypeMask m_surfaces {};
+	Bool m_crusher {};
+	Bool m_isHuman {};
+	PathfindLayerEnum m_fromLayer {};
+	PathfindLayerEnum m_toLayer {};
+	ICoord2D m_fromCell {};
+	ICoord2D m_toCell {};
+
+	Bool operator==(const PathfindCorridorKey &other) const;
+};
+
+/**
+ * A small LRU cache of the zone blocks that hierarchical searches opened up for the low level
+ * search, not counting the blocks around the unit's feet.  A unit that repaths from the same cell
+ * to the same goal, as a blocked or waiting unit does, reuses the corridor instead of repeating
+ * the hierarchical search.  The whole cache is dropped whenever the zone manager's generation
+ * changes.  It only ever saves work, so it isn't saved with the game.
+ */
+class PathfindCorridorCache
+{
+public:
+	enum {MAX_CORRIDORS = 64};
+
+	PathfindCorridorCache(void) { }
+
+	void clear(void);			///< Drop all corridors.
+	void reset(void);			///< Drop all corridors and zero the counters.
+
+	/// Returns the cached blocks for key, or NULL.  Counts a hit or a miss.
+	const std::vector<Int> *find(const PathfindCorridorKey &key, UnsignedInt zoneGeneration);
+	/// Remember the corridor for key, evicting the least recently used one if full.
+	void add(const PathfindCorridorKey &key, const std::vector<Int> &blocks);
+
+	Int getHits(void) const {return m_hits;}
+	Int getMisses(void) const {return m_misses;}
+
+	void addHitNanos(Int64 nanos) {m_hitNanos += nanos;}
+	void addSearchNanos(Int64 nanos) {m_searchNanos += nanos;}
+	void addCheck(Bool same) {m_checked++; if (!same) m_differed++;}
+	AsciiString report(Int frames) const;	///< For ReplayBenchmark.
+
+private:
+	struct Corridor
+	{
+		PathfindCorridorKey m_key {};
+		std::vector<Int> m_blocks {};
+		UnsignedInt m_lastUsed {};
+	};
+
+	std::vector<Corridor> m_corridors {};
+	UnsignedInt m_zoneGeneration {};					///< Zone generation the cached corridors belong to.
+	UnsignedInt m_useCount {};
+	Int m_hits {};
+	Int m_misses {};
+	Int64 m_hitNanos {};							///< Time spent reopening cached corridors.
+	Int64 m_searchNanos {};						///< Time spent in the hierarchical searches that were cached.
+	Int m_checked {};									///< Hits searched again anyway, for -corridorCacheBenchmark.
+	Int m_differed {};								///< Of those, how many found a different corridor.
 };
 
 /** 
@@ -661,6 +802,9 @@ public:
 
 	Bool queueForPath(ObjectID id);	 ///< The object wants to request a pathfind, so put it on the list to process.
 	void processPathfindQueue(void); ///< Process some or all of the queued pathfinds.
+	AsciiString reportCorridorCache(Int frames) const {return m_corridorCache.report(frames);}	///< Hierarchical searches skipped and done, for ReplayBenchmark.
+	void resetCorridorCache(void) {m_corridorCache.reset();}
+	AsciiString reportZoneBlockPasses(Int frames) const {return m_zoneManager.reportBlockPasses(frames);}	///< Threaded against serial zone block passes, for ReplayBenchmark.
 	void forceMapRecalculation( );	///< Force pathfind map recomputation. If region is given, only that area is recomputed
 
 	/** Returns an aircraft path to the goal.  */
@@ -847,7 +991,11 @@ protected:
 		const Coord3D *fromPos, PathfindCell *goalCell, Bool center, Bool blocked );	///< Work backwards from goal cell to construct final path
 	Path *buildGroundPath( Bool isCrusher,const Coord3D *fromPos, PathfindCell *goalCell, 
 		Bool center, Int pathDiameter );	///< Work backwards from goal cell to construct final path
-	Path *buildHierachicalPath( const Coord3D *fromPos, PathfindCell *goalCell);	///< Work backwards from goal cell to construct final path
+	Path *buildHierachicalPath( const Coord3D *fromPos, PathfindCell *goalCell,
+		std::vector<Int> *corridor = NULL);	///< Work backwards from goal cell to construct final path, optionally returning the blocks it opened before the ones at fromPos
+	void getCorridorKey( PathfindCorridorKey &key, Bool isHuman, LocomotorSurfaceTypeMask surfaces, Bool crusher,
+		PathfindCell *fromCell, PathfindCell *goalCell );
+	void setPassableAroundPos( const Coord3D *pos );	///< Open up the blocks near a starting position, as buildHierachicalPath does.
 
 	void  prependCells( Path *path, const Coord3D *fromPos, 
 																	PathfindCell *goalCell, Bool center ); ///< Add pathfind cells to a path.
@@ -868,7 +1016,7 @@ private:
 	IRegion2D m_extent {};														///< Grid extent limits
 	IRegion2D m_logicalExtent {};										///< Logical grid extent limits
 
-	PathfindCell *m_openList {};											///< Cells ready to be explored
+	PathfindOpenList m_openList {};										///< Cells ready to be explored
 	PathfindCell *m_closedList {};										///< Cells already explored
 
 	Bool m_isMapReady {};														///< True if all cells of map have been classified
@@ -882,6 +1030,7 @@ private:
 	ObjectID m_ignoreObstacleID {};									///< Ignore the given obstacle
 
 	PathfindZoneManager m_zoneManager {};						///< Handles the pathfind zones.
+	PathfindCorridorCache m_corridorCache {};			///< Recent hierarchical search results.
 
 	PathfindLayer m_layers[LAYER_LAST+1];
 
@@ -146,6 +146,8 @@ public:
 	Bool isInGameLogicUpdate( void ) const { return m_isInUpdate; }
 	UnsignedInt getFrame( void );										///< Returns the current simulation frame number
 	UnsignedInt getCRC( Int mode = CRC_CACHED, AsciiString deepCRCFileName = AsciiString::TheEmptyString );		///< Returns the CRC
+	static AsciiString reportIncrementalCRC( Int frames );	///< for ReplayBenchmark, when run with -incrementalCRC
+	static void resetIncrementalCRC( void );
 
 #if 0
 	void setObjectIDCounter( ObjectID nextObjID ) { m_nextObjID = nextObjID; }
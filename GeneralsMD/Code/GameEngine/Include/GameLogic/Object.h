@@ -92,12 +92,14 @@ class SpecialPowerCompletionDie;
 class SpecialPowerModuleInterface;
 class SpecialPowerTemplate;
 class SpecialPowerUpdateInterface;
+class SlavedUpdateInterface;
 class Team;
 class UpdateModule;
 class UpdateModuleInterface;
 class UpgradeModule;
 class UpgradeModuleInterface;
 class UpgradeTemplate;
+class XferCRC;
 
 class ObjectHeldHelper;
 class ObjectDisabledHelper;
@@ -109,7 +111,10 @@ class TempWeaponBonusHelper;
 class ObjectWeaponStatusHelper;
 class ObjectDefectionHelper;
 
+struct ModuleInterfaceLayout;
+
 enum CommandSourceType: int;
+enum ObjectInterfaceType: int;
 enum HackerAttackMode: int;
 enum NameKeyType: int;
 enum SpecialPowerType: int;
@@ -304,6 +309,12 @@ public:
 	StealthUpdate*          getStealth() const { return m_stealth; }
 	SpawnBehaviorInterface* getSpawnBehaviorInterface() const;
 	ProjectileUpdateInterface* getProjectileUpdateInterface() const;
+	SlavedUpdateInterface* getSlavedUpdateInterface() const;
+
+	/// How many interface lookups went through the template's module layout, and how many had to
+	/// search the modules, since the last reset, and how long each way takes (for ReplayBenchmark).
+	static AsciiString reportModuleInterfaceLookups( Int frames );
+	static void resetModuleInterfaceLookups( void );
 
 
 	// special case for the AIUpdateInterface, since it will be referred to a great deal
@@ -446,6 +457,10 @@ public:
 	PartitionData *friend_getPartitionData() const { return m_partitionData; }
 	const PartitionData *friend_getConstPartitionData() const { return m_partitionData; }
 
+	/// something crc() looks at has changed, so the cached CRC words must be rebuilt
+	void markCRCDirty() const { m_crcDirty = TRUE; }
+	void friend_xferIncrementalCRC( XferCRC *xferCRC );	///< for use ONLY by GameLogic::getCRC
+
 	void onPartitionCellChange();///< We have moved a 'significant' amount, so do maintenence that can be considered 'cell-based'
 	void handlePartitionCellMaintenance();					///< Undo and redo all shroud actions.  Call when something has changed, like position or ownership or Death
 
@@ -478,6 +493,10 @@ public:
 	Int getTransportSlotCount() const;
 	void friend_setContainedBy( Object *containedBy ) { m_containedBy = containedBy; }
 
+	// for use ONLY by Team, to keep its ObjectCensus straight
+	UnsignedByte friend_getCensusState() const { return m_censusState; }
+	void friend_setCensusState( UnsignedByte state ) { m_censusState = state; }
+
 	// Special Powers -------------------------------------------------------------------------------
 	SpecialPowerModuleInterface *getSpecialPowerModule( const SpecialPowerTemplate *specialPowerTemplate ) const;
 	void doSpecialPower( const SpecialPowerTemplate *specialPowerTemplate, UnsignedInt commandOptions, Bool forced = false );	///< execute power
@@ -580,8 +599,8 @@ public:
 	void clearWeaponSetFlag(WeaponSetType wst);
 	inline Bool testWeaponSetFlag(WeaponSetType wst) const { return m_curWeaponSetFlags.test(wst); }
 	inline const WeaponSetFlags& getWeaponSetFlags() const { return m_curWeaponSetFlags; }
-	Bool setWeaponLock( WeaponSlotType weaponSlot, WeaponLockType lockType ){ return m_weaponSet.setWeaponLock( weaponSlot, lockType ); }
-	void releaseWeaponLock(WeaponLockType lockType){ m_weaponSet.releaseWeaponLock(lockType); }
+	Bool setWeaponLock( WeaponSlotType weaponSlot, WeaponLockType lockType ){ markCRCDirty(); return m_weaponSet.setWeaponLock( weaponSlot, lockType ); }
+	void releaseWeaponLock(WeaponLockType lockType){ markCRCDirty(); m_weaponSet.releaseWeaponLock(lockType); }
 	Bool isCurWeaponLocked() const { return m_weaponSet.isCurWeaponLocked(); }
 
 	void setArmorSetFlag(ArmorSetType ast);
@@ -700,6 +719,11 @@ protected:
 	// It will go away someday. Yeah, right. Just like GlobalData.
 	Module* findModule(NameKeyType key) const;
 
+	/// The first module with the interface, from the template's layout.  Only call when m_moduleInterfaceLayout is set.
+	BehaviorModule* findModuleWithInterface( ObjectInterfaceType type ) const;
+	void computeModuleInterfaceLayout( void );
+	UnsignedInt64 timeModuleInterfaceLookups( Int64& nanos );	///< for reportModuleInterfaceLookups
+
 	Bool didEnterOrExit() const;
 
 	void setID( ObjectID id );
@@ -785,6 +809,7 @@ private:
 
 	// modules
 	BehaviorModule**					m_behaviors {};	// BehaviorModule, not BehaviorModuleInterface
+	const ModuleInterfaceLayout*		m_moduleInterfaceLayout {};	///< our template's, once m_behaviors is built; NULL means search m_behaviors
 
 	// cache these, for convenience
 	ContainModuleInterface*				m_contain {};
@@ -853,10 +878,14 @@ private:
 #endif
 	UnsignedByte								m_scriptStatus {};					///< status as set by scripting, corresponds to ORed ObjectScriptStatusBits
 	UnsignedByte								m_privateStatus {};					///< status bits that are never directly accessible to outside world
+	UnsignedByte								m_censusState {};					///< the ObjectCensus bucket our team last counted us in
 	Byte										m_numTriggerAreasActive {};
 	Bool										m_singleUseCommandUsed {FALSE};
 	Bool										m_isReceivingDifficultyBonus {FALSE};
 
+	std::vector<UnsignedInt>					m_crcWords {};					///< the words crc() folded last time we were dirty
+	mutable Bool								m_crcDirty {TRUE};					///< m_crcWords is out of date
+
 };  // end class Object
 
 #ifdef DEBUG_LOGGING
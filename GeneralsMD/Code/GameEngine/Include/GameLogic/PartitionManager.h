@@ -60,6 +60,8 @@
 #include "Common/Geometry.h"
 #include "GameClient/Display.h"	// for ShroudLevel
 
+#include <span>
+
 //-----------------------------------------------------------------------------
 //           defines                                                      
 //-----------------------------------------------------------------------------
@@ -401,6 +403,7 @@ private:
 	Int								m_coiInUseCount {};							///< number of COIs that are actually in use
 	CellAndObjectIntersection		*m_coiArray {};								///< The array of COIs 
 	Int								m_doneFlag {};
+	Int								m_positionSlot {};							///< our slot in the PartitionManager's PartitionPositionCache
 	DirtyStatus						m_dirtyStatus {};
 	ObjectShroudStatus				m_shroudedness[MAX_PLAYER_COUNT];						
 	ObjectShroudStatus				m_shroudednessPrevious[MAX_PLAYER_COUNT];	///<previous frames value of m_shroudedness						
@@ -563,6 +566,9 @@ public:
 	Int friend_getDoneFlag() { return m_doneFlag; }
 	void friend_setDoneFlag(Int i) { m_doneFlag = i; }
 
+	Int friend_getPositionSlot() const { return m_positionSlot; }
+	void friend_refreshPositionCache();	///< copy our Object's position and size into the PartitionPositionCache
+
 	inline Bool isInListDirtyModules(PartitionData* const* pListHead) const
 	{
 		Bool result = (*pListHead == this || m_prevDirty || m_nextDirty);
@@ -1326,6 +1332,101 @@ protected:
 #endif
 };
 
+//=====================================
+/**
+	A packed copy of the 2D position and bounding radius of every PartitionData's
+	Object, kept one array per field, so that range queries can throw out most of
+	the candidates in a cell several at a time without touching the Objects at all.
+
+	This is only ever used to reject things that are out of range; whatever gets past
+	it still goes through the real distance calculation. The slots are refreshed on
+	every transform and geometry change of their Object, and the reject limit is padded,
+	so while a slot is current it only throws out what the real calculation would too.
+	A slot that missed a refresh could reject something that is in range, so anything
+	that moves an Object has to go through reactToTransformChange. New slots start out
+	with a huge radius, which never rejects anything, until the first refresh, and a
+	PartitionData with no slot (-1) is never rejected either.
+*/
+class PartitionPositionCache
+{
+public:
+	PartitionPositionCache();
+
+	Int allocSlot();
+	void freeSlot(Int slot);
+	void setSlot(Int slot, Real x, Real y, Real radius);
+
+	/**
+		for each of the 'count' slots given, set maybe[i] to nonzero iff the object in that
+		slot could be within 'reach' of (x, y), counting its own radius only if useRadius.
+	*/
+	void findMaybeInRange(const Int *slots, Int count, Real x, Real y, Real reach, Bool useRadius, UnsignedByte *maybe) const;
+
+private:
+	std::vector<Real>		m_x {};
+	std::vector<Real>		m_y {};
+	std::vector<Real>		m_radius {};
+	std::vector<Int>		m_freeSlots {};
+};
+
+//=====================================
+/**
+	One object found by PartitionManager::queryObjectsInRange.
+*/
+struct PartitionQueryHit
+{
+	Object				*m_object;			///< the object found
+	Real					m_distSqr;			///< its distance (squared) from the query point
+};
+
+typedef std::span<const PartitionQueryHit> PartitionQueryResult;
+
+//=====================================
+/**
+	Caller-owned working space for PartitionManager::queryObjectsInRange.
+
+	getClosestObjects marks every PartitionData it visits with a single shared
+	done flag, so only one query can be running at a time. A query made through
+	a scratch remembers the PartitionDatas it has seen in the scratch instead, so
+	queries may nest (eg, from inside a PartitionFilter) or run on other threads,
+	as long as each one has a scratch of its own. The buffers keep their capacity,
+	so a reused scratch stops allocating once it has grown to fit.
+
+	The result of a query lives in the scratch, and is only good until the scratch
+	is used again.
+*/
+class PartitionQueryScratch
+{
+public:
+	PartitionQueryScratch();
+
+	// No copies allowed!
+	PartitionQueryScratch(const PartitionQueryScratch&) = delete;
+	PartitionQueryScratch& operator=(const PartitionQueryScratch&) = delete;
+
+	PartitionQueryResult getResult() const { return PartitionQueryResult(m_hits.data(), m_hits.size()); }
+
+private:
+	friend class PartitionManager;
+
+	struct SeenSlot
+	{
+		const PartitionData	*m_data;
+		UnsignedInt					m_stamp;			///< slot is only in use if this matches PartitionQueryScratch::m_stamp
+	};
+
+	void begin();
+	Bool markSeen(const PartitionData *data);	///< return true iff data had not been seen yet in this query
+	void growSeen();
+	void sort(IterOrderType order);
+
+	std::vector<PartitionQueryHit>	m_hits {};
+	std::vector<PartitionQueryHit>	m_sortTemp {};
+	std::vector<SeenSlot>						m_seen {};			///< open-addressed set, always a power of two in size
+	UnsignedInt											m_stamp {};
+	UnsignedInt											m_seenCount {};
+};
+
 //=====================================
 /** 
 	PartitionManager is the singleton class that manages the entire partition/collision
@@ -1361,6 +1462,10 @@ private:
 	RadiusVec				m_radiusVec {};
 #endif
 
+	PartitionPositionCache					m_positionCache {};
+	std::vector<PartitionQueryScratch *>	m_allQueryScratch {};		///< every scratch the pool has made
+	std::vector<PartitionQueryScratch *>	m_freeQueryScratch {};		///< the ones not currently borrowed
+
 protected:
 
 	/**
@@ -1378,6 +1483,28 @@ protected:
 		Coord3D *closestVecArg
 	);
 
+	/// the reentrant counterpart of getClosestObjects(..., iter, ...), used by queryObjectsInRange.
+	void queryObjects(
+		PartitionQueryScratch& scratch,
+		const Object *obj, 
+		const Coord3D *pos, 
+		Real maxDist, 
+		DistanceCalculationType dc, 
+		PartitionFilter **filters, 
+		IterOrderType order
+	);
+
+	/// queryObjects, timed and checked against the iterateObjectsInRange path, for -partitionQueryBenchmark.
+	void benchmarkQueryObjects(
+		PartitionQueryScratch& scratch,
+		const Object *obj, 
+		const Coord3D *pos, 
+		Real maxDist, 
+		DistanceCalculationType dc, 
+		PartitionFilter **filters, 
+		IterOrderType order
+	);
+
 	void shutdown( void );
 
 	/// used to validate the positions for findPositionAround family of methods
@@ -1533,6 +1660,38 @@ public:
 		IterOrderType order = ITER_FASTEST
 	);
 
+	/**
+		Like iterateObjectsInRange, but reentrant and allocation-free: the objects found
+		(in the same order iterateObjectsInRange would give them) are written into the
+		given scratch, and returned as a span into it.
+	*/
+	PartitionQueryResult queryObjectsInRange(
+		PartitionQueryScratch& scratch,
+		const Object *obj, 
+		Real maxDist, 
+		DistanceCalculationType dc, 
+		PartitionFilter **filters = NULL, 
+		IterOrderType order = ITER_FASTEST
+	);
+
+	PartitionQueryResult queryObjectsInRange(
+		PartitionQueryScratch& scratch,
+		const Coord3D *pos, 
+		Real maxDist, 
+		DistanceCalculationType dc, 
+		PartitionFilter **filters = NULL, 
+		IterOrderType order = ITER_FASTEST
+	);
+
+	PartitionPositionCache& friend_getPositionCache() { return m_positionCache; }	///< only for use by PartitionData
+
+	/// borrow a scratch for queryObjectsInRange from the logic thread's pool; see PartitionQueryScratchHolder
+	PartitionQueryScratch *allocQueryScratch();
+	void releaseQueryScratch(PartitionQueryScratch *scratch);
+
+	static AsciiString reportQueryBenchmark( Int frames );	///< for ReplayBenchmark, when run with -partitionQueryBenchmark
+	static void resetQueryBenchmark( void );
+
 	SimpleObjectIterator *iterateAllObjects(PartitionFilter **filters = NULL);		
 
 	/**
@@ -1696,6 +1855,27 @@ public:
 };
 #endif
 
+//-----------------------------------------------------------------------------
+/**
+	Borrows a PartitionQueryScratch from ThePartitionManager for as long as it is in
+	scope. Code that can end up running itself again (weapon damage that kills
+	something with a death weapon, say) gets a different scratch each time in.
+*/
+class PartitionQueryScratchHolder
+{
+private:
+	PartitionQueryScratch *m_scratch;
+public:
+	PartitionQueryScratchHolder();
+	~PartitionQueryScratchHolder();
+
+	// No copies allowed!
+	PartitionQueryScratchHolder(const PartitionQueryScratchHolder&) = delete;
+	PartitionQueryScratchHolder& operator=(const PartitionQueryScratchHolder&) = delete;
+
+	PartitionQueryScratch& get() { return *m_scratch; }
+};
+
 //-----------------------------------------------------------------------------
 //           Inlining                                                       
 //-----------------------------------------------------------------------------
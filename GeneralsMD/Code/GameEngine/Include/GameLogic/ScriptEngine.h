@@ -40,6 +40,9 @@
 #include "Common/SubsystemInterface.h"
 #include "GameLogic/Scripts.h"
 
+#include <unordered_map>
+#include <unordered_set>
+
 class DataChunkInput;
 struct DataChunkInfo;
 class DataChunkOutput;
@@ -95,6 +98,17 @@ struct TFlag
 	AsciiString name {};
 };
 
+/// What tracking the state conditions read saved over a map; reported when the map is reset.
+struct ScriptEvaluationStats
+{
+	UnsignedInt frames {};
+	Int64 updateNanos {};								///< time spent in ScriptEngine::update
+	UnsignedInt64 clausesEvaluated {};
+	UnsignedInt64 clausesSkipped {};					///< clauses none of whose inputs had changed
+	UnsignedInt64 conditionsEvaluated {};
+	UnsignedInt64 conditionsAvoided {};				///< conditions the skipped clauses needed last time
+};
+
 typedef std::list<AsciiString> ListAsciiString;
 typedef std::list<AsciiString>::iterator ListAsciiStringIt;
 
@@ -363,6 +377,8 @@ public:
 	//Kris: Moved to public... so that I can refresh it when building abilities in script dialogs.
 	void createNamedCache( void );
 
+	void reportNamedObjectBenchmark( Int units );	///< time named unit lookups both ways (-scriptNameBenchmark)
+
 	///Begin VTUNE
 	void setEnableVTune(Bool value);
 	Bool getEnableVTune() const;
@@ -387,6 +403,13 @@ protected:
 
 	Int allocateCounter( const AsciiString& name);
 	Int allocateFlag( const AsciiString& name);
+	Int findCounter( const AsciiString& name ) const;	///< 0 if there is no such counter
+	Int findFlag( const AsciiString& name ) const;		///< 0 if there is no such flag
+	void indexCountersAndFlags( void );					///< rebuilds m_counterIndex and m_flagIndex
+	Int findNamedObject( const AsciiString& name ) const;	///< index into m_namedObjects, or -1
+	void addNamedObject( const AsciiString& name, Object *obj );
+	void clearNamedObjects( void );
+	void clearUIInteractions( void );
 	void executeScripts( Script *pScriptHead );
 	void executeScript( Script *pScript );
 	Script *findScript(const AsciiString& name);
@@ -423,6 +446,13 @@ protected:
 
 	AttackPriorityInfo *findAttackInfo(const AsciiString& name, Bool addIfNotFound);
 
+	// Tracking what conditions read, so clauses are only evaluated when something they read changes.
+	void notifyOfScriptStateChange(ScriptStateType which) { m_scriptStateChanged[which] = ++m_scriptStateSerial; }
+	void invalidateScriptState( void );		///< everything may have changed, e.g. on a new map or a load
+	Bool getConditionStateRead( Condition *pCondition, UnsignedInt *stateRead );
+	Bool isClauseCurrent( const OrCondition *pClause ) const;
+	void reportEvaluationStats( void );
+
 protected:
 	/// Stuff to execute scripts sequentially
 	typedef std::vector<SequentialScript*> VecSequentialScriptPtr;
@@ -442,10 +472,16 @@ protected:
 protected:
 	ActionTemplate		m_actionTemplates[ScriptAction::NUM_ITEMS];
 	ConditionTemplate	m_conditionTemplates[Condition::NUM_ITEMS];
+	typedef std::unordered_map< NameKeyType, Int, rts::hash<NameKeyType>, rts::equal_to<NameKeyType> > NameKeyIndexMap;
+	typedef std::unordered_map< const Object *, Int > ObjectIndexMap;
+	typedef std::unordered_set< NameKeyType, rts::hash<NameKeyType>, rts::equal_to<NameKeyType> > NameKeySet;
+
 	TCounter			m_counters[MAX_COUNTERS];
 	Int					m_numCounters {};
+	NameKeyIndexMap		m_counterIndex {};				///< counter name -> index into m_counters
 	TFlag				m_flags[MAX_FLAGS];
 	Int					m_numFlags {};
+	NameKeyIndexMap		m_flagIndex {};					///< flag name -> index into m_flags
 	AttackPriorityInfo	m_attackPriorityInfo[MAX_ATTACK_PRIORITIES];
 	Int					m_numAttackInfo {};
 	Int					m_endGameTimer {};
@@ -454,7 +490,9 @@ protected:
 	Object				*m_callingObject {};					///< Object that is calling script, used for THIS_OBJECT
 	Team				*m_conditionTeam {};				///< Team that is being used to evaluate conditions, used for THIS_TEAM
 	Object				*m_conditionObject {};				///< Unit that is being used to evaluate conditions, used for THIS_OBJECT
-	VecNamedRequests	m_namedObjects {};
+	VecNamedRequests	m_namedObjects {};				///< in the order the names were first seen, which is the order they are saved in
+	NameKeyIndexMap		m_namedObjectIndex {};			///< name -> first entry in m_namedObjects with that name
+	ObjectIndexMap		m_namedObjectEntries {};		///< live object -> its entry in m_namedObjects
 	Bool				m_firstUpdate {TRUE};
 	Player				*m_currentPlayer {};
 	Player				*m_skirmishHumanPlayer {};
@@ -471,6 +509,10 @@ protected:
 
 	UnsignedInt			m_frameObjectCountChanged {};
 
+	UnsignedInt			m_scriptStateSerial {};
+	UnsignedInt			m_scriptStateChanged[SCRIPT_STATE_COUNT] {};	///< serial of the last change to each ScriptStateType
+	ScriptEvaluationStats	m_evaluationStats {};
+
 	ObjectTypeCount		m_objectCounts[MAX_PLAYER_COUNT];
 
 	/// These are three separate lists rather than one to increase speed efficiency
@@ -479,6 +521,7 @@ protected:
 	ListAsciiStringUINT		m_testingAudio {};
 
 	ListAsciiString			m_uiInteractions {};
+	NameKeySet				m_uiInteractionKeys {};		///< the names in m_uiInteractions
 	
 	ListAsciiStringObjectID	m_triggeredSpecialPowers[MAX_PLAYER_COUNT];
 	ListAsciiStringObjectID	m_midwaySpecialPowers	[MAX_PLAYER_COUNT];
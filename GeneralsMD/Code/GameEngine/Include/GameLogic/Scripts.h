@@ -72,6 +72,7 @@
 #define OUTER_PERIMETER "OuterPerimeter"
 
 class Parameter;
+class Player;
 class Script;
 class OrCondition;
 class Condition;
@@ -166,6 +167,15 @@ class OrCondition : public MemoryPoolObject
 protected:
 	OrCondition *m_nextOr;   // Next or clause.
 	Condition *m_firstAnd;	 // These are Anded.
+
+	// The last value of this clause, kept by ScriptEngine::evaluateConditions while every condition
+	// it evaluated declared what it reads.
+	Bool m_hasCachedValue {};
+	Bool m_cachedValue {};
+	UnsignedInt m_cachedStateRead {};				///< SCRIPT_STATE_BITs read to get the value
+	UnsignedInt m_cachedStateSerial {};			///< ScriptEngine state serial when it was evaluated
+	Int m_cachedConditionCount {};					///< conditions evaluated to get the value
+	const Player *m_cachedPlayer {};				///< the current player it was evaluated for
 	
 public:
 	OrCondition():m_nextOr(NULL),m_firstAnd(NULL){};
@@ -182,11 +192,28 @@ public:
 
 public:
 	void setNextOrCondition(OrCondition *pOr) {m_nextOr = pOr;}
-	void setFirstAndCondition(Condition *pAnd) {m_firstAnd = pAnd;}
+	void setFirstAndCondition(Condition *pAnd) {m_firstAnd = pAnd; m_hasCachedValue = false;}
 
 	OrCondition *getNextOrCondition(void) {return m_nextOr;}
 	Condition *getFirstAndCondition(void) {return m_firstAnd;}
 
+	void setCachedValue(Bool value, UnsignedInt stateRead, UnsignedInt stateSerial, Int conditionCount, const Player *player)
+	{
+		m_hasCachedValue = true;
+		m_cachedValue = value;
+		m_cachedStateRead = stateRead;
+		m_cachedStateSerial = stateSerial;
+		m_cachedConditionCount = conditionCount;
+		m_cachedPlayer = player;
+	}
+	void clearCachedValue(void) {m_hasCachedValue = false;}
+	Bool hasCachedValue(void) const {return m_hasCachedValue;}
+	Bool getCachedValue(void) const {return m_cachedValue;}
+	UnsignedInt getCachedStateRead(void) const {return m_cachedStateRead;}
+	UnsignedInt getCachedStateSerial(void) const {return m_cachedStateSerial;}
+	Int getCachedConditionCount(void) const {return m_cachedConditionCount;}
+	const Player *getCachedPlayer(void) const {return m_cachedPlayer;}
+
 	Condition *removeCondition(Condition *pCond);
 	void deleteCondition(Condition *pCond);
 	static void WriteOrConditionDataChunk(DataChunkOutput &chunkWriter, OrCondition *pCondition);
@@ -1052,6 +1079,27 @@ public:
 
 #define dontCOUNT_SCRIPT_USAGE
 
+//-------------------------------------------------------------------------------------------------
+/** Script engine state a condition can declare that it reads (ConditionTemplate::m_stateRead).
+The engine stamps each kind of state when it changes, so a clause of conditions that only read
+declared state isn't evaluated again until one of them has changed. */
+enum ScriptStateType
+{
+	SCRIPT_STATE_FLAGS,
+	SCRIPT_STATE_UI_INTERACTIONS,		///< flags forced true for a frame by the UI
+	SCRIPT_STATE_COUNTERS,					///< counters set by actions, and timers started, stopped or adjusted
+	SCRIPT_STATE_TIMER_TICKS,				///< running timers counting down, every frame
+	SCRIPT_STATE_TIMERS_EXPIRED,		///< a running timer counting down to zero
+	SCRIPT_STATE_VIDEOS,
+	SCRIPT_STATE_SPECIAL_POWERS,
+	SCRIPT_STATE_UPGRADES,
+	SCRIPT_STATE_SCIENCES,
+
+	SCRIPT_STATE_COUNT
+};
+
+#define SCRIPT_STATE_BIT(x) (1u << (x))
+
 //-------------------------------------------------------------------------------------------------
 // ******************************** class Template ***********************************************
 //-------------------------------------------------------------------------------------------------
@@ -1100,7 +1148,12 @@ EMPTY_DTOR(Template)
 // ******************************** class ConditionTemplate ***********************************************
 //-------------------------------------------------------------------------------------------------
 /// Template for condition.
-class ConditionTemplate : public Template{};
+class ConditionTemplate : public Template
+{
+public:
+	Bool				m_stateDeclared {};			///< FALSE means it reads something we can't track, so it is always evaluated
+	UnsignedInt m_stateRead {};					///< SCRIPT_STATE_BITs, when m_stateDeclared
+};
 
 //-------------------------------------------------------------------------------------------------
 // ******************************** class ActionTemplate ***********************************************
@@ -63,10 +63,10 @@
 
 // #include "GameClient/ControlBar.h"
 // #include "GameClient/Drawable.h"
-// #include "GameClient/View.h"
+#include "GameClient/View.h"
 
 #include "GameLogic/GameLogic.h"
-// #include "GameLogic/TerrainLogic.h"
+#include "GameLogic/TerrainLogic.h"
 
 #include "WWMath/matrix3d.h"
 
@@ -312,87 +312,90 @@ void AudioManager::reset()
 //-------------------------------------------------------------------------------------------------
 void AudioManager::update()
 {
-	// FIXME: Uncomment once TheTacticalView is implemented.
-	// Coord3D groundPos, microphonePos;
-	// TheTacticalView->getPosition( &groundPos );
-	// Real angle = TheTacticalView->getAngle();
-	// Matrix3D rot = Matrix3D::Identity;
-	// rot.Rotate_Z( angle );
-	// Vector3 forward( 0, 1, 0 );
-	// rot.mulVector3( forward );
-
-	// Real desiredHeight = TheAudio->getAudioSettings()->m_microphoneDesiredHeightAboveTerrain;
-	// Real maxPercentage = TheAudio->getAudioSettings()->m_microphoneMaxPercentageBetweenGroundAndCamera;
-
-	// Coord3D lookTo;
-	// lookTo.set(forward.X, forward.Y, forward.Z);
-
-	// //Kris: At this point, the microphone is calculated to be at the ground position where the camera is looking at.
-	// //Instead we want to move the microphone towards the camera. Hopefully, it'll be a desired altitude, but if it
-	// //gets too close to the camera (or even past it), that would be undesirable. Therefore, we have a backup method
-	// //of making sure we only go a certain percentage towards the camera or the desired height, whichever occurs first.
-	// Coord3D cameraPos = TheTacticalView->get3DCameraPosition();
-	// Coord3D groundToCameraVector;
-	// groundToCameraVector.set( &cameraPos );
-	// groundToCameraVector.sub( &groundPos );
-	// Real bestScaleFactor;
-
-	// if( cameraPos.z <= desiredHeight || groundToCameraVector.z <= 0.0f )
-	// {
-	// 	//Use the percentage calculation!
-	// 	bestScaleFactor = maxPercentage;
-	// }
-	// else
-	// {
-	// 	//Calculate the stopping position of the groundToCameraVector when we force z to be m_microphoneDesiredHeightAboveTerrain
-	// 	Real zScale = desiredHeight / groundToCameraVector.z;
+	// the view isn't created for headless runs, and there is nothing to listen to before a map loads
+	if (TheTacticalView == NULL || TheTerrainLogic == NULL)
+		return;
 
-	// 	//Use the smallest of the two scale calculations
-	// 	bestScaleFactor = MIN( maxPercentage, zScale );
-	// }
+	Coord3D groundPos, microphonePos;
+	TheTacticalView->getPosition( &groundPos );
+	Real angle = TheTacticalView->getAngle();
+	Matrix3D rot = Matrix3D::Identity;
+	rot.Rotate_Z( angle );
+	Vector3 forward( 0, 1, 0 );
+	rot.mulVector3( forward );
+
+	Real desiredHeight = TheAudio->getAudioSettings()->m_microphoneDesiredHeightAboveTerrain;
+	Real maxPercentage = TheAudio->getAudioSettings()->m_microphoneMaxPercentageBetweenGroundAndCamera;
+
+	Coord3D lookTo;
+	lookTo.set(forward.X, forward.Y, forward.Z);
+
+	//Kris: At this point, the microphone is calculated to be at the ground position where the camera is looking at.
+	//Instead we want to move the microphone towards the camera. Hopefully, it'll be a desired altitude, but if it
+	//gets too close to the camera (or even past it), that would be undesirable. Therefore, we have a backup method
+	//of making sure we only go a certain percentage towards the camera or the desired height, whichever occurs first.
+	Coord3D cameraPos = TheTacticalView->get3DCameraPosition();
+	Coord3D groundToCameraVector;
+	groundToCameraVector.set( &cameraPos );
+	groundToCameraVector.sub( &groundPos );
+	Real bestScaleFactor;
+
+	if( cameraPos.z <= desiredHeight || groundToCameraVector.z <= 0.0f )
+	{
+		//Use the percentage calculation!
+		bestScaleFactor = maxPercentage;
+	}
+	else
+	{
+		//Calculate the stopping position of the groundToCameraVector when we force z to be m_microphoneDesiredHeightAboveTerrain
+		Real zScale = desiredHeight / groundToCameraVector.z;
 
-	// //Now apply the best scalar to the ground-to-camera vector.
-	// groundToCameraVector.scale( bestScaleFactor );
+		//Use the smallest of the two scale calculations
+		bestScaleFactor = MIN( maxPercentage, zScale );
+	}
 
-	// //Set the microphone to be the ground position adjusted for terrain plus the vector we just calculated.
-	// groundPos.z = TheTerrainLogic->getGroundHeight( groundPos.x, groundPos.y );
-	// microphonePos.set( &groundPos );
-	// microphonePos.add( &groundToCameraVector );
+	//Now apply the best scalar to the ground-to-camera vector.
+	groundToCameraVector.scale( bestScaleFactor );
 
-	// //Viola! A properly placed microphone.
-	// setListenerPosition( &microphonePos, &lookTo );
+	//Set the microphone to be the ground position adjusted for terrain plus the vector we just calculated.
+	groundPos.z = TheTerrainLogic->getGroundHeight( groundPos.x, groundPos.y );
+	microphonePos.set( &groundPos );
+	microphonePos.add( &groundToCameraVector );
 
+	//Viola! A properly placed microphone.
+	setListenerPosition( &microphonePos, &lookTo );
 
-	// //Now determine if we would like to boost the volume based on the camera being close to the microphone!
-	// Real maxBoostScalar = TheAudio->getAudioSettings()->m_zoomSoundVolumePercentageAmount;
-	// Real minDist = TheAudio->getAudioSettings()->m_zoomMinDistance;
-	// Real maxDist = TheAudio->getAudioSettings()->m_zoomMaxDistance;
 
-	// //We can't boost a sound above 100%, instead reduce the normal sound level.
-	// m_zoomVolume = 1.0f - maxBoostScalar;
+	//Now determine if we would like to boost the volume based on the camera being close to the microphone!
+	Real maxBoostScalar = TheAudio->getAudioSettings()->m_zoomSoundVolumePercentageAmount;
+	Real minDist = TheAudio->getAudioSettings()->m_zoomMinDistance;
+	Real maxDist = TheAudio->getAudioSettings()->m_zoomMaxDistance;
 
-	// //Are we even using a boost?
-	// if( maxBoostScalar > 0.0f )
-	// {
-	// 	//How far away is the camera from the microphone?
-	// 	Coord3D vector = cameraPos;
-	// 	vector.sub( &microphonePos );
-	// 	Real dist = vector.length();
-
-	// 	if( dist < minDist )
-	// 	{
-	// 		//Max volume!
-	// 		m_zoomVolume = 1.0f;
-	// 	}
-	// 	else if( dist < maxDist )
-	// 	{
-	// 		//Determine what the boost amount will be. 
-	// 		Real scalar = (dist - minDist) / (maxDist - minDist);
-	// 		m_zoomVolume = 1.0f - scalar * maxBoostScalar;
-	// 	}
-	// }
+	//We can't boost a sound above 100%, instead reduce the normal sound level.
+	m_zoomVolume = 1.0f - maxBoostScalar;
+
+	//Are we even using a boost?
+	if( maxBoostScalar > 0.0f )
+	{
+		//How far away is the camera from the microphone?
+		Coord3D vector = cameraPos;
+		vector.sub( &microphonePos );
+		Real dist = vector.length();
+
+		if( dist < minDist )
+		{
+			//Max volume!
+			m_zoomVolume = 1.0f;
+		}
+		else if( dist < maxDist )
+		{
+			//Determine what the boost amount will be. 
+			Real scalar = (dist - minDist) / (maxDist - minDist);
+			m_zoomVolume = 1.0f - scalar * maxBoostScalar;
+		}
+	}
 
-	// set3DVolumeAdjustment( m_zoomVolume );
+	set3DVolumeAdjustment( m_zoomVolume );
 
 }
 
@@ -1128,6 +1128,167 @@ Int parseMod(char *args[], Int num)
 	return 1;
 }
 
+Int parseUseINICache(char *[], int)
+{
+	if (TheWritableGlobalData)
+	{
+		TheWritableGlobalData->m_data.m_useINICache = TRUE;
+	}
+	return 1;
+}
+
+Int parsePerfTrace(char *[], int)
+{
+	if (TheWritableGlobalData)
+	{
+		TheWritableGlobalData->m_data.m_perfTrace = TRUE;
+	}
+	return 1;
+}
+
+Int parseHeadless(char *[], int)
+{
+	if (TheWritableGlobalData)
+	{
+		TheWritableGlobalData->m_data.m_headless = TRUE;
+		TheWritableGlobalData->m_data.m_shellMapOn = FALSE;
+		TheWritableGlobalData->m_data.m_playIntro = FALSE;
+		TheWritableGlobalData->m_data.m_afterIntro = TRUE;
+		TheWritableGlobalData->m_data.m_playSizzle = FALSE;
+	}
+	return 1;
+}
+
+Int parseIncrementalCRC(char *[], int)
+{
+	if (TheWritableGlobalData)
+	{
+		TheWritableGlobalData->m_data.m_incrementalCRC = TRUE;
+	}
+	return 1;
+}
+
+Int parseCompressSaves(char *[], int)
+{
+	if (TheWritableGlobalData)
+	{
+		TheWritableGlobalData->m_data.m_compressSaveGames = TRUE;
+	}
+	return 1;
+}
+
+Int parseTextureCache(char *[], int)
+{
+	if (TheWritableGlobalData)
+	{
+		TheWritableGlobalData->m_data.m_useTextureCache = TRUE;
+	}
+	return 1;
+}
+
+Int parseReplaySnapshots(char *args[], int num)
+{
+	if (TheWritableGlobalData && num > 1)
+	{
+		TheWritableGlobalData->m_data.m_replaySnapshotInterval = std::max(0, atoi(args[1]));
+	}
+	return 2;
+}
+
+Int parseReplaySnapshotMB(char *args[], int num)
+{
+	if (TheWritableGlobalData && num > 1)
+	{
+		TheWritableGlobalData->m_data.m_replaySnapshotBudgetMB = std::max(1, atoi(args[1]));
+	}
+	return 2;
+}
+
+Int parseSeekFrame(char *args[], int num)
+{
+	if (TheWritableGlobalData && num > 1)
+	{
+		TheWritableGlobalData->m_data.m_replaySeekFrame = std::max(0, atoi(args[1]));
+	}
+	return 2;
+}
+
+Int parsePartitionQueryBenchmark(char *[], int)
+{
+	if (TheWritableGlobalData)
+	{
+		TheWritableGlobalData->m_data.m_partitionQueryBenchmark = TRUE;
+	}
+	return 1;
+}
+
+Int parseCorridorCacheBenchmark(char *[], int)
+{
+	if (TheWritableGlobalData)
+	{
+		TheWritableGlobalData->m_data.m_corridorCacheBenchmark = TRUE;
+	}
+	return 1;
+}
+
+Int parseZoneBlockBenchmark(char *[], int)
+{
+	if (TheWritableGlobalData)
+	{
+		TheWritableGlobalData->m_data.m_zoneBlockBenchmark = TRUE;
+	}
+	return 1;
+}
+
+Int parseINIParseBenchmark(char *[], int)
+{
+	if (TheWritableGlobalData)
+	{
+		TheWritableGlobalData->m_data.m_iniParseBenchmark = TRUE;
+	}
+	return 1;
+}
+
+Int parseNameKeyBenchmark(char *[], int)
+{
+	if (TheWritableGlobalData)
+	{
+		TheWritableGlobalData->m_data.m_nameKeyBenchmark = TRUE;
+	}
+	return 1;
+}
+
+Int parseDDSDecodeBenchmark(char *args[], int num)
+{
+	if (TheWritableGlobalData)
+	{
+		TheWritableGlobalData->m_data.m_ddsDecodeBenchmark = TRUE;
+	}
+	// only the decoder is timed, so there's no need for a window
+	return parseHeadless(args, num);
+}
+
+Int parseScriptNameBenchmark(char *args[], int num)
+{
+	if (TheWritableGlobalData && num > 1)
+	{
+		TheWritableGlobalData->m_data.m_scriptNameBenchmarkUnits = std::max(0, atoi(args[1]));
+	}
+	return 2;
+}
+
+Int parseParticleBenchmark(char *args[], int num)
+{
+	if (TheWritableGlobalData && num > 2)
+	{
+		TheWritableGlobalData->m_data.m_particleBenchmarkEmitters = static_cast<UnsignedInt>(std::max(0, atoi(args[1])));
+		TheWritableGlobalData->m_data.m_particleBenchmarkFrames = static_cast<UnsignedInt>(std::max(0, atoi(args[2])));
+	}
+	// particles update the same without being drawn
+	parseHeadless(args, num);
+	return 3;
+}
+
 static CommandLineParam params[] =
 {
 	{ "-noshellmap", parseNoShellMap },
@@ -1142,6 +1303,23 @@ static CommandLineParam params[] =
 	{ "-mod", parseMod },
 	{ "-noshaders", parseNoShaders },
 	{ "-quickstart", parseQuickStart },
+	{ "-useINICache", parseUseINICache },
+	{ "-perfTrace", parsePerfTrace },
+	{ "-headless", parseHeadless },
+	{ "-incrementalCRC", parseIncrementalCRC },
+	{ "-compressSaves", parseCompressSaves },
+	{ "-replaySnapshots", parseReplaySnapshots },
+	{ "-replaySnapshotMB", parseReplaySnapshotMB },
+	{ "-seekFrame", parseSeekFrame },
+	{ "-textureCache", parseTextureCache },
+	{ "-partitionQueryBenchmark", parsePartitionQueryBenchmark },
+	{ "-corridorCacheBenchmark", parseCorridorCacheBenchmark },
+	{ "-zoneBlockBenchmark", parseZoneBlockBenchmark },
+	{ "-iniParseBenchmark", parseINIParseBenchmark },
+	{ "-nameKeyBenchmark", parseNameKeyBenchmark },
+	{ "-ddsDecodeBenchmark", parseDDSDecodeBenchmark },
+	{ "-particleBenchmark", parseParticleBenchmark },
+	{ "-scriptNameBenchmark", parseScriptNameBenchmark },
 
 #if (defined(_DEBUG) || defined(_INTERNAL))
 	{ "-noaudio", parseNoAudio },
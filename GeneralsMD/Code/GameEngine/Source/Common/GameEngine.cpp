@@ -39,6 +39,7 @@
 #include "Common/GameAudio.h"
 #include "Common/GameEngine.h"
 #include "Common/INI.h"
+#include "Common/INICache.h"
 #include "Common/INIException.h"
 #include "Common/MessageStream.h"
 #include "Common/ThingFactory.h"
@@ -48,7 +49,7 @@
 #include "Common/LocalFileSystem.h"
 // #include "Common/CDManager.h"
 #include "Common/GlobalData.h"
-// #include "Common/PerfTimer.h"
+#include "Common/PerfTimer.h"
 #include "Common/RandomValue.h"
 #include "Common/NameKeyGenerator.h"
 #include "Common/ModuleFactory.h"
@@ -61,6 +62,7 @@
 #include "Common/DamageFX.h"
 #include "Common/MultiplayerSettings.h"
 #include "Common/Recorder.h"
+#include "Common/ReplayBenchmark.h"
 #include "Common/SpecialPower.h"
 #include "Common/TerrainTypes.h"
 #include "Common/Upgrade.h"
@@ -82,7 +84,7 @@
 #include "GameLogic/GameLogic.h"
 #include "GameLogic/Locomotor.h"
 #include "GameLogic/RankInfo.h"
-// #include "GameLogic/ScriptEngine.h"
+#include "GameLogic/ScriptEngine.h"
 #include "GameLogic/SidesList.h"
 
 // #include "GameClient/Display.h"
@@ -220,6 +222,13 @@ GameEngine::~GameEngine()
 
 	// TheGameResultsQueue->endThreads();
 
+	// writes back anything recorded since init, so it must go while the file systems are still up
+	delete TheINICache;
+	TheINICache = NULL;
+
+	delete TheReplayBenchmark;
+	TheReplayBenchmark = NULL;
+
 	TheSubsystemList->shutdownAll();
 	delete TheSubsystemList;
 	TheSubsystemList = NULL;
@@ -244,6 +253,7 @@ GameEngine::~GameEngine()
 	// _Module.Term();
 
 #ifdef PERF_TIMERS
+	PerfGather::termPerfTrace();
 	PerfGather::termPerfDump();
 #endif
 
@@ -393,6 +403,22 @@ void GameEngine::init( int argc, char *argv[] )
 		// special-case: parse command-line parameters after loading global data
 		parseCommandLine(argc, argv);
 
+	#ifdef PERF_TIMERS
+		if (TheGlobalData->m_data.m_perfTrace)
+			PerfGather::initPerfTrace("AAAPerfStats");
+	#endif
+
+		// the global data itself has been parsed by now, but everything after this can come from the INI cache.
+		if (TheGlobalData->m_data.m_useINICache)
+		{
+			TheINICache = MSGNEW("GameEngineSubsystem") INICache;
+			TheINICache->load();
+		}
+
+		// everything the parse table benchmark replays is looked up from here on
+		if (TheGlobalData->m_data.m_iniParseBenchmark)
+			INI::recordParseLookups(TRUE);
+
 		// doesn't require resets so just create a single instance here.
 		TheGameLODManager = MSGNEW("GameEngineSubsystem") GameLODManager;
 		TheGameLODManager->init();
@@ -569,6 +595,39 @@ void GameEngine::init( int argc, char *argv[] )
 
 		TheSubsystemList->postProcessLoadAll();
 
+		// most keys are made while loading the INIs, so this is a good time to see how the table is doing
+		TheNameKeyGenerator->reportStatistics();
+
+		if (TheINICache)
+		{
+			TheINICache->save();
+			TheINICache->reportTimings();
+		}
+
+		if (TheGlobalData->m_data.m_iniParseBenchmark)
+		{
+			INI::reportParseLookupBenchmark();
+			setQuitting(TRUE);
+		}
+
+		if (TheGlobalData->m_data.m_nameKeyBenchmark)
+		{
+			TheNameKeyGenerator->reportBenchmark();
+			setQuitting(TRUE);
+		}
+
+		if (TheGlobalData->m_data.m_particleBenchmarkEmitters > 0)
+		{
+			TheParticleSystemManager->reportUpdateBenchmark(TheGlobalData->m_data.m_particleBenchmarkEmitters, TheGlobalData->m_data.m_particleBenchmarkFrames);
+			setQuitting(TRUE);
+		}
+
+		if (TheGlobalData->m_data.m_scriptNameBenchmarkUnits > 0)
+		{
+			TheScriptEngine->reportNamedObjectBenchmark(TheGlobalData->m_data.m_scriptNameBenchmarkUnits);
+			setQuitting(TRUE);
+		}
+
 		setFramesPerSecondLimit(TheGlobalData->m_data.m_framesPerSecondLimit);
 
 		TheAudio->setOn(TheGlobalData->m_data.m_audioOn && TheGlobalData->m_data.m_musicOn, AudioAffect_Music);
@@ -662,7 +721,13 @@ void GameEngine::init( int argc, char *argv[] )
 			}
 			else if (fname.endsWithNoCase(".rep"))
 			{
-				TheRecorder->playbackFile(fname);
+				// headless replays are benchmark runs; this reads the replay header, so it has to
+				// happen before the recorder opens the file for playback
+				if (TheGlobalData->m_data.m_headless)
+					TheReplayBenchmark = MSGNEW("GameEngineSubsystem") ReplayBenchmark(fname);
+
+				if (!TheRecorder->playbackFile(fname) && TheReplayBenchmark)
+					TheReplayBenchmark->abort("could not open replay");
 			}
 		}
 
@@ -749,7 +814,7 @@ DEBUG_LOG(("<<< GameEngine::reset >>>\n"));
 }
 
 /// -----------------------------------------------------------------------------------------------
-// DECLARE_PERF_TIMER(GameEngine_update)
+DECLARE_PERF_TIMER(GameEngine_update)
 
 /** -----------------------------------------------------------------------------------------------
  * Update the game engine by updating the GameClient and GameLogic singletons.
@@ -758,7 +823,7 @@ DEBUG_LOG(("<<< GameEngine::reset >>>\n"));
  */
 void GameEngine::update( void )
 { 
-	// USE_PERF_TIMER(GameEngine_update)
+	USE_PERF_TIMER(GameEngine_update)
 	// {
 
 	// 	{
@@ -770,8 +835,14 @@ void GameEngine::update( void )
 
 	// 		/// @todo Move audio init, update, etc, into GameClient update
 			
-			TheAudio->UPDATE();
-			TheGameClient->UPDATE();
+			// headless runs only drive the logic; nothing is drawn or heard.  Neither is anything
+			// while a replay seek runs the logic forward to its target frame.
+			if (!TheGlobalData->m_data.m_headless && !TheRecorder->isSeeking())
+			{
+				TheAudio->UPDATE();
+				TheGameClient->UPDATE();
+				TheGameState->UPDATE();
+			}
 			TheMessageStream->propagateMessages();
 
 	// 		if (TheNetwork != NULL)
@@ -868,6 +939,9 @@ void GameEngine::execute( void )
 					// }
 					RELEASE_CRASH(("Uncaught Exception in GameEngine::update"));
 				}	// catch
+
+				if (TheReplayBenchmark)
+					TheReplayBenchmark->update();
 			}	// perf
 
 // 			{
@@ -879,7 +953,8 @@ void GameEngine::execute( void )
 		// doing performance tuning, please just change this on your local system. -MDC
 		#if defined(_DEBUG) || defined(_INTERNAL)
 					// ::Sleep(1); // give everyone else a tiny time slice.
-					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+					if (!TheGlobalData->m_data.m_headless && !TheRecorder->isSeeking())
+						std::this_thread::sleep_for(std::chrono::milliseconds(1));
 		#endif
 
 
@@ -909,14 +984,15 @@ void GameEngine::execute( void )
 
 // 		}	// perfgather for execute_loop
 
-// #ifdef PERF_TIMERS
-// 		if (!m_quitting && TheGameLogic->isInGame() && !TheGameLogic->isInShellGame() && !TheGameLogic->isGamePaused())
-// 		{
-// 			PerfGather::dumpAll(TheGameLogic->getFrame());
-// 			PerfGather::displayGraph(TheGameLogic->getFrame());
-// 			PerfGather::resetAll();
-// 		}
-// #endif
+#ifdef PERF_TIMERS
+		PerfGather::flushPerfTrace();
+		if (!m_quitting && TheGameLogic->isInGame() && !TheGameLogic->isInShellGame() && !TheGameLogic->isGamePaused())
+		{
+			PerfGather::dumpAll(TheGameLogic->getFrame());
+			PerfGather::displayGraph(TheGameLogic->getFrame());
+		}
+		PerfGather::resetAll();
+#endif
 
 	}
 
@@ -944,6 +944,24 @@ GlobalData::GlobalData()
 
 	m_data.m_isBreakableMovie = FALSE;
 	m_data.m_breakTheMovie = FALSE;
+	m_data.m_useINICache = FALSE;
+	m_data.m_perfTrace = FALSE;
+	m_data.m_headless = FALSE;
+	m_data.m_incrementalCRC = FALSE;
+	m_data.m_compressSaveGames = FALSE;
+	m_data.m_useTextureCache = FALSE;
+	m_data.m_replaySnapshotInterval = 0;
+	m_data.m_replaySnapshotBudgetMB = 256;
+	m_data.m_replaySeekFrame = 0;
+	m_data.m_partitionQueryBenchmark = FALSE;
+	m_data.m_corridorCacheBenchmark = FALSE;
+	m_data.m_zoneBlockBenchmark = FALSE;
+	m_data.m_iniParseBenchmark = FALSE;
+	m_data.m_nameKeyBenchmark = FALSE;
+	m_data.m_ddsDecodeBenchmark = FALSE;
+	m_data.m_particleBenchmarkEmitters = 0;
+	m_data.m_particleBenchmarkFrames = 0;
+	m_data.m_scriptNameBenchmarkUnits = 0;
 
 	setTimeOfDay( m_data.m_timeOfDay );
 
@@ -32,6 +32,7 @@
 #define DEFINE_DEATH_NAMES
 
 #include "Common/INI.h"
+#include "Common/INICache.h"
 #include "Common/INIException.h"
 
 #include "Common/DamageFX.h"
@@ -60,7 +61,9 @@
 // #include "GameLogic/ScriptEngine.h"
 #include "GameLogic/Weapon.h"
 
+#include <chrono>
 #include <cstdint>
+#include <unordered_set>
 
 #ifdef _INTERNAL
 // for occasional debugging...
@@ -302,10 +305,15 @@ void INI::prepFile( AsciiString filename, INILoadType loadType )
 //-------------------------------------------------------------------------------------------------
 void INI::unPrepFile()
 {
-	// close the file
-	m_file->close();
-	m_file = NULL;
+	// close the file (there is none when the lines were replayed from the INI cache)
+	if (m_file)
+	{
+		m_file->close();
+		m_file = NULL;
+	}
   m_readBufferUsed=m_readBufferNext=0;
+	m_cachedLine = NULL;
+	m_cachedLinesEnd = NULL;
 	m_filename = "None";
 	m_loadType = INI_LOAD_INVALID;
 	m_lineNum = 0;
@@ -313,45 +321,258 @@ void INI::unPrepFile()
 	// s_xfer = NULL;
 }
 
+//-------------------------------------------------------------------------------------------------
+/** Sorted index over the tokens of a parse table, so that a token can be looked up with a
+	* binary search instead of a strcmp against every entry.  Matching is still exact and case
+	* sensitive, and when a table names the same token twice the earlier entry wins, just as
+	* it did with the linear walk. */
+//-------------------------------------------------------------------------------------------------
+template <typename ENTRY>
+class ParseTableIndex
+{
+public:
+
+	explicit ParseTableIndex( const ENTRY *table )
+	{
+		const ENTRY *entry {};
+		for (entry = table; entry->token; ++entry)
+			m_sorted.push_back(entry);
+
+		std::stable_sort(m_sorted.begin(), m_sorted.end(), lessToken);
+		m_sorted.erase(std::unique(m_sorted.begin(), m_sorted.end(), sameToken), m_sorted.end());
+
+		m_terminator = entry;
+	}
+
+	// the pointers refer to static parse tables, so copies are harmless
+	ParseTableIndex( const ParseTableIndex& ) = default;
+	ParseTableIndex& operator=( const ParseTableIndex& ) = default;
+
+	const ENTRY *find( const char *token ) const
+	{
+		typename std::vector<const ENTRY*>::const_iterator it =
+			std::lower_bound(m_sorted.begin(), m_sorted.end(), token, lessThanToken);
+		if (it != m_sorted.end() && strcmp((*it)->token, token) == 0)
+			return *it;
+		return NULL;
+	}
+
+	const ENTRY *getTerminator( void ) const { return m_terminator; }
+
+private:
+
+	static bool lessToken( const ENTRY *a, const ENTRY *b ) { return strcmp(a->token, b->token) < 0; }
+	static bool sameToken( const ENTRY *a, const ENTRY *b ) { return strcmp(a->token, b->token) == 0; }
+	static bool lessThanToken( const ENTRY *a, const char *token ) { return strcmp(a->token, token) < 0; }
+
+	std::vector<const ENTRY*> m_sorted {};		///< entries with a token, sorted by token
+	const ENTRY *m_terminator {};							///< the null token entry that ends the table
+};
+
+typedef ParseTableIndex<FieldParse> FieldParseIndex;
+
+//-------------------------------------------------------------------------------------------------
+/** Field parse tables are all static data, so their indices are built the first time each table
+	* is used and kept, keyed by table address, for the rest of the run. */
+//-------------------------------------------------------------------------------------------------
+static const FieldParseIndex& getFieldParseIndex( const FieldParse* parseTable )
+{
+	static std::unordered_map<const FieldParse*, FieldParseIndex> s_indices;
+	static const FieldParse* s_lastTable = NULL;
+	static const FieldParseIndex* s_lastIndex = NULL;
+
+	// a block is parsed line after line against the same table, so remember the last one
+	if (parseTable == s_lastTable)
+		return *s_lastIndex;
+
+	std::unordered_map<const FieldParse*, FieldParseIndex>::iterator it = s_indices.find(parseTable);
+	if (it == s_indices.end())
+		it = s_indices.emplace(parseTable, FieldParseIndex(parseTable)).first;
+
+	s_lastTable = parseTable;
+	s_lastIndex = &it->second;
+	return it->second;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** A parse table lookup made while loading, kept for -iniParseBenchmark.  A NULL table means
+	* the lookup was of a block type in theTypeTable. */
+//-------------------------------------------------------------------------------------------------
+struct ParseLookup
+{
+	const FieldParse *m_table;
+	std::string m_token;
+};
+
+static Bool s_recordParseLookups = FALSE;
+static std::vector<ParseLookup> s_parseLookups;
+
+//-------------------------------------------------------------------------------------------------
+static void recordParseLookup(const FieldParse* parseTable, const char* token)
+{
+	ParseLookup lookup = { parseTable, token };
+	s_parseLookups.push_back(lookup);
+}
+
+//-------------------------------------------------------------------------------------------------
+static const ParseTableIndex<BlockParse>& getBlockParseIndex( void )
+{
+	static const ParseTableIndex<BlockParse> s_typeIndex(theTypeTable);
+	return s_typeIndex;
+}
+
 //-------------------------------------------------------------------------------------------------
 static INIBlockParse findBlockParse(const char* token)
+{
+	if (s_recordParseLookups)
+		recordParseLookup(NULL, token);
+
+	const BlockParse* parse = getBlockParseIndex().find(token);
+	return parse ? parse->parse : NULL;
+}
+
+//-------------------------------------------------------------------------------------------------
+static INIFieldParseProc findFieldParse(const FieldParse* parseTable, const char* token, int& offset, const void*& userData)
+{
+	if (s_recordParseLookups)
+		recordParseLookup(parseTable, token);
+
+	const FieldParseIndex& index = getFieldParseIndex(parseTable);
+
+	const FieldParse* parse = index.find(token);
+	if (parse)
+	{
+		offset = parse->offset;
+		userData = parse->userData;
+		return parse->parse;
+	}
+
+	parse = index.getTerminator();
+	if (parse->parse) 
+	{
+		offset = parse->offset;
+		userData = token;
+		return parse->parse;
+	}
+
+	return NULL;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** The strcmp walk the lookups used before the tables were indexed, kept as the baseline for
+	* -iniParseBenchmark. */
+//-------------------------------------------------------------------------------------------------
+static const BlockParse* findBlockParseLinear(const char* token)
 {
 	for (const BlockParse* parse = theTypeTable; parse->token; ++parse)
 	{
-		if (strcmp( parse->token, token ) == 0)
-		{
-			return parse->parse;
-		}
+		if (strcmp(parse->token, token) == 0)
+			return parse;
 	}
 	return NULL;
 }
 
 //-------------------------------------------------------------------------------------------------
-static INIFieldParseProc findFieldParse(const FieldParse* parseTable, const char* token, int& offset, const void*& userData)
+static const FieldParse* findFieldParseLinear(const FieldParse* parseTable, const char* token)
 {
 	const FieldParse* parse {};
 	for (parse = parseTable; parse->token; ++parse)
 	{
-		if (strcmp( parse->token, token ) == 0)
+		if (strcmp(parse->token, token) == 0)
+			return parse;
+	}
+	return parse;
+}
+
+//-------------------------------------------------------------------------------------------------
+static const BlockParse* findBlockParseIndexed(const char* token)
+{
+	return getBlockParseIndex().find(token);
+}
+
+//-------------------------------------------------------------------------------------------------
+static const FieldParse* findFieldParseIndexed(const FieldParse* parseTable, const char* token)
+{
+	const FieldParseIndex& index = getFieldParseIndex(parseTable);
+	const FieldParse* parse = index.find(token);
+	return parse ? parse : index.getTerminator();
+}
+
+//-------------------------------------------------------------------------------------------------
+static Int64 parseLookupNanos( void )
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Run every lookup recorded during the load through the linear walk and through the index,
+	* the same number of times each, and make sure both find the same entry every time. */
+//-------------------------------------------------------------------------------------------------
+template <typename FIND_BLOCK, typename FIND_FIELD>
+static Int64 timeParseLookups( Int passes, FIND_BLOCK findBlock, FIND_FIELD findField, std::vector<const void*>& found )
+{
+	found.clear();
+	found.reserve(s_parseLookups.size());
+
+	Int64 start = parseLookupNanos();
+	for (Int pass = 0; pass < passes; ++pass)
+	{
+		for (std::vector<ParseLookup>::const_iterator it = s_parseLookups.begin(); it != s_parseLookups.end(); ++it)
 		{
-			offset = parse->offset;
-			userData = parse->userData;
-			return parse->parse;
+			const void* entry = it->m_table ? (const void*)findField(it->m_table, it->m_token.c_str()) : (const void*)findBlock(it->m_token.c_str());
+			if (pass == 0)
+				found.push_back(entry);
 		}
 	}
+	return parseLookupNanos() - start;
+}
 
-	if (!parse->token && parse->parse) 
+//-------------------------------------------------------------------------------------------------
+void INI::recordParseLookups( Bool record )
+{
+	s_recordParseLookups = record;
+}
+
+//-------------------------------------------------------------------------------------------------
+void INI::reportParseLookupBenchmark( void )
+{
+	static const Int PASSES = 20;
+	s_recordParseLookups = FALSE;
+
+	Int blockLookups = 0;
+	std::unordered_set<const FieldParse*> tables;
+	for (std::vector<ParseLookup>::const_iterator it = s_parseLookups.begin(); it != s_parseLookups.end(); ++it)
 	{
-		offset = parse->offset;
-		userData = token;
-		return parse->parse;
+		if (it->m_table)
+			tables.insert(it->m_table);
+		else
+			++blockLookups;
 	}
-	else
+
+	// one untimed pass through the index first, so building the indices isn't counted against it
+	std::vector<const void*> linearFound, indexedFound;
+	timeParseLookups(1, findBlockParseIndexed, findFieldParseIndexed, indexedFound);
+
+	Int64 linearNanos = timeParseLookups(PASSES, findBlockParseLinear, findFieldParseLinear, linearFound);
+	Int64 indexedNanos = timeParseLookups(PASSES, findBlockParseIndexed, findFieldParseIndexed, indexedFound);
+
+	Int mismatches = 0;
+	for (size_t i = 0; i < linearFound.size(); ++i)
 	{
-		return NULL;
+		if (linearFound[i] != indexedFound[i])
+			++mismatches;
 	}
 
-	return NULL;
+	double lookups = (double)s_parseLookups.size() * PASSES;
+	printf("INI parse table lookups: %d recorded (%d block types, %d fields in %d tables), %d passes\n",
+		(Int)s_parseLookups.size(), blockLookups, (Int)s_parseLookups.size() - blockLookups, (Int)tables.size(), PASSES);
+	printf("  linear  %.3f ms (%.1f ns/lookup)\n", linearNanos / 1.0e6, lookups > 0 ? linearNanos / lookups : 0.0);
+	printf("  indexed %.3f ms (%.1f ns/lookup)\n", indexedNanos / 1.0e6, lookups > 0 ? indexedNanos / lookups : 0.0);
+	printf("  %d lookups found a different entry\n", mismatches);
+	fflush(stdout);
+
+	s_parseLookups.clear();
+	s_parseLookups.shrink_to_fit();
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -364,11 +585,15 @@ void INI::load( AsciiString filename, INILoadType loadType, Xfer */*pXfer*/ )
 	// setFPMode(); // so we have consistent Real values for GameLogic -MDC
 
 	// s_xfer = pXfer;
-	prepFile(filename, loadType);
+	auto startTime {std::chrono::steady_clock::now()};
+	Bool fromCache = FALSE;
+	if (TheINICache)
+		fromCache = prepCachedFile(filename, loadType);
+	else
+		prepFile(filename, loadType);
 
 	try
 	{
-
 		// read all lines in the file
 		DEBUG_ASSERTCRASH( m_endOfFile == FALSE, ("INI::load, EOF at the beginning!\n") );
 		while( m_endOfFile == FALSE )
@@ -423,8 +648,93 @@ void INI::load( AsciiString filename, INILoadType loadType, Xfer */*pXfer*/ )
 
 	unPrepFile();
 
+	if (TheINICache)
+	{
+		std::chrono::duration<Real> elapsed {std::chrono::steady_clock::now() - startTime};
+		TheINICache->addLoadTime(fromCache, elapsed.count());
+	}
+
 }  // end load
 
+//-------------------------------------------------------------------------------------------------
+/** prepFile() for use with the INI cache.  If the cache has lines for this file, recorded from
+	* the same loose file or archive entry, point readLine() at them without opening the file at
+	* all.  Otherwise open the file, lex the whole of it up front exactly as readLine() would,
+	* record the result and replay that instead.  Returns TRUE if the lines came from the cache. */
+//-------------------------------------------------------------------------------------------------
+Bool INI::prepCachedFile( AsciiString filename, INILoadType loadType )
+{
+	INICacheSource source;
+	Bool haveSource = INICache::getSource(filename, &source);
+
+	const INICacheEntry *entry = haveSource ? TheINICache->find(filename, source) : NULL;
+	if (entry)
+	{
+		if( m_file != NULL || m_cachedLine != NULL )
+		{
+
+			DEBUG_CRASH(( "INI::load, cannot open file '%s', file already open\n", filename.str() ));
+			throw INI_FILE_ALREADY_OPEN;
+
+		}  // end if
+
+		m_filename = filename;
+		m_loadType = loadType;
+		m_cachedLine = entry->m_lines.data();
+		m_cachedLinesEnd = m_cachedLine + entry->m_lines.size();
+		return TRUE;
+	}
+
+	prepFile(filename, loadType);
+
+	// if we can't tell where the file came from we can't tell when it goes stale, so don't keep it
+	if (!haveSource)
+		return FALSE;
+
+	std::vector<char> lines;
+	do
+	{
+		readLine();
+		UnsignedShort length = static_cast<UnsignedShort>(strlen(m_buffer));
+		const char *lengthBytes = reinterpret_cast<const char *>(&length);
+		lines.insert(lines.end(), lengthBytes, lengthBytes + sizeof(length));
+		lines.insert(lines.end(), m_buffer, m_buffer + length + 1);
+	} while (m_endOfFile == FALSE);
+
+	entry = TheINICache->record(filename, source, lines);
+
+	// start over; the parsers get the lines we just recorded
+	m_lineNum = 0;
+	m_endOfFile = FALSE;
+	m_cachedLine = entry->m_lines.data();
+	m_cachedLinesEnd = m_cachedLine + entry->m_lines.size();
+
+	return FALSE;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Cached counterpart of readLine(): copy the next recorded line into the buffer */
+//-------------------------------------------------------------------------------------------------
+void INI::readCachedLine( void )
+{
+	if (m_endOfFile)
+	{
+		*m_buffer = 0;
+		return;
+	}
+
+	UnsignedShort length;
+	memcpy(&length, m_cachedLine, sizeof(length));
+	memcpy(m_buffer, m_cachedLine + sizeof(length), length + 1u);
+	m_cachedLine += sizeof(length) + length + 1u;
+
+	m_lineNum++;
+
+	// the last record is the one on which the file ran out
+	if (m_cachedLine >= m_cachedLinesEnd)
+		m_endOfFile = TRUE;
+}
+
 //-------------------------------------------------------------------------------------------------
 /** Read a line from the already open file.  Any comments will be remved and
 	* therefore ignored from any given line */
@@ -432,7 +742,13 @@ void INI::load( AsciiString filename, INILoadType loadType, Xfer */*pXfer*/ )
 void INI::readLine( void )
 {
 	// sanity
-	DEBUG_ASSERTCRASH( m_file, ("readLine(), file pointer is NULL\n") );
+	DEBUG_ASSERTCRASH( m_file || m_cachedLine, ("readLine(), file pointer is NULL\n") );
+
+	if (m_cachedLine)
+	{
+		readCachedLine();
+		return;
+	}
 
   if (m_endOfFile)
     *m_buffer=0;
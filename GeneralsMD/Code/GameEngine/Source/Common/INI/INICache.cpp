@@ -0,0 +1,362 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// FILE: INICache.cpp /////////////////////////////////////////////////////////////////////////////
+// Desc:   Binary cache of pre-lexed INI files
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// INCLUDES ///////////////////////////////////////////////////////////////////////////////////////
+#include "PreRTS.h"	// This must go first in EVERY cpp file int the GameEngine
+
+#include "Common/INICache.h"
+#include "Common/File.h"
+#include "Common/FileSystem.h"
+#include "Common/INI.h"
+#include "Common/GlobalData.h"
+#include "Common/LocalFileSystem.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// PRIVATE DATA ///////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static const char *INICacheFilename = "INICache.dat";
+static const char INICacheMagic[4] = { 'I', 'N', 'I', 'C' };
+
+// bump this whenever the record layout or INI::readLine's lexing changes
+static const UnsignedInt INICacheVersion = 2;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// PUBLIC DATA ////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+INICache *TheINICache = NULL;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS //////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+/** Pulls little pieces out of the loaded cache image, failing once it runs off the end */
+//-------------------------------------------------------------------------------------------------
+class INICacheReader
+{
+public:
+	INICacheReader(const char *data, Int size) : m_cur(data), m_end(data + size), m_ok(TRUE) { }
+
+	Bool ok( void ) const { return m_ok; }
+
+	const char *bytes( Int count )
+	{
+		if (!m_ok || count < 0 || m_end - m_cur < count)
+		{
+			m_ok = FALSE;
+			return NULL;
+		}
+		const char *p = m_cur;
+		m_cur += count;
+		return p;
+	}
+
+	UnsignedInt readUnsignedInt( void )
+	{
+		UnsignedInt value = 0;
+		const char *p = bytes(sizeof(value));
+		if (p)
+			memcpy(&value, p, sizeof(value));
+		return value;
+	}
+
+	UnsignedInt64 readUnsignedInt64( void )
+	{
+		UnsignedInt64 value = 0;
+		const char *p = bytes(sizeof(value));
+		if (p)
+			memcpy(&value, p, sizeof(value));
+		return value;
+	}
+
+private:
+	const char *m_cur;
+	const char *m_end;
+	Bool m_ok;
+};
+
+//-------------------------------------------------------------------------------------------------
+/** Make sure a set of line records can be replayed without overrunning INI's line buffer */
+//-------------------------------------------------------------------------------------------------
+static Bool validateLines( const char *lines, UnsignedInt length )
+{
+	if (length == 0)
+		return FALSE;
+
+	const char *cur = lines;
+	const char *end = lines + length;
+	while (cur < end)
+	{
+		UnsignedShort lineLength;
+		if (end - cur < static_cast<Int>(sizeof(lineLength)))
+			return FALSE;
+		memcpy(&lineLength, cur, sizeof(lineLength));
+		cur += sizeof(lineLength);
+
+		if (lineLength > INI_MAX_CHARS_PER_LINE || end - cur < lineLength + 1 || cur[lineLength] != 0)
+			return FALSE;
+		cur += lineLength + 1;
+	}
+	return TRUE;
+}
+
+//-------------------------------------------------------------------------------------------------
+static void writeUnsignedInt( File *file, UnsignedInt value )
+{
+	file->write(&value, sizeof(value));
+}
+
+//-------------------------------------------------------------------------------------------------
+static void writeUnsignedInt64( File *file, UnsignedInt64 value )
+{
+	file->write(&value, sizeof(value));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS ///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+INICache::INICache()
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+INICache::~INICache()
+{
+	save();
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+AsciiString INICache::getCacheFilename( void ) const
+{
+	AsciiString filename;
+	filename.format("%s%s", TheGlobalData->getPath_UserData().str(), INICacheFilename);
+	return filename;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** FNV-1a, used to key cache entries on file contents */
+//-------------------------------------------------------------------------------------------------
+UnsignedInt INICache::hashBytes( const char *data, Int length, UnsignedInt hash )
+{
+	for (Int i = 0; i < length; ++i)
+	{
+		hash ^= static_cast<UnsignedByte>(data[i]);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Read the cache file.  A missing, stale or damaged cache is simply ignored; every INI file
+	* will then be parsed the slow way and recorded afresh. */
+//-------------------------------------------------------------------------------------------------
+void INICache::load( void )
+{
+	m_entries.clear();
+	m_dirty = FALSE;
+
+	AsciiString filename = getCacheFilename();
+	File *file = TheLocalFileSystem->openFile(filename.str(), File::READ | File::BINARY);
+	if (file == NULL)
+	{
+		DEBUG_LOG(("INICache::load - no INI cache at %s\n", filename.str()));
+		return;
+	}
+
+	Int size = file->size();
+	char *data = file->readEntireAndClose();
+	file = NULL;
+
+	INICacheReader reader(data, size);
+	const char *magic = reader.bytes(sizeof(INICacheMagic));
+	UnsignedInt version = reader.readUnsignedInt();
+	UnsignedInt count = reader.readUnsignedInt();
+
+	if (!reader.ok() || memcmp(magic, INICacheMagic, sizeof(INICacheMagic)) != 0 || version != INICacheVersion)
+	{
+		DEBUG_LOG(("INICache::load - ignoring out of date INI cache %s\n", filename.str()));
+		delete [] data;
+		return;
+	}
+
+	for (UnsignedInt i = 0; i < count && reader.ok(); ++i)
+	{
+		UnsignedInt nameLength = reader.readUnsignedInt();
+		const char *name = reader.bytes(static_cast<Int>(nameLength));
+		UnsignedInt archiveLength = reader.readUnsignedInt();
+		const char *archive = reader.bytes(static_cast<Int>(archiveLength));
+		INICacheSource source;
+		source.m_offset = reader.readUnsignedInt();
+		source.m_size = reader.readUnsignedInt64();
+		source.m_timestamp = reader.readUnsignedInt64();
+		UnsignedInt linesLength = reader.readUnsignedInt();
+		const char *lines = reader.bytes(static_cast<Int>(linesLength));
+		if (!reader.ok())
+			break;
+
+		if (!validateLines(lines, linesLength))
+		{
+			DEBUG_LOG(("INICache::load - skipping bad cache entry\n"));
+			continue;
+		}
+
+		AsciiString key = std::string(name, nameLength).c_str();
+		source.m_archive = std::string(archive, archiveLength).c_str();
+		INICacheEntry &entry = m_entries[key];
+		entry.m_source = source;
+		entry.m_lines.assign(lines, lines + linesLength);
+	}
+
+	if (!reader.ok())
+	{
+		DEBUG_LOG(("INICache::load - INI cache %s is damaged, discarding it\n", filename.str()));
+		m_entries.clear();
+	}
+
+	delete [] data;
+
+	DEBUG_LOG(("INICache::load - %d INI files in cache\n", static_cast<Int>(m_entries.size())));
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+void INICache::save( void )
+{
+	if (!m_dirty || TheLocalFileSystem == NULL)
+		return;
+
+	AsciiString filename = getCacheFilename();
+	File *file = TheLocalFileSystem->openFile(filename.str(), File::WRITE | File::CREATE | File::TRUNCATE | File::BINARY);
+	if (file == NULL)
+	{
+		DEBUG_LOG(("INICache::save - could not write %s\n", filename.str()));
+		return;
+	}
+
+	file->write(INICacheMagic, sizeof(INICacheMagic));
+	writeUnsignedInt(file, INICacheVersion);
+	writeUnsignedInt(file, static_cast<UnsignedInt>(m_entries.size()));
+
+	for (INICacheMap::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+	{
+		writeUnsignedInt(file, static_cast<UnsignedInt>(it->first.getLength()));
+		file->write(it->first.str(), it->first.getLength());
+		const INICacheSource &source = it->second.m_source;
+		writeUnsignedInt(file, static_cast<UnsignedInt>(source.m_archive.getLength()));
+		file->write(source.m_archive.str(), source.m_archive.getLength());
+		writeUnsignedInt(file, source.m_offset);
+		writeUnsignedInt64(file, source.m_size);
+		writeUnsignedInt64(file, source.m_timestamp);
+		writeUnsignedInt(file, static_cast<UnsignedInt>(it->second.m_lines.size()));
+		file->write(it->second.m_lines.data(), static_cast<Int>(it->second.m_lines.size()));
+	}
+
+	file->close();
+	m_dirty = FALSE;
+
+	DEBUG_LOG(("INICache::save - wrote %d INI files to %s\n", static_cast<Int>(m_entries.size()), filename.str()));
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Looks the file up the same way FileSystem::openFile does, loose files first, without
+	* reading any of it.  Returns FALSE if the file can't be found. */
+//-------------------------------------------------------------------------------------------------
+Bool INICache::getSource( const AsciiString& filename, INICacheSource *source )
+{
+	FileInfo info;
+	if (!TheFileSystem->getFileLocation(filename, &source->m_archive, &source->m_offset, &info))
+		return FALSE;
+
+	source->m_size = info.size;
+	source->m_timestamp = info.timestamp;
+	return TRUE;
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+const INICacheEntry *INICache::find( const AsciiString& filename, const INICacheSource& source ) const
+{
+	AsciiString key = filename;
+	key.toLower();
+
+	INICacheMap::const_iterator it = m_entries.find(key);
+	if (it == m_entries.end() || !(it->second.m_source == source))
+		return NULL;
+
+	return &it->second;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Store the lexed lines of an INI file, replacing any stale entry.  The lines are swapped
+	* into the cache, so 'lines' is left empty. */
+//-------------------------------------------------------------------------------------------------
+const INICacheEntry *INICache::record( const AsciiString& filename, const INICacheSource& source, std::vector<char>& lines )
+{
+	AsciiString key = filename;
+	key.toLower();
+
+	INICacheEntry &entry = m_entries[key];
+	entry.m_source = source;
+	entry.m_lines.swap(lines);
+	lines.clear();
+
+	m_dirty = TRUE;
+
+	return &entry;
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+void INICache::addLoadTime( Bool fromCache, Real seconds )
+{
+	if (fromCache)
+	{
+		++m_cachedFiles;
+		m_cachedSeconds += seconds;
+	}
+	else
+	{
+		++m_parsedFiles;
+		m_parsedSeconds += seconds;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Compare a cold run (every file lexed and recorded) against a warm one (every file replayed)
+	* by looking at this report from two consecutive launches.  It goes to stdout, like the
+	* replay benchmark's report, so release and -headless runs show it too. */
+//-------------------------------------------------------------------------------------------------
+void INICache::reportTimings( void ) const
+{
+	printf("INICache: %d INI files parsed from source in %.3f seconds (%.3f ms/file)\n",
+		m_parsedFiles, m_parsedSeconds, m_parsedFiles ? 1000.0f * m_parsedSeconds / m_parsedFiles : 0.0f);
+	printf("INICache: %d INI files replayed from cache in %.3f seconds (%.3f ms/file)\n",
+		m_cachedFiles, m_cachedSeconds, m_cachedFiles ? 1000.0f * m_cachedSeconds / m_cachedFiles : 0.0f);
+	fflush(stdout);
+}
@@ -30,6 +30,8 @@
 
 #include "PreRTS.h"	// This must go first in EVERY cpp file int the GameEngine
 
+#include <chrono>
+
 // Public Data ////////////////////////////////////////////////////////////////////////////////////
 NameKeyGenerator *TheNameKeyGenerator = NULL;  ///< name key gen. singleton
 
@@ -39,8 +41,7 @@ NameKeyGenerator::NameKeyGenerator()
 
 	m_nextID = (UnsignedInt)NAMEKEY_INVALID;  // uninitialized system
 
-	for (Int i = 0; i < SOCKET_COUNT; ++i)
-		m_sockets[i] = NULL;
+	freeSockets();
 
 }  // end NameKeyGenerator
 
@@ -75,148 +76,266 @@ void NameKeyGenerator::reset()
 //------------------------------------------------------------------------------------------------- 
 void NameKeyGenerator::freeSockets()
 {
-	for (Int i = 0; i < SOCKET_COUNT; ++i)
-	{
-		Bucket *next;
-		for (Bucket *b = m_sockets[i]; b; b = next)
-		{
-			next = b->m_nextInSocket;
-			b->deleteInstance();
-		}
-		m_sockets[i] = NULL;
-	}
+	m_slots.assign(INITIAL_SLOT_COUNT, Slot());
+	m_names.clear();
+	m_hashes.clear();
 
 }  // end freeSockets
 
-/* ------------------------------------------------------------------------ */
-inline UnsignedInt calcHashForString(const char* p)
+//-------------------------------------------------------------------------------------------------
+/** The string hashes are cheap but leave the low bits poorly mixed, and the table is indexed
+	* by the low bits, so scramble them first */
+//-------------------------------------------------------------------------------------------------
+static inline UnsignedInt slotForHash(UnsignedInt hash, UnsignedInt mask)
 {
-	UnsignedInt result = 0; 
-	UnsignedByte *pp = (UnsignedByte*)p;
-	while (*pp) 
-		result = (result << 5) + result + *pp++; 
-	return result;
+	hash ^= hash >> 16;
+	hash *= 0x45d9f3bu;
+	hash ^= hash >> 16;
+	return hash & mask;
 }
 
-/* ------------------------------------------------------------------------ */
-inline UnsignedInt calcHashForLowercaseString(const char* p)
+//-------------------------------------------------------------------------------------------------
+/** Double the table and re-place every key, once it's half full */
+//-------------------------------------------------------------------------------------------------
+void NameKeyGenerator::grow()
 {
-	UnsignedInt result = 0; 
-	UnsignedByte *pp = (UnsignedByte*)p;
-	while (*pp) 
-		result = (result << 5) + result + static_cast<UnsignedInt>(tolower(*pp++)); 
-	return result;
-}
+	std::vector<Slot> slots(m_slots.size() * 2);
+	UnsignedInt mask = static_cast<UnsignedInt>(slots.size()) - 1;
+
+	for (size_t i = 0; i < m_hashes.size(); ++i)
+	{
+		UnsignedInt index = slotForHash(m_hashes[i], mask);
+		while (slots[index].m_key != NAMEKEY_INVALID)
+			index = (index + 1) & mask;
+		slots[index].m_hash = m_hashes[i];
+		slots[index].m_key = (NameKeyType)(i + 1);
+	}
+
+	m_slots.swap(slots);
+
+}  // end grow
 
 //------------------------------------------------------------------------------------------------- 
 AsciiString NameKeyGenerator::keyToName(NameKeyType key)
 {
-	for (Int i = 0; i < SOCKET_COUNT; ++i)
-	{
-		for (Bucket *b = m_sockets[i]; b; b = b->m_nextInSocket)
-		{
-			if (key == b->m_key)
-				return b->m_nameString;
-		}
-	}
-	return AsciiString::TheEmptyString;
+	if (key <= NAMEKEY_INVALID || static_cast<size_t>(key) > m_names.size())
+		return AsciiString::TheEmptyString;
+	return m_names[static_cast<size_t>(key) - 1];
 }
 
-//------------------------------------------------------------------------------------------------- 
-NameKeyType NameKeyGenerator::nameToKey(const char* nameString)
+//-------------------------------------------------------------------------------------------------
+/** Look up a name, making a new key for it if it's not there.  A key only matches a lookup of
+	* the same kind of hash, so a plain lookup of "foo" and a lowercase lookup of "FOO" share a key,
+	* while plain lookups of "foo" and "FOO" don't. */
+//-------------------------------------------------------------------------------------------------
+NameKeyType NameKeyGenerator::findOrInsert(const char* nameString, UnsignedInt hash, Bool lowercase)
 {
-	Bucket *b;
+	DEBUG_ASSERTCRASH(hash == (lowercase ? calcLowercaseHash(nameString) : calcHash(nameString)),
+		("NameKeyGenerator - precomputed hash for '%s' is wrong", nameString));
 
-	UnsignedInt hash = calcHashForString(nameString) % SOCKET_COUNT;
+	UnsignedInt mask = static_cast<UnsignedInt>(m_slots.size()) - 1;
+	UnsignedInt index = slotForHash(hash, mask);
+
+	++m_lookups;
 
 	// hmm, do we have it already?
-	for (b = m_sockets[hash]; b; b = b->m_nextInSocket)
+	for (;;)
 	{
-		if (strcmp(nameString, b->m_nameString.str()) == 0)
-			return b->m_key; 
+		++m_probes;
+
+		const Slot &slot = m_slots[index];
+		if (slot.m_key == NAMEKEY_INVALID)
+			break;
+
+		if (slot.m_hash == hash)
+		{
+			const char *existing = m_names[static_cast<size_t>(slot.m_key) - 1].str();
+			if ((lowercase ? strcasecmp(nameString, existing) : strcmp(nameString, existing)) == 0)
+				return slot.m_key;
+		}
+
+		index = (index + 1) & mask;
 	}
 
 	// nope, guess not. let's allocate it.
-	b = newInstance(Bucket);
-	b->m_key = (NameKeyType)m_nextID++;
-	b->m_nameString = nameString;
-	b->m_nextInSocket = m_sockets[hash];
-	m_sockets[hash] = b;
-
-	NameKeyType result = b->m_key;
-
-#if defined(_DEBUG) || defined(_INTERNAL)
-	// reality-check to be sure our hasher isn't going bad.
-	const Int maxThresh = 3;
-	Int numOverThresh = 0;
-	for (Int i = 0; i < SOCKET_COUNT; ++i)
-	{
-		Int numInThisSocket = 0;
-		for (b = m_sockets[i]; b; b = b->m_nextInSocket)
-			++numInThisSocket;
+	NameKeyType result = (NameKeyType)m_nextID++;
+	m_names.push_back(AsciiString(nameString));
+	m_hashes.push_back(hash);
+	m_slots[index].m_hash = hash;
+	m_slots[index].m_key = result;
 
-		if (numInThisSocket > maxThresh)
-			++numOverThresh;
-	}
-	
-	// if more than a small percent of the sockets are getting deep, probably want to increase the socket count.
-	if (numOverThresh > SOCKET_COUNT/20)
-	{
-		DEBUG_CRASH(("hmm, might need to increase the number of bucket-sockets for NameKeyGenerator (numOverThresh %d = %f%%)\n",numOverThresh,(Real)numOverThresh/(Real)(SOCKET_COUNT/20)));
-	}
-#endif
+	// keep probe sequences short
+	if (m_names.size() * 2 > m_slots.size())
+		grow();
 
 	return result;
 
+}  // end findOrInsert
+
+//------------------------------------------------------------------------------------------------- 
+NameKeyType NameKeyGenerator::nameToKey(const char* nameString)
+{
+	return findOrInsert(nameString, calcHash(nameString), FALSE);
+
 }  // end nameToKey
 
 //------------------------------------------------------------------------------------------------- 
 NameKeyType NameKeyGenerator::nameToLowercaseKey(const char* nameString)
 {
-	Bucket *b;
+	return findOrInsert(nameString, calcLowercaseHash(nameString), TRUE);
 
-	UnsignedInt hash = calcHashForLowercaseString(nameString) % SOCKET_COUNT;
+}  // end nameToLowercaseKey
 
-	// hmm, do we have it already?
-	for (b = m_sockets[hash]; b; b = b->m_nextInSocket)
+//-------------------------------------------------------------------------------------------------
+/** Compare a load against an earlier one by looking at this report from each */
+//-------------------------------------------------------------------------------------------------
+void NameKeyGenerator::reportStatistics() const
+{
+	DEBUG_LOG(("NameKeyGenerator: %d keys in %d slots, %d lookups averaging %f probes\n",
+		static_cast<Int>(m_names.size()), static_cast<Int>(m_slots.size()), m_lookups,
+		m_lookups ? static_cast<Real>(m_probes) / static_cast<Real>(m_lookups) : 0.0f));
+}
+
+//-------------------------------------------------------------------------------------------------
+static Int64 nameKeyNanos()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//-------------------------------------------------------------------------------------------------
+/** The chained sockets the table replaced, rebuilt from our keys so the same lookups can be
+	* timed both ways */
+//-------------------------------------------------------------------------------------------------
+struct ChainedNameKeys
+{
+	enum { SOCKET_COUNT = 45007 };
+
+	struct Bucket
+	{
+		Int						m_nextInSocket;		///< index into m_buckets, -1 at the end of the chain
+		NameKeyType		m_key;
+		const char		*m_name;
+	};
+
+	std::vector<Int>		m_sockets;
+	std::vector<Bucket>	m_buckets;
+
+	ChainedNameKeys() : m_sockets(SOCKET_COUNT, -1), m_buckets() { }
+
+	void add(const char *name, NameKeyType key, UnsignedInt hash)
 	{
-		if (strcasecmp(nameString, b->m_nameString.str()) == 0)
-			return b->m_key; 
+		Int &socket = m_sockets[hash % SOCKET_COUNT];
+		Bucket b = { socket, key, name };
+		socket = static_cast<Int>(m_buckets.size());
+		m_buckets.push_back(b);
 	}
 
-	// nope, guess not. let's allocate it.
-	b = newInstance(Bucket);
-	b->m_key = (NameKeyType)m_nextID++;
-	b->m_nameString = nameString;
-	b->m_nextInSocket = m_sockets[hash];
-	m_sockets[hash] = b;
-
-	NameKeyType result = b->m_key;
-
-#if defined(_DEBUG) || defined(_INTERNAL)
-	// reality-check to be sure our hasher isn't going bad.
-	const Int maxThresh = 3;
-	Int numOverThresh = 0;
-	for (Int i = 0; i < SOCKET_COUNT; ++i)
+	NameKeyType find(const char *name, Bool lowercase) const
 	{
-		Int numInThisSocket = 0;
-		for (b = m_sockets[i]; b; b = b->m_nextInSocket)
-			++numInThisSocket;
+		UnsignedInt hash = lowercase ? NameKeyGenerator::calcLowercaseHash(name) : NameKeyGenerator::calcHash(name);
+		for (Int i = m_sockets[hash % SOCKET_COUNT]; i >= 0; i = m_buckets[static_cast<size_t>(i)].m_nextInSocket)
+		{
+			const Bucket &b = m_buckets[static_cast<size_t>(i)];
+			if ((lowercase ? strcasecmp(name, b.m_name) : strcmp(name, b.m_name)) == 0)
+				return b.m_key;
+		}
+		return NAMEKEY_INVALID;
+	}
 
-		if (numInThisSocket > maxThresh)
-			++numOverThresh;
+	/// the old keyToName looked at every bucket
+	const char *findName(NameKeyType key) const
+	{
+		for (size_t s = 0; s < SOCKET_COUNT; ++s)
+		{
+			for (Int i = m_sockets[s]; i >= 0; i = m_buckets[static_cast<size_t>(i)].m_nextInSocket)
+			{
+				const Bucket &b = m_buckets[static_cast<size_t>(i)];
+				if (b.m_key == key)
+					return b.m_name;
+			}
+		}
+		return "";
 	}
-	
-	// if more than a small percent of the sockets are getting deep, probably want to increase the socket count.
-	if (numOverThresh > SOCKET_COUNT/20)
+};
+
+//-------------------------------------------------------------------------------------------------
+/** Look up every key we have by name, through the table and through the old chained sockets,
+	* and report the time for each.  Run once the INIs are loaded, when most keys exist. */
+//-------------------------------------------------------------------------------------------------
+void NameKeyGenerator::reportBenchmark()
+{
+	static const Int PASSES = 20;
+	static const Int KEY_TO_NAME_SAMPLES = 500;
+
+	std::vector<Bool> lowercase(m_names.size());
+	ChainedNameKeys chained;
+	for (size_t i = 0; i < m_names.size(); ++i)
 	{
-		DEBUG_CRASH(("hmm, might need to increase the number of bucket-sockets for NameKeyGenerator (numOverThresh %d = %f%%)\n",numOverThresh,(Real)numOverThresh/(Real)(SOCKET_COUNT/20)));
+		lowercase[i] = m_hashes[i] != calcHash(m_names[i].str());
+		chained.add(m_names[i].str(), (NameKeyType)(i + 1), m_hashes[i]);
 	}
-#endif
 
-	return result;
+	// every name is already in the table, so none of these make a new key
+	Int mismatches = 0;
+	UnsignedInt probes = m_probes;
+	UnsignedInt lookups = m_lookups;
+	Int64 tableNanos = nameKeyNanos();
+	for (Int pass = 0; pass < PASSES; ++pass)
+	{
+		for (size_t i = 0; i < m_names.size(); ++i)
+		{
+			const char *name = m_names[i].str();
+			NameKeyType key = lowercase[i] ? nameToLowercaseKey(name) : nameToKey(name);
+			if (key != (NameKeyType)(i + 1))
+				++mismatches;
+		}
+	}
+	tableNanos = nameKeyNanos() - tableNanos;
+	probes = m_probes - probes;
+	lookups = m_lookups - lookups;
 
-}  // end nameToLowercaseKey
+	Int64 chainedNanos = nameKeyNanos();
+	for (Int pass = 0; pass < PASSES; ++pass)
+	{
+		for (size_t i = 0; i < m_names.size(); ++i)
+		{
+			if (chained.find(m_names[i].str(), lowercase[i]) != (NameKeyType)(i + 1))
+				++mismatches;
+		}
+	}
+	chainedNanos = nameKeyNanos() - chainedNanos;
+
+	// keyToName, spread over the keys
+	Int samples = std::min(KEY_TO_NAME_SAMPLES, static_cast<Int>(m_names.size()));
+	size_t step = samples > 0 ? m_names.size() / static_cast<size_t>(samples) : 1;
+	Int64 indexNanos = nameKeyNanos();
+	for (Int s = 0; s < samples; ++s)
+	{
+		NameKeyType key = (NameKeyType)(static_cast<size_t>(s) * step + 1);
+		if (keyToName(key).isEmpty())
+			++mismatches;
+	}
+	indexNanos = nameKeyNanos() - indexNanos;
+
+	Int64 scanNanos = nameKeyNanos();
+	for (Int s = 0; s < samples; ++s)
+	{
+		NameKeyType key = (NameKeyType)(static_cast<size_t>(s) * step + 1);
+		if (*chained.findName(key) == 0)
+			++mismatches;
+	}
+	scanNanos = nameKeyNanos() - scanNanos;
+
+	double nameLookups = (double)m_names.size() * PASSES;
+	printf("NameKeyGenerator: %d keys, %d slots, %d passes\n", static_cast<Int>(m_names.size()), static_cast<Int>(m_slots.size()), PASSES);
+	printf("  nameToKey   table %.3f ms (%.1f ns/lookup, %.2f probes), chained sockets %.3f ms (%.1f ns/lookup)\n",
+		tableNanos / 1.0e6, nameLookups > 0 ? tableNanos / nameLookups : 0.0, lookups ? (double)probes / lookups : 0.0,
+		chainedNanos / 1.0e6, nameLookups > 0 ? chainedNanos / nameLookups : 0.0);
+	printf("  keyToName   index %.1f ns, socket scan %.1f ns per lookup (%d samples)\n",
+		samples > 0 ? (double)indexNanos / samples : 0.0, samples > 0 ? (double)scanNanos / samples : 0.0, samples);
+	printf("  %d lookups found the wrong key\n", mismatches);
+	fflush(stdout);
+}
 
 //------------------------------------------------------------------------------------------------- 
 // Get a string out of the INI. Store it into a NameKeyType
@@ -234,7 +353,7 @@ NameKeyType StaticNameKey::key() const
 	{
 		DEBUG_ASSERTCRASH(TheNameKeyGenerator, ("no TheNameKeyGenerator yet"));
 		if (TheNameKeyGenerator)
-			m_key = TheNameKeyGenerator->nameToKey(m_name);
+			m_key = TheNameKeyGenerator->nameToKey(m_name, m_hash);
 	}
 	return m_key;
 }
@@ -35,20 +35,8 @@
 #include "GameClient/Display.h"
 #include "GameClient/GraphDraw.h"
 
-__forceinline void ProfileGetTime(__int64 &t)
-{
-  _asm
-  {
-    mov ecx,[t]
-    push eax
-    push edx
-    rdtsc
-    mov [ecx],eax
-    mov [ecx+4],edx
-    pop edx
-    pop eax
-  };
-}
+#include <atomic>
+#include <mutex>
 
 #ifdef _INTERNAL
 // for occasional debugging...
@@ -73,141 +61,80 @@ void GetPrecisionTimerTicksPerSec(Int64* t)
 	*t = s_ticksPerSec;
 }
 
-//Kris: Plugged in Martin's code to optimize timer setup.
-#define HOFFESOMMER_REPLACEMENT_CODE
+//-------------------------------------------------------------------------------------------------
+static Int64 getMonotonicNanoseconds()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+	return static_cast<Int64>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
 
 //-------------------------------------------------------------------------------------------------
 void InitPrecisionTimer()
 {
-#ifdef HOFFESOMMER_REPLACEMENT_CODE
-
-  // measure clock cycles 3 times for 20 msec each
-  // then take the 2 counts that are closest, average
-  _int64 n[ 3 ];
-  for( int k = 0; k < 3; k++ )
-  {
-    // wait for end of current tick
-    unsigned timeEnd = timeGetTime() + 2;
-    while( timeGetTime() < timeEnd ); //do nothing
- 
-    // get cycles
-    _int64 start, startQPC, endQPC;
-    QueryPerformanceCounter( (LARGE_INTEGER *)&startQPC );
-    ProfileGetTime( start );
-    timeEnd += 20;
-    while( timeGetTime() < timeEnd ); //do nothing
-    ProfileGetTime( n[ k ] );
-    n[ k ] -= start;
- 
-    // convert to 1 second
-    if( QueryPerformanceCounter( (LARGE_INTEGER*)&endQPC ) )
-    {
-      QueryPerformanceFrequency( (LARGE_INTEGER*)&s_ticksPerSec );
-      n[ k ] = ( n[ k ] * s_ticksPerSec ) / ( endQPC - startQPC );
-    }
-    else
-    {
-      n[ k ] = ( n[ k ] * 1000 ) / 20;
-    }
-  }
- 
-  // find two closest values
-  _int64 d01 = n[ 1 ] - n[ 0 ];
-	_int64 d02 = n[ 2 ] - n[ 0 ];
-	_int64 d12 = n[ 2 ] - n[ 1 ];
-
-  if( d01 < 0 )
+#ifdef PERF_TIMER_USE_RDTSC
+
+	// Martin's trick: measure clock cycles 3 times for 20 msec each,
+	// then take the 2 counts that are closest, average
+	const Int64 SAMPLE_NSEC = 20 * 1000000;
+	Int64 n[ 3 ];
+	for( int k = 0; k < 3; k++ )
+	{
+		Int64 start, end;
+		Int64 startNsec = getMonotonicNanoseconds();
+		GetPrecisionTimer( &start );
+		Int64 endNsec;
+		do
+		{
+			endNsec = getMonotonicNanoseconds();
+		} while( endNsec - startNsec < SAMPLE_NSEC );
+		GetPrecisionTimer( &end );
+
+		// convert to 1 second
+		n[ k ] = ( ( end - start ) * 1000000000 ) / ( endNsec - startNsec );
+	}
+
+	// find two closest values
+	Int64 d01 = n[ 1 ] - n[ 0 ];
+	Int64 d02 = n[ 2 ] - n[ 0 ];
+	Int64 d12 = n[ 2 ] - n[ 1 ];
+
+	if( d01 < 0 )
 	{
 		d01 = -d01;
 	}
-  if( d02 < 0 ) 
+	if( d02 < 0 ) 
 	{
 		d02 = -d02;
 	}
-  if( d12 < 0 )
+	if( d12 < 0 )
 	{
 		d12 = -d12;
 	}
 
-  _int64 avg;
-  if( d01 < d02 )
-  {
-    avg = d01 < d12 ? n[ 0 ] + n[ 1 ] : n[ 1 ] + n[ 2 ];
-  }
-  else
-  {
-    avg = d02 < d12 ? n[ 0 ] + n[ 2 ] : n[ 1 ] + n[ 2 ];
-  }
+	Int64 avg;
+	if( d01 < d02 )
+	{
+		avg = d01 < d12 ? n[ 0 ] + n[ 1 ] : n[ 1 ] + n[ 2 ];
+	}
+	else
+	{
+		avg = d02 < d12 ? n[ 0 ] + n[ 2 ] : n[ 1 ] + n[ 2 ];
+	}
 
-	//s_ticksPerMSec = 1.0 * TotalTicks / totalTime;
-	s_ticksPerMSec = avg / 2000.0f;
-	s_ticksPerSec = s_ticksPerMSec * 1000.0f;
-	s_ticksPerUSec = s_ticksPerSec / 1000000.0f;
+	s_ticksPerSec = avg / 2;
 
-	
 #else
 
-	//Kris: With total disrespect, this code costs 5 real seconds of init time
-	//whenever we fire up the game.
-
-	#ifdef USE_QPF
-		QueryPerformanceFrequency((LARGE_INTEGER*)&s_ticksPerSec);
-	#else
-		// Init the precision timers
-		Int64 totalTime = 0;
-		Int64	TotalTicks = 0;
-		static int TESTS = 5;
-		
-		for (int i = 0; i < TESTS; ++i) 
-		{
-			int        TimeStart;
-			int        TimeStop;
-			Int64		   StartTicks;
-			Int64		   EndTicks;
-
-			TimeStart = timeGetTime();
-			GetPrecisionTimer(&StartTicks);
-			for(;;)
-			{
-				TimeStop = timeGetTime();
-				if ((TimeStop - TimeStart) > 1000)
-				{
-					GetPrecisionTimer(&EndTicks);
-					break;
-				}
-			}
-
-			TotalTicks += (EndTicks - StartTicks);
+	// the ticks are nanoseconds already
+	s_ticksPerSec = 1000000000;
 
-			totalTime += (TimeStop - TimeStart);
-		}
-
-		s_ticksPerMSec = 1.0 * TotalTicks / totalTime;
-		s_ticksPerSec = s_ticksPerMSec * 1000.0f;
-	#endif
-		s_ticksPerMSec = s_ticksPerSec / 1000.0f;
-		s_ticksPerUSec = s_ticksPerSec / 1000000.0f;
-
-	#ifdef NOT_IN_USE
-		Int64 bogus[8];
-		GetPrecisionTimer(&start);
-		for (Int ii = 0; ii < ITERS; ++ii)
-		{
-			GetPrecisionTimer(&bogus[0]);
-			GetPrecisionTimer(&bogus[1]);
-			GetPrecisionTimer(&bogus[2]);
-			GetPrecisionTimer(&bogus[3]);
-			GetPrecisionTimer(&bogus[4]);
-			GetPrecisionTimer(&bogus[5]);
-			GetPrecisionTimer(&bogus[6]);
-			GetPrecisionTimer(&bogus[7]);
-		}
-		TheTicksToGetTicks = (bogus[7] - start) / (ITERS*8);
-		DEBUG_LOG(("TheTicksToGetTicks is %d (%f usec)\n",(int)TheTicksToGetTicks,TheTicksToGetTicks/s_ticksPerUSec));
-	#endif
-		
 #endif
 
+	s_ticksPerMSec = s_ticksPerSec / 1000.0;
+	s_ticksPerUSec = s_ticksPerSec / 1000000.0;
+
+	DEBUG_LOG(("InitPrecisionTimer: %lld ticks per second\n", (long long)s_ticksPerSec));
 }
 #endif // defined(PERF_TIMERS) || defined(DUMP_PERF_STATS)
 
@@ -233,13 +160,13 @@ typedef std::vector< std::pair< AsciiString, AsciiString > > StringPairVec;
 class PerfMetricsOutput
 {
 private:
-	StringPairVec m_outputStats;
+	StringPairVec m_outputStats {};
 
 public:
 
 	AsciiString& getStatsString(const AsciiString& id)
 	{
-		for (int i = 0; i < m_outputStats.size(); ++i) 
+		for (size_t i = 0; i < m_outputStats.size(); ++i) 
 		{
 			if (m_outputStats[i].first == id) 
 				return m_outputStats[i].second;
@@ -252,11 +179,11 @@ public:
 
 	void clearStatsString(const AsciiString& id)
 	{
-		for (int i = 0; i < m_outputStats.size(); ++i) 
+		for (size_t i = 0; i < m_outputStats.size(); ++i) 
 		{
 			if (m_outputStats[i].first == id) 
 			{
-				m_outputStats.erase(&m_outputStats[i]);
+				m_outputStats.erase(m_outputStats.begin() + (Int)i);
 				return;
 			}
 		}
@@ -272,9 +199,47 @@ static Int s_perfDumpOptions = 0;
 static UnsignedInt s_lastDumpedFrame = 0;
 static char s_buf[256] = "";
 
-PerfGather*		PerfGather::m_active[MAX_ACTIVE_STACK] = { 0 };
-PerfGather**	PerfGather::m_activeHead = &PerfGather::m_active[0];
-Int64					PerfGather::s_stopStartOverhead = -1;
+thread_local PerfGather*	PerfGather::m_active[MAX_ACTIVE_STACK] = { 0 };
+thread_local Int					PerfGather::m_activeDepth = 0;
+Int64											PerfGather::s_stopStartOverhead = -1;
+Bool											PerfGather::s_tracing = false;
+
+//-------------------------------------------------------------------------------------------------
+// Trace export. Every thread that stops a timer while tracing is on gets its own ring of events,
+// which only that thread writes; flushPerfTrace (called once a frame from the main thread) drains
+// all of them into a Chrome trace-event file. A thread that records more than a ring's worth of
+// scopes between flushes loses the oldest ones.
+
+struct PerfTraceEvent
+{
+	const char*		m_identifier;
+	Int64					m_startTime;
+	Int64					m_endTime;
+};
+
+class PerfTraceBuffer
+{
+public:
+	enum { SIZE = 1 << 15 };		// must be a power of 2
+
+	PerfTraceBuffer(Int threadIndex) : m_threadIndex(threadIndex) { }
+
+	// No copies allowed!
+	PerfTraceBuffer(const PerfTraceBuffer&) = delete;
+	PerfTraceBuffer& operator=(const PerfTraceBuffer&) = delete;
+
+	PerfTraceEvent							m_events[SIZE] {};
+	std::atomic<UnsignedInt>		m_written {};		///< events ever written, by the owning thread only
+	UnsignedInt									m_read {};			///< events already flushed, by the flushing thread only
+	Int													m_threadIndex {};
+};
+
+static std::mutex s_traceMutex;
+static std::vector<PerfTraceBuffer*> s_traceBuffers;	// never freed; threads may still hold them at exit
+static thread_local PerfTraceBuffer* s_threadTraceBuffer = NULL;
+static FILE* s_perfTraceFile = NULL;
+static Int64 s_traceStartTime = 0;
+static Bool s_traceFirstEvent = true;
 
 
 //-------------------------------------------------------------------------------------------------
@@ -318,19 +283,17 @@ void PerfGather::removeFromList()
 }
 
 //-------------------------------------------------------------------------------------------------
-PerfGather::PerfGather(const char *identifier) : 
+PerfGather::PerfGather(const char *identifier, Bool netOnly) : 
 	m_identifier(identifier), 
 	m_startTime(0), 
 	m_runningTimeGross(0), 
 	m_runningTimeNet(0), 
 	m_callCount(0),
 	m_next(0),
-	m_prev(0)
+	m_prev(0),
+	m_ignore(FALSE),
+	m_netTimeOnly(netOnly)
 {
-	//Added By Sadullah Nader
-	//Initializations inserted 
-	m_ignore = FALSE;
-	//
 	DEBUG_ASSERTCRASH(strchr(m_identifier, ',') == NULL, ("PerfGather names must not contain commas"));
 	addToList();
 }
@@ -350,15 +313,215 @@ void PerfGather::reset()
 	m_callCount = 0;
 }
 
+//-------------------------------------------------------------------------------------------------
+/*static*/ void PerfGather::recordTraceEvent(const char *identifier, Int64 startTime, Int64 endTime)
+{
+	PerfTraceBuffer *buf = s_threadTraceBuffer;
+	if (buf == NULL)
+	{
+		std::lock_guard<std::mutex> lock(s_traceMutex);
+		buf = new PerfTraceBuffer((Int)s_traceBuffers.size());
+		s_traceBuffers.push_back(buf);
+		s_threadTraceBuffer = buf;
+	}
+
+	UnsignedInt written = buf->m_written.load(std::memory_order_relaxed);
+	PerfTraceEvent& ev = buf->m_events[written & (PerfTraceBuffer::SIZE - 1)];
+	ev.m_identifier = identifier;
+	ev.m_startTime = startTime;
+	ev.m_endTime = endTime;
+	buf->m_written.store(written + 1, std::memory_order_release);
+}
+
+//-------------------------------------------------------------------------------------------------
+/*static*/ void PerfGather::initPerfTrace(const char* fname)
+{
+	PerfGather::termPerfTrace();
+
+	char tmp[256];
+	snprintf(tmp, sizeof(tmp), "%s.json", fname);
+
+	s_perfTraceFile = fopen(tmp, "w");
+	if (s_perfTraceFile == NULL)
+	{
+		DEBUG_CRASH(("could not open/create perf trace file %s",tmp));
+		return;
+	}
+
+	fprintf(s_perfTraceFile, "[\n");
+	s_traceFirstEvent = true;
+	GetPrecisionTimer(&s_traceStartTime);
+
+	// skip anything recorded by an earlier trace
+	{
+		std::lock_guard<std::mutex> lock(s_traceMutex);
+		for (size_t i = 0; i < s_traceBuffers.size(); ++i)
+			s_traceBuffers[i]->m_read = s_traceBuffers[i]->m_written.load(std::memory_order_acquire);
+	}
+
+	s_tracing = true;
+}
+
+//-------------------------------------------------------------------------------------------------
+/*static*/ void PerfGather::flushPerfTrace()
+{
+	if (!s_perfTraceFile)
+		return;
+
+	std::lock_guard<std::mutex> lock(s_traceMutex);
+	for (size_t i = 0; i < s_traceBuffers.size(); ++i)
+	{
+		PerfTraceBuffer *buf = s_traceBuffers[i];
+		UnsignedInt written = buf->m_written.load(std::memory_order_acquire);
+		UnsignedInt read = buf->m_read;
+		if (written - read > PerfTraceBuffer::SIZE)
+			read = written - PerfTraceBuffer::SIZE;
+
+		for (; read != written; ++read)
+		{
+			PerfTraceEvent ev = buf->m_events[read & (PerfTraceBuffer::SIZE - 1)];
+
+			// the owning thread may have lapped us while we were copying; drop anything it reused.
+			// once it has written SIZE more, it may already be writing this slot again.
+			if (buf->m_written.load(std::memory_order_acquire) - read >= PerfTraceBuffer::SIZE)
+				continue;
+
+			if (ev.m_startTime < s_traceStartTime)
+				continue;
+
+			fprintf(s_perfTraceFile, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+				s_traceFirstEvent ? "" : ",\n",
+				ev.m_identifier,
+				buf->m_threadIndex,
+				(ev.m_startTime - s_traceStartTime) / s_ticksPerUSec,
+				(ev.m_endTime - ev.m_startTime) / s_ticksPerUSec);
+			s_traceFirstEvent = false;
+		}
+		buf->m_read = written;
+	}
+	fflush(s_perfTraceFile);
+}
+
+//-------------------------------------------------------------------------------------------------
+/*static*/ void PerfGather::termPerfTrace()
+{
+	if (!s_perfTraceFile)
+		return;
+
+	flushPerfTrace();
+	s_tracing = false;
+
+	std::lock_guard<std::mutex> lock(s_traceMutex);
+	for (size_t i = 0; i < s_traceBuffers.size(); ++i)
+	{
+		Int tid = s_traceBuffers[i]->m_threadIndex;
+		fprintf(s_perfTraceFile, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s %d\"}}",
+			s_traceFirstEvent ? "" : ",\n", tid, tid == 0 ? "Main" : "Worker", tid);
+		s_traceFirstEvent = false;
+	}
+	fprintf(s_perfTraceFile, "\n]\n");
+	fclose(s_perfTraceFile);
+	s_perfTraceFile = NULL;
+}
+
+//-------------------------------------------------------------------------------------------------
+void PerfGather::addFrameToHistogram()
+{
+	Int64 usec = (Int64)(m_runningTimeGross / s_ticksPerUSec);
+	Int bucket = 0;
+	while (usec > 0 && bucket < HISTOGRAM_BUCKETS - 1)
+	{
+		usec >>= 1;
+		++bucket;
+	}
+	++m_histogram[bucket];
+}
+
+//-------------------------------------------------------------------------------------------------
+/*static*/ void PerfGather::writeHistograms()
+{
+	char tmp[256];
+	snprintf(tmp, sizeof(tmp), "%sHistogram.csv", s_buf);
+
+	FILE* fp = fopen(tmp, "w");
+	if (fp == NULL)
+	{
+		DEBUG_CRASH(("could not open/create perf histogram file %s -- is it open in another app?",tmp));
+		return;
+	}
+
+	fprintf(fp, "Timer");
+	for (Int i = 0; i < HISTOGRAM_BUCKETS; ++i)
+	{
+		fprintf(fp, ",<%dus", 1 << i);
+	}
+	fprintf(fp, "\n");
+
+	for (PerfGather* head = getHeadPtr(); head != NULL; head = head->m_next)
+	{
+		fprintf(fp, "%s", head->m_identifier);
+		for (Int i = 0; i < HISTOGRAM_BUCKETS; ++i)
+		{
+			fprintf(fp, ",%u", head->m_histogram[i]);
+			head->m_histogram[i] = 0;
+		}
+		fprintf(fp, "\n");
+	}
+
+	fclose(fp);
+}
+
 //-------------------------------------------------------------------------------------------------
 /*static*/ void PerfGather::resetAll()
 {
 	for (PerfGather* head = getHeadPtr(); head != NULL; head = head->m_next)
 	{
+		head->m_totalTimeGross += head->m_runningTimeGross;
+		head->m_totalTimeNet += head->m_runningTimeNet;
+		head->m_totalCallCount += head->m_callCount;
 		head->reset();
 	}
 }
 
+//-------------------------------------------------------------------------------------------------
+/*static*/ void PerfGather::clearTotals()
+{
+	for (PerfGather* head = getHeadPtr(); head != NULL; head = head->m_next)
+	{
+		head->m_totalTimeGross = 0;
+		head->m_totalTimeNet = 0;
+		head->m_totalCallCount = 0;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+/*static*/ AsciiString PerfGather::reportTotals(Int frames)
+{
+	const Int MAX_REPORTED = 25;
+
+	std::vector<const PerfGather*> gathers;
+	for (const PerfGather* head = getHeadPtr(); head != NULL; head = head->m_next)
+	{
+		if (head->m_totalCallCount > 0)
+			gathers.push_back(head);
+	}
+	std::sort(gathers.begin(), gathers.end(), 
+		[](const PerfGather* a, const PerfGather* b) { return a->m_totalTimeNet > b->m_totalTimeNet; });
+
+	double perFrame = frames > 0 ? 1.0 / frames : 0.0;
+	AsciiString report, line;
+	if (s_stopStartOverhead >= 0)
+		report.format("  perf timers: %.1f nsec per start/stop%s\n", s_stopStartOverhead * 1000.0 / s_ticksPerUSec, s_tracing ? ", tracing" : "");
+	for (size_t i = 0; i < gathers.size() && i < (size_t)MAX_REPORTED; ++i)
+	{
+		const PerfGather* g = gathers[i];
+		line.format("  %-40s net %8.3f msec/frame, gross %8.3f msec/frame, %8.1f calls/frame\n", g->m_identifier,
+			g->m_totalTimeNet / s_ticksPerMSec * perFrame, g->m_totalTimeGross / s_ticksPerMSec * perFrame, g->m_totalCallCount * perFrame);
+		report.concat(line);
+	}
+	return report;
+}
+
 //-------------------------------------------------------------------------------------------------
 /*static*/ void PerfGather::initPerfDump(const char* fname, Int options)
 {
@@ -491,6 +654,12 @@ void PerfGather::reset()
 		fprintf(s_perfStatsFile, "\n");
 		fflush(s_perfStatsFile);
 
+		for (PerfGather* head = getHeadPtr(); head != NULL; head = head->m_next)
+		{
+			if (head->m_callCount > 0)
+				head->addFrameToHistogram();
+		}
+
 		s_lastDumpedFrame = frame;
 
 	}
@@ -555,6 +724,7 @@ void PerfGather::reset()
 {
 	if (s_perfStatsFile)
 	{
+		writeHistograms();
 		fflush(s_perfStatsFile);
 		fclose(s_perfStatsFile);
 		s_perfStatsFile = NULL;
@@ -570,21 +740,19 @@ void PerfGather::reset()
 PerfTimer::PerfTimer( const char *identifier, Bool crashWithInfo, Int startFrame, Int endFrame) :
 	m_identifier(identifier), 
 	m_crashWithInfo(crashWithInfo), 
-	m_startFrame(startFrame), 
-	m_endFrame(endFrame),
-	m_callCount(0),
-	m_runningTime(0),
+	m_startFrame((UnsignedInt)startFrame), 
+	m_endFrame((UnsignedInt)endFrame),
+	m_lastFrame(NO_END_FRAME),
 	m_outputInfo(true),
-	//Added By Sadullah Nader
-	//Intializations inserted
-	m_lastFrame(-1)
+	m_runningTime(0),
+	m_callCount(0)
 {
 }
 
 //-------------------------------------------------------------------------------------------------
 PerfTimer::~PerfTimer( )
 {
-	if (m_endFrame == -1) {
+	if (m_endFrame == NO_END_FRAME) {
 		outputInfo();
 	}
 }
@@ -592,11 +760,11 @@ PerfTimer::~PerfTimer( )
 //-------------------------------------------------------------------------------------------------
 void PerfTimer::outputInfo( void )
 {
-	if (TheGlobalData->m_showMetrics) {
+	if (TheGlobalData->m_data.m_showMetrics) {
 		return;
 	}
 
-	if (m_outputInfo && !TheGlobalData->m_showMetrics) {
+	if (m_outputInfo && !TheGlobalData->m_data.m_showMetrics) {
 		m_outputInfo = false;
 	} else {
 		return;
@@ -645,11 +813,9 @@ void PerfTimer::outputInfo( void )
 //-------------------------------------------------------------------------------------------------
 void PerfTimer::showMetrics( void )
 {
-#if defined(_DEBUG) || defined(_INTERNAL)
 	double totalTimeInMS = 1000.0 * m_runningTime / s_ticksPerSec;
 	double avgTimePerFrame = totalTimeInMS / (m_lastFrame - m_startFrame + 1);
 	double avgTimePerCall = totalTimeInMS / m_callCount;
-#endif
 
 	// we want to work on the thing in the array, so just store a reference.
 	AsciiString &outputStats = s_output.getStatsString(m_identifier);
@@ -667,13 +833,13 @@ void PerfTimer::showMetrics( void )
 }
 
 //-------------------------------------------------------------------------------StatMetricsDisplay
-void StatMetricsDisplay( DebugDisplayInterface *dd, void *, FILE *fp )
+void StatMetricsDisplay( DebugDisplayInterface *dd, void *, FILE * )
 {
 	dd->printf("Performance Metrics: \n");
 	// no copies will take place because we are storing a reference to the thing
 	StringPairVec &stats = s_output.friend_getAllStatsStrings();
 
-	for (int i = 0; i < stats.size(); ++i) {
+	for (size_t i = 0; i < stats.size(); ++i) {
 		dd->printf("%s", stats[i].second.str());
 	}
 }
@@ -224,10 +224,116 @@ PlayerRelationMap::~PlayerRelationMap( void )
 {
 
 	// make sure the data is cleared
-	m_map.clear();
+	clear();
 
 }  // end ~PlayerRelationmap
 
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PlayerRelationMap::setRelationship( PlayerIndex playerIndex, Relationship r )
+{
+
+	// note that this creates the entry if it doesn't exist.
+	m_map[ playerIndex ] = r;
+	if( (UnsignedInt)playerIndex < MAX_PLAYER_COUNT )
+	{
+		m_relations[ playerIndex ] = r;
+		m_hasRelation |= (1u << playerIndex);
+	}
+
+}  // end setRelationship
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+Bool PlayerRelationMap::removeRelationship( PlayerIndex playerIndex )
+{
+
+	PlayerRelationMapType::iterator it = m_map.find( playerIndex );
+	if( it == m_map.end() )
+		return FALSE;
+
+	m_map.erase( it );
+	if( (UnsignedInt)playerIndex < MAX_PLAYER_COUNT )
+		m_hasRelation &= ~(1u << playerIndex);
+	return TRUE;
+
+}  // end removeRelationship
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+Bool PlayerRelationMap::clear( void )
+{
+
+	if( m_map.empty() )
+		return FALSE;
+
+	m_map.clear();
+	m_hasRelation = 0;
+	return TRUE;
+
+}  // end clear
+
+// ------------------------------------------------------------------------------------------------
+// Dense relationship lookups checked against the map, for ReplayBenchmark; see
+// PlayerRelationMap::reportDenseCopyChecks.
+// ------------------------------------------------------------------------------------------------
+struct DenseCopyCounts
+{
+	UnsignedInt		m_agreements;
+	UnsignedInt		m_disagreements;
+};
+static DenseCopyCounts s_denseCopyCounts;
+
+Bool PlayerRelationMap::s_checkDenseCopies = FALSE;
+
+// ------------------------------------------------------------------------------------------------
+/** Check that a dense lookup gives what the map would have */
+// ------------------------------------------------------------------------------------------------
+void PlayerRelationMap::checkDenseCopy( PlayerIndex playerIndex ) const
+{
+
+	PlayerRelationMapType::const_iterator it = m_map.find( playerIndex );
+	Bool inTable = (m_hasRelation & (1u << playerIndex)) != 0;
+	Bool agrees;
+	if( it == m_map.end() )
+		agrees = !inTable;
+	else
+		agrees = inTable && m_relations[ playerIndex ] == (*it).second;
+
+	if( agrees )
+	{
+		++s_denseCopyCounts.m_agreements;
+	}
+	else
+	{
+		++s_denseCopyCounts.m_disagreements;
+		DEBUG_CRASH( ("PlayerRelationMap: dense table out of step for player %d\n", playerIndex) );
+	}
+
+}  // end checkDenseCopy
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+AsciiString PlayerRelationMap::reportDenseCopyChecks( Int frames )
+{
+	AsciiString report;
+	UnsignedInt checks = s_denseCopyCounts.m_agreements + s_denseCopyCounts.m_disagreements;
+	if( checks == 0 )
+		return report;
+
+	report.format( "  player relations: %u dense lookups checked against the map (%.2f/frame), %u agreed, %u disagreed\n",
+		checks, frames > 0 ? (double)checks / frames : 0.0, s_denseCopyCounts.m_agreements, s_denseCopyCounts.m_disagreements );
+	return report;
+}
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void PlayerRelationMap::resetDenseCopyChecks( void )
+{
+	memset( &s_denseCopyCounts, 0, sizeof( s_denseCopyCounts ) );
+	s_checkDenseCopies = TRUE;
+}
+
 // ------------------------------------------------------------------------------------------------
 /** CRC */
 // ------------------------------------------------------------------------------------------------
@@ -289,7 +395,7 @@ void PlayerRelationMap::xfer( Xfer *xfer )
 			xfer->xferUser( &r, sizeof( Relationship ) );
 
 			// assign relationship
-			m_map[ playerIndex ] = r;
+			setRelationship( playerIndex, r );
 				
 		}  // end for, i
 
@@ -369,6 +475,7 @@ void Player::init(const PlayerTemplate* pt)
 	// FIXME: Haven't worked out where this gets reset.  Disabling the crash for now.
 	// DEBUG_ASSERTCRASH(m_playerTeamPrototypes.size() == 0, ("Player::m_playerTeamPrototypes is not empty at game start!\n"));
 	DEBUG_ASSERTLOG(m_playerTeamPrototypes.size() == 0, ("Player::m_playerTeamPrototypes is not empty at game start!\n"));
+	rebuildObjectCensus();
 	m_skillPointsModifier = 1.0f;
 	m_attackedFrame = 0;
 
@@ -595,16 +702,13 @@ Relationship Player::getRelationship(const Team *that) const
 		}
 		
 		// hummm... well, do we have something for that team's player?
-		if (!m_playerRelations->m_map.empty())
+		if (!m_playerRelations->isEmpty())
 		{
 			const Player* thatPlayer = that->getControllingPlayer();
-			if (thatPlayer != NULL)
+			Relationship r;
+			if (thatPlayer != NULL && m_playerRelations->findRelationship(thatPlayer->getPlayerIndex(), &r))
 			{
-				PlayerRelationMapType::const_iterator it = m_playerRelations->m_map.find(thatPlayer->getPlayerIndex());
-				if (it != m_playerRelations->m_map.end())
-				{
-					return (*it).second;
-				}
+				return r;
 			}
 		}
 	}
@@ -616,32 +720,18 @@ void Player::setPlayerRelationship(const Player *that, Relationship r)
 {
 	if (that != NULL)
 	{
-		// note that this creates the entry if it doesn't exist.
-		m_playerRelations->m_map[that->getPlayerIndex()] = r;
+		m_playerRelations->setRelationship(that->getPlayerIndex(), r);
 	}
 }
 
 // ------------------------------------------------------------------------
 Bool Player::removePlayerRelationship(const Player *that)
 {
-	if (!m_playerRelations->m_map.empty())
+	if (that == NULL)
 	{
-		if (that == NULL)
-		{
-			m_playerRelations->m_map.clear();
-			return true;
-		}
-		else
-		{
-			PlayerRelationMapType::iterator it = m_playerRelations->m_map.find(that->getPlayerIndex());
-			if (it != m_playerRelations->m_map.end())
-			{
-				m_playerRelations->m_map.erase(it);
-				return true;
-			}
-		}
+		return m_playerRelations->clear();
 	}
-	return false;
+	return m_playerRelations->removeRelationship(that->getPlayerIndex());
 }
 
 //=============================================================================
@@ -1025,7 +1115,7 @@ void Player::initFromDict(const Dict* d)
 	m_handicap.readFromDict(d);
 
 	/// @todo Ack!  the todo in PlayerList::reset() mentioning the need for a Player::reset() really needs to get done.
-	m_playerRelations->m_map.clear(); // For now, it has been decided to just fix this one.  Dear god me must reset.
+	m_playerRelations->clear(); // For now, it has been decided to just fix this one.  Dear god me must reset.
 	m_teamRelations->m_map.clear(); // For now, it has been decided to just fix this one.  Dear god me must reset.
 	
 	Int i;
@@ -1814,6 +1904,12 @@ void Player::addTeamToList(TeamPrototype* team)
 	}
 
 	m_playerTeamPrototypes.push_back(team);
+
+	// whatever the team already has now counts as ours
+	for (DLINK_ITERATOR<Team> iter = team->iterate_TeamInstanceList(); !iter.done(); iter.advance())
+	{
+		m_objectCensus.addCensus(iter.cur()->getObjectCensus(), 1);
+	}
 }
 
 //=============================================================================
@@ -1824,6 +1920,10 @@ void Player::removeTeamFromList(TeamPrototype* team)
 	{
 		if (team == *it)
 		{
+			for (DLINK_ITERATOR<Team> iter = team->iterate_TeamInstanceList(); !iter.done(); iter.advance())
+			{
+				m_objectCensus.addCensus(iter.cur()->getObjectCensus(), -1);
+			}
 			m_playerTeamPrototypes.erase(it);
 			return;
 		}
@@ -1858,39 +1958,66 @@ void Player::countObjectsByThingTemplate(Int numTmplates, const ThingTemplate* c
 	for (i = 0; i < numTmplates; ++i)
 		counts[i] = 0;
 
-	for (PlayerTeamList::const_iterator it = m_playerTeamPrototypes.begin(); 
-			 it != m_playerTeamPrototypes.end(); 
-			 ++it)
-	{	
-		(*it)->countObjectsByThingTemplate(numTmplates, things, ignoreDead, counts, ignoreUnderConstruction);
-	}
+#ifdef _DEBUG
+	if (m_objectCensus.isVerifyDue(TheGameLogic->getFrame()))
+		verifyObjectCensus();
+#endif
+	m_objectCensus.countObjectsByThingTemplate(numTmplates, things, ignoreDead, counts, ignoreUnderConstruction);
 }
 
 //=============================================================================
 Int Player::countBuildings(void)
 {
-	int retVal = 0;
+#ifdef _DEBUG
+	if (m_objectCensus.isVerifyDue(TheGameLogic->getFrame()))
+		verifyObjectCensus();
+#endif
+	return m_objectCensus.countBuildings();
+}
 
+//=============================================================================
+Int Player::countObjects(KindOfMaskType setMask, KindOfMaskType clearMask)
+{
+#ifdef _DEBUG
+	if (m_objectCensus.isVerifyDue(TheGameLogic->getFrame()))
+		verifyObjectCensus();
+#endif
+	return m_objectCensus.countObjects(setMask, clearMask);
+}
+
+//=============================================================================
+void Player::rebuildObjectCensus()
+{
+	m_objectCensus.clear();
 	for (PlayerTeamList::const_iterator it = m_playerTeamPrototypes.begin(); 
 			 it != m_playerTeamPrototypes.end(); ++it)
-	{	
-		retVal += (*it)->countBuildings();
+	{
+		for (DLINK_ITERATOR<Team> iter = (*it)->iterate_TeamInstanceList(); !iter.done(); iter.advance())
+		{
+			m_objectCensus.addCensus(iter.cur()->getObjectCensus(), 1);
+		}
 	}
-	return retVal;
 }
 
+#ifdef _DEBUG
 //=============================================================================
-Int Player::countObjects(KindOfMaskType setMask, KindOfMaskType clearMask)
+void Player::verifyObjectCensus() const
 {
-	int retVal = 0;
-
+	ObjectCensus recount;
 	for (PlayerTeamList::const_iterator it = m_playerTeamPrototypes.begin(); 
 			 it != m_playerTeamPrototypes.end(); ++it)
-	{	
-		retVal += (*it)->countObjects(setMask, clearMask);
+	{
+		for (DLINK_ITERATOR<Team> teamIter = (*it)->iterate_TeamInstanceList(); !teamIter.done(); teamIter.advance())
+		{
+			for (DLINK_ITERATOR<Object> iter = teamIter.cur()->iterate_TeamMemberList(); !iter.done(); iter.advance())
+			{
+				recount.add(iter.cur()->getTemplate(), ObjectCensus::getCensusState(iter.cur()));
+			}
+		}
 	}
-	return retVal;
+	DEBUG_ASSERTCRASH(m_objectCensus.isSameAs(recount), ("Player %d object census doesn't match the objects on its teams\n", getPlayerIndex()));
 }
+#endif
 
 //=============================================================================
 Object *Player::findClosestByKindOf( Object *queryObject, KindOfMaskType setMask, KindOfMaskType clearMask )
@@ -4724,5 +4851,8 @@ DEBUG_CRASH(("Player::xfer not yet implemented!"));
 void Player::loadPostProcess( void )
 {
 
+	// our team list was replaced wholesale during the load, so count our objects again
+	rebuildObjectCensus();
+
 }  // end loadPostProcess
 
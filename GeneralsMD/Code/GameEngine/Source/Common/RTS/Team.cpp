@@ -163,6 +163,156 @@ void TeamRelationMap::loadPostProcess( void )
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+UnsignedByte ObjectCensus::getCensusState( const Object *obj )
+{
+	UnsignedByte state = 0;
+	if( obj->isEffectivelyDead() )
+		state |= CENSUS_DEAD;
+	if( obj->getStatusBits().test( OBJECT_STATUS_UNDER_CONSTRUCTION ) )
+		state |= CENSUS_UNDER_CONSTRUCTION;
+	return state;
+}
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void ObjectCensus::add( const ThingTemplate *tmpl, UnsignedByte state, Int count )
+{
+	if( tmpl == NULL || count == 0 )
+		return;
+
+	DEBUG_ASSERTCRASH( state < CENSUS_STATE_COUNT, ("ObjectCensus::add - bad state %d\n", state) );
+
+	std::vector<Entry>::iterator it;
+	for( it = m_entries.begin(); it != m_entries.end(); ++it )
+	{
+		if( it->m_template == tmpl )
+			break;
+	}
+
+	if( it == m_entries.end() )
+	{
+		if( count < 0 )
+		{
+			DEBUG_CRASH(( "ObjectCensus::add - removing '%s', which was never counted\n", tmpl->getName().str() ));
+			return;
+		}
+
+		Entry entry = { tmpl, { 0 }, 0 };
+		m_entries.push_back( entry );
+		it = m_entries.end() - 1;
+	}
+
+	it->m_count[ state ] += count;
+	it->m_total += count;
+	DEBUG_ASSERTCRASH( it->m_count[ state ] >= 0, ("ObjectCensus::add - count for '%s' went negative\n", tmpl->getName().str()) );
+
+	if( tmpl->isKindOf( KINDOF_STRUCTURE ) )
+		m_buildingCount += count;
+
+	if( it->m_total <= 0 )
+	{
+		*it = m_entries.back();
+		m_entries.pop_back();
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void ObjectCensus::addCensus( const ObjectCensus& that, Int sign )
+{
+	for( std::vector<Entry>::const_iterator it = that.m_entries.begin(); it != that.m_entries.end(); ++it )
+	{
+		for( Int state = 0; state < CENSUS_STATE_COUNT; ++state )
+			add( it->m_template, (UnsignedByte)state, sign * it->m_count[ state ] );
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void ObjectCensus::clear()
+{
+	m_entries.clear();
+	m_buildingCount = 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+Bool ObjectCensus::isSameAs( const ObjectCensus& that ) const
+{
+	if( m_entries.size() != that.m_entries.size() || m_buildingCount != that.m_buildingCount )
+		return FALSE;
+
+	for( std::vector<Entry>::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it )
+	{
+		std::vector<Entry>::const_iterator other;
+		for( other = that.m_entries.begin(); other != that.m_entries.end(); ++other )
+		{
+			if( other->m_template == it->m_template )
+				break;
+		}
+
+		if( other == that.m_entries.end() )
+			return FALSE;
+
+		for( Int state = 0; state < CENSUS_STATE_COUNT; ++state )
+		{
+			if( other->m_count[ state ] != it->m_count[ state ] )
+				return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void ObjectCensus::countObjectsByThingTemplate( Int numTmplates, const ThingTemplate* const* things, Bool ignoreDead, Int *counts, Bool ignoreUnderConstruction ) const
+{
+	for( std::vector<Entry>::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it )
+	{
+		Int count = 0;
+		for( Int state = 0; state < CENSUS_STATE_COUNT; ++state )
+		{
+			if( ignoreDead && (state & CENSUS_DEAD) )
+				continue;
+			if( ignoreUnderConstruction && (state & CENSUS_UNDER_CONSTRUCTION) )
+				continue;
+			count += it->m_count[ state ];
+		}
+
+		if( count == 0 )
+			continue;
+
+		for( Int i = 0; i < numTmplates; ++i )
+		{
+			if( it->m_template->isEquivalentTo( things[i] ) )
+			{
+				counts[i] += count;
+				break;
+			}
+		}
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+Int ObjectCensus::countObjects( KindOfMaskType setMask, KindOfMaskType clearMask ) const
+{
+	Int count = 0;
+	for( std::vector<Entry>::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it )
+	{
+		if( it->m_template->isKindOfMulti( setMask, clearMask ) )
+			count += it->m_total;
+	}
+	return count;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 // ------------------------------------------------------------------------
 // ------------------------------------------------------------------------
 // ------------------------------------------------------------------------
@@ -1509,16 +1659,13 @@ Relationship Team::getRelationship(const Team *that) const
 	}
 
 	// hummm... well, do we have an override for that team's player?
-	if (!m_playerRelations->m_map.empty() && that != NULL)
+	if (!m_playerRelations->isEmpty() && that != NULL)
 	{
 		Player* thatPlayer = that->getControllingPlayer();
-		if (thatPlayer != NULL)
+		Relationship r;
+		if (thatPlayer != NULL && m_playerRelations->findRelationship(thatPlayer->getPlayerIndex(), &r))
 		{
-			PlayerRelationMapType::const_iterator it = m_playerRelations->m_map.find(thatPlayer->getPlayerIndex());
-			if (it != m_playerRelations->m_map.end())
-			{
-				return (*it).second;
-			}
+			return r;
 		}
 	}
 
@@ -1613,92 +1760,98 @@ void Team::setOverridePlayerRelationship( Int playerIndex, Relationship r )
 {
 	if (playerIndex != PLAYER_INDEX_INVALID)
 	{
-		// note that this creates the entry if it doesn't exist.
-		m_playerRelations->m_map[playerIndex] = r;
+		m_playerRelations->setRelationship(playerIndex, r);
 	}
 }
 
 // ------------------------------------------------------------------------
 Bool Team::removeOverridePlayerRelationship( Int playerIndex )
 {
-	if (!m_playerRelations->m_map.empty())
+	if (playerIndex == PLAYER_INDEX_INVALID)
 	{
-		if (playerIndex == PLAYER_INDEX_INVALID)
-		{
-			m_playerRelations->m_map.clear();
-			return true;
-		}
-		else
-		{
-			PlayerRelationMapType::iterator it = m_playerRelations->m_map.find(playerIndex);
-			if (it != m_playerRelations->m_map.end())
-			{
-				m_playerRelations->m_map.erase(it);
-				return true;
-			}
-		}
+		return m_playerRelations->clear();
 	}
-	return false;
+	return m_playerRelations->removeRelationship(playerIndex);
 }
 
 // ------------------------------------------------------------------------
 void Team::countObjectsByThingTemplate(Int numTmplates, const ThingTemplate* const* things, Bool ignoreDead, Int *counts, Bool ignoreUnderConstruction) const
 {
-	for (DLINK_ITERATOR<Object> iter = iterate_TeamMemberList(); !iter.done(); iter.advance())
-	{
-		const ThingTemplate *objtmpl = iter.cur()->getTemplate();
-		for (Int i = 0; i < numTmplates; ++i)
-		{
-			//Kris: Compare
-			if( !objtmpl->isEquivalentTo( things[i] ) )
-			{
-				continue;
-			}
+#ifdef _DEBUG
+	if (m_census.isVerifyDue(TheGameLogic->getFrame()))
+		verifyObjectCensus();
+#endif
+	m_census.countObjectsByThingTemplate(numTmplates, things, ignoreDead, counts, ignoreUnderConstruction);
+}
 
-			if (ignoreDead && iter.cur()->isEffectivelyDead())
-				continue;
+// ------------------------------------------------------------------------
+Int Team::countBuildings(void)
+{
+#ifdef _DEBUG
+	if (m_census.isVerifyDue(TheGameLogic->getFrame()))
+		verifyObjectCensus();
+#endif
+	return m_census.countBuildings();
+}
 
-			if( ignoreUnderConstruction && iter.cur()->getStatusBits().test( OBJECT_STATUS_UNDER_CONSTRUCTION ) )
-				continue;
+// ------------------------------------------------------------------------
+Int Team::countObjects(KindOfMaskType setMask, KindOfMaskType clearMask)
+{
+#ifdef _DEBUG
+	if (m_census.isVerifyDue(TheGameLogic->getFrame()))
+		verifyObjectCensus();
+#endif
+	return m_census.countObjects(setMask, clearMask);
+}
 
-			counts[i] += 1;
-			break;	// from 'next i', NOT 'next object'
+// ------------------------------------------------------------------------
+void Team::addMemberToCensus( Object *obj )
+{
+	UnsignedByte state = ObjectCensus::getCensusState( obj );
+	obj->friend_setCensusState( state );
 
-		}
-	}
+	m_census.add( obj->getTemplate(), state );
+	Player *player = getControllingPlayer();
+	if (player)
+		player->friend_getObjectCensus().add( obj->getTemplate(), state );
 }
 
 // ------------------------------------------------------------------------
-Int Team::countBuildings(void)
+void Team::removeMemberFromCensus( Object *obj )
 {
-	int retVal = 0;
-	for (DLINK_ITERATOR<Object> iter = iterate_TeamMemberList(); !iter.done(); iter.advance()) {
-		const ThingTemplate* objtmpl = iter.cur()->getTemplate();
-		if (!objtmpl) {
-			continue;
-		}
-		if (objtmpl->isKindOf(KINDOF_STRUCTURE)) {
-			++retVal;
-		}
-	}
-	return retVal;
+	UnsignedByte state = obj->friend_getCensusState();
+
+	m_census.remove( obj->getTemplate(), state );
+	Player *player = getControllingPlayer();
+	if (player)
+		player->friend_getObjectCensus().remove( obj->getTemplate(), state );
 }
 
 // ------------------------------------------------------------------------
-Int Team::countObjects(KindOfMaskType setMask, KindOfMaskType clearMask)
+void Team::updateMemberCensus( Object *obj )
 {
-	int retVal = 0;
-	for (DLINK_ITERATOR<Object> iter = iterate_TeamMemberList(); !iter.done(); iter.advance()) {
-		const ThingTemplate* objtmpl = iter.cur()->getTemplate();
-		if (!objtmpl) {
-			continue;
-		}
-		if (objtmpl->isKindOfMulti(setMask, clearMask)) {
-			++retVal;
-		}
+	if (!isInList_TeamMemberList(obj))
+		return;
+
+	if (obj->friend_getCensusState() == ObjectCensus::getCensusState( obj ))
+		return;
+
+	removeMemberFromCensus( obj );
+	addMemberToCensus( obj );
+}
+
+#ifdef _DEBUG
+// ------------------------------------------------------------------------
+void Team::verifyObjectCensus() const
+{
+	ObjectCensus recount;
+	for (DLINK_ITERATOR<Object> iter = iterate_TeamMemberList(); !iter.done(); iter.advance())
+	{
+		recount.add( iter.cur()->getTemplate(), ObjectCensus::getCensusState( iter.cur() ) );
 	}
-	return retVal;
+	DEBUG_ASSERTCRASH( m_census.isSameAs( recount ), ("Team '%s' object census doesn't match its members\n", getName().str()) );
 }
+#endif
 
 // ------------------------------------------------------------------------
 void Team::healAllObjects(void)
@@ -2832,6 +2985,11 @@ void Team::loadPostProcess( void )
 	// we're done with the xfer list now
 	m_xferMemberIDList.clear();
 
+#ifdef _DEBUG
+	// the members counted themselves in as they set their team during their own xfer
+	verifyObjectCensus();
+#endif
+
 }  // end loadPostProcess
 
 
@@ -31,7 +31,7 @@
 
 #include "Lib/BaseType.h"
 #include "Common/RandomValue.h"
-// #include "Common/CRC.h"
+#include "Common/CRC.h"
 #include "Common/Debug.h"
 // #include "GameLogic/GameLogic.h"
 
@@ -148,11 +148,9 @@ UnsignedInt GetGameLogicRandomSeed( void )
 
 UnsignedInt GetGameLogicRandomSeedCRC( void )
 {
-	printf("*** GetGameLogicRandomSeedCRC not yet implemented!\n");
-	// CRC c;
-	// c.computeCRC(theGameLogicSeed, 6*sizeof(UnsignedInt));
-	// return c.get();
-	return 0;
+	CRC c;
+	c.computeCRC(theGameLogicSeed, 6*sizeof(UnsignedInt));
+	return c.get();
 }
 
 void InitRandom( void )
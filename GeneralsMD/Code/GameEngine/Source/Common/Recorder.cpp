@@ -30,6 +30,9 @@
 #include "Common/Player.h"
 #include "Common/GlobalData.h"
 #include "Common/GameEngine.h"
+#include "Common/GameState.h"
+#include "Common/LatchRestore.h"
+#include "Common/ReplaySnapshotRing.h"
 #include "GameClient/GameWindow.h"
 #include "GameClient/GameWindowManager.h"
 #include "GameClient/InGameUI.h"
@@ -54,6 +57,9 @@
 
 Int REPLAY_CRC_INTERVAL = 100;
 
+// the ring also has a memory budget, this just keeps lookups short
+static const Int MAX_REPLAY_SNAPSHOTS = 64;
+
 const char *replayExtention = ".rep";
 const char *lastReplayFileName = "00000000";	// a name the user is unlikely to ever type, but won't cause panic & confusion
 
@@ -400,6 +406,8 @@ RecorderClass::RecorderClass()
  * Destructor
  */
 RecorderClass::~RecorderClass() {
+	delete m_snapshots;
+	m_snapshots = NULL;
 }
 
 /**
@@ -430,6 +438,14 @@ void RecorderClass::init() {
  * Reset the recorder to the "initialized state."
  */
 void RecorderClass::reset() {
+	// restoring a snapshot resets the whole engine, but playback carries on from the snapshot
+	if (m_restoringSnapshot)
+		return;
+
+	delete m_snapshots;
+	m_snapshots = NULL;
+	m_seekTarget = 0;
+
 	if (m_file != NULL) {
 		fclose(m_file);
 		m_file = NULL;
@@ -466,6 +482,20 @@ void RecorderClass::updatePlayback() {
 	if (m_doingAnalysis)
 		curFrame = m_nextFrame;
 
+	if (m_seekTarget != 0 && curFrame >= m_seekTarget) {
+		Real seekMilliseconds = std::chrono::duration<Real, std::milli>(std::chrono::steady_clock::now() - m_seekStart).count();
+		DEBUG_LOG(("RecorderClass::updatePlayback - reached frame %d, seek took %.2f ms\n", curFrame, seekMilliseconds));
+		++m_seeksFinished;
+		m_seekMilliseconds += seekMilliseconds;
+		m_seekTarget = 0;
+	}
+
+	// snapshots are taken before this frame's commands are queued, so a restore reads them again
+	Int interval = TheGlobalData->m_data.m_replaySnapshotInterval;
+	if (m_snapshots != NULL && !m_doingAnalysis && curFrame % static_cast<UnsignedInt>(interval) == 0 && !m_snapshots->has(curFrame)) {
+		takeSnapshot(curFrame);
+	}
+
 	// While there are commands to be queued up for this frame, do it.
 	while (m_nextFrame == curFrame) {
 		appendNextCommand();	// append the next command to TheCommandQueue
@@ -478,6 +508,10 @@ void RecorderClass::updatePlayback() {
  * reaching the end of the playback file.
  */
 void RecorderClass::stopPlayback() {
+	delete m_snapshots;
+	m_snapshots = NULL;
+	m_seekTarget = 0;
+
 	if (m_file != NULL) {
 		fclose(m_file);
 		m_file = NULL;
@@ -967,6 +1001,7 @@ public:
 	UnsignedInt getLocalPlayer(void) { return m_localPlayer; }
 
 	void setSawCRCMismatch(void) { m_sawCRCMismatch = TRUE; }
+	void clearCRCs(void) { m_data.clear(); }
 	Bool sawCRCMismatch(void) { return m_sawCRCMismatch; }
 
 protected:
@@ -1187,6 +1222,15 @@ Bool RecorderClass::playbackFile(AsciiString filename)
 	}
 
 	m_currentReplayFilename = filename;
+
+	delete m_snapshots;
+	m_snapshots = NULL;
+	if (TheGlobalData->m_data.m_replaySnapshotInterval > 0 && !m_doingAnalysis)
+	{
+		size_t budget = static_cast<size_t>(TheGlobalData->m_data.m_replaySnapshotBudgetMB) * 1024 * 1024;
+		m_snapshots = NEW ReplaySnapshotRing(MAX_REPLAY_SNAPSHOTS, budget);
+	}
+
 	return TRUE;
 }
 
@@ -1259,6 +1303,132 @@ void RecorderClass::readNextFrame() {
 	}
 }
 
+/**
+ * Save the whole game into the snapshot ring, along with where playback is in the replay file.
+ * Memory use and capture time are reported for every snapshot interval.
+ */
+void RecorderClass::takeSnapshot(UnsignedInt frame) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	ReplaySnapshot snapshot;
+	snapshot.m_frame = frame;
+	snapshot.m_filePos = ftell(m_file);
+	snapshot.m_nextFrame = m_nextFrame;
+	if (!TheGameState->saveToImage(snapshot.m_image)) {
+		DEBUG_LOG(("RecorderClass::takeSnapshot - could not save frame %d\n", frame));
+		return;
+	}
+	snapshot.m_captureMilliseconds = std::chrono::duration<Real, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	Real captureMilliseconds = snapshot.m_captureMilliseconds;
+#ifdef DEBUG_LOGGING
+	Int imageSize = static_cast<Int>(snapshot.m_image.size());
+#endif
+	m_snapshots->add(snapshot);
+	++m_snapshotsTaken;
+	m_snapshotMilliseconds += captureMilliseconds;
+
+	DEBUG_LOG(("RecorderClass::takeSnapshot - frame %d, %d bytes in %.2f ms, ring holds %d snapshots in %d KB\n",
+		frame, imageSize, captureMilliseconds, m_snapshots->getCount(), static_cast<Int>(m_snapshots->getBytes() / 1024)));
+}
+
+/**
+ * Load a snapshot and carry on playback from its place in the replay file.  On failure the engine
+ * has been reset and playback is stopped.
+ */
+Bool RecorderClass::restoreSnapshot(const ReplaySnapshot& snapshot) {
+	// the snapshot lives in the ring, which has to survive the engine reset
+	long filePos = snapshot.m_filePos;
+	UnsignedInt nextFrame = snapshot.m_nextFrame;
+
+	Bool ok;
+	{
+		LatchRestore<Bool> restoring(m_restoringSnapshot, TRUE);
+		ok = TheGameState->loadFromImage(snapshot.m_image);
+	}
+
+	if (!ok || fseek(m_file, filePos, SEEK_SET) != 0) {
+		DEBUG_LOG(("RecorderClass::restoreSnapshot - could not restore frame %d\n", snapshot.m_frame));
+		m_nextFrame = (UnsignedInt)-1;
+		stopPlayback();
+		return FALSE;
+	}
+
+	m_nextFrame = nextFrame;
+
+	// CRCs queued for frames we're about to play again would be compared against the wrong frames
+	if (m_crcInfo != NULL)
+		m_crcInfo->clearCRCs();
+
+	return TRUE;
+}
+
+/**
+ * Jump playback to 'frame'.  Going backwards restores the nearest snapshot at or before the
+ * frame; either way the logic then runs forward without drawing until it gets there.  Seeking
+ * forward only restores a snapshot if it's ahead of where we already are.
+ */
+Bool RecorderClass::seekPlayback(UnsignedInt frame) {
+	if (m_mode != RECORDERMODETYPE_PLAYBACK || m_file == NULL || m_doingAnalysis)
+		return FALSE;
+
+	m_seekStart = std::chrono::steady_clock::now();
+	UnsignedInt curFrame = TheGameLogic->getFrame();
+	const ReplaySnapshot *snapshot = m_snapshots ? m_snapshots->findAtOrBefore(frame) : NULL;
+
+	if (snapshot != NULL && (frame < curFrame || snapshot->m_frame > curFrame)) {
+#ifdef DEBUG_LOGGING
+		UnsignedInt snapshotFrame = snapshot->m_frame;
+#endif
+		if (!restoreSnapshot(*snapshot))
+			return FALSE;
+		Real restoreMilliseconds = std::chrono::duration<Real, std::milli>(std::chrono::steady_clock::now() - m_seekStart).count();
+		DEBUG_LOG(("RecorderClass::seekPlayback - restored frame %d for frame %d in %.2f ms\n", snapshotFrame, frame, restoreMilliseconds));
+		++m_seeksRestored;
+		m_seekRestoreMilliseconds += restoreMilliseconds;
+	} else if (frame < curFrame) {
+		DEBUG_LOG(("RecorderClass::seekPlayback - no snapshot at or before frame %d\n", frame));
+		return FALSE;
+	}
+
+	m_seekTarget = frame;
+	return TRUE;
+}
+
+/**
+ * Snapshot capture, restore and whole-seek times since resetSeekTimings, one line each for the
+ * ones that happened.
+ */
+AsciiString RecorderClass::reportSeekTimings() const {
+	AsciiString report;
+	AsciiString line;
+	if (m_snapshotsTaken > 0) {
+		line.format("  replay snapshots: %d taken, %.2f ms each, ring holds %d in %d KB\n", m_snapshotsTaken,
+			m_snapshotMilliseconds / m_snapshotsTaken, m_snapshots ? m_snapshots->getCount() : 0,
+			m_snapshots ? static_cast<Int>(m_snapshots->getBytes() / 1024) : 0);
+		report.concat(line);
+	}
+	if (m_seeksRestored > 0) {
+		line.format("  replay seeks: %d restored a snapshot in %.2f ms each", m_seeksRestored, m_seekRestoreMilliseconds / m_seeksRestored);
+		report.concat(line);
+		if (m_seeksFinished > 0) {
+			line.format(", %d reached their frame in %.2f ms each", m_seeksFinished, m_seekMilliseconds / m_seeksFinished);
+			report.concat(line);
+		}
+		report.concat("\n");
+	}
+	return report;
+}
+
+void RecorderClass::resetSeekTimings() {
+	m_snapshotsTaken = 0;
+	m_snapshotMilliseconds = 0.0f;
+	m_seeksRestored = 0;
+	m_seekRestoreMilliseconds = 0.0f;
+	m_seeksFinished = 0;
+	m_seekMilliseconds = 0.0f;
+}
+
 /**
  * This reads the next command from the replay file and appends it to TheCommandList.
  */
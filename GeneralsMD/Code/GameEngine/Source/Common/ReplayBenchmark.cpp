@@ -0,0 +1,192 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// FILE: ReplayBenchmark.cpp //////////////////////////////////////////////////////////////////////
+// Desc:   Times a headless replay playback
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// INCLUDES ///////////////////////////////////////////////////////////////////////////////////////
+#include "PreRTS.h"	// This must go first in EVERY cpp file int the GameEngine
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+
+#include "Common/ReplayBenchmark.h"
+#include "Common/GameAudio.h"
+#include "Common/GameEngine.h"
+#include "Common/GameState.h"
+#include "Common/GlobalData.h"
+#include "Common/PerfTimer.h"
+#include "Common/Player.h"
+#include "Common/Recorder.h"
+#include "Common/SubsystemInterface.h"
+#include "GameLogic/AI.h"
+#include "GameLogic/AIPathfind.h"
+#include "GameLogic/GameLogic.h"
+#include "GameLogic/Object.h"
+#include "GameLogic/PartitionManager.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// PUBLIC DATA ////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+ReplayBenchmark *TheReplayBenchmark = NULL;
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS //////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+static Int64 nowNanos( void )
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS ///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+ReplayBenchmark::ReplayBenchmark( const AsciiString& replayFile ) : m_replayFile(replayFile)
+{
+	// the header tells us how long the replay is, which lets us stop on the right frame even
+	// if the recorder never reaches the end of the command stream
+	RecorderClass::ReplayHeader header;
+	header.forPlayback = FALSE;
+	header.filename = replayFile;
+	if (TheRecorder && TheRecorder->readReplayHeader(header))
+		m_frameDuration = header.frameDuration;
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+ReplayBenchmark::~ReplayBenchmark()
+{
+	SubsystemInterface::setTimeUpdates(FALSE);
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Starts timing once the replay game is up, so map loading isn't counted, and finishes when
+	* the playback ends, the game is torn down, or the replay's recorded length is reached. */
+//-------------------------------------------------------------------------------------------------
+void ReplayBenchmark::update( void )
+{
+	if (m_done)
+		return;
+
+	if (!m_running)
+	{
+		if (TheGameLogic->isInReplayGame())
+			start();
+		return;
+	}
+
+	// -seekFrame goes back once, from a snapshot interval past the frame, so there's a snapshot
+	// at or before it to restore (given -replaySnapshots)
+	UnsignedInt seekFrame = (UnsignedInt)TheGlobalData->m_data.m_replaySeekFrame;
+	UnsignedInt seekFrom = seekFrame + (UnsignedInt)std::max(1, TheGlobalData->m_data.m_replaySnapshotInterval);
+	if (seekFrame != 0 && !m_seekTried && TheGameLogic->getFrame() >= seekFrom)
+	{
+		m_seekTried = TRUE;
+		UnsignedInt curFrame = TheGameLogic->getFrame();
+		if (TheRecorder->seekPlayback(seekFrame))
+			m_seekedFrames = curFrame - seekFrame;
+		else
+			printf("ReplayBenchmark: couldn't seek from frame %u back to frame %u, is -replaySnapshots set?\n", curFrame, seekFrame);
+		return;
+	}
+
+	if (!TheGameLogic->isInReplayGame() ||
+			TheRecorder->getMode() != RECORDERMODETYPE_PLAYBACK ||
+			(m_frameDuration != 0 && TheGameLogic->getFrame() >= m_frameDuration))
+	{
+		finish();
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+void ReplayBenchmark::abort( const char *reason )
+{
+	printf("ReplayBenchmark: %s: %s\n", m_replayFile.str(), reason);
+	m_done = TRUE;
+	m_running = FALSE;
+	TheGameEngine->setQuitting(TRUE);
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+void ReplayBenchmark::start( void )
+{
+	m_running = TRUE;
+	m_startFrame = TheGameLogic->getFrame();
+
+	TheSubsystemList->clearUpdateTimesForAll();
+	SubsystemInterface::setTimeUpdates(TRUE);
+	Object::resetModuleInterfaceLookups();
+	PartitionManager::resetQueryBenchmark();
+	TheAI->pathfinder()->resetCorridorCache();
+	GameLogic::resetIncrementalCRC();
+	PlayerRelationMap::resetDenseCopyChecks();
+	TheRecorder->resetSeekTimings();
+	TheAudio->resetCacheStats();
+#ifdef PERF_TIMERS
+	PerfGather::clearTotals();
+#endif
+
+	m_startNanos = nowNanos();
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+void ReplayBenchmark::finish( void )
+{
+	Int64 elapsed = nowNanos() - m_startNanos;
+	SubsystemInterface::setTimeUpdates(FALSE);
+
+	m_running = FALSE;
+	m_done = TRUE;
+
+	// a failed restore resets the engine, which can leave the frame behind where we started
+	Int64 playedFrames = (Int64)TheGameLogic->getFrame() - (Int64)m_startFrame + (Int64)m_seekedFrames;
+	Int frames = (Int)std::clamp<Int64>(playedFrames, 0, INT_MAX);
+	Real seconds = (Real)((double)elapsed / 1.0e9);
+
+	printf("ReplayBenchmark: %s\n", m_replayFile.str());
+	printf("  %d logic frames in %.3f seconds, %.1f logic frames/sec (%.3f ms/frame)\n",
+		frames, seconds, seconds > 0.0f ? frames / seconds : 0.0f, frames > 0 ? 1000.0f * seconds / frames : 0.0f);
+	printf("%s", TheSubsystemList->reportUpdateTimesForAll(frames).str());
+	printf("%s", Object::reportModuleInterfaceLookups(frames).str());
+	printf("%s", PartitionManager::reportQueryBenchmark(frames).str());
+	printf("%s", TheAI->pathfinder()->reportCorridorCache(frames).str());
+	printf("%s", TheAI->pathfinder()->reportZoneBlockPasses(frames).str());
+	printf("%s", GameLogic::reportIncrementalCRC(frames).str());
+	printf("%s", PlayerRelationMap::reportDenseCopyChecks(frames).str());
+	printf("%s", TheAudio->reportCacheStats(frames).str());
+	printf("%s", TheRecorder->reportSeekTimings().str());
+	printf("%s", TheGameState->reportSaveBenchmark().str());
+#ifdef PERF_TIMERS
+	printf("%s", PerfGather::reportTotals(frames).str());
+#endif
+	printf("  final logic CRC: %8.8X\n", TheGameLogic->getCRC(CRC_CACHED));
+	fflush(stdout);
+
+	TheGameEngine->setQuitting(TRUE);
+}
@@ -0,0 +1,110 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// FILE: ReplaySnapshotRing.cpp ///////////////////////////////////////////////////////////////////
+// Desc:   Bounded ring of in-memory game snapshots taken during replay playback
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// INCLUDES ///////////////////////////////////////////////////////////////////////////////////////
+#include "PreRTS.h"	// This must go first in EVERY cpp file int the GameEngine
+
+#include "Common/ReplaySnapshotRing.h"
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+ReplaySnapshotRing::ReplaySnapshotRing( Int maxSnapshots, size_t maxBytes ) :
+	m_slots( static_cast<size_t>(std::max(1, maxSnapshots)) ),
+	m_maxBytes( maxBytes )
+{
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+void ReplaySnapshotRing::clear( void )
+{
+	while (m_count > 0)
+		dropOldest();
+	m_head = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+void ReplaySnapshotRing::dropOldest( void )
+{
+	ReplaySnapshot &oldest = m_slots[static_cast<size_t>(m_head)];
+	m_bytes -= oldest.m_image.size();
+
+	// actually give the memory back, clear() alone would keep the capacity
+	std::vector<UnsignedByte>().swap(oldest.m_image);
+
+	m_head = (m_head + 1) % static_cast<Int>(m_slots.size());
+	--m_count;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Snapshots are normally added in frame order, but after a seek backwards the frames in front
+	* of the restored one are captured again.  Those are skipped by the caller via has(), and since
+	* replays are deterministic any snapshot still in the ring stays valid */
+//-------------------------------------------------------------------------------------------------
+void ReplaySnapshotRing::add( ReplaySnapshot& snapshot )
+{
+	Int capacity = static_cast<Int>(m_slots.size());
+
+	// always keep the newest one, even if it alone is over budget
+	while (m_count > 0 && (m_count == capacity || m_bytes + snapshot.m_image.size() > m_maxBytes))
+		dropOldest();
+
+	ReplaySnapshot &slot = m_slots[static_cast<size_t>((m_head + m_count) % capacity)];
+	slot.m_frame = snapshot.m_frame;
+	slot.m_filePos = snapshot.m_filePos;
+	slot.m_nextFrame = snapshot.m_nextFrame;
+	slot.m_captureMilliseconds = snapshot.m_captureMilliseconds;
+	slot.m_image.swap(snapshot.m_image);
+	snapshot.m_image.clear();
+
+	m_bytes += slot.m_image.size();
+	++m_count;
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+Bool ReplaySnapshotRing::has( UnsignedInt frame ) const
+{
+	Int capacity = static_cast<Int>(m_slots.size());
+	for (Int i = 0; i < m_count; ++i)
+	{
+		if (m_slots[static_cast<size_t>((m_head + i) % capacity)].m_frame == frame)
+			return TRUE;
+	}
+	return FALSE;
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+const ReplaySnapshot *ReplaySnapshotRing::findAtOrBefore( UnsignedInt frame ) const
+{
+	const ReplaySnapshot *best = NULL;
+	Int capacity = static_cast<Int>(m_slots.size());
+	for (Int i = 0; i < m_count; ++i)
+	{
+		const ReplaySnapshot &snapshot = m_slots[static_cast<size_t>((m_head + i) % capacity)];
+		if (snapshot.m_frame <= frame && (best == NULL || snapshot.m_frame > best->m_frame))
+			best = &snapshot;
+	}
+	return best;
+}
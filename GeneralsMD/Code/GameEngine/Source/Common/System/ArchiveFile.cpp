@@ -37,7 +37,7 @@
 // checks to see if str matches searchString.  Search string is done in the
 // using * and ? as wildcards. * is used to denote any number of characters,
 // and ? is used to denote a single wildcard character.
-static Bool SearchStringMatches(AsciiString str, AsciiString searchString) 
+Bool ArchiveFile::SearchStringMatches(AsciiString str, AsciiString searchString) 
 {
 	if (str.getLength() == 0) {
 		if (searchString.getLength() == 0) {
@@ -196,6 +196,18 @@ void ArchiveFile::attachFile(File *file)
 	m_file = file;
 }
 
+Bool ArchiveFile::getFileOffset(const AsciiString& filename, UnsignedInt *offset) const
+{
+	const ArchivedFileInfo *fileInfo = getArchivedFileInfo(filename);
+	if (fileInfo == NULL)
+	{
+		return FALSE;
+	}
+
+	*offset = fileInfo->m_offset;
+	return TRUE;
+}
+
 const ArchivedFileInfo * ArchiveFile::getArchivedFileInfo(const AsciiString& filename) const
 {
 	AsciiString path {};
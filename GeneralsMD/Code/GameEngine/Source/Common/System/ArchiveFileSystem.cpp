@@ -264,6 +264,28 @@ Bool ArchiveFileSystem::getFileInfo(const AsciiString& filename, FileInfo *fileI
 	}
 }
 
+Bool ArchiveFileSystem::getFileLocation(const AsciiString& filename, AsciiString *archivePath, UnsignedInt *offset, FileInfo *fileInfo) const
+{
+	if (filename.getLength() <= 0) {
+		return FALSE;
+	}
+
+	AsciiString archiveFilename = getArchiveFilenameForFile(filename);
+	ArchiveFileMap::const_iterator it = m_archiveFileMap.find(archiveFilename);
+	if (it == m_archiveFileMap.end())
+	{
+		return FALSE;
+	}
+
+	if (!it->second->getFileInfo(filename, fileInfo) || !it->second->getFileOffset(filename, offset))
+	{
+		return FALSE;
+	}
+
+	*archivePath = it->second->getPath();
+	return TRUE;
+}
+
 AsciiString ArchiveFileSystem::getArchiveFilenameForFile(const AsciiString& filename) const
 {
 	AsciiString path;
@@ -249,6 +249,31 @@ Bool FileSystem::getFileInfo(const AsciiString& filename, FileInfo *fileInfo) co
 	return FALSE;
 }
 
+//============================================================================
+// FileSystem::getFileLocation
+//============================================================================
+Bool FileSystem::getFileLocation(const AsciiString& filename, AsciiString *archivePath, UnsignedInt *offset, FileInfo *fileInfo) const
+{
+	USE_PERF_TIMER(FileSystem)
+	if (archivePath == NULL || offset == NULL || fileInfo == NULL) {
+		return FALSE;
+	}
+	memset(fileInfo, 0, sizeof(FileInfo));
+	archivePath->clear();
+	*offset = 0;
+
+	// same order as openFile: loose files override the archives
+	if (TheLocalFileSystem->getFileInfo(filename, fileInfo)) {
+		return TRUE;
+	}
+
+	if (TheArchiveFileSystem->getFileLocation(filename, archivePath, offset, fileInfo)) {
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
 //============================================================================
 // FileSystem::createDirectory
 //============================================================================
@@ -93,7 +93,6 @@ static PoolSizeRec sizes[] =
 	{ "MusicTrack", 32, 32 },
 	{ "PositionalSoundPool", 32, 32 },
 	{ "GameMessage", 2048, 32 },
-	{ "NameKeyBucketPool", 9000, 1024 },
 	{ "ObjectSellInfo", 16, 16 },
 	{ "ProductionPrerequisitePool", 1024, 32 },
 	{ "RadarObject", 512, 32 },
@@ -356,6 +355,7 @@ static PoolSizeRec sizes[] =
 	{ "DeployStyleAIUpdate", 32, 32 },
 	{ "AssaultTransportAIUpdate", 64, 32 },
 	{ "StreamingArchiveFile", 8, 8 },
+	{ "MappedArchiveFileView", 32, 32 },
 
 	{ "DozerActionStateMachine", 256, 32 },
 	{ "DozerPrimaryStateMachine", 256, 32 },
@@ -39,10 +39,11 @@
 #include "Common/PlayerList.h"
 #include "Common/RandomValue.h"
 #include "Common/Radar.h"
+#include "Common/SaveGameWriter.h"
 #include "Common/Team.h"
 #include "Common/WellKnownKeys.h"
-// #include "Common/XferLoad.h"
-// #include "Common/XferSave.h"
+#include "Common/XferLoad.h"
+#include "Common/XferSaveMemory.h"
 #include "GameClient/CampaignManager.h"
 #include "GameClient/GadgetListBox.h"
 #include "GameClient/GameClient.h"
@@ -58,6 +59,7 @@
 // #include "GameLogic/ScriptEngine.h"
 #include "GameLogic/SidesList.h"
 #include "GameLogic/TerrainLogic.h"
+#include <chrono>
 #include <filesystem>
 
 #ifdef _INTERNAL
@@ -305,6 +307,10 @@ GameState::~GameState( void )
 	// clear any available game 
 	clearAvailableGames();
 
+	// finishes writing any saves still in flight
+	delete m_saveWriter;
+	m_saveWriter = NULL;
+
 }  // end ~GameState
 
 // ------------------------------------------------------------------------------------------------
@@ -363,6 +369,40 @@ void GameState::reset( void )
 
 }  // end reset
 
+// ------------------------------------------------------------------------------------------------
+/** Saves are written in the background, so the player only hears how one went once it's on disk */
+// ------------------------------------------------------------------------------------------------
+void GameState::update( void )
+{
+
+	if( m_saveWriter == NULL )
+		return;
+
+	std::vector<AsciiString> failedFiles;
+	Int written = m_saveWriter->reportFinishedWrites( &failedFiles );
+
+	// print message to the user for game successfully saved
+	if( written > 0 )
+	{
+		UnicodeString msg = TheGameText->fetch( "GUI:GameSaveComplete" );
+		TheInGameUI->message( msg );
+	}
+
+	for( std::vector<AsciiString>::const_iterator it = failedFiles.begin(); it != failedFiles.end(); ++it )
+	{
+
+		UnicodeString ufilepath;
+		ufilepath.translate( *it );
+
+		UnicodeString msg;
+		msg.format( TheGameText->fetch("GUI:ErrorSavingGame"), ufilepath.str() );
+
+		MessageBoxOk(TheGameText->fetch("GUI:Error"), msg, NULL);
+
+	}  // end for
+
+}  // end update
+
 // ------------------------------------------------------------------------------------------------
 /** Clear any available games entries */
 // ------------------------------------------------------------------------------------------------
@@ -551,13 +591,6 @@ SaveCode GameState::saveGame( AsciiString filename, UnicodeString desc,
 															SaveFileType saveType, SnapshotType which )
 {
 
-(void) filename;
-(void) desc;
-(void) saveType;
-(void) which;
-DEBUG_CRASH(("GameState::saveGame not yet implemented!"));
-return SC_ERROR;
-#if 0
 	// if there is no filename, this is a new file being created, find an appropriate filename
 	if( filename.isEmpty() )
 		filename = findNextSaveFilename( desc );
@@ -578,16 +611,12 @@ return SC_ERROR;
 	// save description as current description in the game state
 	m_gameInfo.description = desc;
 
-	// open the save file
-	XferSave xferSave;
-	try {
-		xferSave.open( filepath );
-	} catch(...) {
-		// print error message to the user
-		TheInGameUI->message( "GUI:Error" );
-		DEBUG_LOG(( "Error opening file '%s'\n", filepath.str() ));
-		return SC_ERROR;
-	}
+	// the whole save is built in memory, only handing it to the writer thread touches the disk
+#ifdef DEBUG_LOGGING
+	std::chrono::steady_clock::time_point saveStart = std::chrono::steady_clock::now();
+#endif
+	XferSaveMemory xferSave;
+	xferSave.open( filepath );
 
 	// save our save file type
 	SaveGameInfo *gameInfo = getSaveGameInfo();
@@ -622,22 +651,33 @@ return SC_ERROR;
 
 		MessageBoxOk(TheGameText->fetch("GUI:Error"), msg, NULL);
 
-		// close the file and get out of here
+		// close the image and get out of here, nothing was written
 		xferSave.close();
 		return SC_ERROR;
 		
 	}  // end catch
 
-	// close the file
 	xferSave.close();
 
-	// print message to the user for game successfully saved
-	UnicodeString msg = TheGameText->fetch( "GUI:GameSaveComplete" );
-	TheInGameUI->message( msg );
+	// queue the image to be written, compressed if asked to
+	if( m_saveWriter == NULL )
+		m_saveWriter = NEW SaveGameWriter;
+#ifdef DEBUG_LOGGING
+	size_t imageSize = xferSave.getImage().size();
+#endif
+	CompressionType compression = TheGlobalData->m_data.m_compressSaveGames ? CompressionManager::getPreferredCompression() : COMPRESSION_NONE;
+	m_saveWriter->write( filepath, xferSave.getImage(), compression );
+
+	// this is the time the player actually waits, the writer reports its own time when it's done
+#ifdef DEBUG_LOGGING
+	DEBUG_LOG(( "GameState::saveGame - '%s' serialized %d bytes, main thread stalled %.2f ms\n",
+							filepath.str(), static_cast<Int>(imageSize),
+							std::chrono::duration<Real, std::milli>(std::chrono::steady_clock::now() - saveStart).count() ));
+#endif
 
+	// the player is told the save is complete, or that it failed, by update() once the write is done
 	return SC_OK;
 
-#endif // if 0
 }  // end saveGame
 
 // ------------------------------------------------------------------------------------------------
@@ -694,6 +734,10 @@ return SC_ERROR;
 	// construct path to file
 	AsciiString filepath = getFilePathInSaveDirectory(gameInfo.filename);
 
+	// the file may still be on its way to disk
+	if( m_saveWriter )
+		m_saveWriter->flush();
+
 	// open the save file
 	XferLoad xferLoad;
 	xferLoad.open( filepath );
@@ -965,6 +1009,10 @@ Bool GameState::doesSaveGameExist( AsciiString filename )
 	// construct full path to file
 	AsciiString filepath = getFilePathInSaveDirectory(filename);
 
+	// a save that's still being written counts, it will be there before anyone can read it
+	if( m_saveWriter && m_saveWriter->isPending( filepath ) )
+		return TRUE;
+
 	const std::filesystem::path path{filepath.str()};
 	return std::filesystem::exists(path);
 
@@ -1016,6 +1064,10 @@ DEBUG_CRASH(("GameState::getSaveGameInfoFromFile not yet implemented!"));
 
 	}  // end if
 
+	// the file may still be on its way to disk
+	if( m_saveWriter && m_saveWriter->isPending( filename ) )
+		m_saveWriter->flush();
+
 	// open file for partial loading
 	XferLoad xferLoad;
 	xferLoad.open( filename );
@@ -1360,6 +1412,244 @@ DEBUG_CRASH(("GameState::iterateSaveFiles not yet implemented!"));
 #endif // if 0
 }  // end iterateSaveFiles
 
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+/** Serialize the running game into 'image' exactly as saveGame would, but without touching
+	* the disk or the save game info the player sees.  Returns FALSE if any block failed */
+// ------------------------------------------------------------------------------------------------
+Bool GameState::saveToImage( std::vector<UnsignedByte>& image )
+{
+
+	// a snapshot is always a full save, never a mission save
+	LatchRestore<SaveFileType> saveType( m_gameInfo.saveFileType, SAVE_FILE_TYPE_NORMAL );
+
+	XferSaveMemory xferSave;
+	xferSave.open( "snapshot" );
+
+	Bool error = FALSE;
+	try
+	{
+		xferSaveData( &xferSave, SNAPSHOT_SAVELOAD );
+	}
+	catch( ... )
+	{
+		error = TRUE;
+	}
+
+	xferSave.close();
+
+	image.clear();
+	if( error == FALSE )
+		image.swap( xferSave.getImage() );
+
+	return !error;
+
+}  // end saveToImage
+
+// ------------------------------------------------------------------------------------------------
+/** Restore a game from an image made by saveToImage.  This follows loadGame, the engine is
+	* reset and every block is loaded and post processed.  On failure the engine is left reset,
+	* unless there were no blocks to load into, which fails before anything is touched */
+// ------------------------------------------------------------------------------------------------
+Bool GameState::loadFromImage( const std::vector<UnsignedByte>& image )
+{
+
+	// with nothing registered to load, every block would be skipped and we'd "restore" an empty game
+	if( m_snapshotBlockList[ SNAPSHOT_SAVELOAD ].empty() )
+	{
+		DEBUG_LOG(( "GameState::loadFromImage - no blocks to load the snapshot into\n" ));
+		return FALSE;
+	}
+
+	XferLoad xferLoad;
+	try
+	{
+		xferLoad.openImage( "snapshot", image );
+	}
+	catch( ... )
+	{
+		return FALSE;
+	}
+
+	// clear out the game engine
+	TheGameEngine->reset();
+
+	// lock creation of new ghost objects
+	TheGhostObjectManager->saveLockGhostObjects( TRUE );
+
+	LatchRestore<Bool> inLoadGame(m_isInLoadGame, TRUE);
+
+	// load the snapshot data
+	Bool error = FALSE;
+	try
+	{
+		xferSaveData( &xferLoad, SNAPSHOT_SAVELOAD );
+	}
+	catch( ... )
+	{
+		error = TRUE;
+	}
+
+	xferLoad.close();
+
+	// un-savelock the ghost objects
+	TheGhostObjectManager->saveLockGhostObjects( FALSE );
+
+	try
+	{
+		gameStatePostProcessLoad();
+	}
+	catch( ... )
+	{
+		error = TRUE;
+	}
+
+	if( error == TRUE )
+	{
+
+		if( TheGameLogic->isInGame() )
+			TheGameLogic->clearGameData( FALSE );
+		TheGameEngine->reset();
+
+	}  // end if
+
+	return !error;
+
+}  // end loadFromImage
+
+// ------------------------------------------------------------------------------------------------
+static Bool readSaveBenchmarkFile( const AsciiString& filepath, std::vector<UnsignedByte>& contents )
+{
+	contents.clear();
+	FILE *fp = fopen( filepath.str(), "rb" );
+	if( fp == NULL )
+		return FALSE;
+
+	UnsignedByte buffer[ 64 * 1024 ];
+	size_t read;
+	while( (read = fread( buffer, 1, sizeof(buffer), fp )) > 0 )
+		contents.insert( contents.end(), buffer, buffer + read );
+	fclose( fp );
+	return TRUE;
+
+}  // end readSaveBenchmarkFile
+
+// ------------------------------------------------------------------------------------------------
+/** Save the running game the way saves used to be written, through XferSave straight to disk,
+	* and the way saveGame does now, into memory and through a SaveGameWriter.  Reports how long
+	* the main thread waits for each and whether the two files are byte for byte the same */
+// ------------------------------------------------------------------------------------------------
+AsciiString GameState::reportSaveBenchmark( void )
+{
+	const Int SAVE_BENCHMARK_RUNS = 5;
+
+	//
+	// most save blocks are still stubbed out in this port, so until they're registered, save
+	// the logic blocks whose xfer is there
+	//
+	SnapshotBlockList blocks = m_snapshotBlockList[SNAPSHOT_SAVELOAD];
+	if( blocks.empty() )
+	{
+		Snapshot *logicBlocks[] = { TheTeamFactory, TheSidesList, ThePartitionManager, TheRadar };
+		const char *logicBlockNames[] = { "CHUNK_TeamFactory", "CHUNK_SidesList", "CHUNK_Partition", "CHUNK_Radar" };
+		for( Int i = 0; i < ARRAY_SIZE(logicBlocks); ++i )
+		{
+			if( logicBlocks[i] == NULL )
+				continue;
+			SnapshotBlock block;
+			block.snapshot = logicBlocks[i];
+			block.blockName = logicBlockNames[i];
+			blocks.push_back( block );
+		}
+	}
+	std::swap( blocks, m_snapshotBlockList[SNAPSHOT_SAVELOAD] );
+	LatchRestore<SaveFileType> saveType( m_gameInfo.saveFileType, SAVE_FILE_TYPE_NORMAL );
+
+	TheFileSystem->createDirectory( getSaveDirectory() );
+	AsciiString directPath = getFilePathInSaveDirectory( "SaveBenchmarkDirect.sav" );
+	AsciiString writerPath = getFilePathInSaveDirectory( "SaveBenchmarkWriter.sav" );
+
+	SaveGameWriter writer;
+	Real directMilliseconds = 0.0f;
+	Real stallMilliseconds = 0.0f;
+	Real finishedMilliseconds = 0.0f;
+	size_t fileSize = 0;
+	Int mismatches = 0;
+	Bool error = FALSE;
+
+	for( Int run = 0; run < SAVE_BENCHMARK_RUNS && error == FALSE; ++run )
+	{
+
+		std::vector<UnsignedByte> image;
+		try
+		{
+
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			XferSave xferDirect;
+			xferDirect.open( directPath );
+			xferSaveData( &xferDirect, SNAPSHOT_SAVELOAD );
+			xferDirect.close();
+			directMilliseconds += std::chrono::duration<Real, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			start = std::chrono::steady_clock::now();
+			XferSaveMemory xferMemory;
+			xferMemory.open( writerPath );
+			xferSaveData( &xferMemory, SNAPSHOT_SAVELOAD );
+			xferMemory.close();
+			Real serializeMilliseconds = std::chrono::duration<Real, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			// keep a copy to compare with, the writer takes the original; this isn't timed
+			image = xferMemory.getImage();
+
+			start = std::chrono::steady_clock::now();
+			writer.write( writerPath, xferMemory.getImage(), COMPRESSION_NONE );
+			Real queueMilliseconds = std::chrono::duration<Real, std::milli>(std::chrono::steady_clock::now() - start).count();
+			writer.flush();
+			stallMilliseconds += serializeMilliseconds + queueMilliseconds;
+			finishedMilliseconds += serializeMilliseconds + std::chrono::duration<Real, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		}  // end try
+		catch( ... )
+		{
+			error = TRUE;
+			break;
+		}
+
+		if( writer.reportFinishedWrites() != 1 )
+			error = TRUE;
+
+		std::vector<UnsignedByte> direct, written;
+		if( !readSaveBenchmarkFile( directPath, direct ) || !readSaveBenchmarkFile( writerPath, written ) )
+			error = TRUE;
+		if( direct != written || direct != image )
+			++mismatches;
+		fileSize = direct.size();
+
+	}  // end for
+
+	std::swap( blocks, m_snapshotBlockList[SNAPSHOT_SAVELOAD] );
+	std::error_code removeError;
+	std::filesystem::remove( directPath.str(), removeError );
+	std::filesystem::remove( writerPath.str(), removeError );
+
+	AsciiString report;
+	if( error )
+	{
+		report.format( "  save: failed to save %d blocks\n", static_cast<Int>(blocks.size()) );
+		return report;
+	}
+	report.format( "  save: %d blocks, %d bytes, mean of %d runs\n"
+								 "    XferSave to disk          %.3f ms on the main thread\n"
+								 "    XferSaveMemory + writer   %.3f ms on the main thread, on disk after %.3f ms\n"
+								 "    %d runs wrote files that differ\n",
+								 static_cast<Int>(blocks.size()), static_cast<Int>(fileSize), SAVE_BENCHMARK_RUNS,
+								 directMilliseconds / SAVE_BENCHMARK_RUNS,
+								 stallMilliseconds / SAVE_BENCHMARK_RUNS, finishedMilliseconds / SAVE_BENCHMARK_RUNS,
+								 mismatches );
+	return report;
+
+}  // end reportSaveBenchmark
+
 // ------------------------------------------------------------------------------------------------
 /** Save game to xfer or load game using xfer */
 // ------------------------------------------------------------------------------------------------
@@ -1390,6 +1680,13 @@ void GameState::xferSaveData( Xfer *xfer, SnapshotType which )
 	{
 		DEBUG_LOG(("GameState::xferSaveData() - XFER_SAVE\n"));
 
+		// a file with nothing but the end token would load as an empty game
+		if( m_snapshotBlockList[which].empty() )
+		{
+			DEBUG_LOG(( "GameState::xferSaveData - no blocks to save in '%s'\n", xfer->getIdentifier() ));
+			throw SC_INVALID_DATA;
+		}
+
 		// save all blocks
 		AsciiString blockName;
 		SnapshotBlock *blockInfo;
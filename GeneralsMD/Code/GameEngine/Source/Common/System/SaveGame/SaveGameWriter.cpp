@@ -0,0 +1,276 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// FILE: SaveGameWriter.cpp ///////////////////////////////////////////////////////////////////////
+// Desc:   Writes finished save game images to disk on a background thread
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// INCLUDES ///////////////////////////////////////////////////////////////////////////////////////
+#include "PreRTS.h"	// This must go first in EVERY cpp file int the GameEngine
+
+#include "Common/SaveGameWriter.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#ifdef _UNIX
+#include <unistd.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS //////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+static Real millisecondsSince( std::chrono::steady_clock::time_point start )
+{
+	return std::chrono::duration<Real, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS ///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+SaveGameWriter::SaveGameWriter( void )
+{
+
+}  // end SaveGameWriter
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+SaveGameWriter::~SaveGameWriter( void )
+{
+
+	if( m_thread.joinable() )
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_quit = TRUE;
+		}
+		m_wake.notify_one();
+
+		// the thread finishes the queue before it quits
+		m_thread.join();
+	}
+
+	reportFinishedWrites();
+
+}  // end ~SaveGameWriter
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+void SaveGameWriter::write( const AsciiString& filepath, std::vector<UnsignedByte>& image, CompressionType compression )
+{
+
+	// the image is megabytes; its compression buffer is allocated here, and both come back to
+	// be freed in reportFinishedWrites, so the writer thread never takes the big blocks
+	std::vector<UnsignedByte> compressed;
+	if( compression != COMPRESSION_NONE && !image.empty() )
+		compressed.resize( static_cast<size_t>(CompressionManager::getMaxCompressedSize( static_cast<Int>(image.size()), compression )) );
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		m_jobs.emplace_back();
+		Job &job = m_jobs.back();
+		job.m_filepath = filepath.str();
+		job.m_image.swap( image );
+		job.m_compressed.swap( compressed );
+		job.m_compression = compression;
+	}
+
+	if( m_thread.joinable() == FALSE )
+		m_thread = std::thread( &SaveGameWriter::threadMain, this );
+
+	m_wake.notify_one();
+
+}  // end write
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+void SaveGameWriter::flush( void )
+{
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_idle.wait( lock, [this]() { return m_jobs.empty() && !m_busy; } );
+	}
+
+}  // end flush
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+Bool SaveGameWriter::isPending( const AsciiString& filepath )
+{
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if( m_busy && m_activeFilepath == filepath.str() )
+		return TRUE;
+
+	for( std::deque<Job>::const_iterator it = m_jobs.begin(); it != m_jobs.end(); ++it )
+		if( it->m_filepath == filepath.str() )
+			return TRUE;
+
+	return FALSE;
+
+}  // end isPending
+
+//-------------------------------------------------------------------------------------------------
+/** The writer thread can't use the debug log or the UI, so it leaves its results for us to report
+	* here.  The files that couldn't be written are added to failedFiles. */
+//-------------------------------------------------------------------------------------------------
+Int SaveGameWriter::reportFinishedWrites( std::vector<AsciiString> *failedFiles )
+{
+
+	std::vector<Result> results;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		results.swap( m_results );
+	}
+
+	Int written = 0;
+	for( std::vector<Result>::const_iterator it = results.begin(); it != results.end(); ++it )
+	{
+
+		if( it->m_ok )
+		{
+			DEBUG_LOG(( "SaveGameWriter - wrote '%s', %d bytes (%d on disk), compress %.2f ms, write %.2f ms\n",
+									it->m_filepath.c_str(), static_cast<Int>(it->m_imageSize), static_cast<Int>(it->m_writtenSize),
+									it->m_compressMilliseconds, it->m_writeMilliseconds ));
+			++written;
+		}
+		else
+		{
+			DEBUG_LOG(( "SaveGameWriter - Error writing '%s'\n", it->m_filepath.c_str() ));
+			if( failedFiles )
+				failedFiles->push_back( AsciiString( it->m_filepath.c_str() ) );
+		}
+
+	}  // end for
+
+	return written;
+
+}  // end reportFinishedWrites
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+void SaveGameWriter::threadMain( void )
+{
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	for (;;)
+	{
+
+		m_wake.wait( lock, [this]() { return m_quit || !m_jobs.empty(); } );
+
+		if( m_jobs.empty() )
+			break;		// quitting, and nothing left to write
+
+		Job job;
+		job.m_filepath.swap( m_jobs.front().m_filepath );
+		job.m_image.swap( m_jobs.front().m_image );
+		job.m_compressed.swap( m_jobs.front().m_compressed );
+		job.m_compression = m_jobs.front().m_compression;
+		m_jobs.pop_front();
+		m_activeFilepath = job.m_filepath;
+		m_busy = TRUE;
+
+		lock.unlock();
+
+		Result result;
+		writeJob( job, result );
+		result.m_image.swap( job.m_image );
+		result.m_compressed.swap( job.m_compressed );
+
+		lock.lock();
+
+		m_results.push_back( std::move( result ) );
+		m_activeFilepath.clear();
+		m_busy = FALSE;
+		if( m_jobs.empty() )
+			m_idle.notify_all();
+
+	}  // end for
+
+}  // end threadMain
+
+//-------------------------------------------------------------------------------------------------
+/** Compress the image if asked to, write it beside its destination and rename it into place */
+//-------------------------------------------------------------------------------------------------
+void SaveGameWriter::writeJob( Job& job, Result& result )
+{
+
+	result.m_filepath = job.m_filepath;
+	result.m_imageSize = job.m_image.size();
+
+	const UnsignedByte *data = job.m_image.data();
+	size_t dataSize = job.m_image.size();
+
+	if( job.m_compression != COMPRESSION_NONE && !job.m_compressed.empty() )
+	{
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		Int imageSize = static_cast<Int>(dataSize);
+		Int compressedSize = CompressionManager::compressData( job.m_compression, job.m_image.data(), imageSize,
+																													 job.m_compressed.data(), static_cast<Int>(job.m_compressed.size()) );
+
+		// keep the image as it is if compression failed or didn't help
+		if( compressedSize > 0 && compressedSize < imageSize )
+		{
+			data = job.m_compressed.data();
+			dataSize = static_cast<size_t>(compressedSize);
+		}
+
+		result.m_compressMilliseconds = millisecondsSince( start );
+
+	}  // end if
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	std::string tempPath = job.m_filepath + ".tmp";
+	FILE *fp = fopen( tempPath.c_str(), "wb" );
+	if( fp == NULL )
+		return;
+
+	Bool ok = dataSize == 0 || fwrite( data, dataSize, 1, fp ) == 1;
+	ok = fflush( fp ) == 0 && ok;
+#ifdef _UNIX
+	// make sure the data is on disk before the rename makes it the real save
+	ok = fsync( fileno( fp ) ) == 0 && ok;
+#endif
+	ok = fclose( fp ) == 0 && ok;
+
+	std::error_code error;
+	if( ok )
+	{
+		std::filesystem::rename( tempPath, job.m_filepath, error );
+		ok = !error;
+	}
+	if( !ok )
+		std::filesystem::remove( tempPath, error );
+
+	result.m_writtenSize = dataSize;
+	result.m_writeMilliseconds = millisecondsSince( start );
+	result.m_ok = ok;
+
+}  // end writeJob
+
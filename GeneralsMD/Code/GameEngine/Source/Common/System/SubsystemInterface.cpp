@@ -40,6 +40,11 @@
 #include "Common/PerfTimer.h"
 
 Real SubsystemInterface::s_msConsumed = 0;
+#else
+#include <chrono>
+
+Bool SubsystemInterface::s_timeUpdates = FALSE;
+Int64 SubsystemInterface::s_nestedUpdateNanos = 0;
 #endif
 
 //-----------------------------------------------------------------------------
@@ -120,6 +125,24 @@ void SubsystemInterface::DRAW(void)
 	}
 
 }
+#else
+//-----------------------------------------------------------------------------
+void SubsystemInterface::timedUpdate(void)
+{
+	Int64 outerNested = s_nestedUpdateNanos;
+	s_nestedUpdateNanos = 0;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	update();
+	Int64 elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+	m_updateNanosGross += elapsed;
+	m_updateNanosNet += elapsed - s_nestedUpdateNanos;
+	++m_updateCount;
+
+	// to whoever is updating us, all of our time counts as nested
+	s_nestedUpdateNanos = outerNested + elapsed;
+}
 #endif
 
 
@@ -136,24 +159,20 @@ SubsystemInterfaceList::~SubsystemInterfaceList()
 }
 
 //-----------------------------------------------------------------------------
-void SubsystemInterfaceList::addSubsystem([[maybe_unused]] SubsystemInterface* sys)
+void SubsystemInterfaceList::addSubsystem(SubsystemInterface* sys)
 {
-#ifdef DUMP_PERF_STATS
 	m_allSubsystems.push_back(sys);
-#endif
 }
 //-----------------------------------------------------------------------------
-void SubsystemInterfaceList::removeSubsystem([[maybe_unused]] SubsystemInterface* sys)
+void SubsystemInterfaceList::removeSubsystem(SubsystemInterface* sys)
 {
-#ifdef DUMP_PERF_STATS
-	for (SubsystemList::iterator it = m_allSubsystems.begin(); it != m_subsystems.end(); ++it)
+	for (SubsystemList::iterator it = m_allSubsystems.begin(); it != m_allSubsystems.end(); ++it)
 	{	 
 		if ( (*it) == sys) {
 			m_allSubsystems.erase(it);
 			break;
 		}
 	}
-#endif
 }
 //-----------------------------------------------------------------------------
 void SubsystemInterfaceList::initSubsystem(SubsystemInterface* sys, const char* path1, const char* path2, const char* dirpath, Xfer *pXfer, AsciiString name)
@@ -241,4 +260,42 @@ AsciiString SubsystemInterfaceList::dumpTimesForAll()
 	buffer.concat(tmp);
 	return buffer;
 }
-#endif
\ No newline at end of file
+#else
+//-----------------------------------------------------------------------------
+void SubsystemInterfaceList::clearUpdateTimesForAll()
+{
+	for (SubsystemList::iterator it = m_allSubsystems.begin(); it != m_allSubsystems.end(); ++it)
+	{
+		(*it)->clearUpdateTimes();
+	}
+}
+
+//-----------------------------------------------------------------------------
+/** One line per subsystem that was updated while timing was on, with its gross and net
+	* (excluding nested subsystem updates) time per frame. */
+//-----------------------------------------------------------------------------
+AsciiString SubsystemInterfaceList::reportUpdateTimesForAll(Int frames)
+{
+	if (frames < 1)
+		frames = 1;
+
+	AsciiString buffer;
+	buffer = "SUBSYSTEM UPDATES (ms/frame gross, net, calls):\n";
+	for (SubsystemList::iterator it = m_allSubsystems.begin(); it != m_allSubsystems.end(); ++it)
+	{
+		SubsystemInterface* sys = *it;
+		if (sys->getUpdateCount() == 0)
+			continue;
+
+		AsciiString name = sys->getName();
+		AsciiString curLine;
+		curLine.format("  %8.3f %8.3f %8d  %s\n",
+			(double)sys->getUpdateNanosGross() / 1.0e6 / frames,
+			(double)sys->getUpdateNanosNet() / 1.0e6 / frames,
+			sys->getUpdateCount(),
+			name.isEmpty() ? "(unnamed)" : name.str());
+		buffer.concat(curLine);
+	}
+	return buffer;
+}
+#endif
@@ -33,8 +33,8 @@
 #include "Common/XferCRC.h"
 #include "Common/XferDeepCRC.h"
 #include "Common/CRC.h"
+#include "Common/CRCEngine.h"
 #include "Common/Snapshot.h"
-#include <arpa/inet.h> // for htonl
 
 //-------------------------------------------------------------------------------------------------
 //-------------------------------------------------------------------------------------------------
@@ -97,22 +97,13 @@ void XferCRC::endBlock( void )
 //-------------------------------------------------------------------------------------------------
 void XferCRC::addCRC( UnsignedInt val )
 {
-	UnsignedInt hibit;
 
-	val = htonl(val);
+	val = CRCEngine::toNetwork(val);
 
-	if (m_crc & 0x80000000)
-	{
-		hibit = 1;
-	}
-	else
-	{
-		hibit = 0;
-	}
+	if (m_capture)
+		m_capture->push_back(val);
 
-	m_crc <<= 1;
-	m_crc += val;
-	m_crc += hibit;
+	m_crc = CRCEngine::fold(m_crc, val);
 
 }  // end addCRC
 
@@ -137,7 +128,7 @@ void XferCRC::xferSnapshot( Snapshot *snapshot )
 //-------------------------------------------------------------------------------------------------
 /** Perform a single CRC operation on the data passed in */
 //-------------------------------------------------------------------------------------------------
-void XferCRC::xferImplementation( void *data, UnsignedInt dataSize )
+void XferCRC::xferImplementation( void *data, Int dataSize )
 {
 
 	if (!data || dataSize < 1)
@@ -145,28 +136,27 @@ void XferCRC::xferImplementation( void *data, UnsignedInt dataSize )
 		return;
 	}
 
-	const UnsignedInt *uintPtr = (const UnsignedInt *) (data);
+	if (m_capture)
+		CRCEngine::appendXferWords(*m_capture, data, static_cast<UnsignedInt>(dataSize));
 
-	for (UnsignedInt i=0 ; i<dataSize/4 ; i++)
-	{
-		addCRC (*uintPtr++);
-	}
-
-	int leftover = dataSize & 3;
-	if (leftover)
-	{
-		UnsignedInt val = 0;
-		const unsigned char *c = (const unsigned char *)uintPtr;
-		for (Int i=0; i<leftover; i++)
-		{
-			val += (c[i] << (i*8));
-		}
-		val = htonl(val);
-		addCRC (val);
-	}
+	m_crc = CRCEngine::foldXferData(m_crc, data, static_cast<UnsignedInt>(dataSize));
 	
 }  // end xferImplementation
 
+//-------------------------------------------------------------------------------------------------
+/** Fold words previously collected with setCapture(), exactly as if the data that produced
+	* them had been xfered again */
+//-------------------------------------------------------------------------------------------------
+void XferCRC::addCRCWords( const UnsignedInt *words, UnsignedInt count )
+{
+
+	if (m_capture)
+		m_capture->insert(m_capture->end(), words, words + count);
+
+	m_crc = CRCEngine::foldWords(m_crc, words, count);
+
+}  // end addCRCWords
+
 //-------------------------------------------------------------------------------------------------
 //-------------------------------------------------------------------------------------------------
 void XferCRC::skip( Int )
@@ -179,7 +169,7 @@ void XferCRC::skip( Int )
 UnsignedInt XferCRC::getCRC( void )
 {
 
-	return htonl(m_crc);
+	return CRCEngine::toNetwork(m_crc);
 
 }  // end skip
 
@@ -273,7 +263,7 @@ void XferDeepCRC::close( void )
 //-------------------------------------------------------------------------------------------------
 /** Perform a single CRC operation on the data passed in */
 //-------------------------------------------------------------------------------------------------
-void XferDeepCRC::xferImplementation( void *data, UnsignedInt dataSize )
+void XferDeepCRC::xferImplementation( void *data, Int dataSize )
 {
 
 	if (!data || dataSize < 1)
@@ -286,7 +276,7 @@ void XferDeepCRC::xferImplementation( void *data, UnsignedInt dataSize )
 										 m_identifier.str()) );
 
 	// write data to file
-	if( fwrite( data, dataSize, 1, m_fileFP ) != 1 )
+	if( fwrite( data, static_cast<size_t>(dataSize), 1, m_fileFP ) != 1 )
 	{
 
 		DEBUG_CRASH(( "XferSave - Error writing to file '%s'\n", m_identifier.str() ));
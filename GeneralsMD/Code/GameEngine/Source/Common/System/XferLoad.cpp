@@ -33,6 +33,7 @@
 #include "Common/GameState.h"
 #include "Common/Snapshot.h"
 #include "Common/XferLoad.h"
+#include "Compression.h"
 
 //-------------------------------------------------------------------------------------------------
 //-------------------------------------------------------------------------------------------------
@@ -89,8 +90,84 @@ void XferLoad::open( AsciiString identifier )
 
 	}  // end if
 
+	//
+	// save games may have been compressed by the SaveGameWriter, in which case we decompress
+	// the whole thing and read from memory.  Everything after this works on m_fileFP as usual.
+	//
+	char header[ 8 ];
+	size_t headerSize = fread( header, 1, sizeof( header ), m_fileFP );
+	if( CompressionManager::isDataCompressed( header, static_cast<Int>(headerSize) ) == FALSE )
+	{
+
+		rewind( m_fileFP );
+		return;
+
+	}  // end if
+
+	fseek( m_fileFP, 0, SEEK_END );
+	long fileSize = ftell( m_fileFP );
+	rewind( m_fileFP );
+
+	std::vector<UnsignedByte> compressed( static_cast<size_t>(fileSize) );
+	Bool ok = fread( compressed.data(), compressed.size(), 1, m_fileFP ) == 1;
+	fclose( m_fileFP );
+	m_fileFP = NULL;
+
+	Int imageSize = ok ? CompressionManager::getUncompressedSize( compressed.data(), static_cast<Int>(fileSize) ) : 0;
+	if( imageSize > 0 )
+	{
+
+		m_image.resize( static_cast<size_t>(imageSize) );
+		if( CompressionManager::decompressData( compressed.data(), static_cast<Int>(fileSize), m_image.data(), imageSize ) == imageSize )
+			m_fileFP = fmemopen( m_image.data(), m_image.size(), "rb" );
+
+	}  // end if
+
+	if( m_fileFP == NULL )
+	{
+
+		DEBUG_CRASH(( "File '%s' could not be decompressed\n", identifier.str() ));
+		m_image.clear();
+		throw XFER_READ_ERROR;
+
+	}  // end if
+
 }  // end open
 
+//-------------------------------------------------------------------------------------------------
+/** Open an in-memory image, as built by XferSaveMemory, for reading.  The image is copied so
+	* the caller is free to discard or reuse it while we're open */
+//-------------------------------------------------------------------------------------------------
+void XferLoad::openImage( AsciiString identifier, const std::vector<UnsignedByte>& image )
+{
+
+	// sanity, check to see if we're already open
+	if( m_fileFP != NULL )
+	{
+
+		DEBUG_CRASH(( "Cannot open image '%s' cause we've already got '%s' open\n",
+									identifier.str(), m_identifier.str() ));
+		throw XFER_FILE_ALREADY_OPEN;
+
+	}  // end if
+
+	// call base class
+	Xfer::open( identifier );
+
+	m_image = image;
+	if( m_image.empty() == FALSE )
+		m_fileFP = fmemopen( m_image.data(), m_image.size(), "rb" );
+	if( m_fileFP == NULL )
+	{
+
+		DEBUG_CRASH(( "Image '%s' could not be opened\n", identifier.str() ));
+		m_image.clear();
+		throw XFER_FILE_NOT_FOUND;
+
+	}  // end if
+
+}  // end openImage
+
 //-------------------------------------------------------------------------------------------------
 /** Close our current file */
 //-------------------------------------------------------------------------------------------------
@@ -109,6 +186,7 @@ void XferLoad::close( void )
 	// close the file
 	fclose( m_fileFP );
 	m_fileFP = NULL;
+	m_image.clear();
 
 	// erase the filename
 	m_identifier.clear();
@@ -248,7 +326,7 @@ void XferLoad::xferImplementation( void *data, Int dataSize )
 										 m_identifier.str()) );
 
 	// read data from file
-	if( fread( data, dataSize, 1, m_fileFP ) != 1 )
+	if( fread( data, static_cast<size_t>(dataSize), 1, m_fileFP ) != 1 )
 	{
 
 		DEBUG_CRASH(( "XferLoad - Error reading from file '%s'\n", m_identifier.str() ));
@@ -40,8 +40,8 @@ class XferBlockData : public MemoryPoolObject
 
 public:
 
-	XferFilePos filePos;			///< the file position of this block
-	XferBlockData *next;			///< next block on the stack
+	XferFilePos filePos {};			///< the file position of this block
+	XferBlockData *next {};			///< next block on the stack
 
 };
 EMPTY_DTOR(XferBlockData)
@@ -234,7 +234,7 @@ void XferSave::endBlock( void )
 	fseek( m_fileFP, top->filePos, SEEK_SET );
 
 	// write the size in bytes between the block position and what is our current file position
-	XferBlockSize blockSize = currentFilePos - top->filePos - sizeof( XferBlockSize );
+	XferBlockSize blockSize = static_cast<XferBlockSize>(currentFilePos - top->filePos - static_cast<XferFilePos>(sizeof( XferBlockSize )));
 	if( fwrite( &blockSize, sizeof( XferBlockSize ), 1, m_fileFP ) != 1 )
 	{
 
@@ -347,7 +347,7 @@ void XferSave::xferImplementation( void *data, Int dataSize )
 										 m_identifier.str()) );
 
 	// write data to file
-	if( fwrite( data, dataSize, 1, m_fileFP ) != 1 )
+	if( fwrite( data, static_cast<size_t>(dataSize), 1, m_fileFP ) != 1 )
 	{
 
 		DEBUG_CRASH(( "XferSave - Error writing to file '%s'\n", m_identifier.str() ));
@@ -0,0 +1,169 @@
+/*
+**	Command & Conquer Generals Zero Hour(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// FILE: XferSaveMemory.cpp ///////////////////////////////////////////////////////////////////////
+// Desc:   Xfer save implementation that builds the file image in memory
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// USER INCLUDES //////////////////////////////////////////////////////////////////////////////////
+#include "PreRTS.h"	// This must go first in EVERY cpp file int the GameEngine
+#include "Common/XferSaveMemory.h"
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// PUBLIC METHDOS /////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+XferSaveMemory::XferSaveMemory( void )
+{
+
+}  // end XferSaveMemory
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+XferSaveMemory::~XferSaveMemory( void )
+{
+
+	// the block stack should be empty, same as XferSave
+	if( m_blockStack.empty() == FALSE )
+	{
+
+		DEBUG_CRASH(( "Warning: XferSaveMemory::~XferSaveMemory - block stack was not empty!\n" ));
+
+	}  // end if
+
+}  // end ~XferSaveMemory
+
+//-------------------------------------------------------------------------------------------------
+/** Start a new, empty image */
+//-------------------------------------------------------------------------------------------------
+void XferSaveMemory::open( AsciiString identifier )
+{
+
+	// sanity, check to see if we're already open
+	if( m_isOpen )
+	{
+
+		DEBUG_CRASH(( "Cannot open '%s' cause we've already got '%s' open\n",
+									identifier.str(), m_identifier.str() ));
+		throw XFER_FILE_ALREADY_OPEN;
+
+	}  // end if
+
+	// call base class
+	Xfer::open( identifier );
+
+	m_image.clear();
+	m_blockStack.clear();
+	m_isOpen = TRUE;
+
+}  // end open
+
+//-------------------------------------------------------------------------------------------------
+/** Finish the image.  It stays in getImage() until the next open */
+//-------------------------------------------------------------------------------------------------
+void XferSaveMemory::close( void )
+{
+
+	// sanity, if we aren't open we can do nothing
+	if( m_isOpen == FALSE )
+	{
+
+		DEBUG_CRASH(( "Xfer close called, but no image was open\n" ));
+		throw XFER_FILE_NOT_OPEN;
+
+	}  // end if
+
+	m_isOpen = FALSE;
+
+	// erase the identifier
+	m_identifier.clear();
+
+}  // end close
+
+//-------------------------------------------------------------------------------------------------
+/** Write a placeholder block size and remember where it is, see XferSave::beginBlock */
+//-------------------------------------------------------------------------------------------------
+Int XferSaveMemory::beginBlock( void )
+{
+
+	// sanity
+	DEBUG_ASSERTCRASH( m_isOpen, ("Xfer begin block - '%s' is not open\n", m_identifier.str()) );
+
+	m_blockStack.push_back( m_image.size() );
+
+	// write a placeholder
+	XferBlockSize blockSize = 0;
+	xferImplementation( &blockSize, sizeof( XferBlockSize ) );
+
+	return XFER_OK;
+
+}  // end beginBlock
+
+//-------------------------------------------------------------------------------------------------
+/** Fill in the size of the last begun block, see XferSave::endBlock */
+//-------------------------------------------------------------------------------------------------
+void XferSaveMemory::endBlock( void )
+{
+
+	// sanity, make sure we have a block started
+	if( m_blockStack.empty() )
+	{
+
+		DEBUG_CRASH(( "Xfer end block called, but no matching begin block was found\n" ));
+		throw XFER_BEGIN_END_MISMATCH;
+
+	}  // end if
+
+	size_t blockPos = m_blockStack.back();
+	m_blockStack.pop_back();
+
+	XferBlockSize blockSize = static_cast<XferBlockSize>(m_image.size() - blockPos - sizeof( XferBlockSize ));
+	memcpy( &m_image[ blockPos ], &blockSize, sizeof( XferBlockSize ) );
+
+}  // end endBlock
+
+//-------------------------------------------------------------------------------------------------
+/** Skip forward 'dataSize' bytes */
+//-------------------------------------------------------------------------------------------------
+void XferSaveMemory::skip( Int dataSize )
+{
+
+	if( dataSize > 0 )
+		m_image.resize( m_image.size() + static_cast<size_t>(dataSize) );
+
+}  // end skip
+
+//-------------------------------------------------------------------------------------------------
+/** Perform the write operation */
+//-------------------------------------------------------------------------------------------------
+void XferSaveMemory::xferImplementation( void *data, Int dataSize )
+{
+
+	// sanity
+	DEBUG_ASSERTCRASH( m_isOpen, ("XferSaveMemory - '%s' is not open\n", m_identifier.str()) );
+
+	if( dataSize <= 0 )
+		return;
+
+	const UnsignedByte *bytes = static_cast<const UnsignedByte *>(data);
+	m_image.insert( m_image.end(), bytes, bytes + dataSize );
+
+}  // end xferImplementation
+
@@ -517,6 +517,9 @@ void ThingTemplate::parseModuleName(INI* ini, void *instance, void* store, const
 	const char* token = ini->getNextToken();
 	AsciiString tokenStr = token;
 
+	// the modules are changing, so Objects created from here on will lay them out differently
+	self->m_moduleInterfaceLayout = ModuleInterfaceLayout();
+
 	// get the tag string (it is now required)
 	AsciiString moduleTagStr;
 	try
@@ -924,6 +927,7 @@ Bool ThingTemplate::removeModuleInfo(const AsciiString& moduleToRemove, AsciiStr
 	{
 		DEBUG_ASSERTCRASH(!removed, ("Hmm, multiple removed in ThingTemplate::removeModuleInfo, should this be possible?"));
 		removed = true;
+		m_moduleInterfaceLayout = ModuleInterfaceLayout();
 	}
 	if (m_ini.m_drawModuleInfo.clearModuleDataWithTag(moduleToRemove, clearedModuleNameOut))
 	{
@@ -1130,6 +1134,9 @@ ThingTemplate& ThingTemplate::operator=(const ThingTemplate& other)
 	m_perUnitSounds = other.m_perUnitSounds;
 	m_perUnitFX = other.m_perUnitFX;
 
+	// the layout was worked out for other's Objects; the next Object made from us works ours out
+	m_moduleInterfaceLayout = ModuleInterfaceLayout();
+
 	return *this;
 }
 
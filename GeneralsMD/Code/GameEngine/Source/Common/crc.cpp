@@ -26,8 +26,118 @@
 #include "PreRTS.h"	// This must go first in EVERY cpp file int the GameEngine
 
 #include "Common/CRC.h"
+#include "Common/CRCEngine.h"
 #include "Common/Debug.h"
 
+//-------------------------------------------------------------------------------------------------
+/** Fold every byte of buf into crc, eight at a time */
+//-------------------------------------------------------------------------------------------------
+UnsignedInt CRCEngine::foldBytes( UnsignedInt crc, const void *buf, Int len )
+{
+	if (!buf || len < 1)
+		return crc;
+
+	const UnsignedByte *p = (const UnsignedByte *)buf;
+	const UnsignedByte *end = p + len;
+
+	for (; end - p >= 8; p += 8)
+	{
+		crc = fold(crc, p[0]);
+		crc = fold(crc, p[1]);
+		crc = fold(crc, p[2]);
+		crc = fold(crc, p[3]);
+		crc = fold(crc, p[4]);
+		crc = fold(crc, p[5]);
+		crc = fold(crc, p[6]);
+		crc = fold(crc, p[7]);
+	}
+
+	for (; p < end; ++p)
+		crc = fold(crc, *p);
+
+	return crc;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Fold data the way XferCRC always has: whole words big endian, then any 1-3 leftover bytes
+	* as a little endian word (the original swapped them twice). */
+//-------------------------------------------------------------------------------------------------
+UnsignedInt CRCEngine::foldXferData( UnsignedInt crc, const void *data, UnsignedInt dataSize )
+{
+	if (!data || dataSize < 1)
+		return crc;
+
+	const UnsignedByte *p = (const UnsignedByte *)data;
+	UnsignedInt words = dataSize / 4;
+
+	for (; words >= 4; words -= 4, p += 16)
+	{
+		UnsignedInt w0 = loadWord(p);
+		UnsignedInt w1 = loadWord(p + 4);
+		UnsignedInt w2 = loadWord(p + 8);
+		UnsignedInt w3 = loadWord(p + 12);
+		crc = fold(crc, w0);
+		crc = fold(crc, w1);
+		crc = fold(crc, w2);
+		crc = fold(crc, w3);
+	}
+
+	for (; words > 0; --words, p += 4)
+		crc = fold(crc, loadWord(p));
+
+	UnsignedInt leftover = dataSize & 3;
+	if (leftover)
+	{
+		UnsignedInt val = 0;
+		for (UnsignedInt i = 0; i < leftover; ++i)
+			val += (UnsignedInt)p[i] << (i*8);
+		crc = fold(crc, val);
+	}
+
+	return crc;
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+UnsignedInt CRCEngine::foldWords( UnsignedInt crc, const UnsignedInt *words, UnsignedInt count )
+{
+	const UnsignedInt *end = words + count;
+
+	for (; end - words >= 4; words += 4)
+	{
+		crc = fold(crc, words[0]);
+		crc = fold(crc, words[1]);
+		crc = fold(crc, words[2]);
+		crc = fold(crc, words[3]);
+	}
+
+	for (; words < end; ++words)
+		crc = fold(crc, *words);
+
+	return crc;
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+void CRCEngine::appendXferWords( std::vector<UnsignedInt>& words, const void *data, UnsignedInt dataSize )
+{
+	if (!data || dataSize < 1)
+		return;
+
+	const UnsignedByte *p = (const UnsignedByte *)data;
+	for (UnsignedInt i = 0; i < dataSize / 4; ++i, p += 4)
+		words.push_back(loadWord(p));
+
+	UnsignedInt leftover = dataSize & 3;
+	if (leftover)
+	{
+		UnsignedInt val = 0;
+		for (UnsignedInt i = 0; i < leftover; ++i)
+			val += (UnsignedInt)p[i] << (i*8);
+		words.push_back(val);
+	}
+}
+
 #ifdef _DEBUG
 
 void CRC::addCRC( UnsignedByte val )
@@ -56,7 +56,7 @@
 #include "GameClient/Eva.h"
 #include "GameClient/GameWindowManager.h"
 #include "GameClient/GlobalLanguage.h"
-// #include "GameClient/GraphDraw.h"
+#include "GameClient/GraphDraw.h"
 // #include "GameClient/GUICommandTranslator.h"
 #include "GameClient/HeaderTemplate.h"
 // #include "GameClient/HintSpy.h"
@@ -79,7 +79,7 @@ void GraphDraw::addEntry(AsciiString str, Real val)
 //-------------------------------------------------------------------------------------------------
 void GraphDraw::render()
 {
-	Int width = TheDisplay->getWidth();
+	Int width = (Int)TheDisplay->getWidth();
 
 	// divide the width by two because we're going to use the left half of the screen for labels.
 	//width /= 2;
@@ -88,11 +88,13 @@ void GraphDraw::render()
 	Int start = width * 0.33f;
 	width -= start;
 
-	Int height = TheDisplay->getHeight();
+#ifdef _DEBUG
+	Int height = (Int)TheDisplay->getHeight();
 
 	Int totalCount = m_graphEntries.size();
 	DEBUG_ASSERTCRASH(totalCount < MAX_GRAPH_VALUES, ("MAX_GRAPH_VALUES must be increased, not all labels will appear (max %d, cur %d).\n",MAX_GRAPH_VALUES,totalCount));
 	DEBUG_ASSERTCRASH(BAR_HEIGHT * totalCount < height, ("BAR_HEIGHT must be reduced, as bars are being drawn off-screen.\n"));
+#endif
 	VecGraphEntriesIt it;
 
 	Int count = 0;
@@ -107,7 +109,7 @@ void GraphDraw::render()
 			m_displayStrings[count]->draw(5, count * BAR_HEIGHT, 0xFFFFFFFF, 0x00000000, 1, 1);
 		}
 
-		TheDisplay->drawFillRect(start, count * BAR_HEIGHT - (BAR_SPACE / 2), it->second / 100000.0f * width, BAR_HEIGHT - BAR_SPACE, 0x7FFFFFFF);
+		TheDisplay->drawFillRect(start, count * BAR_HEIGHT - (BAR_SPACE / 2), it->second / 100000.0f * width, (Int)BAR_HEIGHT - (Int)BAR_SPACE, 0x7FFFFFFF);
 
 		++count;
 	}
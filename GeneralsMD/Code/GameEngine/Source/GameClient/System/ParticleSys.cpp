@@ -29,6 +29,16 @@
 
 #include "PreRTS.h"	// This must go first in EVERY cpp file int the GameEngine
 
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <iterator>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #define DEFINE_PARTICLE_SYSTEM_NAMES
 #define DEFINE_PARTICLE_PRIORITY_NAMES
 
@@ -206,49 +216,74 @@ enum
 //todo move this somewhere more useful.
 static Real angleBetween(const Coord2D *vecA, const Coord2D *vecB);
 
+// particles that die in a ParticleSystem::update, kept between frames so it doesn't allocate
+static std::vector<Particle *> s_deadParticles;
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // Particle ///////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 // ------------------------------------------------------------------------------------------------
-/** Compute alpha rate to get to next key on given frame */
+/** Alpha rate to get from the key before 'targetKey' to it, shared by Particle and ParticleStore */
 // ------------------------------------------------------------------------------------------------
-void Particle::computeAlphaRate( void )
+static Real alphaKeyRate( const Keyframe *keys, Int targetKey )
 {
-	if (m_alphaKey[ m_alphaTargetKey ].frame == 0)
-	{
-		m_alphaRate = 0.0f;
-		return;
-	}
+	if (keys[ targetKey ].frame == 0)
+		return 0.0f;
 
-	Real delta = m_alphaKey[ m_alphaTargetKey ].value - m_alphaKey[ m_alphaTargetKey-1 ].value;
-	UnsignedInt time = m_alphaKey[ m_alphaTargetKey ].frame - m_alphaKey[ m_alphaTargetKey-1 ].frame;
+	Real delta = keys[ targetKey ].value - keys[ targetKey-1 ].value;
+	UnsignedInt time = keys[ targetKey ].frame - keys[ targetKey-1 ].frame;
 
-	m_alphaRate = delta/time;
+	return delta/time;
 }
 
 // ------------------------------------------------------------------------------------------------
-/** Compute color rate to get to next key on given frame */
+/** Color rate to get from the key before 'targetKey' to it, shared by Particle and ParticleStore */
 // ------------------------------------------------------------------------------------------------
-void Particle::computeColorRate( void )
+static void colorKeyRate( const RGBColorKeyframe *keys, Int targetKey, RGBColor *rate )
 {
-	if (m_colorKey[ m_colorTargetKey ].frame == 0)
+	if (keys[ targetKey ].frame == 0)
 	{
-		m_colorRate.red = 0.0f;
-		m_colorRate.green = 0.0f;
-		m_colorRate.blue = 0.0f;
+		rate->red = 0.0f;
+		rate->green = 0.0f;
+		rate->blue = 0.0f;
 		return;
 	}
 
-	UnsignedInt time = m_colorKey[ m_colorTargetKey ].frame - m_colorKey[ m_colorTargetKey-1 ].frame;
-	Real delta = m_colorKey[ m_colorTargetKey ].color.red - m_colorKey[ m_colorTargetKey-1 ].color.red;
-	m_colorRate.red = delta/time;
+	UnsignedInt time = keys[ targetKey ].frame - keys[ targetKey-1 ].frame;
+	Real delta = keys[ targetKey ].color.red - keys[ targetKey-1 ].color.red;
+	rate->red = delta/time;
+
+	delta = keys[ targetKey ].color.green - keys[ targetKey-1 ].color.green;
+	rate->green = delta/time;
+
+	delta = keys[ targetKey ].color.blue - keys[ targetKey-1 ].color.blue;
+	rate->blue = delta/time;
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Frame the key at 'targetKey' is due on, or 0 if there are no more keys */
+// ------------------------------------------------------------------------------------------------
+template <typename KEY>
+static inline UnsignedInt nextKeyFrame( const KEY *keys, Int targetKey )
+{
+	return (targetKey < MAX_KEYFRAMES) ? keys[ targetKey ].frame : 0;
+}
 
-	delta = m_colorKey[ m_colorTargetKey ].color.green - m_colorKey[ m_colorTargetKey-1 ].color.green;
-	m_colorRate.green = delta/time;
+// ------------------------------------------------------------------------------------------------
+/** Compute alpha rate to get to next key on given frame */
+// ------------------------------------------------------------------------------------------------
+void Particle::computeAlphaRate( void )
+{
+	m_alphaRate = alphaKeyRate( m_alphaKey, m_alphaTargetKey );
+}
 
-	delta = m_colorKey[ m_colorTargetKey ].color.blue - m_colorKey[ m_colorTargetKey-1 ].color.blue;
-	m_colorRate.blue = delta/time;
+// ------------------------------------------------------------------------------------------------
+/** Compute color rate to get to next key on given frame */
+// ------------------------------------------------------------------------------------------------
+void Particle::computeColorRate( void )
+{
+	colorKeyRate( m_colorKey, m_colorTargetKey, &m_colorRate );
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -348,16 +383,19 @@ Particle::~Particle()
 // ------------------------------------------------------------------------------------------------
 void Particle::applyForce( const Coord3D *force )
 {
-	m_accel.x += force->x;
-	m_accel.y += force->y;
-	m_accel.z += force->z;
+	m_system->getParticleStore().addAccel( m_storeSlot, force );
 }
 
 // ------------------------------------------------------------------------------------------------
-/** Update the behavior of an individual particle */
+/** Update the behavior of an individual particle, in its own fields.  ParticleStore::update does
+	* the same for every particle in a system at once, and is what ParticleSystem::update runs;
+	* this is kept so -particleBenchmark can check and time the store against it. */
 // ------------------------------------------------------------------------------------------------
-Bool Particle::update( void )
+inline Bool Particle::update( const ParticleUpdateContext &context )
 {
+	// apply 'gravity' force
+	m_accel.z += context.m_gravity;
+
 	// integrate acceleration into velocity
 	m_vel.x += m_accel.x;
 	m_vel.y += m_accel.y;
@@ -368,17 +406,13 @@ Bool Particle::update( void )
 	m_vel.z *= m_velDamping;
 
 	// integrate velocity into position
-	const Coord3D *driftVel = m_system->getDriftVelocity();
-	m_pos.x += m_vel.x + driftVel->x;
-	m_pos.y += m_vel.y + driftVel->y;
-	m_pos.z += m_vel.z + driftVel->z;
+	m_pos.x += m_vel.x + context.m_driftVelocity.x;
+	m_pos.y += m_vel.y + context.m_driftVelocity.y;
+	m_pos.z += m_vel.z + context.m_driftVelocity.z;
 
 	// integrate the wind (if specified) into position
-	ParticleSystemInfo::WindMotion windMotion = m_system->getWindMotion();
-
-	// see if we should even do anything
-	if( windMotion != ParticleSystemInfo::WIND_MOTION_NOT_USED )
-		doWindMotion();
+	if( context.m_hasWind )
+		doWindMotion( context );
 
 	// update orientation
 	m_angleZ += m_angularRateZ;
@@ -399,17 +433,20 @@ Bool Particle::update( void )
 	m_size += m_sizeRate;
 	m_sizeRate *= m_sizeRateDamping;
 
+	// keyframes are timed from the particle's creation
+	UnsignedInt age = context.m_frame - m_createTimestamp;
+
 	//
 	// Update alpha (if used)
 	//
 
-	if (m_system->getShaderType() != ParticleSystemInfo::ADDITIVE)
+	if (context.m_updateAlpha)
 	{
 		m_alpha += m_alphaRate;
 
 		if (m_alphaTargetKey < MAX_KEYFRAMES && m_alphaKey[ m_alphaTargetKey ].frame)
 		{
-			if (TheGameClient->getFrame() - m_createTimestamp >= m_alphaKey[ m_alphaTargetKey ].frame)
+			if (age >= m_alphaKey[ m_alphaTargetKey ].frame)
 			{
 				m_alpha = m_alphaKey[ m_alphaTargetKey ].value;
 				m_alphaTargetKey++;
@@ -435,7 +472,7 @@ Bool Particle::update( void )
 
 	if (m_colorTargetKey < MAX_KEYFRAMES && m_colorKey[ m_colorTargetKey ].frame)
 	{
-		if (TheGameClient->getFrame() - m_createTimestamp >= m_colorKey[ m_colorTargetKey ].frame)
+		if (age >= m_colorKey[ m_colorTargetKey ].frame)
 		{
 			// can't set, because of colorscale
 			// m_color = m_colorKey[ m_colorTargetKey ].color;
@@ -481,64 +518,25 @@ Bool Particle::update( void )
 	DEBUG_ASSERTCRASH( m_lifetimeLeft, ( "A particle has an infinite lifetime..." ));
 
 	// if we've gone totally invisible, destroy ourselves
-	if (isInvisible())
+	if (isInvisible( context ))
 		return false;
 	return true;
 }
 
 // ------------------------------------------------------------------------------------------------
-/** Do wind motion as specified by the particle system template, if present */
+/** Push the particle along the system's wind, which blows from the context's wind center */
 // ------------------------------------------------------------------------------------------------
-void Particle::doWindMotion( void )
+inline void Particle::doWindMotion( const ParticleUpdateContext &context )
 {
 
-	// get the angle of the wind
-	Real windAngle = m_system->getWindAngle();
-
-	// get the system position
-	Coord3D systemPos;
-	m_system->getPosition( &systemPos );
-
-	// when we're attached objects and drawables we offset by that position as well
-	if( ObjectID attachedObj = m_system->getAttachedObject() )
-	{
-		Object *obj = TheGameLogic->findObjectByID( attachedObj );
-
-		if( obj )
-		{
-			const Coord3D *objPos = obj->getPosition();
-
-			systemPos.x += objPos->x;
-			systemPos.y += objPos->y;
-			systemPos.z += objPos->z;
-
-		}  // end if
-
-	}  // end if
-	else if( DrawableID attachedDraw = m_system->getAttachedDrawable() )
-	{
-		Drawable *draw = TheGameClient->findDrawableByID( attachedDraw );
-
-		if( draw )
-		{
-			const Coord3D *drawPos = draw->getPosition();
-
-			systemPos.x += drawPos->x;
-			systemPos.y += drawPos->y;
-			systemPos.z += drawPos->z;
-
-		}  // end if
-
-	}  // end else if
-
 	//
 	// compute a vector from the system position in the world to the particle ... we will use
 	// this to compute how much force we apply
 	//
 	Coord3D v;
-	v.x = m_pos.x - systemPos.x;
-	v.y = m_pos.y - systemPos.y;
-	v.z = m_pos.z - systemPos.z;
+	v.x = m_pos.x - context.m_windCenter.x;
+	v.y = m_pos.y - context.m_windCenter.y;
+	v.z = m_pos.z - context.m_windCenter.z;
 
 	// distance amounts for full force from wind and no force at all
 	Real fullForceDistance = 75.0f;
@@ -561,8 +559,8 @@ void Particle::doWindMotion( void )
 																		(noForceDistance - fullForceDistance)));
 
 		// integate the wind motion into the position
-		m_pos.x += (Cos( windAngle ) * windForceStrength);
-		m_pos.y += (Sin( windAngle ) * windForceStrength);
+		m_pos.x += (context.m_windCos * windForceStrength);
+		m_pos.y += (context.m_windSin * windForceStrength);
 
 	}  // end if
 
@@ -577,11 +575,11 @@ ParticlePriorityType Particle::getPriority( void )
 }
 
 // ------------------------------------------------------------------------------------------------
-/** Return true if this particle is invisible */
+/** Return true if this particle is invisible under the context's shader */
 // ------------------------------------------------------------------------------------------------
-Bool Particle::isInvisible( void )
+inline Bool Particle::isInvisible( const ParticleUpdateContext &context )
 {
-	switch (m_system->getShaderType())
+	switch (context.m_shaderType)
 	{
 		case ParticleSystemInfo::ADDITIVE:
 			// if color is black, this particle is invisible
@@ -639,6 +637,10 @@ void Particle::crc( Xfer* /* xfer */ )
 void Particle::xfer( Xfer *xfer )
 {
 
+	// our state lives in the system's store, the fields only carry it to and from the file
+	if( xfer->getXferMode() != XFER_LOAD )
+		m_system->getParticleStore().save( this );
+
 	// version 
 	XferVersion currentVersion = 1;
 	XferVersion version = currentVersion;
@@ -688,6 +690,9 @@ void Particle::xfer( Xfer *xfer )
 	ParticleSystemID systemUnderControlID = m_systemUnderControl ? m_systemUnderControl->getSystemID() : INVALID_PARTICLE_SYSTEM_ID;
 	xfer->xferUser( &systemUnderControlID, sizeof( ParticleSystemID ) );
 
+	if( xfer->getXferMode() == XFER_LOAD )
+		m_system->getParticleStore().load( this );
+
 }  // end xfer
 
 // ------------------------------------------------------------------------------------------------
@@ -724,6 +729,557 @@ void Particle::loadPostProcess( void )
 
 }  // end loadPostProcess
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// ParticleStore //////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// distance amounts for full force from wind and no force at all, as Particle::doWindMotion
+static const Real WIND_FULL_FORCE_DISTANCE = 75.0f;
+static const Real WIND_NO_FORCE_DISTANCE = 200.0f;
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+template <typename FN>
+void ParticleStore::forEachArray( FN fn )
+{
+	fn( m_particles );
+	fn( m_posX ); fn( m_posY ); fn( m_posZ );
+	fn( m_velX ); fn( m_velY ); fn( m_velZ );
+	fn( m_accelX ); fn( m_accelY ); fn( m_accelZ );
+	fn( m_velDamping );
+	fn( m_angle ); fn( m_angularRate ); fn( m_angularDamping );
+	fn( m_size ); fn( m_sizeRate ); fn( m_sizeRateDamping );
+	fn( m_alpha ); fn( m_alphaRate );
+	fn( m_red ); fn( m_green ); fn( m_blue );
+	fn( m_redRate ); fn( m_greenRate ); fn( m_blueRate );
+	fn( m_colorScale );
+	fn( m_windRandomness );
+	fn( m_lifetimeLeft ); fn( m_createTimestamp );
+	fn( m_alphaTargetKey ); fn( m_alphaKeyFrame );
+	fn( m_colorTargetKey ); fn( m_colorKeyFrame );
+	fn( m_upTowardsEmitter );
+}
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void ParticleStore::add( Particle *p )
+{
+	size_t slot = m_particles.size();
+	forEachArray( [slot]( auto &array ) { array.resize( slot + 1 ); } );
+
+	m_particles[ slot ] = p;
+	p->m_storeSlot = (Int)slot;
+	load( p );
+}
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void ParticleStore::remove( Particle *p )
+{
+	size_t slot = (size_t)p->m_storeSlot;
+	DEBUG_ASSERTCRASH( slot < m_particles.size() && m_particles[ slot ] == p, ("ParticleStore::remove - particle isn't in its slot") );
+
+	forEachArray( [slot]( auto &array ) { array[ slot ] = array.back(); array.pop_back(); } );
+
+	if( slot < m_particles.size() )
+		m_particles[ slot ]->m_storeSlot = (Int)slot;
+	p->m_storeSlot = -1;
+}
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void ParticleStore::load( Particle *p )
+{
+	size_t i = (size_t)p->m_storeSlot;
+
+	m_posX[ i ] = p->m_pos.x;
+	m_posY[ i ] = p->m_pos.y;
+	m_posZ[ i ] = p->m_pos.z;
+	m_velX[ i ] = p->m_vel.x;
+	m_velY[ i ] = p->m_vel.y;
+	m_velZ[ i ] = p->m_vel.z;
+	m_accelX[ i ] = p->m_accel.x;
+	m_accelY[ i ] = p->m_accel.y;
+	m_accelZ[ i ] = p->m_accel.z;
+	m_velDamping[ i ] = p->m_velDamping;
+	m_angle[ i ] = p->m_angleZ;
+	m_angularRate[ i ] = p->m_angularRateZ;
+	m_angularDamping[ i ] = p->m_angularDamping;
+	m_size[ i ] = p->m_size;
+	m_sizeRate[ i ] = p->m_sizeRate;
+	m_sizeRateDamping[ i ] = p->m_sizeRateDamping;
+	m_alpha[ i ] = p->m_alpha;
+	m_alphaRate[ i ] = p->m_alphaRate;
+	m_red[ i ] = p->m_color.red;
+	m_green[ i ] = p->m_color.green;
+	m_blue[ i ] = p->m_color.blue;
+	m_redRate[ i ] = p->m_colorRate.red;
+	m_greenRate[ i ] = p->m_colorRate.green;
+	m_blueRate[ i ] = p->m_colorRate.blue;
+	m_colorScale[ i ] = p->m_colorScale;
+	m_windRandomness[ i ] = p->m_windRandomness;
+	m_lifetimeLeft[ i ] = p->m_lifetimeLeft;
+	m_createTimestamp[ i ] = p->m_createTimestamp;
+	m_alphaTargetKey[ i ] = p->m_alphaTargetKey;
+	m_alphaKeyFrame[ i ] = nextKeyFrame( p->m_alphaKey, p->m_alphaTargetKey );
+	m_colorTargetKey[ i ] = p->m_colorTargetKey;
+	m_colorKeyFrame[ i ] = nextKeyFrame( p->m_colorKey, p->m_colorTargetKey );
+	m_upTowardsEmitter[ i ] = p->m_particleUpTowardsEmitter ? 1 : 0;
+}
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void ParticleStore::save( Particle *p ) const
+{
+	size_t i = (size_t)p->m_storeSlot;
+
+	p->m_pos.x = m_posX[ i ];
+	p->m_pos.y = m_posY[ i ];
+	p->m_pos.z = m_posZ[ i ];
+	p->m_vel.x = m_velX[ i ];
+	p->m_vel.y = m_velY[ i ];
+	p->m_vel.z = m_velZ[ i ];
+	p->m_accel.x = m_accelX[ i ];
+	p->m_accel.y = m_accelY[ i ];
+	p->m_accel.z = m_accelZ[ i ];
+	p->m_angleZ = m_angle[ i ];
+	p->m_angularRateZ = m_angularRate[ i ];
+	p->m_size = m_size[ i ];
+	p->m_sizeRate = m_sizeRate[ i ];
+	p->m_alpha = m_alpha[ i ];
+	p->m_alphaRate = m_alphaRate[ i ];
+	p->m_color.red = m_red[ i ];
+	p->m_color.green = m_green[ i ];
+	p->m_color.blue = m_blue[ i ];
+	p->m_colorRate.red = m_redRate[ i ];
+	p->m_colorRate.green = m_greenRate[ i ];
+	p->m_colorRate.blue = m_blueRate[ i ];
+	p->m_lifetimeLeft = m_lifetimeLeft[ i ];
+	p->m_alphaTargetKey = m_alphaTargetKey[ i ];
+	p->m_colorTargetKey = m_colorTargetKey[ i ];
+
+	// the rest never changes once the particle is made
+}
+
+// ------------------------------------------------------------------------------------------------
+static inline Bool sameReal( Real a, Real b )
+{
+	// bit for bit, so a NaN matches itself and 0 doesn't match -0
+	UnsignedInt bitsA, bitsB;
+	memcpy( &bitsA, &a, sizeof( bitsA ) );
+	memcpy( &bitsB, &b, sizeof( bitsB ) );
+	return bitsA == bitsB;
+}
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+Bool ParticleStore::matches( const Particle *p ) const
+{
+	size_t i = (size_t)p->m_storeSlot;
+
+	return sameReal( p->m_pos.x, m_posX[ i ] ) && sameReal( p->m_pos.y, m_posY[ i ] ) && sameReal( p->m_pos.z, m_posZ[ i ] ) &&
+		sameReal( p->m_vel.x, m_velX[ i ] ) && sameReal( p->m_vel.y, m_velY[ i ] ) && sameReal( p->m_vel.z, m_velZ[ i ] ) &&
+		sameReal( p->m_accel.x, m_accelX[ i ] ) && sameReal( p->m_accel.y, m_accelY[ i ] ) && sameReal( p->m_accel.z, m_accelZ[ i ] ) &&
+		sameReal( p->m_angleZ, m_angle[ i ] ) && sameReal( p->m_angularRateZ, m_angularRate[ i ] ) &&
+		sameReal( p->m_size, m_size[ i ] ) && sameReal( p->m_sizeRate, m_sizeRate[ i ] ) &&
+		sameReal( p->m_alpha, m_alpha[ i ] ) && sameReal( p->m_alphaRate, m_alphaRate[ i ] ) &&
+		sameReal( p->m_color.red, m_red[ i ] ) && sameReal( p->m_color.green, m_green[ i ] ) && sameReal( p->m_color.blue, m_blue[ i ] ) &&
+		sameReal( p->m_colorRate.red, m_redRate[ i ] ) && sameReal( p->m_colorRate.green, m_greenRate[ i ] ) && sameReal( p->m_colorRate.blue, m_blueRate[ i ] ) &&
+		p->m_lifetimeLeft == m_lifetimeLeft[ i ] && p->m_alphaTargetKey == m_alphaTargetKey[ i ] && p->m_colorTargetKey == m_colorTargetKey[ i ];
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Slot i has reached the alpha key it was heading for: snap to it and head for the next */
+// ------------------------------------------------------------------------------------------------
+void ParticleStore::advanceAlphaKey( size_t i )
+{
+	const Keyframe *keys = m_particles[ i ]->m_alphaKey;
+	Int targetKey = m_alphaTargetKey[ i ];
+
+	Real alpha = keys[ targetKey ].value;
+	++targetKey;
+
+	m_alphaTargetKey[ i ] = targetKey;
+	m_alphaRate[ i ] = alphaKeyRate( keys, targetKey );
+	m_alphaKeyFrame[ i ] = nextKeyFrame( keys, targetKey );
+
+	if (alpha < 0.0f)
+		alpha = 0.0f;
+	else if (alpha > 1.0f)
+		alpha = 1.0f;
+	m_alpha[ i ] = alpha;
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Slot i has reached the color key it was heading for: head for the next.  The color isn't
+	* snapped to the key, because of the color scale. */
+// ------------------------------------------------------------------------------------------------
+void ParticleStore::advanceColorKey( size_t i )
+{
+	const RGBColorKeyframe *keys = m_particles[ i ]->m_colorKey;
+	Int targetKey = m_colorTargetKey[ i ] + 1;
+
+	RGBColor rate;
+	colorKeyRate( keys, targetKey, &rate );
+
+	m_colorTargetKey[ i ] = targetKey;
+	m_redRate[ i ] = rate.red;
+	m_greenRate[ i ] = rate.green;
+	m_blueRate[ i ] = rate.blue;
+	m_colorKeyFrame[ i ] = nextKeyFrame( keys, targetKey );
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Particle::isInvisible for slot i */
+// ------------------------------------------------------------------------------------------------
+Bool ParticleStore::isInvisible( size_t i, const ParticleUpdateContext &context ) const
+{
+	switch (context.m_shaderType)
+	{
+		case ParticleSystemInfo::ADDITIVE:
+			// black, and not on the way to another color
+			return m_colorKeyFrame[ i ] == 0 && (m_red[ i ] + m_green[ i ] + m_blue[ i ]) <= 0.06f;
+
+		case ParticleSystemInfo::ALPHA:
+			return m_alpha[ i ] < 0.02f;
+
+		case ParticleSystemInfo::ALPHA_TEST:
+			return false;
+
+		case ParticleSystemInfo::MULTIPLY:
+			// white, and not on the way to another color
+			return m_colorKeyFrame[ i ] == 0 && (m_red[ i ] * m_green[ i ] * m_blue[ i ]) > 0.95f;
+
+		default:
+			break;
+	}
+
+	// should never get here - if we do, data is incorrect
+	return true;
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Particle::update for slot i, step for step, so a slot and a Particle given the same state
+	* come out of a frame bit for bit the same */
+// ------------------------------------------------------------------------------------------------
+Bool ParticleStore::updateSlot( size_t i, const ParticleUpdateContext &context )
+{
+	m_accelZ[ i ] += context.m_gravity;
+
+	m_velX[ i ] = (m_velX[ i ] + m_accelX[ i ]) * m_velDamping[ i ];
+	m_velY[ i ] = (m_velY[ i ] + m_accelY[ i ]) * m_velDamping[ i ];
+	m_velZ[ i ] = (m_velZ[ i ] + m_accelZ[ i ]) * m_velDamping[ i ];
+
+	m_posX[ i ] += m_velX[ i ] + context.m_driftVelocity.x;
+	m_posY[ i ] += m_velY[ i ] + context.m_driftVelocity.y;
+	m_posZ[ i ] += m_velZ[ i ] + context.m_driftVelocity.z;
+
+	if( context.m_hasWind )
+	{
+		Coord3D v;
+		v.x = m_posX[ i ] - context.m_windCenter.x;
+		v.y = m_posY[ i ] - context.m_windCenter.y;
+		v.z = m_posZ[ i ] - context.m_windCenter.z;
+
+		Real distFromWind = v.length();
+		if( distFromWind < WIND_NO_FORCE_DISTANCE )
+		{
+			Real windForceStrength = 2.0f * m_windRandomness[ i ];
+			if( distFromWind > WIND_FULL_FORCE_DISTANCE )
+				windForceStrength *= (1.0f - ((distFromWind - WIND_FULL_FORCE_DISTANCE) /
+																			(WIND_NO_FORCE_DISTANCE - WIND_FULL_FORCE_DISTANCE)));
+
+			m_posX[ i ] += (context.m_windCos * windForceStrength);
+			m_posY[ i ] += (context.m_windSin * windForceStrength);
+		}
+	}
+
+	m_angle[ i ] += m_angularRate[ i ];
+	m_angularRate[ i ] *= m_angularDamping[ i ];
+
+	if (m_upTowardsEmitter[ i ])
+	{
+		static const Coord2D upVec = { 0.0f, 1.0f };
+		const Coord3D &emitterPos = m_particles[ i ]->m_emitterPos;
+		Coord2D emitterDir;
+		emitterDir.x = m_posX[ i ] - emitterPos.x;
+		emitterDir.y = m_posY[ i ] - emitterPos.y;
+		m_angle[ i ] = (angleBetween(&upVec, &emitterDir) + PI);
+	}
+
+	m_size[ i ] += m_sizeRate[ i ];
+	m_sizeRate[ i ] *= m_sizeRateDamping[ i ];
+
+	UnsignedInt age = context.m_frame - m_createTimestamp[ i ];
+
+	if (context.m_updateAlpha)
+	{
+		Real alpha = m_alpha[ i ] + m_alphaRate[ i ];
+		if (m_alphaKeyFrame[ i ] == 0)
+			m_alphaRate[ i ] = 0.0f;
+
+		if (alpha < 0.0f)
+			alpha = 0.0f;
+		else if (alpha > 1.0f)
+			alpha = 1.0f;
+		m_alpha[ i ] = alpha;
+
+		if (m_alphaKeyFrame[ i ] != 0 && age >= m_alphaKeyFrame[ i ])
+			advanceAlphaKey( i );
+	}
+
+	Real red = m_red[ i ] + m_redRate[ i ];
+	Real green = m_green[ i ] + m_greenRate[ i ];
+	Real blue = m_blue[ i ] + m_blueRate[ i ];
+
+	if (m_colorKeyFrame[ i ] == 0)
+	{
+		m_redRate[ i ] = 0.0f;
+		m_greenRate[ i ] = 0.0f;
+		m_blueRate[ i ] = 0.0f;
+	}
+	else if (age >= m_colorKeyFrame[ i ])
+	{
+		advanceColorKey( i );
+	}
+
+	red += m_colorScale[ i ];
+	green += m_colorScale[ i ];
+	blue += m_colorScale[ i ];
+
+	// red is clamped before green is tested against 0, so green is only ever clamped at the top
+	if (red < 0.0f)
+		red = 0.0f;
+	else if (red > 1.0f)
+		red = 1.0f;
+
+	if (green > 1.0f)
+		green = 1.0f;
+
+	if (blue < 0.0f)
+		blue = 0.0f;
+	else if (blue > 1.0f)
+		blue = 1.0f;
+
+	m_red[ i ] = red;
+	m_green[ i ] = green;
+	m_blue[ i ] = blue;
+
+	m_accelX[ i ] = 0.0f;
+	m_accelY[ i ] = 0.0f;
+	m_accelZ[ i ] = 0.0f;
+
+	if (m_lifetimeLeft[ i ] && --m_lifetimeLeft[ i ] == 0)
+		return true;
+
+	DEBUG_ASSERTCRASH( m_lifetimeLeft[ i ], ( "A particle has an infinite lifetime..." ));
+
+	return isInvisible( i, context );
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Run a frame of every particle in the store.  Four slots go through at a time with SSE2, the
+	* rest (and everything without SSE2) through updateSlot; either way the arithmetic is
+	* Particle::update's, in the same order.  Keys that come due are rare, so those lanes go back
+	* through advanceAlphaKey/advanceColorKey one at a time. */
+// ------------------------------------------------------------------------------------------------
+void ParticleStore::update( const ParticleUpdateContext &context, std::vector<Particle *> &dead )
+{
+	const size_t count = m_particles.size();
+	size_t i = 0;
+
+#if defined(__SSE2__)
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps( 1.0f );
+	const __m128 two = _mm_set1_ps( 2.0f );
+	const __m128 gravity = _mm_set1_ps( context.m_gravity );
+	const __m128 driftX = _mm_set1_ps( context.m_driftVelocity.x );
+	const __m128 driftY = _mm_set1_ps( context.m_driftVelocity.y );
+	const __m128 driftZ = _mm_set1_ps( context.m_driftVelocity.z );
+	const __m128 windX = _mm_set1_ps( context.m_windCenter.x );
+	const __m128 windY = _mm_set1_ps( context.m_windCenter.y );
+	const __m128 windZ = _mm_set1_ps( context.m_windCenter.z );
+	const __m128 windCos = _mm_set1_ps( context.m_windCos );
+	const __m128 windSin = _mm_set1_ps( context.m_windSin );
+	const __m128 fullForceDistance = _mm_set1_ps( WIND_FULL_FORCE_DISTANCE );
+	const __m128 noForceDistance = _mm_set1_ps( WIND_NO_FORCE_DISTANCE );
+	const __m128 forceSpan = _mm_set1_ps( WIND_NO_FORCE_DISTANCE - WIND_FULL_FORCE_DISTANCE );
+	const __m128 additiveLimit = _mm_set1_ps( 0.06f );
+	const __m128 alphaLimit = _mm_set1_ps( 0.02f );
+	const __m128 multiplyLimit = _mm_set1_ps( 0.95f );
+	const __m128i zeroInt = _mm_setzero_si128();
+	const __m128i oneInt = _mm_set1_epi32( 1 );
+	const __m128i allOnes = _mm_set1_epi32( -1 );
+	const __m128i frame = _mm_set1_epi32( (Int)context.m_frame );
+
+	// SSE2 only compares signed ints, flipping the top bit makes that an unsigned compare
+	const __m128i signBit = _mm_set1_epi32( (Int)0x80000000u );
+
+	for (; i + 4 <= count; i += 4)
+	{
+		// gravity into acceleration, acceleration into velocity, then damping
+		__m128 accelZ = _mm_add_ps( _mm_loadu_ps( &m_accelZ[ i ] ), gravity );
+		__m128 damping = _mm_loadu_ps( &m_velDamping[ i ] );
+		__m128 velX = _mm_mul_ps( _mm_add_ps( _mm_loadu_ps( &m_velX[ i ] ), _mm_loadu_ps( &m_accelX[ i ] ) ), damping );
+		__m128 velY = _mm_mul_ps( _mm_add_ps( _mm_loadu_ps( &m_velY[ i ] ), _mm_loadu_ps( &m_accelY[ i ] ) ), damping );
+		__m128 velZ = _mm_mul_ps( _mm_add_ps( _mm_loadu_ps( &m_velZ[ i ] ), accelZ ), damping );
+		_mm_storeu_ps( &m_velX[ i ], velX );
+		_mm_storeu_ps( &m_velY[ i ], velY );
+		_mm_storeu_ps( &m_velZ[ i ], velZ );
+
+		__m128 posX = _mm_add_ps( _mm_loadu_ps( &m_posX[ i ] ), _mm_add_ps( velX, driftX ) );
+		__m128 posY = _mm_add_ps( _mm_loadu_ps( &m_posY[ i ] ), _mm_add_ps( velY, driftY ) );
+		__m128 posZ = _mm_add_ps( _mm_loadu_ps( &m_posZ[ i ] ), _mm_add_ps( velZ, driftZ ) );
+
+		if( context.m_hasWind )
+		{
+			__m128 dx = _mm_sub_ps( posX, windX );
+			__m128 dy = _mm_sub_ps( posY, windY );
+			__m128 dz = _mm_sub_ps( posZ, windZ );
+			__m128 dist = _mm_sqrt_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( dx, dx ), _mm_mul_ps( dy, dy ) ), _mm_mul_ps( dz, dz ) ) );
+
+			__m128 strength = _mm_mul_ps( two, _mm_loadu_ps( &m_windRandomness[ i ] ) );
+			__m128 falloff = _mm_mul_ps( strength, _mm_sub_ps( one, _mm_div_ps( _mm_sub_ps( dist, fullForceDistance ), forceSpan ) ) );
+			__m128 outside = _mm_cmpgt_ps( dist, fullForceDistance );
+			strength = _mm_or_ps( _mm_and_ps( outside, falloff ), _mm_andnot_ps( outside, strength ) );
+
+			// lanes out of reach keep their position untouched, rather than getting + 0
+			__m128 inReach = _mm_cmplt_ps( dist, noForceDistance );
+			posX = _mm_or_ps( _mm_and_ps( inReach, _mm_add_ps( posX, _mm_mul_ps( windCos, strength ) ) ), _mm_andnot_ps( inReach, posX ) );
+			posY = _mm_or_ps( _mm_and_ps( inReach, _mm_add_ps( posY, _mm_mul_ps( windSin, strength ) ) ), _mm_andnot_ps( inReach, posY ) );
+		}
+
+		_mm_storeu_ps( &m_posX[ i ], posX );
+		_mm_storeu_ps( &m_posY[ i ], posY );
+		_mm_storeu_ps( &m_posZ[ i ], posZ );
+
+		__m128 angularRate = _mm_loadu_ps( &m_angularRate[ i ] );
+		_mm_storeu_ps( &m_angle[ i ], _mm_add_ps( _mm_loadu_ps( &m_angle[ i ] ), angularRate ) );
+		_mm_storeu_ps( &m_angularRate[ i ], _mm_mul_ps( angularRate, _mm_loadu_ps( &m_angularDamping[ i ] ) ) );
+
+		__m128 sizeRate = _mm_loadu_ps( &m_sizeRate[ i ] );
+		_mm_storeu_ps( &m_size[ i ], _mm_add_ps( _mm_loadu_ps( &m_size[ i ] ), sizeRate ) );
+		_mm_storeu_ps( &m_sizeRate[ i ], _mm_mul_ps( sizeRate, _mm_loadu_ps( &m_sizeRateDamping[ i ] ) ) );
+
+		// a key is due when it exists and the particle is at least that many frames old
+		__m128i age = _mm_sub_epi32( frame, _mm_loadu_si128( (const __m128i *)&m_createTimestamp[ i ] ) );
+		__m128i ageBiased = _mm_xor_si128( age, signBit );
+
+		Int alphaDue = 0;
+		if (context.m_updateAlpha)
+		{
+			__m128i keyFrame = _mm_loadu_si128( (const __m128i *)&m_alphaKeyFrame[ i ] );
+			__m128i hasKey = _mm_xor_si128( _mm_cmpeq_epi32( keyFrame, zeroInt ), allOnes );
+			__m128i notYet = _mm_cmpgt_epi32( _mm_xor_si128( keyFrame, signBit ), ageBiased );
+			alphaDue = _mm_movemask_ps( _mm_castsi128_ps( _mm_andnot_si128( notYet, hasKey ) ) );
+
+			// max/min return their second operand on a tie or a NaN, which keeps -0 and NaN as the ifs do
+			__m128 alphaRate = _mm_loadu_ps( &m_alphaRate[ i ] );
+			__m128 alpha = _mm_add_ps( _mm_loadu_ps( &m_alpha[ i ] ), alphaRate );
+			_mm_storeu_ps( &m_alpha[ i ], _mm_min_ps( one, _mm_max_ps( zero, alpha ) ) );
+			_mm_storeu_ps( &m_alphaRate[ i ], _mm_and_ps( alphaRate, _mm_castsi128_ps( hasKey ) ) );
+		}
+
+		__m128i colorKeyFrame = _mm_loadu_si128( (const __m128i *)&m_colorKeyFrame[ i ] );
+		__m128i hasColorKey = _mm_xor_si128( _mm_cmpeq_epi32( colorKeyFrame, zeroInt ), allOnes );
+		__m128i colorNotYet = _mm_cmpgt_epi32( _mm_xor_si128( colorKeyFrame, signBit ), ageBiased );
+		Int colorDue = _mm_movemask_ps( _mm_castsi128_ps( _mm_andnot_si128( colorNotYet, hasColorKey ) ) );
+
+		__m128 redRate = _mm_loadu_ps( &m_redRate[ i ] );
+		__m128 greenRate = _mm_loadu_ps( &m_greenRate[ i ] );
+		__m128 blueRate = _mm_loadu_ps( &m_blueRate[ i ] );
+		__m128 colorScale = _mm_loadu_ps( &m_colorScale[ i ] );
+		__m128 red = _mm_add_ps( _mm_add_ps( _mm_loadu_ps( &m_red[ i ] ), redRate ), colorScale );
+		__m128 green = _mm_add_ps( _mm_add_ps( _mm_loadu_ps( &m_green[ i ] ), greenRate ), colorScale );
+		__m128 blue = _mm_add_ps( _mm_add_ps( _mm_loadu_ps( &m_blue[ i ] ), blueRate ), colorScale );
+		red = _mm_min_ps( one, _mm_max_ps( zero, red ) );
+		green = _mm_min_ps( one, green );
+		blue = _mm_min_ps( one, _mm_max_ps( zero, blue ) );
+		_mm_storeu_ps( &m_red[ i ], red );
+		_mm_storeu_ps( &m_green[ i ], green );
+		_mm_storeu_ps( &m_blue[ i ], blue );
+		_mm_storeu_ps( &m_redRate[ i ], _mm_and_ps( redRate, _mm_castsi128_ps( hasColorKey ) ) );
+		_mm_storeu_ps( &m_greenRate[ i ], _mm_and_ps( greenRate, _mm_castsi128_ps( hasColorKey ) ) );
+		_mm_storeu_ps( &m_blueRate[ i ], _mm_and_ps( blueRate, _mm_castsi128_ps( hasColorKey ) ) );
+
+		_mm_storeu_ps( &m_accelX[ i ], zero );
+		_mm_storeu_ps( &m_accelY[ i ], zero );
+		_mm_storeu_ps( &m_accelZ[ i ], zero );
+
+		// count down lifetimes, 0 is forever; a particle dies on the frame it goes from 1 to 0
+		__m128i lifetimeLeft = _mm_loadu_si128( (const __m128i *)&m_lifetimeLeft[ i ] );
+		__m128i forever = _mm_cmpeq_epi32( lifetimeLeft, zeroInt );
+		__m128i expired = _mm_cmpeq_epi32( lifetimeLeft, oneInt );
+		_mm_storeu_si128( (__m128i *)&m_lifetimeLeft[ i ], _mm_add_epi32( lifetimeLeft, _mm_andnot_si128( forever, allOnes ) ) );
+		DEBUG_ASSERTCRASH( _mm_movemask_ps( _mm_castsi128_ps( forever ) ) == 0, ( "A particle has an infinite lifetime..." ));
+
+		// the few lanes that need a key or to face their emitter
+		for (Int lane = 0; lane < 4; ++lane)
+		{
+			size_t slot = i + (size_t)lane;
+			if (alphaDue & (1 << lane))
+				advanceAlphaKey( slot );
+			if (colorDue & (1 << lane))
+				advanceColorKey( slot );
+			if (m_upTowardsEmitter[ slot ])
+			{
+				static const Coord2D upVec = { 0.0f, 1.0f };
+				const Coord3D &emitterPos = m_particles[ slot ]->m_emitterPos;
+				Coord2D emitterDir;
+				emitterDir.x = m_posX[ slot ] - emitterPos.x;
+				emitterDir.y = m_posY[ slot ] - emitterPos.y;
+				m_angle[ slot ] = (angleBetween(&upVec, &emitterDir) + PI);
+			}
+		}
+
+		// visibility goes by the keys as they are after this frame's advances
+		__m128 invisible = zero;
+		switch (context.m_shaderType)
+		{
+			case ParticleSystemInfo::ADDITIVE:
+			{
+				__m128i noKey = _mm_cmpeq_epi32( _mm_loadu_si128( (const __m128i *)&m_colorKeyFrame[ i ] ), zeroInt );
+				__m128 black = _mm_cmple_ps( _mm_add_ps( _mm_add_ps( red, green ), blue ), additiveLimit );
+				invisible = _mm_and_ps( _mm_castsi128_ps( noKey ), black );
+				break;
+			}
+
+			case ParticleSystemInfo::ALPHA:
+				invisible = _mm_cmplt_ps( _mm_loadu_ps( &m_alpha[ i ] ), alphaLimit );
+				break;
+
+			case ParticleSystemInfo::ALPHA_TEST:
+				break;
+
+			case ParticleSystemInfo::MULTIPLY:
+			{
+				__m128i noKey = _mm_cmpeq_epi32( _mm_loadu_si128( (const __m128i *)&m_colorKeyFrame[ i ] ), zeroInt );
+				__m128 white = _mm_cmpgt_ps( _mm_mul_ps( _mm_mul_ps( red, green ), blue ), multiplyLimit );
+				invisible = _mm_and_ps( _mm_castsi128_ps( noKey ), white );
+				break;
+			}
+
+			default:
+				invisible = _mm_castsi128_ps( allOnes );
+				break;
+		}
+
+		Int died = _mm_movemask_ps( _mm_or_ps( _mm_castsi128_ps( expired ), invisible ) );
+		for (Int lane = 0; died != 0; ++lane, died >>= 1)
+		{
+			if (died & 1)
+				dead.push_back( m_particles[ i + (size_t)lane ] );
+		}
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		if (updateSlot( i, context ))
+			dead.push_back( m_particles[ i ] );
+	}
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1045,6 +1601,17 @@ void ParticleSystemInfo::loadPostProcess( void )
 ParticleSystem::ParticleSystem( const ParticleSystemTemplate *sysTemplate, 
 																ParticleSystemID id, 
 																Bool createSlaves )
+{
+	init( sysTemplate, id, createSlaves );
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Set up the system from its template.  This is also how the manager brings a recycled system
+	* back to life, so everything the system depends on must be (re)set here. */
+// ------------------------------------------------------------------------------------------------
+void ParticleSystem::init( const ParticleSystemTemplate *sysTemplate, 
+													 ParticleSystemID id, 
+													 Bool createSlaves )
 {
 	m_systemParticlesHead = m_systemParticlesTail = NULL;
 
@@ -1198,6 +1765,17 @@ ParticleSystem::ParticleSystem( const ParticleSystemTemplate *sysTemplate,
 /** Destroy particle system and all of its particles */
 // ------------------------------------------------------------------------------------------------
 ParticleSystem::~ParticleSystem()
+{
+	// systems parked on a template's free list have already been detached
+	if (m_template)
+		detach();
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Destroy all of our particles and unlink from our master, slave and the manager.  Afterwards
+	* the system is inert until init() is called on it again. */
+// ------------------------------------------------------------------------------------------------
+void ParticleSystem::detach( void )
 {
 
 	// tell any of our slave systems that we are going away
@@ -1236,6 +1814,9 @@ ParticleSystem::~ParticleSystem()
 	
 	TheParticleSystemManager->friend_removeParticleSystem(this);
 	//DEBUG_ASSERTLOG(!(m_totalParticleSystemCount % 10 == 0), ( "TotalParticleSystemCount = %d\n", m_totalParticleSystemCount ));
+
+	m_template = NULL;
+	m_systemID = INVALID_PARTICLE_SYSTEM_ID;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -1725,9 +2306,11 @@ Particle *ParticleSystem::createParticle( const ParticleInfo *info,
 		// ALWAYS_RENDER particles are exempt from all count limits, and are always created, regardless of LOD issues.
 		if (priority != ALWAYS_RENDER)
 		{
-			UnsignedInt numInExcess = TheParticleSystemManager->getParticleCount() - (UnsignedInt)TheGlobalData->m_data.m_maxParticleCount;
-			if ( numInExcess > 0)
+			// only over the cap is there an excess; the unsigned difference wraps when under it
+			UnsignedInt maxParticleCount = (UnsignedInt)TheGlobalData->m_data.m_maxParticleCount;
+			if ( TheParticleSystemManager->getParticleCount() > maxParticleCount )
 			{
+				UnsignedInt numInExcess = TheParticleSystemManager->getParticleCount() - maxParticleCount;
 				if( (UnsignedInt) TheParticleSystemManager->removeOldestParticles(numInExcess, priority) != numInExcess )
 					return NULL;  // could not remove enough particles, don't create new stuff
 			}
@@ -2063,30 +2646,13 @@ Bool ParticleSystem::update( Int localPlayerIndex  )
 	//
 	// Update all particles in the system
 	//
-	Particle *p = m_systemParticlesHead;
-	Particle *oldParticle;
-	while (p)
-	{
+	ParticleUpdateContext context;
+	getUpdateContext( &context );
 
-		// apply 'gravity' force
-		if (m_ini.m_gravity != 0.0f)
-		{
-			Coord3D force;
-			force.x = 0.0f;
-			force.y = 0.0f;
-			force.z = m_ini.m_gravity;
-			p->applyForce( &force );
-		}
-
-		if (p->update() == false)
-		{
-			oldParticle = p;
-			p = p->m_systemNext;
-			oldParticle->deleteInstance();
-		} else {
-			p = p->m_systemNext;
-		}
-	}
+	s_deadParticles.clear();
+	m_store.update( context, s_deadParticles );
+	for (Particle *dead : s_deadParticles)
+		dead->deleteInstance();
 
 	//
 	// If we have been "destroyed", wait for all of our particles to die off,
@@ -2115,6 +2681,63 @@ Bool ParticleSystem::update( Int localPlayerIndex  )
 	return true;
 }
 
+// ------------------------------------------------------------------------------------------------
+/** Gather the system state that every particle update needs.  This is only valid for the current
+	* frame, since the system's position, wind angle and attachments all move. */
+// ------------------------------------------------------------------------------------------------
+void ParticleSystem::getUpdateContext( ParticleUpdateContext *context )
+{
+	context->m_driftVelocity = m_ini.m_driftVelocity;
+	context->m_gravity = m_ini.m_gravity;
+	context->m_shaderType = m_ini.m_shaderType;
+	context->m_updateAlpha = (m_ini.m_shaderType != ParticleSystemInfo::ADDITIVE);
+	context->m_frame = TheGameClient->getFrame();
+
+	// see if we should even do anything with the wind
+	context->m_hasWind = (m_ini.m_windMotion != ParticleSystemInfo::WIND_MOTION_NOT_USED);
+	if (context->m_hasWind == false)
+		return;
+
+	context->m_windCos = Cos( m_ini.m_windAngle );
+	context->m_windSin = Sin( m_ini.m_windAngle );
+
+	// the wind blows from the system position
+	getPosition( &context->m_windCenter );
+
+	// when we're attached objects and drawables we offset by that position as well
+	if( m_attachedToObjectID )
+	{
+		Object *obj = TheGameLogic->findObjectByID( m_attachedToObjectID );
+
+		if( obj )
+		{
+			const Coord3D *objPos = obj->getPosition();
+
+			context->m_windCenter.x += objPos->x;
+			context->m_windCenter.y += objPos->y;
+			context->m_windCenter.z += objPos->z;
+
+		}  // end if
+
+	}  // end if
+	else if( m_attachedToDrawableID )
+	{
+		Drawable *draw = TheGameClient->findDrawableByID( m_attachedToDrawableID );
+
+		if( draw )
+		{
+			const Coord3D *drawPos = draw->getPosition();
+
+			context->m_windCenter.x += drawPos->x;
+			context->m_windCenter.y += drawPos->y;
+			context->m_windCenter.z += drawPos->z;
+
+		}  // end if
+
+	}  // end else if
+
+}  // end getUpdateContext
+
 // ------------------------------------------------------------------------------------------------
 /** Update the wind motion */
 // ------------------------------------------------------------------------------------------------
@@ -2277,6 +2900,7 @@ void ParticleSystem::addParticle( Particle *particleToAdd )
 	particleToAdd->m_inSystemList = TRUE;
 
 	++m_particleCount;
+	m_store.add( particleToAdd );
 
 	particleToAdd->setPersonality( m_personalityStore++ ); 
 
@@ -2305,6 +2929,7 @@ void ParticleSystem::removeParticle( Particle *particleToRemove )
 	particleToRemove->m_systemNext = particleToRemove->m_systemPrev = NULL;
 	particleToRemove->m_inSystemList = FALSE;
 	--m_particleCount;
+	m_store.remove( particleToRemove );
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -2808,7 +3433,10 @@ ParticleSystemTemplate::ParticleSystemTemplate( const AsciiString &name ) :
 // ------------------------------------------------------------------------------------------------
 ParticleSystemTemplate::~ParticleSystemTemplate()
 {
- 
+	// free any dead systems kept around for reuse
+	for (std::vector<ParticleSystem *>::iterator it = m_freeSystems.begin(); it != m_freeSystems.end(); ++it)
+		(*it)->deleteInstance();
+	m_freeSystems.clear();
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -2927,6 +3555,11 @@ void ParticleSystemManager::reset( void )
 	m_fieldParticleCount = 0;
 	m_particleSystemCount = 0;
 
+	DEBUG_ASSERTCRASH( m_allParticleSystemList.empty() && m_systemsByID.empty(), ("RESET: ParticleSystem lists are not empty!\n") );
+	m_systemsByID.clear();
+
+	purgeFreeParticleSystems();
+
 	m_uniqueSystemID = INVALID_PARTICLE_SYSTEM_ID;
 	
 	m_lastLogicFrameUpdate = 0xffffffff;
@@ -2959,7 +3592,7 @@ void ParticleSystemManager::update( void )
 		if (sys->update(m_localPlayerIndex) == false)
 		{
 			++it;
-			sys->deleteInstance();
+			releaseParticleSystem( sys );
 		} else {
 			++it;
 		}
@@ -2974,6 +3607,133 @@ void ParticleSystemManager::setOnScreenParticleCount(int count)
 	m_onScreenParticleCount = count;
 }
 
+// ------------------------------------------------------------------------------------------------
+static Int64 particleNanos()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Run 'emitters' systems, cycling through every template, for 'frames' frames, timing each
+	* system's particles through the one-at-a-time Particle::update against its ParticleStore.
+	* Each frame the Particles are brought up to their slots first, so both ways start from the
+	* same state, and every particle is checked to come out the same both ways, dead or alive.
+	* Nothing is emitted while timing, so both see the same particles. (-particleBenchmark) */
+// ------------------------------------------------------------------------------------------------
+void ParticleSystemManager::reportUpdateBenchmark( UnsignedInt emitters, UnsignedInt frames )
+{
+	enum { WARMUP_FRAMES = 60, GRID_SIZE = 64 };
+
+	// let the systems emit past the usual cap, it's put back before we return
+	Int maxParticleCount = TheGlobalData->m_data.m_maxParticleCount;
+	TheWritableGlobalData->m_data.m_maxParticleCount = INT_MAX;
+	UnsignedInt clientFrame = TheGameClient->getFrame();
+
+	UnsignedInt systemsCreated = 0;
+	for( TemplateMap::const_iterator it = m_templateMap.begin(); systemsCreated < emitters && !m_templateMap.empty(); )
+	{
+		ParticleSystem *sys = createParticleSystem( it->second );
+		if( sys != NULL )
+		{
+			// spread them over a grid so the wind centers differ between systems
+			Coord3D pos;
+			pos.x = (Real)( systemsCreated % GRID_SIZE ) * 50.0f;
+			pos.y = (Real)( systemsCreated / GRID_SIZE % GRID_SIZE ) * 50.0f;
+			pos.z = 0.0f;
+			sys->setPosition( &pos );
+		}
+		++systemsCreated;
+
+		if( ++it == m_templateMap.end() )
+			it = m_templateMap.begin();
+	}
+
+	for( Int frame = 0; frame < WARMUP_FRAMES; ++frame )
+	{
+		TheGameClient->setFrame( TheGameClient->getFrame() + 1 );
+		for( ParticleSystemListIt it = m_allParticleSystemList.begin(); it != m_allParticleSystemList.end(); )
+		{
+			ParticleSystem *sys = *it++;
+			if( sys->update( m_localPlayerIndex ) == false )
+				releaseParticleSystem( sys );
+		}
+	}
+
+	UnsignedInt warmParticles = m_particleCount;
+	UnsignedInt warmSystems = m_particleSystemCount;
+
+	Int64 referenceNanos = 0;
+	Int64 storeNanos = 0;
+	UnsignedInt updates = 0;
+	UnsignedInt differed = 0;
+	std::vector<Particle *> referenceDead;
+	std::vector<Particle *> mismatchedDead;
+	for( UnsignedInt frame = 0; frame < frames; ++frame )
+	{
+		TheGameClient->setFrame( TheGameClient->getFrame() + 1 );
+		for( ParticleSystemListIt it = m_allParticleSystemList.begin(); it != m_allParticleSystemList.end(); ++it )
+		{
+			ParticleSystem *sys = *it;
+			ParticleStore &store = sys->getParticleStore();
+			ParticleUpdateContext context;
+			sys->getUpdateContext( &context );
+
+			for( Particle *p = sys->getFirstParticle(); p; p = p->m_systemNext )
+				store.save( p );
+
+			referenceDead.clear();
+			Int64 start = particleNanos();
+			for( Particle *p = sys->getFirstParticle(); p; p = p->m_systemNext )
+			{
+				if( p->update( context ) == false )
+					referenceDead.push_back( p );
+			}
+			referenceNanos += particleNanos() - start;
+
+			s_deadParticles.clear();
+			start = particleNanos();
+			store.update( context, s_deadParticles );
+			storeNanos += particleNanos() - start;
+
+			updates += (UnsignedInt)store.getCount();
+			for( Particle *p = sys->getFirstParticle(); p; p = p->m_systemNext )
+			{
+				if( !store.matches( p ) )
+					++differed;
+			}
+
+			// the store lists its dead in slot order, the reference in list order
+			std::sort( referenceDead.begin(), referenceDead.end() );
+			std::sort( s_deadParticles.begin(), s_deadParticles.end() );
+			mismatchedDead.clear();
+			std::set_symmetric_difference( referenceDead.begin(), referenceDead.end(),
+				s_deadParticles.begin(), s_deadParticles.end(), std::back_inserter( mismatchedDead ) );
+			differed += (UnsignedInt)mismatchedDead.size();
+
+			for( Particle *dead : s_deadParticles )
+				dead->deleteInstance();
+		}
+	}
+
+#if defined(__SSE2__)
+	const char *storePath = "SSE2";
+#else
+	const char *storePath = "scalar";
+#endif
+	printf( "Particle update benchmark: %u emitters, %u systems and %u particles after %d warmup frames, %u frames timed\n",
+		emitters, warmSystems, warmParticles, (Int)WARMUP_FRAMES, frames );
+	printf( "  one particle at a time: %u updates in %.2f ms, %.1f ns each\n",
+		updates, (Real)referenceNanos / 1.0e6f, updates ? (Real)referenceNanos / (Real)updates : 0.0f );
+	printf( "  particle store (%s):   %u updates in %.2f ms, %.1f ns each, %.2fx\n",
+		storePath, updates, (Real)storeNanos / 1.0e6f, updates ? (Real)storeNanos / (Real)updates : 0.0f,
+		storeNanos ? (Real)referenceNanos / (Real)storeNanos : 0.0f );
+	printf( "  %u particles differed between the two\n", differed );
+
+	reset();
+	TheGameClient->setFrame( clientFrame );
+	TheWritableGlobalData->m_data.m_maxParticleCount = maxParticleCount;
+}
+
 // ------------------------------------------------------------------------------------------------
 /** Given a file containing particle system properties, create a new instance of it */
 // ------------------------------------------------------------------------------------------------
@@ -2984,10 +3744,56 @@ ParticleSystem *ParticleSystemManager::createParticleSystem( const ParticleSyste
 		return NULL;
 
 	m_uniqueSystemID = (ParticleSystemID)((UnsignedInt)m_uniqueSystemID + 1);
+	++m_createCount;
+
+	// bring a dead system of this template back if there is one
+	if (!sysTemplate->m_freeSystems.empty())
+	{
+		ParticleSystem *sys = sysTemplate->m_freeSystems.back();
+		sysTemplate->m_freeSystems.pop_back();
+		++m_reuseCount;
+
+		// anything init() doesn't set must look as it does in a newly constructed system
+		sys->m_ini = ParticleSystemInfo().m_ini;
+		sys->init( sysTemplate, m_uniqueSystemID, createSlaves );
+		return sys;
+	}
+
 	ParticleSystem *sys = newInstance(ParticleSystem)( sysTemplate, m_uniqueSystemID, createSlaves );
 	return sys;
 }
 
+// ------------------------------------------------------------------------------------------------
+/** A system has died; detach it and keep it on its template's free list for the next
+	* createParticleSystem of that template, unless the list is already full. */
+// ------------------------------------------------------------------------------------------------
+void ParticleSystemManager::releaseParticleSystem( ParticleSystem *sys )
+{
+	const ParticleSystemTemplate *sysTemplate = sys->getTemplate();
+	if (sysTemplate == NULL || sysTemplate->m_freeSystems.size() >= MAX_FREE_SYSTEMS_PER_TEMPLATE)
+	{
+		sys->deleteInstance();
+		return;
+	}
+
+	sys->detach();
+	sysTemplate->m_freeSystems.push_back( sys );
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Free every system parked on a template's free list */
+// ------------------------------------------------------------------------------------------------
+void ParticleSystemManager::purgeFreeParticleSystems( void )
+{
+	for (TemplateMap::iterator it = m_templateMap.begin(); it != m_templateMap.end(); ++it)
+	{
+		ParticleSystemTemplate *sysTemplate = (*it).second;
+		for (std::vector<ParticleSystem *>::iterator sys = sysTemplate->m_freeSystems.begin(); sys != sysTemplate->m_freeSystems.end(); ++sys)
+			(*sys)->deleteInstance();
+		sysTemplate->m_freeSystems.clear();
+	}
+}
+
 // ------------------------------------------------------------------------------------------------
 /// given a template, instantiate a particle system attached to the given object, and return its ID
 // ------------------------------------------------------------------------------------------------
@@ -3010,20 +3816,13 @@ ParticleSystem *ParticleSystemManager::findParticleSystem( ParticleSystemID id )
 	if (id == INVALID_PARTICLE_SYSTEM_ID)
 		return NULL;	// my, that was easy
 
-	ParticleSystem *system = NULL;
-
-	for( ParticleSystemListIt it = m_allParticleSystemList.begin(); it != m_allParticleSystemList.end(); ++it ) {
-		system = *it;
-		if (!system) {
-			continue;
-		}
+	++m_lookupCount;
 
-		if( system->getSystemID() == id ) {
-			return system;
-		}
-	}
+	ParticleSystemIDMap::const_iterator it = m_systemsByID.find( id );
+	if (it == m_systemsByID.end())
+		return NULL;
 
-	return NULL;
+	return *(it->second);
 
 }  // end findParticleSystem
 
@@ -3190,6 +3989,7 @@ void ParticleSystemManager::removeParticle( Particle *particleToRemove)
 void ParticleSystemManager::friend_addParticleSystem( ParticleSystem *particleSystemToAdd )
 {
 	m_allParticleSystemList.push_back(particleSystemToAdd);
+	m_systemsByID[ particleSystemToAdd->getSystemID() ] = std::prev( m_allParticleSystemList.end() );
 	++m_particleSystemCount;
 }
 
@@ -3198,6 +3998,16 @@ void ParticleSystemManager::friend_addParticleSystem( ParticleSystem *particleSy
 // ------------------------------------------------------------------------------------------------
 void ParticleSystemManager::friend_removeParticleSystem( ParticleSystem *particleSystemToRemove )
 {
+	ParticleSystemIDMap::iterator found = m_systemsByID.find( particleSystemToRemove->getSystemID() );
+	if (found != m_systemsByID.end() && *(found->second) == particleSystemToRemove) {
+		m_allParticleSystemList.erase(found->second);
+		m_systemsByID.erase(found);
+		--m_particleSystemCount;
+		return;
+	}
+
+	// not indexed under its ID, which should never happen
+	DEBUG_CRASH(( "friend_removeParticleSystem - system %d is not indexed by its ID\n", particleSystemToRemove->getSystemID() ));
 	ParticleSystemListIt it = std::find(m_allParticleSystemList.begin(), m_allParticleSystemList.end(), particleSystemToRemove);
 	if (it != m_allParticleSystemList.end()) {
 		m_allParticleSystemList.erase(it);
@@ -3349,9 +4159,18 @@ void ParticleSystemManager::xfer( Xfer *xfer )
 
 			}  // end if
 
-			// read system data
+			// read system data; this replaces the ID it was created with by its saved one
+			ParticleSystemID createdID = system->getSystemID();
 			xfer->xferSnapshot( system );
 
+			ParticleSystemIDMap::iterator found = m_systemsByID.find( createdID );
+			if (found != m_systemsByID.end())
+			{
+				ParticleSystemListIt listIt = found->second;
+				m_systemsByID.erase( found );
+				m_systemsByID[ system->getSystemID() ] = listIt;
+			}
+
 		}  // end for, i
 
 	}  // end else, load
@@ -3378,9 +4197,11 @@ void ParticleSystemDebugDisplay( DebugDisplayInterface *dd, void *, FILE* /* fp
 	dd->setCursorPos( 0, 0 );
 	dd->setRightMargin( 2 );
 	
-	dd->printf( "Total Particles: %d\n", TheParticleSystemManager->getParticleCount() );
+	dd->printf( "Total Particles: %u\n", TheParticleSystemManager->getParticleCount() );
 	dd->printf( "Total Particles (On Screen): %d\n", TheParticleSystemManager->getOnScreenParticleCount());
-	dd->printf( "Total Particle Systems: %d\n", TheParticleSystemManager->getParticleSystemCount() );
+	dd->printf( "Total Particle Systems: %u\n", TheParticleSystemManager->getParticleSystemCount() );
+	dd->printf( "Particle Systems Created: %u (%u reused)\n", TheParticleSystemManager->getCreateCount(), TheParticleSystemManager->getReuseCount() );
+	dd->printf( "Particle System Lookups: %u\n", TheParticleSystemManager->getLookupCount() );
 
 	ParticleSystemManager::ParticleSystemList list = TheParticleSystemManager->getAllParticleSystems();
 	ParticleSystemManager::ParticleSystemList::iterator it;
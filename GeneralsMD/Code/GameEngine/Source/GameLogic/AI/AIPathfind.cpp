@@ -52,6 +52,11 @@
 
 #include "Common/UnitTimings.h" //Contains the DO_UNIT_TIMINGS define jba.	
 
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
 
 #define no_INTENSE_DEBUG
 
@@ -1186,6 +1191,95 @@ void PathfindCellInfo::releaseACellInfo(PathfindCellInfo *theInfo)
 
 //-----------------------------------------------------------------------------------
 
+/**
+ * Empties the list and puts the start cell on it.
+ */
+void PathfindOpenList::reset(PathfindCell *start)
+{
+	clear();
+	PathfindCellInfo *info = start->m_info;
+	DEBUG_ASSERTCRASH(info && info->m_open, ("Start cell should be prepared with startPathfind()."));
+	insert(info);
+}
+
+/**
+ * Empties the list, keeping its storage.
+ */
+void PathfindOpenList::clear(void)
+{
+	m_heap.clear();
+	m_nextSequence = 0;
+}
+
+/**
+ * Adds a cell info to the heap.  It goes behind any cells of equal cost already on the list.
+ */
+void PathfindOpenList::insert(PathfindCellInfo *info)
+{
+	info->m_openSequence = m_nextSequence++;
+	m_heap.push_back(info);
+	place(info, (Int)m_heap.size()-1);
+	siftUp(info->m_openIndex);
+}
+
+/**
+ * Takes a cell info off the heap, from wherever it is.
+ */
+void PathfindOpenList::remove(PathfindCellInfo *info)
+{
+	Int index = info->m_openIndex;
+	DEBUG_ASSERTCRASH(index >= 0 && index < getCount() && at(index) == info, ("Cell is not on the open list."));
+	PathfindCellInfo *last = m_heap.back();
+	m_heap.pop_back();
+	info->m_openIndex = -1;
+	if (last == info) {
+		return;
+	}
+	place(last, index);
+	if (index > 0 && isBefore(last, at((index-1)/2))) {
+		siftUp(index);
+	} else {
+		siftDown(index);
+	}
+}
+
+void PathfindOpenList::siftUp(Int index)
+{
+	PathfindCellInfo *info = at(index);
+	while (index > 0) {
+		Int parent = (index-1)/2;
+		if (!isBefore(info, at(parent))) {
+			break;
+		}
+		place(at(parent), index);
+		index = parent;
+	}
+	place(info, index);
+}
+
+void PathfindOpenList::siftDown(Int index)
+{
+	Int count = getCount();
+	PathfindCellInfo *info = at(index);
+	for (;;) {
+		Int child = 2*index+1;
+		if (child >= count) {
+			break;
+		}
+		if (child+1 < count && isBefore(at(child+1), at(child))) {
+			child++;
+		}
+		if (!isBefore(at(child), info)) {
+			break;
+		}
+		place(at(child), index);
+		index = child;
+	}
+	place(info, index);
+}
+
+//-----------------------------------------------------------------------------------
+
 /**
  * Constructor
  */
@@ -1507,100 +1601,43 @@ Bool PathfindCell::removeObstacle( Object *obstacle )
 	return true;
 }
 
-/// put self on "open" list in ascending cost order, return new list
-PathfindCell *PathfindCell::putOnSortedOpenList( PathfindCell *list )
+/// put self on "open" list in ascending cost order
+void PathfindCell::putOnSortedOpenList( PathfindOpenList &list )
 {
 	DEBUG_ASSERTCRASH(m_info, ("Has to have info."));
 	DEBUG_ASSERTCRASH(m_info->m_closed==FALSE && m_info->m_open==FALSE, ("Serious error - Invalid flags. jba"));
-	if (list == NULL)
-	{
-		list = this;
-		m_info->m_prevOpen = NULL;
-		m_info->m_nextOpen = NULL;
-	}
-	else
-	{
-		// insertion sort
-		PathfindCell *c, *lastCell = NULL;
-		for( c = list; c; c = c->getNextOpen() )
-		{
-			if (c->m_info->m_totalCost > m_info->m_totalCost)
-				break;
-
-			lastCell = c;
-		}
-
-		if (c)
-		{
-			// insert just before "c"
-			if (c->m_info->m_prevOpen)
-				c->m_info->m_prevOpen->m_nextOpen = this->m_info;
-			else
-				list = this;
 
-			m_info->m_prevOpen = c->m_info->m_prevOpen;
-			c->m_info->m_prevOpen = this->m_info;
-				
-			m_info->m_nextOpen = c->m_info;
-
-		}
-		else
-		{
-			// append after "lastCell" - end of list
-			lastCell->m_info->m_nextOpen = this->m_info;
-			m_info->m_prevOpen = lastCell->m_info;
-			m_info->m_nextOpen = NULL;
-		}
-	}
+	list.insert(m_info);
 
 	// mark newCell as being on open list
 	m_info->m_open = true;
 	m_info->m_closed = false;
-
-	return list;
 }
 
 /// remove self from "open" list
-PathfindCell *PathfindCell::removeFromOpenList( PathfindCell *list )
+void PathfindCell::removeFromOpenList( PathfindOpenList &list )
 {
 	DEBUG_ASSERTCRASH(m_info, ("Has to have info."));
 	DEBUG_ASSERTCRASH(m_info->m_closed==FALSE && m_info->m_open==TRUE, ("Serious error - Invalid flags. jba"));
-	if (m_info->m_nextOpen)
-		m_info->m_nextOpen->m_prevOpen = m_info->m_prevOpen;
-	
-	if (m_info->m_prevOpen)
-		m_info->m_prevOpen->m_nextOpen = m_info->m_nextOpen;
-	else
-		list = getNextOpen();
 
-	m_info->m_open = false;
-	m_info->m_nextOpen = NULL;
-	m_info->m_prevOpen = NULL;
+	list.remove(m_info);
 
-	return list;
+	m_info->m_open = false;
 }
 
 /// remove all cells from "open" list
-Int PathfindCell::releaseOpenList( PathfindCell *list )
-{
-	Int count = 0;
-	while (list) {
-		count++;
-		DEBUG_ASSERTCRASH(list->m_info, ("Has to have info."));
-		DEBUG_ASSERTCRASH(list->m_info->m_closed==FALSE && list->m_info->m_open==TRUE, ("Serious error - Invalid flags. jba"));
-		PathfindCell *cur = list;
-		PathfindCellInfo *curInfo = list->m_info;
-		if (curInfo->m_nextOpen) {
-			list = curInfo->m_nextOpen->m_cell;
-		}	else {
-			list = NULL;
-		}
-		DEBUG_ASSERTCRASH(cur == curInfo->m_cell, ("Bad backpointer in PathfindCellInfo"));
-		curInfo->m_nextOpen = NULL;
-		curInfo->m_prevOpen = NULL;
-		curInfo->m_open = FALSE;
+Int PathfindCell::releaseOpenList( PathfindOpenList &list )
+{
+	Int count = list.getCount();
+	for (Int i = 0; i < count; i++) {
+		PathfindCell *cur = list.getNth(i);
+		DEBUG_ASSERTCRASH(cur->m_info, ("Has to have info."));
+		DEBUG_ASSERTCRASH(cur->m_info->m_closed==FALSE && cur->m_info->m_open==TRUE, ("Serious error - Invalid flags. jba"));
+		DEBUG_ASSERTCRASH(cur == cur->m_info->m_cell, ("Bad backpointer in PathfindCellInfo"));
+		cur->m_info->m_open = FALSE;
 		cur->releaseInfo();
 	}
+	list.clear();
 	return count;
 }
 
@@ -1848,11 +1885,11 @@ inline Bool groundCliff(const PathfindCell &targetCell, const PathfindCell &sour
 	return false;
 }
 
+// May run off the logic thread, so no asserts here.  ZoneBlock::blockCheckZones() checks the same things.
 static void __fastcall resolveBlockZones(Int srcZone, Int targetZone, zoneStorageType *zoneEquivalency, Int sizeOfZE)
 {
 	Int i;
 	// We have two zones being combined now. Keep the lower zone.
-	DEBUG_ASSERTCRASH(srcZone!=0 && targetZone!=0,  ("Bad resolve zones	."));
 	if (targetZone<srcZone) {
 		for (i=0; i<sizeOfZE; i++) {
 			if (zoneEquivalency[i] == srcZone) {
@@ -1932,12 +1969,11 @@ inline void applyZone(PathfindCell &targetCell, const PathfindCell &sourceCell,
 
 }
 
+// May run off the logic thread, so no asserts here.  ZoneBlock::blockCheckZones() checks the same things.
 inline void applyBlockZone(PathfindCell &targetCell, const PathfindCell &sourceCell,
 													 zoneStorageType *zoneEquivalency, Int firstZone, Int sizeOfZE)
 {	
-	DEBUG_ASSERTCRASH(sourceCell.getZone()>=firstZone && sourceCell.getZone()<firstZone+sizeOfZE, ("Memory overrun - FATAL ERROR."));
 	Int srcZone = zoneEquivalency[sourceCell.getZone()-firstZone];
-	DEBUG_ASSERTCRASH(targetCell.getZone()>=firstZone && sourceCell.getZone()<firstZone+sizeOfZE, ("Memory overrun - FATAL ERROR."));
 	Int targetZone = zoneEquivalency[targetCell.getZone()-firstZone];
 	if (targetZone == srcZone) {
 		return; // already match.
@@ -1993,6 +2029,18 @@ void ZoneBlock::freeZones(void)
 /* Allocate zone equivalency arrays large enough to hold required entries.  If the arrays are already
 large enough, reuse.  Then calculate terrain equivalencies. */
 void ZoneBlock::blockCalculateZones(PathfindCell **map, PathfindLayer /* layers */[], const IRegion2D &bounds) 
+{
+	blockFindZoneRange(map, bounds);
+	allocateZones();
+#ifdef _DEBUG
+	blockCheckZones(map, bounds);
+#endif
+	blockCalculateEquivalencies(map, bounds);
+}
+
+/* Find the range of raw zone numbers used in this block.  Only reads the map, so blocks can do this
+in parallel. */
+void ZoneBlock::blockFindZoneRange(PathfindCell **map, const IRegion2D &bounds) 
 {
 	Int i, j;
 	m_cellOrigin = bounds.lo;
@@ -2009,9 +2057,33 @@ void ZoneBlock::blockCalculateZones(PathfindCell **map, PathfindLayer /* layers
 	}
 	m_firstZone = minZone;
 	m_numZones = 1 + maxZone - minZone;
+}
 
-	allocateZones();
+#ifdef _DEBUG
+/* The checks blockCalculateEquivalencies() would make, done up front on the logic thread, since the
+debug log and assert code is not thread safe. */
+void ZoneBlock::blockCheckZones(PathfindCell **map, const IRegion2D &bounds) const
+{
+	Int i, j;
+	if (m_numZones==1) return; // all zones are equivalent.
+	DEBUG_ASSERTCRASH(m_zonesAllocated>m_numZones && m_groundCliffZones!=NULL, ("Zones not allocated."));
 
+	for( j=bounds.lo.y; j<=bounds.hi.y; j++ )	{
+		for( i=bounds.lo.x; i<=bounds.hi.x; i++ )	{
+			zoneStorageType zone = map[i][j].getZone();
+			DEBUG_ASSERTCRASH(zone != 0, ("Cleared the zone."));
+			DEBUG_ASSERTCRASH(zone>=m_firstZone && zone<m_firstZone+m_numZones, ("Memory overrun - FATAL ERROR."));
+		}
+	}
+}
+#endif
+
+/* Calculate terrain equivalencies within this block.  The equivalency arrays must already have been
+allocated.  Only writes this block's own arrays, so blocks can do this in parallel.  That also means
+no asserts or logging in here; blockCheckZones() does the checking beforehand. */
+void ZoneBlock::blockCalculateEquivalencies(PathfindCell **map, const IRegion2D &bounds) 
+{
+	Int i, j;
 	if (m_numZones==1) return; // all zones are equivalent.
 
 	// Determine water/ground equivalent zones, and ground/cliff equivalent zones.
@@ -2053,7 +2125,6 @@ void ZoneBlock::blockCalculateZones(PathfindCell **map, PathfindLayer /* layers
 					applyBlockZone(map[i][j], map[i][j-1], m_crusherZones, m_firstZone, m_numZones);
 				}
 			}
-			DEBUG_ASSERTCRASH(map[i][j].getZone() != 0, ("Cleared the zone."));
 		}
 	}
 	
@@ -2152,6 +2223,106 @@ void ZoneBlock::allocateZones(void)
 
 
 //------------------------  PathfindZoneManager  -------------------------------
+/**
+ * A few threads kept for the lifetime of the zone manager, to share out the per block zone passes.
+ * The calling thread always takes a share too.  Jobs must only touch their own column's blocks, and
+ * must not allocate, assert or log, since the memory manager and debug code are not thread safe.
+ */
+class ZoneBlockWorkers
+{
+public:
+	enum { MAX_ZONE_THREADS = 8, MIN_COLUMNS_PER_THREAD = 8 };
+
+	explicit ZoneBlockWorkers(Int threadCount);
+	~ZoneBlockWorkers();
+
+	// No copies allowed!
+	ZoneBlockWorkers(const ZoneBlockWorkers&) = delete;
+	ZoneBlockWorkers& operator=(const ZoneBlockWorkers&) = delete;
+
+	Int getThreadCount(void) const {return (Int)m_threads.size() + 1;}
+
+	/// Calls func(column) for every column, striped over 'stripes' threads, and returns when all are done.
+	void run(Int columns, Int stripes, const std::function<void(Int)> &func);
+
+private:
+	void threadMain(Int stripe);
+
+	std::mutex m_mutex {};
+	std::condition_variable m_wake {};						///< signalled when a job is posted or we're quitting
+	std::condition_variable m_done {};						///< signalled when the last worker finishes its stripe
+	std::vector<std::thread> m_threads {};
+	const std::function<void(Int)> *m_func {};
+	Int m_columns {};
+	Int m_stripes {};
+	Int m_running {};															///< workers still busy with the current job
+	UnsignedInt m_generation {};									///< bumped for each job
+	Bool m_quit {};
+};
+
+ZoneBlockWorkers::ZoneBlockWorkers(Int threadCount)
+{
+	for (Int stripe=1; stripe<threadCount; stripe++) 
+		m_threads.emplace_back(&ZoneBlockWorkers::threadMain, this, stripe);
+}
+
+ZoneBlockWorkers::~ZoneBlockWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_quit = TRUE;
+	}
+	m_wake.notify_all();
+	for (size_t t=0; t<m_threads.size(); t++) 
+		m_threads[t].join();
+}
+
+void ZoneBlockWorkers::run(Int columns, Int stripes, const std::function<void(Int)> &func)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_func = &func;
+		m_columns = columns;
+		m_stripes = stripes;
+		m_running = stripes - 1;
+		++m_generation;
+	}
+	m_wake.notify_all();
+
+	for (Int column=0; column<columns; column+=stripes) 
+		func(column);
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_done.wait(lock, [this]() { return m_running == 0; });
+	m_func = NULL;
+}
+
+void ZoneBlockWorkers::threadMain(Int stripe)
+{
+	UnsignedInt seenGeneration = 0;
+	std::unique_lock<std::mutex> lock(m_mutex);
+	for (;;) 
+	{
+		m_wake.wait(lock, [&]() { return m_quit || m_generation != seenGeneration; });
+		if (m_quit) 
+			return;
+		seenGeneration = m_generation;
+		if (stripe >= m_stripes) 
+			continue; // not needed for this one.
+
+		const std::function<void(Int)> *func = m_func;
+		Int columns = m_columns;
+		Int stripes = m_stripes;
+		lock.unlock();
+		for (Int column=stripe; column<columns; column+=stripes) 
+			(*func)(column);
+		lock.lock();
+
+		if (--m_running == 0) 
+			m_done.notify_one();
+	}
+}
+
 PathfindZoneManager::PathfindZoneManager() :
 m_blockOfZoneBlocks(NULL),
 m_zoneBlocks(NULL),
@@ -2173,6 +2344,8 @@ PathfindZoneManager::~PathfindZoneManager()
 {
 	freeZones();
 	freeBlocks();
+	delete m_workers;
+	m_workers = NULL;
 }
 
 void PathfindZoneManager::freeZones() 
@@ -2263,11 +2436,13 @@ void PathfindZoneManager::reset(void)  ///< Called when the map is reset.
 {
 	freeZones();
 	freeBlocks();
+	m_zoneGeneration++;
 } 
 
 
 void PathfindZoneManager::markZonesDirty( Bool /* insert */ )  ///< Called when the zones need to be recalculated.
 {
+	m_zoneGeneration++;
 
 	if (TheGameLogic->getFrame()<2) {
 		m_nextFrameToCalculateZones = 2;
@@ -2295,6 +2470,120 @@ static  Bool  s_stopForceCalling = FALSE;
 #endif
 
 
+/**
+ * Returns the inclusive cell bounds of a zone block, clipped to the map.
+ */
+static IRegion2D getZoneBlockBounds(const IRegion2D &globalBounds, Int xBlock, Int yBlock)
+{
+	IRegion2D bounds;
+	bounds.lo.x = globalBounds.lo.x + xBlock*PathfindZoneManager::ZONE_BLOCK_SIZE;
+	bounds.lo.y = globalBounds.lo.y + yBlock*PathfindZoneManager::ZONE_BLOCK_SIZE;
+	bounds.hi.x = bounds.lo.x + PathfindZoneManager::ZONE_BLOCK_SIZE - 1; // bounds are inclusive.
+	bounds.hi.y = bounds.lo.y + PathfindZoneManager::ZONE_BLOCK_SIZE - 1; // bounds are inclusive.
+	if (bounds.hi.x > globalBounds.hi.x) 
+		bounds.hi.x = globalBounds.hi.x;
+	if (bounds.hi.y > globalBounds.hi.y) 
+		bounds.hi.y = globalBounds.hi.y;
+	return bounds;
+}
+
+/**
+ * Calls func(column) for each column of zone blocks, striping the columns over the zone manager's
+ * worker threads, which are started the first time a map is big enough to want them.  Small maps
+ * aren't worth waking the threads for and run inline, as does everything if !threaded.  Returns the
+ * number of threads used.
+ */
+static Int forEachZoneBlockColumn(ZoneBlockWorkers *&workers, Int columns, Bool threaded, const std::function<void(Int)> &func)
+{
+	Int threadCount = (Int)std::thread::hardware_concurrency();
+	if (threadCount > ZoneBlockWorkers::MAX_ZONE_THREADS) 
+		threadCount = ZoneBlockWorkers::MAX_ZONE_THREADS;
+
+	Int stripes = columns/ZoneBlockWorkers::MIN_COLUMNS_PER_THREAD;
+	if (stripes > threadCount) 
+		stripes = threadCount;
+
+	if (stripes < 2 || !threaded) 
+	{
+		for (Int column=0; column<columns; column++) 
+			func(column);
+		return 1;
+	}
+
+	if (workers == NULL) 
+		workers = MSGNEW("PathfindZoneInfo") ZoneBlockWorkers(threadCount);
+	workers->run(columns, stripes, func);
+	return stripes;
+}
+
+static Int64 zoneBlockNanos()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * The per block passes of calculateZones.  The per block equivalencies are independent of each
+ * other, so the columns of blocks are spread over a few threads.  Allocation is left to this
+ * thread, between the two passes.
+ */
+Int PathfindZoneManager::calculateBlockZones(PathfindCell **map, const IRegion2D &globalBounds, Int xCount, Int yCount, Bool threaded)
+{
+	Int threads = forEachZoneBlockColumn(m_workers, xCount, threaded, [&](Int column)
+	{
+		for (Int row=0; row<yCount; row++) 
+		{
+			IRegion2D bounds = getZoneBlockBounds(globalBounds, column, row);
+			m_zoneBlocks[column][row].blockFindZoneRange(map, bounds);
+		}
+	});
+
+	for (Int xBlock=0; xBlock<xCount; xBlock++) 
+	{
+		for (Int yBlock=0; yBlock<yCount; yBlock++) 
+		{
+			m_zoneBlocks[xBlock][yBlock].allocateZones();
+#ifdef _DEBUG
+			m_zoneBlocks[xBlock][yBlock].blockCheckZones(map, getZoneBlockBounds(globalBounds, xBlock, yBlock));
+#endif
+		}
+	}
+
+	forEachZoneBlockColumn(m_workers, xCount, threaded, [&](Int column)
+	{
+		for (Int row=0; row<yCount; row++) 
+		{
+			IRegion2D bounds = getZoneBlockBounds(globalBounds, column, row);
+			m_zoneBlocks[column][row].blockCalculateEquivalencies(map, bounds);
+		}
+	});
+
+	return threads;
+}
+
+void PathfindZoneManager::getBlockZones(Int xBlock, Int yBlock, std::vector<zoneStorageType> &zones) const
+{
+	const ZoneBlock &block = m_zoneBlocks[xBlock][yBlock];
+	zones.push_back(block.m_firstZone);
+	zones.push_back(block.m_numZones);
+	if (block.m_numZones == 1) 
+		return; // no equivalency tables.
+	zones.insert(zones.end(), block.m_groundCliffZones, block.m_groundCliffZones + block.m_numZones);
+	zones.insert(zones.end(), block.m_groundWaterZones, block.m_groundWaterZones + block.m_numZones);
+	zones.insert(zones.end(), block.m_groundRubbleZones, block.m_groundRubbleZones + block.m_numZones);
+	zones.insert(zones.end(), block.m_crusherZones, block.m_crusherZones + block.m_numZones);
+}
+
+AsciiString PathfindZoneManager::reportBlockPasses(Int /* frames */) const
+{
+	AsciiString report;
+	if (m_blockPassChecks == 0) 
+		return report;
+	report.format("  zone block passes: %d recalculations, threaded (%d threads) %.2f ms, serial %.2f ms each, %.2fx, %d of %d blocks differed\n",
+		m_blockPassChecks, m_blockPassThreads, m_threadedBlockNanos / 1.0e6 / m_blockPassChecks, m_serialBlockNanos / 1.0e6 / m_blockPassChecks,
+		m_threadedBlockNanos > 0 ? (double)m_serialBlockNanos / m_threadedBlockNanos : 0.0, m_blockPassDiffered, m_blockPassBlocks);
+	return report;
+}
+
 void PathfindZoneManager::calculateZones( PathfindCell **map, PathfindLayer layers[], const IRegion2D &globalBounds )
 {
 
@@ -2308,6 +2597,7 @@ void PathfindZoneManager::calculateZones( PathfindCell **map, PathfindLayer laye
 #endif
 
 
+	m_zoneGeneration++;
 	m_maxZone = 1;	// we start using zone 0 as a flag.
 	const Int maxZones=24000;
 	zoneStorageType zoneEquivalency[maxZones];
@@ -2517,29 +2807,47 @@ void PathfindZoneManager::calculateZones( PathfindCell **map, PathfindLayer laye
 
 
 //	DEBUG_ASSERTCRASH(xBlock==m_zoneBlockExtent.x && yBlock==m_zoneBlockExtent.y, ("Inconsistent allocation - SERIOUS ERROR. jba"));
-	for (xBlock=0; xBlock<xCount; xBlock++) 
-  {
-		for (yBlock=0; yBlock<yCount; yBlock++) 
-    {
-			IRegion2D bounds;
-			bounds.lo.x = globalBounds.lo.x + xBlock*ZONE_BLOCK_SIZE;
-			bounds.lo.y = globalBounds.lo.y + yBlock*ZONE_BLOCK_SIZE;
-			bounds.hi.x = bounds.lo.x + ZONE_BLOCK_SIZE - 1; // bounds are inclusive.
-			bounds.hi.y = bounds.lo.y + ZONE_BLOCK_SIZE - 1; // bounds are inclusive.
-			
-      if (bounds.hi.x > globalBounds.hi.x) 
-				bounds.hi.x = globalBounds.hi.x;
-			
-      if (bounds.hi.y > globalBounds.hi.y) 
-				bounds.hi.y = globalBounds.hi.y;
+	if (TheGlobalData->m_data.m_zoneBlockBenchmark) 
+	{
+		// Run the block passes both ways, taking turns at going first, and compare every block.
+		Bool threadedFirst = (m_blockPassChecks & 1) == 0;
+		std::vector<std::vector<zoneStorageType> > firstZones((size_t)(xCount*yCount));
+		for (Int pass=0; pass<2; pass++) 
+		{
+			Bool threaded = (pass == 0) == threadedFirst;
+			Int64 start = zoneBlockNanos();
+			Int threads = calculateBlockZones(map, globalBounds, xCount, yCount, threaded);
+			Int64 nanos = zoneBlockNanos() - start;
+			if (threaded) {
+				m_threadedBlockNanos += nanos;
+				m_blockPassThreads = threads;
+			} else {
+				m_serialBlockNanos += nanos;
+			}
 
-// Although a good safeguard, the logic is already proven, thus skip the check
-//			if (bounds.lo.x>bounds.hi.x || bounds.lo.y>bounds.hi.y) {
-//				DEBUG_CRASH(("Incorrect bounds calculation. Logic error, fix me. jba."));
-//				continue;
-//			}
-			m_zoneBlocks[xBlock][yBlock].blockCalculateZones(map, layers, bounds);
+			std::vector<zoneStorageType> zones;
+			for (xBlock=0; xBlock<xCount; xBlock++) 
+			{
+				for (yBlock=0; yBlock<yCount; yBlock++) 
+				{
+					std::vector<zoneStorageType> &first = firstZones[(size_t)(xBlock*yCount + yBlock)];
+					if (pass == 0) {
+						getBlockZones(xBlock, yBlock, first);
+						continue;
+					}
+					zones.clear();
+					getBlockZones(xBlock, yBlock, zones);
+					m_blockPassBlocks++;
+					if (zones != first) 
+						m_blockPassDiffered++;
+				}
+			}
 		}
+		m_blockPassChecks++;
+	}
+	else 
+	{
+		calculateBlockZones(map, globalBounds, xCount, yCount, TRUE);
 	}
 
 
@@ -2839,6 +3147,8 @@ void PathfindZoneManager::updateZonesForModify(PathfindCell **map, PathfindLayer
 	// double timeToUpdate=0.0f;
 #endif
 #endif
+	m_zoneGeneration++;
+
 	IRegion2D bounds = structureBounds;
 	bounds.hi.x++;
 	bounds.hi.y++;
@@ -3002,6 +3312,32 @@ void PathfindZoneManager::setAllPassable( )
 	}
 }
 
+//
+// Get the indices of the passable blocks.
+//
+void PathfindZoneManager::getPassableBlocks(std::vector<Int> &blocks) const
+{	Int blockX;
+	Int blockY;
+	for (blockX = 0; blockX<m_zoneBlockExtent.x; blockX++) {
+		for (blockY = 0; blockY<m_zoneBlockExtent.y; blockY++) {
+			if (m_zoneBlocks[blockX][blockY].isPassable()) {
+				blocks.push_back(blockX*m_zoneBlockExtent.y + blockY);
+			}
+		}
+	}
+}
+
+//
+// Set the passable flags for blocks from getPassableBlocks().
+//
+void PathfindZoneManager::setPassableBlocks(const std::vector<Int> &blocks)
+{
+	for (size_t i=0; i<blocks.size(); i++) {
+		Int block = blocks[i];
+		m_zoneBlocks[block/m_zoneBlockExtent.y][block%m_zoneBlockExtent.y].setPassable(true);
+	}
+}
+
 //
 // Set the passable flag for the block at this location.
 //
@@ -3820,6 +4156,94 @@ void PathfindLayer::classifyWallMapCell( Int i, Int j , PathfindCell *cell, Obje
 	}
 }
 
+//----------------------- PathfindCorridorCache ---------------------------
+
+static Int64 corridorCacheNanos()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Bool PathfindCorridorKey::operator==(const PathfindCorridorKey &other) const
+{
+	return m_surfaces == other.m_surfaces && m_crusher == other.m_crusher && m_isHuman == other.m_isHuman &&
+		m_fromLayer == other.m_fromLayer && m_toLayer == other.m_toLayer &&
+		m_fromCell.x == other.m_fromCell.x && m_fromCell.y == other.m_fromCell.y &&
+		m_toCell.x == other.m_toCell.x && m_toCell.y == other.m_toCell.y;
+}
+
+void PathfindCorridorCache::clear( void )
+{
+	m_corridors.clear();
+	m_useCount = 0;
+}
+
+void PathfindCorridorCache::reset( void )
+{
+	if (m_hits || m_misses) {
+		DEBUG_LOG(("Pathfind corridor cache: %d hits, %d misses\n", m_hits, m_misses));
+	}
+	clear();
+	m_hits = 0;
+	m_misses = 0;
+	m_hitNanos = 0;
+	m_searchNanos = 0;
+	m_checked = 0;
+	m_differed = 0;
+}
+
+AsciiString PathfindCorridorCache::report( Int frames ) const
+{
+	Int lookups = m_hits + m_misses;
+	AsciiString report;
+	report.format("  pathfind corridor cache: %d lookups (%.1f/frame), %d hits, %d misses, %.1f%% hit rate, search %.2f us, hit %.2f us\n",
+		lookups, frames > 0 ? (double)lookups / frames : 0.0, m_hits, m_misses, lookups > 0 ? 100.0 * m_hits / lookups : 0.0,
+		m_misses > 0 ? m_searchNanos / 1000.0 / m_misses : 0.0, m_hits > 0 ? m_hitNanos / 1000.0 / m_hits : 0.0);
+	if (m_checked > 0) {
+		AsciiString line;
+		line.format("  pathfind corridor cache: %d hits searched again, %d differed\n", m_checked, m_differed);
+		report.concat(line);
+	}
+	return report;
+}
+
+/**
+ * Look up a corridor.  Any corridors from an older zone generation are thrown away first.
+ */
+const std::vector<Int> *PathfindCorridorCache::find( const PathfindCorridorKey &key, UnsignedInt zoneGeneration )
+{
+	if (zoneGeneration != m_zoneGeneration) {
+		m_corridors.clear();
+		m_zoneGeneration = zoneGeneration;
+	}
+	for (size_t i=0; i<m_corridors.size(); i++) {
+		if (m_corridors[i].m_key == key) {
+			m_corridors[i].m_lastUsed = ++m_useCount;
+			m_hits++;
+			return &m_corridors[i].m_blocks;
+		}
+	}
+	m_misses++;
+	return NULL;
+}
+
+void PathfindCorridorCache::add( const PathfindCorridorKey &key, const std::vector<Int> &blocks )
+{
+	size_t slot = m_corridors.size();
+	if (slot >= MAX_CORRIDORS) {
+		slot = 0;
+		for (size_t i=1; i<m_corridors.size(); i++) {
+			if (m_corridors[i].m_lastUsed < m_corridors[slot].m_lastUsed) {
+				slot = i;
+			}
+		}
+	}	else {
+		m_corridors.resize(slot+1);
+	}
+	m_corridors[slot].m_key = key;
+	m_corridors[slot].m_blocks = blocks;
+	m_corridors[slot].m_lastUsed = ++m_useCount;
+}
+
 //----------------------- Pathfinder ---------------------------------------
 
 Pathfinder::Pathfinder( void ) :m_map(NULL)
@@ -3837,6 +4261,7 @@ Pathfinder::~Pathfinder( void )
 void Pathfinder::reset( void )
 {
 	frameToShowObstacles = 0;
+	m_corridorCache.reset();
 	DEBUG_LOG(("Pathfind cell is %d bytes, PathfindCellInfo is %d bytes\n", sizeof(PathfindCell), sizeof(PathfindCellInfo)));
 
 	if (m_blockOfMapCells) {
@@ -3856,7 +4281,7 @@ void Pathfinder::reset( void )
 	// reset the pathfind grid
 	m_extent.lo.x=m_extent.lo.y=m_extent.hi.x=m_extent.hi.y=0;
 	m_logicalExtent.lo.x=m_logicalExtent.lo.y=m_logicalExtent.hi.x=m_logicalExtent.hi.y=0;
-	m_openList = NULL;
+	m_openList.clear();
 	m_closedList = NULL;
 
 	m_ignoreObstacleID = INVALID_ID;
@@ -4706,8 +5131,9 @@ void Pathfinder::debugShowSearch(  Bool pathFound  )
 		addIcon(NULL, 0, 0, color);	 // erase.
 	}
 
-	for( s = m_openList; s; s=s->getNextOpen() )
+	for( Int i = 0; i < m_openList.getCount(); i++ )
 	{
+		s = m_openList.getNth(i);
 		// create objects to show path - they decay
 		RGBColor color;
 		color.red = color.green = 0;
@@ -4811,9 +5237,8 @@ Bool Pathfinder::validMovementTerrain( PathfindLayerEnum layer, const Locomotor*
 //
 void Pathfinder::cleanOpenAndClosedLists(void) {
 	Int count = 0;
-	if (m_openList) {
+	if (!m_openList.empty()) {
 		count += PathfindCell::releaseOpenList(m_openList);
-		m_openList = NULL;
 	}		 
 	if (m_closedList) {
 		count += PathfindCell::releaseClosedList(m_closedList);
@@ -5915,6 +6340,10 @@ void Pathfinder::processPathfindQueue(void)
 	bounds.hi.y = REAL_TO_INT_FLOOR(terrainExtent.hi.y / PATHFIND_CELL_SIZE_F);
 	bounds.hi.x--;
 	bounds.hi.y--;
+	if (bounds.lo.x != m_logicalExtent.lo.x || bounds.lo.y != m_logicalExtent.lo.y ||
+			bounds.hi.x != m_logicalExtent.hi.x || bounds.hi.y != m_logicalExtent.hi.y) {
+		m_corridorCache.clear(); // human searches are clipped to the logical extent.
+	}
 	m_logicalExtent = bounds;
 
 	m_cumulativeCellsAllocated = 0;	// Number of pathfind cells examined.
@@ -5996,7 +6425,7 @@ void Pathfinder::checkChangeLayers(PathfindCell *parentCell)
 					newCell->setCostSoFar(parentCell->getCostSoFar()); // same as parent cost
 					newCell->setTotalCost(parentCell->getTotalCost()) ;
 					// insert newCell in open list such that open list is sorted, smallest total path cost first
-					m_openList = newCell->putOnSortedOpenList( m_openList );
+					newCell->putOnSortedOpenList( m_openList );
 
 				}
 			}
@@ -6104,10 +6533,10 @@ struct ExamineCellsStruct
 
 			// if the to was already on the open list, remove it so it can be re-inserted in order
 			if (to->getOpen())
-				d->thePathfinder->m_openList = to->removeFromOpenList( d->thePathfinder->m_openList );
+				to->removeFromOpenList( d->thePathfinder->m_openList );
 
 			// insert to in open list such that open list is sorted, smallest total path cost first
-			d->thePathfinder->m_openList = to->putOnSortedOpenList( d->thePathfinder->m_openList );
+			to->putOnSortedOpenList( d->thePathfinder->m_openList );
 	}
 
 	return 0;	// keep going
@@ -6367,10 +6796,10 @@ Int Pathfinder::examineNeighboringCells(PathfindCell *parentCell, PathfindCell *
 
 			// if the newCell was already on the open list, remove it so it can be re-inserted in order
 			if (newCell->getOpen())
-				m_openList = newCell->removeFromOpenList( m_openList );
+				newCell->removeFromOpenList( m_openList );
 
 			// insert newCell in open list such that open list is sorted, smallest total path cost first
-			m_openList = newCell->putOnSortedOpenList( m_openList );
+			newCell->putOnSortedOpenList( m_openList );
 		}
 	return cellCount;
 }
@@ -6480,7 +6909,7 @@ Path *Pathfinder::internalFindPath( Object *obj, const LocomotorSet& locomotorSe
 		DEBUG_LOG(("Attempting pathfind to 0,0, generally a bug.\n"));
 		return NULL;
 	}
-	DEBUG_ASSERTCRASH(m_openList==NULL && m_closedList == NULL, ("Dangling lists."));
+	DEBUG_ASSERTCRASH(m_openList.empty() && m_closedList == NULL, ("Dangling lists."));
 	if (m_isMapReady == false) {
 		return NULL;
 	}
@@ -6594,7 +7023,7 @@ Path *Pathfinder::internalFindPath( Object *obj, const LocomotorSet& locomotorSe
 	parentCell->startPathfind(goalCell);
 
 	// initialize "open" list to contain start cell
-	m_openList = parentCell;
+	m_openList.reset(parentCell);
 
 	// "closed" list is initially empty
 	m_closedList = NULL;
@@ -6605,11 +7034,11 @@ Path *Pathfinder::internalFindPath( Object *obj, const LocomotorSet& locomotorSe
 	// Continue search until "open" list is empty, or
 	// until goal is found.
 	//
-	while( m_openList != NULL )
+	while( !m_openList.empty() )
 	{
 		// take head cell off of open list - it has lowest estimated total path cost
-		parentCell = m_openList;
-		m_openList = parentCell->removeFromOpenList(m_openList);
+		parentCell = m_openList.getFirst();
+		parentCell->removeFromOpenList( m_openList );
 
 		if (parentCell == goalCell)
 		{
@@ -6830,23 +7259,32 @@ Path *Pathfinder::buildGroundPath(Bool isCrusher, const Coord3D *fromPos, Pathfi
 }			 
 
 /**
- * Work backwards from goal cell to construct final path.
+ * Fill in the corridor cache key for a hierarchical search between two cells.
  */
-Path *Pathfinder::buildHierachicalPath( const Coord3D *fromPos, PathfindCell *goalCell )
+void Pathfinder::getCorridorKey( PathfindCorridorKey &key, Bool isHuman, LocomotorSurfaceTypeMask surfaces, Bool crusher,
+	PathfindCell *fromCell, PathfindCell *goalCell )
 {
-	DEBUG_ASSERTCRASH( goalCell, ("Pathfinder::buildHierachicalPath: goalCell == NULL") );
-
-	Path *path = newInstance(Path);
-
-	prependCells(path, fromPos, goalCell, true);
+	key.m_surfaces = surfaces;
+	key.m_crusher = crusher;
+	key.m_isHuman = isHuman;
+	key.m_fromLayer = fromCell->getLayer();
+	key.m_toLayer = goalCell->getLayer();
+	key.m_fromCell.x = fromCell->getXIndex();
+	key.m_fromCell.y = fromCell->getYIndex();
+	key.m_toCell.x = goalCell->getXIndex();
+	key.m_toCell.y = goalCell->getYIndex();
+}
 
-	// Expand the hierarchical path around the starting point. jba [8/24/2003]
-	// This allows the unit to get around friendly units that may be near it.
-	Coord3D pos = *path->getFirstNode()->getPosition();
-	Coord3D minPos = pos;
+/**
+ * Open up the blocks within a block's width of the given position.  buildHierachicalPath does
+ * this around the start of the path so units can get around friendly units near them.
+ */
+void Pathfinder::setPassableAroundPos( const Coord3D *pos )
+{
+	Coord3D minPos = *pos;
 	minPos.x -= (Real)PathfindZoneManager::ZONE_BLOCK_SIZE * PATHFIND_CELL_SIZE_F;
 	minPos.y -= (Real)PathfindZoneManager::ZONE_BLOCK_SIZE * PATHFIND_CELL_SIZE_F;
-	Coord3D maxPos = pos;
+	Coord3D maxPos = *pos;
 	maxPos.x += (Real)PathfindZoneManager::ZONE_BLOCK_SIZE * PATHFIND_CELL_SIZE_F;
 	maxPos.y += (Real)PathfindZoneManager::ZONE_BLOCK_SIZE * PATHFIND_CELL_SIZE_F;
 	ICoord2D cellNdxMin, cellNdxMax;
@@ -6858,6 +7296,26 @@ Path *Pathfinder::buildHierachicalPath( const Coord3D *fromPos, PathfindCell *go
 			m_zoneManager.setPassable(i, j, true);
 		}
 	}
+}
+
+/**
+ * Work backwards from goal cell to construct final path.
+ */
+Path *Pathfinder::buildHierachicalPath( const Coord3D *fromPos, PathfindCell *goalCell, std::vector<Int> *corridor )
+{
+	DEBUG_ASSERTCRASH( goalCell, ("Pathfinder::buildHierachicalPath: goalCell == NULL") );
+
+	Path *path = newInstance(Path);
+
+	prependCells(path, fromPos, goalCell, true);
+	if (corridor) {
+		m_zoneManager.getPassableBlocks(*corridor);
+	}
+
+	// Expand the hierarchical path around the starting point. jba [8/24/2003]
+	// This allows the unit to get around friendly units that may be near it.
+	// (prependCells always starts the path at fromPos.)
+	setPassableAroundPos(path->getFirstNode()->getPosition());
 
 #if defined _DEBUG || defined _INTERNAL
 	if (TheGlobalData->m_data.m_debugAI==AI_DEBUG_PATHS)
@@ -6989,7 +7447,7 @@ struct GroundCellsStruct
 			to->setTotalCost(to->getCostSoFar() + costRemaining) ;
 
 			// insert to in open list such that open list is sorted, smallest total path cost first
-			d->thePathfinder->m_openList = to->putOnSortedOpenList( d->thePathfinder->m_openList );
+			to->putOnSortedOpenList( d->thePathfinder->m_openList );
 	}
 
 	return 0;	// keep going
@@ -7025,7 +7483,7 @@ Path *Pathfinder::findGroundPath( const Coord3D *from,
 		DEBUG_LOG(("Attempting pathfind to 0,0, generally a bug.\n"));
 		return NULL;
 	}
-	DEBUG_ASSERTCRASH(m_openList==NULL && m_closedList == NULL, ("Dangling lists."));
+	DEBUG_ASSERTCRASH(m_openList.empty() && m_closedList == NULL, ("Dangling lists."));
 	if (m_isMapReady == false) {
 		return NULL;
 	}
@@ -7112,7 +7570,7 @@ Path *Pathfinder::findGroundPath( const Coord3D *from,
 	parentCell->startPathfind(goalCell);
 
 	// initialize "open" list to contain start cell
-	m_openList = parentCell;
+	m_openList.reset(parentCell);
 
 	// "closed" list is initially empty
 	m_closedList = NULL;
@@ -7122,11 +7580,11 @@ Path *Pathfinder::findGroundPath( const Coord3D *from,
 	// until goal is found.
 	//
 	Int cellCount = 0;
-	while( m_openList != NULL )
+	while( !m_openList.empty() )
 	{
 		// take head cell off of open list - it has lowest estimated total path cost
-		parentCell = m_openList;
-		m_openList = parentCell->removeFromOpenList(m_openList);
+		parentCell = m_openList.getFirst();
+		parentCell->removeFromOpenList( m_openList );
 
 		if (parentCell == goalCell)
 		{
@@ -7279,10 +7737,10 @@ Path *Pathfinder::findGroundPath( const Coord3D *from,
 
 			// if the newCell was already on the open list, remove it so it can be re-inserted in order
 			if (newCell->getOpen())
-				m_openList = newCell->removeFromOpenList( m_openList );
+				newCell->removeFromOpenList( m_openList );
 
 			// insert newCell in open list such that open list is sorted, smallest total path cost first
-			m_openList = newCell->putOnSortedOpenList( m_openList );
+			newCell->putOnSortedOpenList( m_openList );
 		}
 
 
@@ -7423,7 +7881,7 @@ void Pathfinder::processHierarchicalCell( const ICoord2D &scanCell, const ICoord
 			adjNewCell->setTotalCost(adjNewCell->getCostSoFar() + remCost);
 			adjNewCell->setParentCellHierarchical(parentCell);
 			// insert newCell in open list such that open list is sorted, smallest total path cost first
-			m_openList = adjNewCell->putOnSortedOpenList( m_openList );
+			adjNewCell->putOnSortedOpenList( m_openList );
 		}
 
 	}
@@ -7469,7 +7927,7 @@ Path *Pathfinder::internal_findHierarchicalPath( Bool isHuman, const LocomotorSu
 		DEBUG_LOG(("Attempting pathfind to 0,0, generally a bug.\n"));
 		return NULL;
 	}
-	DEBUG_ASSERTCRASH(m_openList==NULL && m_closedList == NULL, ("Dangling lists."));
+	DEBUG_ASSERTCRASH(m_openList.empty() && m_closedList == NULL, ("Dangling lists."));
 	if (m_isMapReady == false) {
 		return NULL;
 	}
@@ -7521,6 +7979,34 @@ Path *Pathfinder::internal_findHierarchicalPath( Bool isHuman, const LocomotorSu
 		return NULL;
 	}
 
+	// The callers only want the blocks this search opens up, so if the same trip has been
+	// searched since the zones last changed, just open up the same blocks again.  The callers
+	// clear the passable flags first, so the cached blocks are exactly the search's own.
+	PathfindCorridorKey corridorKey;
+	std::vector<Int> hitBlocks;
+	Bool checkingHit = false;
+	Int64 searchStart = 0;
+	if (!closestOK) {
+		searchStart = corridorCacheNanos();
+		getCorridorKey(corridorKey, isHuman, locomotorSurface, crusher, parentCell, goalCell);
+		const std::vector<Int> *corridor = m_corridorCache.find(corridorKey, m_zoneManager.getZoneGeneration());
+		if (corridor) {
+			m_zoneManager.setPassableBlocks(*corridor);
+			setPassableAroundPos(from);
+			if (TheGlobalData->m_data.m_corridorCacheBenchmark) {
+				// Search anyway, and see whether it opens up the same blocks.
+				m_zoneManager.getPassableBlocks(hitBlocks);
+				m_zoneManager.clearPassableFlags();
+				checkingHit = true;
+			}	else {
+				goalCell->releaseInfo();
+				parentCell->releaseInfo();
+				m_corridorCache.addHitNanos(corridorCacheNanos() - searchStart);
+				return newInstance(Path);
+			}
+		}
+	}
+
 	parentCell->startPathfind(goalCell);
 
 	// "closed" list is initially empty
@@ -7544,9 +8030,9 @@ Path *Pathfinder::internal_findHierarchicalPath( Bool isHuman, const LocomotorSu
 
 	if (parentCell->getLayer()==LAYER_GROUND) {
 		// initialize "open" list to contain start cell
-		m_openList = parentCell;
+		m_openList.reset(parentCell);
 	}	else {
-		m_openList = parentCell;
+		m_openList.reset(parentCell);
 		PathfindLayerEnum layer = parentCell->getLayer();
 		// We're starting on a bridge, so link to land at the bridge end points.
 		ICoord2D ndx;
@@ -7557,7 +8043,7 @@ Path *Pathfinder::internal_findHierarchicalPath( Bool isHuman, const LocomotorSu
 		PathfindCell *startCell = getCell(LAYER_GROUND, ndx.x, ndx.y);
 		if (cell && startCell) {
 			// Close parent cell;
-			m_openList = parentCell->removeFromOpenList(m_openList);
+			parentCell->removeFromOpenList( m_openList );
 			m_closedList = parentCell->putOnClosedList(m_closedList);
 			startCell->allocateInfo(ndx);
 			startCell->setParentCellHierarchical(parentCell);
@@ -7568,7 +8054,7 @@ Path *Pathfinder::internal_findHierarchicalPath( Bool isHuman, const LocomotorSu
 			startCell->setTotalCost(remCost);
 			startCell->setParentCellHierarchical(parentCell);
 			// insert newCell in open list such that open list is sorted, smallest total path cost first
-			m_openList = startCell->putOnSortedOpenList( m_openList );
+			startCell->putOnSortedOpenList( m_openList );
 
 			cellCount++;
 			cell->allocateInfo(toNdx);
@@ -7578,7 +8064,7 @@ Path *Pathfinder::internal_findHierarchicalPath( Bool isHuman, const LocomotorSu
 			cell->setTotalCost(remCost);
 			cell->setParentCellHierarchical(parentCell);
 			// insert newCell in open list such that open list is sorted, smallest total path cost first
-			m_openList = cell->putOnSortedOpenList( m_openList );
+			cell->putOnSortedOpenList( m_openList );
 		}
 	}
 
@@ -7589,11 +8075,11 @@ Path *Pathfinder::internal_findHierarchicalPath( Bool isHuman, const LocomotorSu
 	// Continue search until "open" list is empty, or
 	// until goal is found.
 	//
-	while( m_openList != NULL )
+	while( !m_openList.empty() )
 	{
 		// take head cell off of open list - it has lowest estimated total path cost
-		parentCell = m_openList;
-		m_openList = parentCell->removeFromOpenList(m_openList);
+		parentCell = m_openList.getFirst();
+		parentCell->removeFromOpenList( m_openList );
 
 		zoneStorageType parentZone;
 		if (parentCell->getLayer()==LAYER_GROUND) {
@@ -7672,7 +8158,7 @@ Path *Pathfinder::internal_findHierarchicalPath( Bool isHuman, const LocomotorSu
 					cell->setTotalCost(cell->getCostSoFar()+remCost);
 					cell->setParentCellHierarchical(startCell);
 					// insert newCell in open list such that open list is sorted, smallest total path cost first
-					m_openList = cell->putOnSortedOpenList( m_openList );
+					cell->putOnSortedOpenList( m_openList );
 
 				}
 			}
@@ -7687,7 +8173,16 @@ Path *Pathfinder::internal_findHierarchicalPath( Bool isHuman, const LocomotorSu
 
 			m_isTunneling = false;
 			// construct and return path
-			Path *path =  buildHierachicalPath( from, goalCell );
+			std::vector<Int> corridor;
+			Path *path =  buildHierachicalPath( from, goalCell, closestOK ? NULL : &corridor );
+			if (checkingHit) {
+				std::vector<Int> searchBlocks;
+				m_zoneManager.getPassableBlocks(searchBlocks);
+				m_corridorCache.addCheck(searchBlocks == hitBlocks);
+			}	else if (!closestOK) {
+				m_corridorCache.add(corridorKey, corridor);
+				m_corridorCache.addSearchNanos(corridorCacheNanos() - searchStart);
+			}
 #if defined _DEBUG || defined _INTERNAL
 			Bool show = TheGlobalData->m_data.m_debugAI==AI_DEBUG_PATHS;
 			show |= (TheGlobalData->m_data.m_debugAI==AI_DEBUG_GROUND_PATHS);
@@ -7968,6 +8463,9 @@ Path *Pathfinder::internal_findHierarchicalPath( Bool isHuman, const LocomotorSu
 #ifdef DUMP_PERF_STATS
 	TheGameLogic->incrementOverallFailedPathfinds();
 #endif
+	if (checkingHit) {
+		m_corridorCache.addCheck(false);
+	}
 	m_isTunneling = false;
 	goalCell->releaseInfo();
 	cleanOpenAndClosedLists();
@@ -8194,7 +8692,7 @@ Bool Pathfinder::pathDestination( 	Object *obj, const LocomotorSet& locomotorSet
 
 	Coord3D adjustTo = *groupDest;
 	Coord3D *to = &adjustTo;
-	DEBUG_ASSERTCRASH(m_openList==NULL && m_closedList == NULL, ("Dangling lists."));
+	DEBUG_ASSERTCRASH(m_openList.empty() && m_closedList == NULL, ("Dangling lists."));
 	// create unique "mark" values for open and closed cells for this pathfind invocation
 
 	Bool isCrusher = obj ? obj->getCrusherLevel() > 0 : false;
@@ -8253,7 +8751,7 @@ Bool Pathfinder::pathDestination( 	Object *obj, const LocomotorSet& locomotorSet
 	parentCell->startPathfind(goalCell);
 
 	// initialize "open" list to contain start cell
-	m_openList = parentCell;
+	m_openList.reset(parentCell);
 
 	// "closed" list is initially empty
 	m_closedList = NULL;
@@ -8262,11 +8760,11 @@ Bool Pathfinder::pathDestination( 	Object *obj, const LocomotorSet& locomotorSet
 	// Continue search until "open" list is empty, or
 	// until goal is found.
 	//
-	while( m_openList != NULL )
+	while( !m_openList.empty() )
 	{
 		// take head cell off of open list - it has lowest estimated total path cost
-		parentCell = m_openList;
-		m_openList = parentCell->removeFromOpenList(m_openList);
+		parentCell = m_openList.getFirst();
+		parentCell->removeFromOpenList( m_openList );
 
 		Coord3D pos;
 		// put parent cell onto closed list - its evaluation is finished
@@ -8389,10 +8887,10 @@ Bool Pathfinder::pathDestination( 	Object *obj, const LocomotorSet& locomotorSet
 
 			// if the newCell was already on the open list, remove it so it can be re-inserted in order
 			if (newCell->getOpen())
-				m_openList = newCell->removeFromOpenList( m_openList );
+				newCell->removeFromOpenList( m_openList );
 
 			// insert newCell in open list such that open list is sorted, smallest total path cost first
-			m_openList = newCell->putOnSortedOpenList( m_openList );
+			newCell->putOnSortedOpenList( m_openList );
 		}
 	}
 
@@ -8472,7 +8970,7 @@ Int Pathfinder::checkPathCost(Object *obj, const LocomotorSet& locomotorSet, con
 
 	Coord3D adjustTo = *rawTo;
 	Coord3D *to = &adjustTo;
-	DEBUG_ASSERTCRASH(m_openList==NULL && m_closedList == NULL, ("Dangling lists."));
+	DEBUG_ASSERTCRASH(m_openList.empty() && m_closedList == NULL, ("Dangling lists."));
 	// create unique "mark" values for open and closed cells for this pathfind invocation
 
 	Bool isCrusher = obj ? obj->getCrusherLevel() > 0 : false;
@@ -8517,7 +9015,7 @@ Int Pathfinder::checkPathCost(Object *obj, const LocomotorSet& locomotorSet, con
 	parentCell->startPathfind(goalCell);
 
 	// initialize "open" list to contain start cell
-	m_openList = parentCell;
+	m_openList.reset(parentCell);
 
 	// "closed" list is initially empty
 	m_closedList = NULL;
@@ -8526,11 +9024,11 @@ Int Pathfinder::checkPathCost(Object *obj, const LocomotorSet& locomotorSet, con
 	// Continue search until "open" list is empty, or
 	// until goal is found.
 	//
-	while( m_openList != NULL )
+	while( !m_openList.empty() )
 	{
 		// take head cell off of open list - it has lowest estimated total path cost
-		parentCell = m_openList;
-		m_openList = parentCell->removeFromOpenList(m_openList);
+		parentCell = m_openList.getFirst();
+		parentCell->removeFromOpenList( m_openList );
 
 		// put parent cell onto closed list - its evaluation is finished
 		m_closedList = parentCell->putOnClosedList( m_closedList );
@@ -8642,10 +9140,10 @@ Int Pathfinder::checkPathCost(Object *obj, const LocomotorSet& locomotorSet, con
 
 			// if the newCell was already on the open list, remove it so it can be re-inserted in order
 			if (newCell->getOpen())
-				m_openList = newCell->removeFromOpenList( m_openList );
+				newCell->removeFromOpenList( m_openList );
 
 			// insert newCell in open list such that open list is sorted, smallest total path cost first
-			m_openList = newCell->putOnSortedOpenList( m_openList );
+			newCell->putOnSortedOpenList( m_openList );
 		}
 	}
 
@@ -8701,7 +9199,7 @@ Path *Pathfinder::findClosestPath( Object *obj, const LocomotorSet& locomotorSet
 		adjustTo.x += PATHFIND_CELL_SIZE_F/2;
 		adjustTo.y += PATHFIND_CELL_SIZE_F/2;
 	}
-	DEBUG_ASSERTCRASH(m_openList==NULL && m_closedList == NULL, ("Dangling lists."));
+	DEBUG_ASSERTCRASH(m_openList.empty() && m_closedList == NULL, ("Dangling lists."));
 	// create unique "mark" values for open and closed cells for this pathfind invocation
 
 	Bool isCrusher = obj ? obj->getCrusherLevel() > 0 : false;
@@ -8800,7 +9298,7 @@ Path *Pathfinder::findClosestPath( Object *obj, const LocomotorSet& locomotorSet
 	Real closestDistScreenSqr = FLT_MAX;
 
 	// initialize "open" list to contain start cell
-	m_openList = parentCell;
+	m_openList.reset(parentCell);
 
 	// "closed" list is initially empty
 	m_closedList = NULL;
@@ -8810,14 +9308,14 @@ Path *Pathfinder::findClosestPath( Object *obj, const LocomotorSet& locomotorSet
 	// until goal is found.
 	//
 	Bool foundGoal = false;
-	while( m_openList != NULL )
+	while( !m_openList.empty() )
 	{
 		Real dx;
 		Real dy;
 		Real distSqr;
 		// take head cell off of open list - it has lowest estimated total path cost
-		parentCell = m_openList;
-		m_openList = parentCell->removeFromOpenList(m_openList);
+		parentCell = m_openList.getFirst();
+		parentCell->removeFromOpenList( m_openList );
 
 		if (parentCell == goalCell)
 		{
@@ -9218,16 +9716,8 @@ Int Pathfinder::iterateCellsAlongLine( const ICoord2D &start, const ICoord2D &en
 
 static ObjectID getSlaverID(const Object* o)
 {
-	for (BehaviorModule** update = o->getBehaviorModules(); *update; ++update)
-	{
-		SlavedUpdateInterface* sdu = (*update)->getSlavedUpdateInterface();
-		if (sdu != NULL)
-		{
-			return sdu->getSlaverID();
-		}
-	}
-	
-	return INVALID_ID;
+	SlavedUpdateInterface* sdu = o->getSlavedUpdateInterface();
+	return sdu ? sdu->getSlaverID() : INVALID_ID;
 }
 
 static ObjectID getContainerID(const Object* o)
@@ -10226,7 +10716,7 @@ Path *Pathfinder::getMoveAwayFromPath(Object* obj, Object *otherObj,
 	Int radius;
 	getRadiusAndCenter(obj, radius, centerInCell);
 
-	DEBUG_ASSERTCRASH(m_openList==NULL && m_closedList == NULL, ("Dangling lists."));
+	DEBUG_ASSERTCRASH(m_openList.empty() && m_closedList == NULL, ("Dangling lists."));
 
 	// determine start cell
 	ICoord2D startCellNdx;
@@ -10266,7 +10756,7 @@ Path *Pathfinder::getMoveAwayFromPath(Object* obj, Object *otherObj,
 	parentCell->startPathfind(NULL);
 
 	// initialize "open" list to contain start cell
-	m_openList = parentCell;
+	m_openList.reset(parentCell);
 
 	// "closed" list is initially empty
 	m_closedList = NULL;
@@ -10281,11 +10771,11 @@ Path *Pathfinder::getMoveAwayFromPath(Object* obj, Object *otherObj,
 	boxHalfWidth += otherRadius*PATHFIND_CELL_SIZE_F;
 	if (otherCenter) boxHalfWidth+=PATHFIND_CELL_SIZE_F/2;
 
-	while( m_openList != NULL )
+	while( !m_openList.empty() )
 	{
 		// take head cell off of open list - it has lowest estimated total path cost
-		parentCell = m_openList;
-		m_openList = parentCell->removeFromOpenList(m_openList);
+		parentCell = m_openList.getFirst();
+		parentCell->removeFromOpenList( m_openList );
 
 		Region2D bounds;
 		Coord3D cellCenter;
@@ -10397,7 +10887,7 @@ Path *Pathfinder::patchPath( const Object *obj, const LocomotorSet& locomotorSet
 
 	m_zoneManager.setAllPassable();
 
-	DEBUG_ASSERTCRASH(m_openList==NULL && m_closedList == NULL, ("Dangling lists."));
+	DEBUG_ASSERTCRASH(m_openList.empty() && m_closedList == NULL, ("Dangling lists."));
 
 	enum {CELL_LIMIT = 2000}; // max cells to examine.
 	Int cellCount = 0;
@@ -10428,7 +10918,7 @@ Path *Pathfinder::patchPath( const Object *obj, const LocomotorSet& locomotorSet
 	parentCell->startPathfind( NULL);
 
 	// initialize "open" list to contain start cell
-	m_openList = parentCell;
+	m_openList.reset(parentCell);
 
 	// "closed" list is initially empty
 	m_closedList = NULL;
@@ -10498,11 +10988,11 @@ Path *Pathfinder::patchPath( const Object *obj, const LocomotorSet& locomotorSet
 		return NULL;
 	}
 
-	while( m_openList != NULL )
+	while( !m_openList.empty() )
 	{
 		// take head cell off of open list - it has lowest estimated total path cost
-		parentCell = m_openList;
-		m_openList = parentCell->removeFromOpenList(m_openList);
+		parentCell = m_openList.getFirst();
+		parentCell->removeFromOpenList( m_openList );
 
 		Coord3D cellCenter;
 		adjustCoordToCell(parentCell->getXIndex(), parentCell->getYIndex(), centerInCell, cellCenter, parentCell->getLayer());
@@ -10669,7 +11159,7 @@ Path *Pathfinder::findAttackPath( const Object *obj, const LocomotorSet& locomot
 
 	Int cellCount = 0;
 
-	DEBUG_ASSERTCRASH(m_openList==NULL && m_closedList == NULL, ("Dangling lists."));
+	DEBUG_ASSERTCRASH(m_openList.empty() && m_closedList == NULL, ("Dangling lists."));
 
 	UnsignedInt attackDistance = weapon->getAttackDistance(obj, victim, victimPos);
 	attackDistance += 3*PATHFIND_CELL_SIZE;
@@ -10710,7 +11200,7 @@ Path *Pathfinder::findAttackPath( const Object *obj, const LocomotorSet& locomot
 	}
 
 	// initialize "open" list to contain start cell
-	m_openList = parentCell;
+	m_openList.reset(parentCell);
 
 	// "closed" list is initially empty
 	m_closedList = NULL;
@@ -10730,11 +11220,11 @@ Path *Pathfinder::findAttackPath( const Object *obj, const LocomotorSet& locomot
 		checkLOS = true;
 	}
 	
-	while( m_openList != NULL )
+	while( !m_openList.empty() )
 	{
 		// take head cell off of open list - it has lowest estimated total path cost
-		parentCell = m_openList;
-		m_openList = parentCell->removeFromOpenList(m_openList);
+		parentCell = m_openList.getFirst();
+		parentCell->removeFromOpenList( m_openList );
 
 		Coord3D cellCenter;
 		adjustCoordToCell(parentCell->getXIndex(), parentCell->getYIndex(), centerInCell, cellCenter, parentCell->getLayer());
@@ -10946,7 +11436,7 @@ Path *Pathfinder::findSafePath( const Object *obj, const LocomotorSet& locomotor
 		isHuman = false; // computer gets to cheat.
 	}
 
-	DEBUG_ASSERTCRASH(m_openList==NULL && m_closedList == NULL, ("Dangling lists."));
+	DEBUG_ASSERTCRASH(m_openList.empty() && m_closedList == NULL, ("Dangling lists."));
 	// create unique "mark" values for open and closed cells for this pathfind invocation
 
 	m_zoneManager.setAllPassable();
@@ -10965,7 +11455,7 @@ Path *Pathfinder::findSafePath( const Object *obj, const LocomotorSet& locomotor
 	parentCell->startPathfind( NULL);
 
 	// initialize "open" list to contain start cell
-	m_openList = parentCell;
+	m_openList.reset(parentCell);
 
 	// "closed" list is initially empty
 	m_closedList = NULL;
@@ -10977,11 +11467,11 @@ Path *Pathfinder::findSafePath( const Object *obj, const LocomotorSet& locomotor
 
 	Real farthestDistanceSqr = 0;
 
-	while( m_openList != NULL )
+	while( !m_openList.empty() )
 	{
 		// take head cell off of open list - it has lowest estimated total path cost
-		parentCell = m_openList;
-		m_openList = parentCell->removeFromOpenList(m_openList);
+		parentCell = m_openList.getFirst();
+		parentCell->removeFromOpenList( m_openList );
 
 		Coord3D cellCenter;
 		adjustCoordToCell(parentCell->getXIndex(), parentCell->getYIndex(), centerInCell, cellCenter, parentCell->getLayer());
@@ -11000,7 +11490,7 @@ Path *Pathfinder::findSafePath( const Object *obj, const LocomotorSet& locomotor
 		if (distSqr>repulsorDistSqr) {
 			ok = true;
 		}
-		if (m_openList == NULL && cellCount>0) {
+		if (m_openList.empty() && cellCount>0) {
 			ok = true; // exhausted the search space, just take the last cell.
 		}
 		if (distSqr > farthestDistanceSqr) {
@@ -11138,5 +11628,6 @@ void Pathfinder::xfer( Xfer *xfer )
 //-----------------------------------------------------------------------------
 void Pathfinder::loadPostProcess( void )
 {
+	m_corridorCache.clear();
 
 }  // end loadPostProcess
@@ -5346,6 +5346,7 @@ void AIAttackFireWeaponState::onExit( StateExitType /* status */ )
 	Weapon* weapon = obj->getCurrentWeapon();
 	if (weapon && weapon->getStatus() == PRE_ATTACK)
 	{
+		obj->markCRCDirty();
 		weapon->setPreAttackFinishedFrame(0);
 	}
 }
@@ -5568,6 +5569,7 @@ StateReturnType AIAttackState::onEnter()
 	Weapon* curWeapon = source->getCurrentWeapon();
 	if (curWeapon)
 	{
+		source->markCRCDirty();
 		curWeapon->setMaxShotCount(NO_MAX_SHOTS_LIMIT);
 		// icky special case for ignoring stealth units we might be targeting, that are currently stealthed. (srj)
 		if (curWeapon->getContinueAttackRange() > 0.0f)
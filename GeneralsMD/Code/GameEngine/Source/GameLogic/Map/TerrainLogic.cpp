@@ -1326,7 +1326,8 @@ Bool TerrainLogic::loadMap( AsciiString filename, Bool query )
 	DEBUG_LOG(("Total of %d waypoints.\n", count));
 #endif
 
-	if (!query) {
+	// headless runs have no renderer to build terrain buffers with; the logic keeps its own heights
+	if (!query && !TheGlobalData->m_data.m_headless) {
 		// tell the game interface a new terrain file has been loaded up
 		TheTerrainVisual->load( getSourceFilename() );
 	}
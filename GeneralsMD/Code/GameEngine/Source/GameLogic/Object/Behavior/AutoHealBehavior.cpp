@@ -253,10 +253,11 @@ UpdateSleepTime AutoHealBehavior::update( void )
 		PartitionFilter *filters[] = { &relationship, &filterAlive, &filterMapStatus, NULL };
 
 		// scan objects in our region
-		ObjectIterator *iter = ThePartitionManager->iterateObjectsInRange( obj->getPosition(), d->m_ini.m_radius, FROM_CENTER_2D, filters );
-		MemoryPoolObjectHolder hold( iter );
-		for( obj = iter->first(); obj; obj = iter->next() )
+		PartitionQueryScratchHolder scratch;
+		PartitionQueryResult inRange = ThePartitionManager->queryObjectsInRange( scratch.get(), obj->getPosition(), d->m_ini.m_radius, FROM_CENTER_2D, filters );
+		for( PartitionQueryResult::iterator it = inRange.begin(); it != inRange.end(); ++it )
 		{
+			obj = it->m_object;
 			// do not heal if we are at max health already
 			BodyModuleInterface *body = obj->getBodyModule();
 			if( body->getHealth() < body->getMaxHealth() )
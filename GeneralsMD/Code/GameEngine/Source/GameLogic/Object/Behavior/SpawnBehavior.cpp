@@ -156,14 +156,10 @@ void SpawnBehavior::onDie( const DamageInfo *damageInfo )
 		if( currentSpawn )
 		{
 			// Go through all my spawns and see if they have a SlavedUpdate I can tell I was killed to
-			for (BehaviorModule** update = currentSpawn->getBehaviorModules(); *update; ++update)
+			SlavedUpdateInterface* sdu = currentSpawn->getSlavedUpdateInterface();
+			if (sdu != NULL)
 			{
-				SlavedUpdateInterface* sdu = (*update)->getSlavedUpdateInterface();
-				if (sdu != NULL)
-				{
-					sdu->onSlaverDie( damageInfo );
-					break;
-				}
+				sdu->onSlaverDie( damageInfo );
 			}
 
 			// our spawner has died, we must invalidate the ID now in the spawned object
@@ -656,14 +652,10 @@ Bool SpawnBehavior::createSpawn()
 	newSpawn->setProducer(parent);
 
 	// If they have a SlavedUpdate, then I have to tell them who their daddy is from now on.
-	for (BehaviorModule** update = newSpawn->getBehaviorModules(); *update; ++update)
+	SlavedUpdateInterface* sdu = newSpawn->getSlavedUpdateInterface();
+	if (sdu != NULL)
 	{
-		SlavedUpdateInterface* sdu = (*update)->getSlavedUpdateInterface();
-		if (sdu != NULL)
-		{
-			sdu->onEnslave( parent );
-			break;
-		}
+		sdu->onEnslave( parent );
 	}
 
 	m_spawnIDs.push_back( newSpawn->getID() );
@@ -808,14 +800,10 @@ void SpawnBehavior::onDamage( DamageInfo *info )
 		if( currentSpawn )
 		{
 			// Go through all my spawns and see if they have a SlavedUpdate I can tell I was hurt to
-			for (BehaviorModule** update = currentSpawn->getBehaviorModules(); *update; ++update)
+			SlavedUpdateInterface* sdu = currentSpawn->getSlavedUpdateInterface();
+			if (sdu != NULL)
 			{
-				SlavedUpdateInterface* sdu = (*update)->getSlavedUpdateInterface();
-				if (sdu != NULL)
-				{
-					sdu->onSlaverDamage( info );
-					break;
-				}
+				sdu->onSlaverDamage( info );
 			}
 		}
 	}
@@ -898,14 +886,10 @@ void SpawnBehavior::computeAggregateStates(void)
 		{
 			//m_selfTaskingSpawnCount += ( currentSpawn->isSelf);
 
-			for (BehaviorModule** update = currentSpawn->getBehaviorModules(); *update; ++update)
+			SlavedUpdateInterface* sdu = currentSpawn->getSlavedUpdateInterface();
+			if (sdu != NULL)
 			{
-				SlavedUpdateInterface* sdu = (*update)->getSlavedUpdateInterface();
-				if (sdu != NULL)
-				{
-					m_selfTaskingSpawnCount += ( sdu->isSelfTasking());;
-					break;
-				}
+				m_selfTaskingSpawnCount += ( sdu->isSelfTasking());;
 			}
 
 
@@ -904,6 +904,7 @@ void ActiveBody::setMaxHealth( Real maxHealth, MaxHealthChangeType healthChangeT
 {
 	Real prevMaxHealth = m_maxHealth;
 	m_maxHealth = maxHealth;
+	getObject()->markCRCDirty();
 	m_initialHealth = maxHealth;
 
 	switch( healthChangeType )
@@ -1223,6 +1224,7 @@ void ActiveBody::internalChangeHealth( Real delta )
 
 	// change the health by the delta, it can be positive or negative
 	m_currentHealth += delta;
+	getObject()->markCRCDirty();
 
 	// high end cap
 	Real maxHealth = m_maxHealth;
@@ -30,8 +30,18 @@
 // INCLUDES ///////////////////////////////////////////////////////////////////////////////////////
 #include "PreRTS.h"
 #include "Common/Xfer.h"
+#include "GameLogic/Object.h"
 #include "GameLogic/Module/BodyModule.h"
 
+// ------------------------------------------------------------------------------------------------
+/** Allows outside systems to apply defensive bonuses or penalties (they all stack as a multiplier!) */
+// ------------------------------------------------------------------------------------------------
+void BodyModule::applyDamageScalar( Real scalar )
+{
+	m_damageScalar *= scalar;
+	getObject()->markCRCDirty();
+}
+
 // ------------------------------------------------------------------------------------------------
 /** CRC */
 // ------------------------------------------------------------------------------------------------
@@ -321,6 +321,7 @@ void TransportContain::onContaining( Object *rider, Bool wasSelected )
 		if( bikeWeapon && riderWeapon )
 		{
 			//Transfer the reload time from the rider to the bike
+			getObject()->markCRCDirty();
 			bikeWeapon->transferNextShotStatsFrom( *riderWeapon );
 		}
 	}
@@ -435,6 +436,7 @@ void TransportContain::onRemoving( Object *rider )
 		if( bikeWeapon && riderWeapon )
 		{
 			//Transfer the reload time from the bike to the rider
+			rider->markCRCDirty();
 			riderWeapon->transferNextShotStatsFrom( *bikeWeapon );
 		}
 	}
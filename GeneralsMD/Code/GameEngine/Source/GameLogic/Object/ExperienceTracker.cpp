@@ -97,6 +97,7 @@ void ExperienceTracker::setMinVeterancyLevel( VeterancyLevel newLevel )
 		VeterancyLevel oldLevel = m_currentLevel;
 		m_currentLevel = newLevel;
 		m_currentExperience = m_parent->getTemplate()->getExperienceRequired(m_currentLevel); //Minimum for this level
+		m_parent->markCRCDirty();
 		if (m_parent)
 			m_parent->onVeterancyLevelChanged( oldLevel, newLevel );
 	}
@@ -113,6 +114,7 @@ void ExperienceTracker::setVeterancyLevel( VeterancyLevel newLevel, Bool provide
 		VeterancyLevel oldLevel = m_currentLevel;
 		m_currentLevel = newLevel;
 		m_currentExperience = m_parent->getTemplate()->getExperienceRequired(m_currentLevel); //Minimum for this level
+		m_parent->markCRCDirty();
 		if (m_parent)
 			m_parent->onVeterancyLevelChanged( oldLevel, newLevel, provideFeedback );
 	}
@@ -170,6 +172,7 @@ void ExperienceTracker::addExperiencePoints( Int experienceGain, Bool canScaleFo
 
 
 	m_currentExperience += amountToGain;
+	m_parent->markCRCDirty();
 
 	Int levelIndex = 0;
 	while( ( (levelIndex + 1) < LEVEL_COUNT) 
@@ -210,6 +213,7 @@ void ExperienceTracker::setExperienceAndLevel( Int experienceIn, Bool provideFee
 	VeterancyLevel oldLevel = m_currentLevel;
 
 	m_currentExperience = experienceIn;
+	m_parent->markCRCDirty();
 
 	Int levelIndex = 0;
 	while( ( (levelIndex + 1) < LEVEL_COUNT) 
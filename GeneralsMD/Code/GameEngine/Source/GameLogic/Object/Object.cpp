@@ -30,6 +30,8 @@
 // INCLUDES /////////////////////////////////////////////////////////////////////////////////////// 
 #include "PreRTS.h"	// This must go first in EVERY cpp file int the GameEngine
 #define DEFINE_WEAPONCONDITIONMAP
+#include <chrono>
+
 #include "Common/BitFlagsIO.h"
 #include "Common/BuildAssistant.h"
 #include "Common/Dict.h"
@@ -58,7 +60,7 @@
 
 #include "GameLogic/AI.h"
 #include "GameLogic/AIPathfind.h"
-// #include "GameLogic/ExperienceTracker.h"
+#include "GameLogic/ExperienceTracker.h"
 #include "GameLogic/FiringTracker.h"
 #include "GameLogic/GameLogic.h"
 // #include "GameLogic/Locomotor.h"
@@ -121,6 +123,10 @@
 ObjectID TheObjectIDToDebug = INVALID_ID;
 #endif
 
+// Counted for ReplayBenchmark; see Object::reportModuleInterfaceLookups.
+static UnsignedInt64 s_indexedInterfaceLookups = 0;
+static UnsignedInt64 s_scannedInterfaceLookups = 0;
+
 // ------------------------------------------------------------------------------------------------
 static const ModelConditionFlags s_allWeaponFireFlags[WEAPONSLOT_COUNT] = 
 {
@@ -429,6 +435,8 @@ Object::Object( const ThingTemplate *tt, const ObjectStatusMaskType& /* objectSt
 
 	*curB = NULL;
 
+	computeModuleInterfaceLayout();
+
 	AIUpdateInterface *ai = getAIUpdateInterface();
 	if (ai) {
 		ai->setAttitude(getTeam()->getPrototype()->getTemplateInfo()->m_initialTeamAttitude);
@@ -627,6 +635,9 @@ Object::~Object()
 	m_ai = NULL;
 	m_physics = NULL;
 
+	// back to searching, since the modules are about to go away one by one
+	m_moduleInterfaceLayout = NULL;
+
 	// delete any modules present
 	for (BehaviorModule** b = m_behaviors; *b; ++b)
 	{
@@ -769,6 +780,8 @@ void Object::setGeometryInfoZ( Real newZ )
 { 
 	// A Z change only does not need to un/register with the PartitionManager
 	m_geometryInfo.setMaxHeightAbovePosition( newZ );
+	if (m_partitionData)
+		m_partitionData->friend_refreshPositionCache();	// but it can change our bounding sphere
 
 	if (m_drawable)
 		m_drawable->reactToGeometryChange();
@@ -781,6 +794,7 @@ void Object::friend_setUndetectedDefector( Bool status )
 		m_privateStatus |= UNDETECTED_DEFECTOR;
 	else
 		m_privateStatus &= ~UNDETECTED_DEFECTOR;
+	markCRCDirty();
 }
 
 //=============================================================================
@@ -847,6 +861,7 @@ void Object::setOrRestoreTeam( Team* team, Bool restoring )
 		if (m_team->isInList_TeamMemberList(this))
 		{
 			m_team->removeFrom_TeamMemberList(this);
+			m_team->removeMemberFromCensus(this);
 			m_team->getControllingPlayer()->becomingTeamMember(this, false);
 		}
 	}
@@ -860,6 +875,7 @@ void Object::setOrRestoreTeam( Team* team, Bool restoring )
 		if (!m_team->isInList_TeamMemberList(this))
 		{
 			m_team->prependTo_TeamMemberList(this);
+			m_team->addMemberToCensus(this);
 			m_team->getControllingPlayer()->becomingTeamMember(this, true);
 		}
 		
@@ -963,6 +979,7 @@ Bool Object::checkAndDetonateBoobyTrap(const Object *victim)
 //=============================================================================
 void Object::setStatus( ObjectStatusMaskType objectStatus, Bool set )
 {
+	markCRCDirty();
 DEBUG_CRASH(("Object::setStatus not yet implemented!"));
 (void) objectStatus;
 (void) set;
@@ -1023,6 +1040,10 @@ DEBUG_CRASH(("Object::setStatus not yet implemented!"));
 
 			if (m_partitionData)
 				m_partitionData->makeDirty(true);
+
+			// construction finished (or was undone), so our team counts us differently now
+			if (m_team)
+				m_team->updateMemberCensus(this);
 		}
 
 	}
@@ -1218,6 +1239,7 @@ Bool Object::testArmorSetFlag(ArmorSetType ast) const
 //=============================================================================
 void Object::reloadAllAmmo(Bool now)
 {
+	markCRCDirty();
 	m_weaponSet.reloadAllAmmo(this, now);
 }
 
@@ -1461,6 +1483,7 @@ CanAttackResult Object::getAbleToUseWeaponAgainstTarget( AbleToAttackType attack
 //=============================================================================
 Bool Object::chooseBestWeaponForTarget(const Object* target, WeaponChoiceCriteria criteria, CommandSourceType cmdSource )
 {
+	markCRCDirty();
 	return m_weaponSet.chooseBestWeaponForTarget(this, target, criteria, cmdSource );
 }
 
@@ -1542,6 +1565,7 @@ void Object::preFireCurrentWeapon( const Object *victim )
 	if (weapon && TheGameLogic->getFrame() + 1 >= weapon->getPossibleNextShotFrame() )
 	{
 		weapon->preFireWeapon( this, victim );
+		markCRCDirty();
 		friend_setUndetectedDefector( FALSE );// My secret is out
 	}
 }
@@ -1785,6 +1809,11 @@ void Object::reactToTransformChange(const Matrix3D* oldMtx, const Coord3D* oldPo
 (void) oldMtx;
 (void) oldPos;
 (void) oldAngle;
+	// keep the PartitionManager's packed copy of our position exact, even for
+	// moves too small to make the partition data dirty.
+	if (m_partitionData)
+		m_partitionData->friend_refreshPositionCache();
+	markCRCDirty();
 DEBUG_CRASH(("Object::reactToTransformChange not yet implemented!"));
 #if 0
 	//USE_PERF_TIMER(Object_reactToTransformChange)
@@ -2017,6 +2046,10 @@ void Object::setEffectivelyDead(Bool dead)
 		BitSet(m_privateStatus, EFFECTIVELY_DEAD);
 	else
 		BitClear(m_privateStatus, EFFECTIVELY_DEAD);
+	markCRCDirty();
+
+	if (m_team)
+		m_team->updateMemberCensus(this);
 
 	if (dead)
 	{
@@ -2613,10 +2646,20 @@ ExitInterface *Object::getObjectExitInterface() const
 {
 	ExitInterface *exitInterface = NULL;
 
-	for( BehaviorModule **umod = m_behaviors; *umod; ++umod )
+	if( m_moduleInterfaceLayout )
 	{
-		if( (exitInterface = (*umod)->getUpdateExitInterface()) != NULL )
-			break;
+		BehaviorModule *module = findModuleWithInterface( OBJECT_INTERFACE_UPDATE_EXIT );
+		if( module )
+			exitInterface = module->getUpdateExitInterface();
+	}
+	else
+	{
+		++s_scannedInterfaceLookups;
+		for( BehaviorModule **umod = m_behaviors; *umod; ++umod )
+		{
+			if( (exitInterface = (*umod)->getUpdateExitInterface()) != NULL )
+				break;
+		}
 	}
 
 	// If you don't have a fancy one, you may have one from your contain module,
@@ -2837,6 +2880,7 @@ void Object::setID( ObjectID id )
 
 	// assign new id
 	m_id = id;
+	markCRCDirty();
 
 	// add new id to lookup table
 	TheGameLogic->addObjectToLookupTable( this );
@@ -2893,6 +2937,7 @@ void Object::friend_notifyOfNewMapBoundary(void)
 		m_privateStatus &= ~OFF_MAP;
 	else
 		m_privateStatus |= OFF_MAP;
+	markCRCDirty();
 }
 
 
@@ -3124,6 +3169,7 @@ void Object::setWeaponSetFlag(WeaponSetType wst)
 { 
 	m_curWeaponSetFlags.set(wst); 
 	m_weaponSet.updateWeaponSet(this);
+	markCRCDirty();
 	// FIXME: Drawable
 	// if (m_drawable)
 	// {
@@ -3136,6 +3182,7 @@ void Object::clearWeaponSetFlag(WeaponSetType wst)
 { 
 	m_curWeaponSetFlags.set(wst, 0); 
 	m_weaponSet.updateWeaponSet(this);
+	markCRCDirty();
 	// FIXME: Drawable
 	// if (m_drawable)
 	// {
@@ -3289,21 +3336,16 @@ Bool Object::isAbleToAttack() const
 
     if ( isKindOf( KINDOF_INFANTRY ) ) // I must be a stinger soldier or similar
     {
-      for (BehaviorModule** update = getBehaviorModules(); *update; ++update)//expensive search, limited only to stinger soldiers
+      SlavedUpdateInterface* sdu = getSlavedUpdateInterface();// limited only to stinger soldiers
+      if ( sdu )
       {
-	      SlavedUpdateInterface* sdu = (*update)->getSlavedUpdateInterface();
-	      if ( sdu )
-	      {
-          ObjectID slaverID = sdu->getSlaverID();
-          if ( slaverID != INVALID_ID )
-          {
-            Object *slaver = TheGameLogic->findObjectByID( slaverID );
-            if ( slaver && slaver->isDisabledByType( DISABLED_SUBDUED ))
-              return FALSE;// if my stinger site is subdued, so am I
-          }
-
-          break;//only expect one slavedupdate, so stop searching
-	      }
+        ObjectID slaverID = sdu->getSlaverID();
+        if ( slaverID != INVALID_ID )
+        {
+          Object *slaver = TheGameLogic->findObjectByID( slaverID );
+          if ( slaver && slaver->isDisabledByType( DISABLED_SUBDUED ))
+            return FALSE;// if my stinger site is subdued, so am I
+        }
       }
     }
 
@@ -3972,9 +4014,8 @@ void Object::onDisabledEdge(Bool becomingDisabled)
 //-------------------------------------------------------------------------------------------------
 /** Object CRC implemtation */
 //-------------------------------------------------------------------------------------------------
-void Object::crc( Xfer* /*xfer*/ )
+void Object::crc( Xfer* xfer )
 {
-#if 0
 	// This is evil - we cast the const Matrix3D * to a Matrix3D * because the XferCRC class must use
 	// the same interface as the XferLoad class for save game restore.  This only works because
 	// XferCRC does not modify its data.
@@ -4056,7 +4097,8 @@ void Object::crc( Xfer* /*xfer*/ )
 	}
 #endif // DEBUG_CRC
 
-	Real health = getBodyModule()->getHealth();
+	// no modules get built yet in this port, so there may be no body to ask
+	Real health = getBodyModule() ? getBodyModule()->getHealth() : 0.0f;
 	xfer->xferUser(&health,														sizeof(health));
 #ifdef DEBUG_CRC
 	if (doLogging)
@@ -4075,7 +4117,7 @@ void Object::crc( Xfer* /*xfer*/ )
 	}
 #endif // DEBUG_CRC
 
-	Real scalar = getBodyModule()->getDamageScalar();
+	Real scalar = getBodyModule() ? getBodyModule()->getDamageScalar() : 1.0f;
 	xfer->xferUser(&scalar,														sizeof(scalar));
 #ifdef DEBUG_CRC
 	if (doLogging)
@@ -4096,7 +4138,6 @@ void Object::crc( Xfer* /*xfer*/ )
 		}
 	}
 	
-#endif // if 0
 }  // end crc
 
 //-------------------------------------------------------------------------------------------------
@@ -4523,11 +4564,33 @@ void Object::xfer( Xfer* /*xfer*/ )
 #endif // if 0
 }  // end xfer
 
+//-------------------------------------------------------------------------------------------------
+/** CRC this object into xferCRC.  While we're clean, the words crc() folded last time are folded
+	* again, which gives exactly the same result as running crc() without touching any modules. */
+//-------------------------------------------------------------------------------------------------
+void Object::friend_xferIncrementalCRC( XferCRC *xferCRC )
+{
+	if (!m_crcDirty)
+	{
+		xferCRC->addCRCWords( m_crcWords.data(), static_cast<UnsignedInt>(m_crcWords.size()) );
+		return;
+	}
+
+	m_crcWords.clear();
+	xferCRC->setCapture( &m_crcWords );
+	xferCRC->xferSnapshot( this );
+	xferCRC->setCapture( NULL );
+	m_crcDirty = FALSE;
+
+}  // end friend_xferIncrementalCRC
+
 //-------------------------------------------------------------------------------------------------
 /** Object load game post process phase */
 //-------------------------------------------------------------------------------------------------
 void Object::loadPostProcess()
 {
+	markCRCDirty();
+
 	if( m_xferContainedByID != INVALID_ID )
 		m_containedBy = TheGameLogic->findObjectByID(m_xferContainedByID);
 	else
@@ -4585,6 +4648,7 @@ void Object::giveUpgrade( const UpgradeTemplate *upgradeT )
 	if (upgradeT)
 	{
 		m_objectUpgradesCompleted.set( upgradeT->getUpgradeMask() );
+		markCRCDirty();
 
 		//
 		// iterate through all the upgrade modules of this object and call the method to
@@ -4774,6 +4838,7 @@ void Object::setWeaponBonusCondition(WeaponBonusConditionType wst)
 	{
 		// Our weapon bonus just changed, so we need to immediately update our weapons
 		m_weaponSet.weaponSetOnWeaponBonusChange(this);
+		markCRCDirty();
 	}
 }
 
@@ -4787,6 +4852,7 @@ void Object::clearWeaponBonusCondition(WeaponBonusConditionType wst)
 	{
 		// Our weapon bonus just changed, so we need to immediately update our weapons
 		m_weaponSet.weaponSetOnWeaponBonusChange(this);
+		markCRCDirty();
 	}
 }
 
@@ -5951,6 +6017,7 @@ void Object::doCommandButtonUsingWaypoints( const CommandButton *commandButton,
 // ------------------------------------------------------------------------------------------------
 void Object::clearLeechRangeModeForAllWeapons()
 {
+	markCRCDirty();
 	m_weaponSet.clearLeechRangeModeForAllWeapons();
 }
 
@@ -5961,7 +6028,14 @@ ProductionUpdateInterface* Object::getProductionUpdateInterface( void )
 {
 	ProductionUpdateInterface *pui;
 
+	if( m_moduleInterfaceLayout )
+	{
+		BehaviorModule *module = findModuleWithInterface( OBJECT_INTERFACE_PRODUCTION_UPDATE );
+		return module ? module->getProductionUpdateInterface() : NULL;
+	}
+
 	// tell our update modules that we intend to do this special power.
+	++s_scannedInterfaceLookups;
 	for( BehaviorModule** u = m_behaviors; *u; ++u )
 	{
 
@@ -5981,6 +6055,13 @@ DockUpdateInterface *Object::getDockUpdateInterface( void )
 {
 	DockUpdateInterface *dock = NULL;
 
+	if( m_moduleInterfaceLayout )
+	{
+		BehaviorModule *module = findModuleWithInterface( OBJECT_INTERFACE_DOCK_UPDATE );
+		return module ? module->getDockUpdateInterface() : NULL;
+	}
+
+	++s_scannedInterfaceLookups;
 	for( BehaviorModule **u = m_behaviors; *u; ++u )
 	{
 		if( (dock = (*u)->getDockUpdateInterface()) != NULL )
@@ -5996,6 +6077,23 @@ DockUpdateInterface *Object::getDockUpdateInterface( void )
 // ------------------------------------------------------------------------------------------------
 SpecialPowerModuleInterface* Object::findSpecialPowerModuleInterface( SpecialPowerType type ) const
 {
+	if (m_moduleInterfaceLayout)
+	{
+		++s_indexedInterfaceLookups;
+		const std::vector<Short>& slots = m_moduleInterfaceLayout->m_specialPowerSlots;
+		for (std::vector<Short>::const_iterator it = slots.begin(); it != slots.end(); ++it)
+		{
+			SpecialPowerModuleInterface* sp = m_behaviors[*it]->getSpecialPower();
+			const SpecialPowerTemplate *spTemplate = sp->getSpecialPowerTemplate();
+			if ((spTemplate && spTemplate->getSpecialPowerType() == type) || type == SPECIAL_INVALID )
+			{
+				return sp; 
+			}
+		}
+		return NULL;
+	}
+
+	++s_scannedInterfaceLookups;
 	for (BehaviorModule** m = m_behaviors; *m; ++m)
 	{
 		SpecialPowerModuleInterface* sp = (*m)->getSpecialPower();
@@ -6016,6 +6114,23 @@ SpecialPowerModuleInterface* Object::findSpecialPowerModuleInterface( SpecialPow
 // ------------------------------------------------------------------------------------------------
 SpecialPowerModuleInterface* Object::findAnyShortcutSpecialPowerModuleInterface() const
 {
+	if( m_moduleInterfaceLayout )
+	{
+		++s_indexedInterfaceLookups;
+		const std::vector<Short>& slots = m_moduleInterfaceLayout->m_specialPowerSlots;
+		for( std::vector<Short>::const_iterator it = slots.begin(); it != slots.end(); ++it )
+		{
+			SpecialPowerModuleInterface* sp = m_behaviors[*it]->getSpecialPower();
+			const SpecialPowerTemplate *spTemplate = sp->getSpecialPowerTemplate();
+			if( spTemplate && spTemplate->isShortcutPower() )
+			{
+				return sp; 
+			}
+		}
+		return NULL;
+	}
+
+	++s_scannedInterfaceLookups;
 	for( BehaviorModule** m = m_behaviors; *m; ++m )
 	{
 		SpecialPowerModuleInterface* sp = (*m)->getSpecialPower();
@@ -6036,6 +6151,13 @@ SpecialPowerModuleInterface* Object::findAnyShortcutSpecialPowerModuleInterface(
 // ------------------------------------------------------------------------------------------------
 SpawnBehaviorInterface* Object::getSpawnBehaviorInterface() const
 {
+	if (m_moduleInterfaceLayout)
+	{
+		BehaviorModule *module = findModuleWithInterface( OBJECT_INTERFACE_SPAWN_BEHAVIOR );
+		return module ? module->getSpawnBehaviorInterface() : NULL;
+	}
+
+	++s_scannedInterfaceLookups;
 	for (BehaviorModule** m = m_behaviors; *m; ++m)
 	{
 		SpawnBehaviorInterface *sbi = (*m)->getSpawnBehaviorInterface();
@@ -6050,6 +6172,13 @@ SpawnBehaviorInterface* Object::getSpawnBehaviorInterface() const
 // ------------------------------------------------------------------------------------------------
 ProjectileUpdateInterface* Object::getProjectileUpdateInterface() const
 {
+	if (m_moduleInterfaceLayout)
+	{
+		BehaviorModule *module = findModuleWithInterface( OBJECT_INTERFACE_PROJECTILE_UPDATE );
+		return module ? module->getProjectileUpdateInterface() : NULL;
+	}
+
+	++s_scannedInterfaceLookups;
 	for (BehaviorModule** m = m_behaviors; *m; ++m)
 	{
 		ProjectileUpdateInterface *pui = (*m)->getProjectileUpdateInterface();
@@ -6061,11 +6190,233 @@ ProjectileUpdateInterface* Object::getProjectileUpdateInterface() const
 	return NULL;
 }
 
+// ------------------------------------------------------------------------------------------------
+/** The SlavedUpdate of a spawned unit, which knows who its slaver is */
+// ------------------------------------------------------------------------------------------------
+SlavedUpdateInterface* Object::getSlavedUpdateInterface() const
+{
+	if (m_moduleInterfaceLayout)
+	{
+		BehaviorModule *module = findModuleWithInterface( OBJECT_INTERFACE_SLAVED_UPDATE );
+		return module ? module->getSlavedUpdateInterface() : NULL;
+	}
+
+	++s_scannedInterfaceLookups;
+	for (BehaviorModule** m = m_behaviors; *m; ++m)
+	{
+		SlavedUpdateInterface *sdu = (*m)->getSlavedUpdateInterface();
+		if( sdu )
+		{
+			return sdu;
+		}
+	}
+	return NULL;
+}
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+BehaviorModule* Object::findModuleWithInterface( ObjectInterfaceType type ) const
+{
+	++s_indexedInterfaceLookups;
+	Short slot = m_moduleInterfaceLayout->m_slot[ type ];
+	return slot != ModuleInterfaceLayout::NO_MODULE ? m_behaviors[ slot ] : NULL;
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Which of these modules have the interfaces we get asked for all the time */
+// ------------------------------------------------------------------------------------------------
+static void buildModuleInterfaceLayout( BehaviorModule** modules, ModuleInterfaceLayout& layout )
+{
+	layout.m_moduleNames.clear();
+	layout.m_specialPowerSlots.clear();
+	layout.m_specialPowerUpdateSlots.clear();
+	for (Int i = 0; i < OBJECT_INTERFACE_COUNT; ++i)
+		layout.m_slot[ i ] = ModuleInterfaceLayout::NO_MODULE;
+
+	for (Short slot = 0; modules[ slot ]; ++slot)
+	{
+		BehaviorModule *module = modules[ slot ];
+		layout.m_moduleNames.push_back(module->getModuleNameKey());
+
+		Bool has[ OBJECT_INTERFACE_COUNT ];
+		has[ OBJECT_INTERFACE_PRODUCTION_UPDATE ] = module->getProductionUpdateInterface() != NULL;
+		has[ OBJECT_INTERFACE_DOCK_UPDATE ] = module->getDockUpdateInterface() != NULL;
+		has[ OBJECT_INTERFACE_UPDATE_EXIT ] = module->getUpdateExitInterface() != NULL;
+		has[ OBJECT_INTERFACE_SPAWN_BEHAVIOR ] = module->getSpawnBehaviorInterface() != NULL;
+		has[ OBJECT_INTERFACE_PROJECTILE_UPDATE ] = module->getProjectileUpdateInterface() != NULL;
+		has[ OBJECT_INTERFACE_SLAVED_UPDATE ] = module->getSlavedUpdateInterface() != NULL;
+		for (Int i = 0; i < OBJECT_INTERFACE_COUNT; ++i)
+		{
+			if (has[ i ] && layout.m_slot[ i ] == ModuleInterfaceLayout::NO_MODULE)
+				layout.m_slot[ i ] = slot;
+		}
+
+		if (module->getSpecialPower())
+			layout.m_specialPowerSlots.push_back(slot);
+		if (module->getSpecialPowerUpdateInterface())
+			layout.m_specialPowerUpdateSlots.push_back(slot);
+	}
+	layout.m_computed = TRUE;
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Once m_behaviors is built, find which of our modules have the interfaces we get asked for
+	* all the time.  The first Object of a template works this out for all of them. */
+// ------------------------------------------------------------------------------------------------
+void Object::computeModuleInterfaceLayout( void )
+{
+	const ThingTemplate *tmpl = getTemplate();
+	if (!tmpl->getModuleInterfaceLayout().m_computed)
+	{
+		ModuleInterfaceLayout layout;
+		buildModuleInterfaceLayout(m_behaviors, layout);
+		tmpl->friend_setModuleInterfaceLayout(layout);
+	}
+
+	std::vector<NameKeyType> moduleNames;
+	for (BehaviorModule** m = m_behaviors; *m; ++m)
+		moduleNames.push_back((*m)->getModuleNameKey());
+
+	// The helper modules depend on a little more than the template; if they came out differently
+	// for this Object, even in the same number of slots, it just searches.
+	const ModuleInterfaceLayout& layout = tmpl->getModuleInterfaceLayout();
+	if (layout.m_moduleNames == moduleNames)
+	{
+		m_moduleInterfaceLayout = &layout;
+	}
+	else
+	{
+		DEBUG_LOG(("Object %s's modules don't match its template's layout, so it will search them\n", tmpl->getName().str()));
+		m_moduleInterfaceLayout = NULL;
+	}
+}
+
+// ------------------------------------------------------------------------------------------------
+static Int64 moduleInterfaceLookupNanos()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ------------------------------------------------------------------------------------------------
+/** Asks for every indexed interface LOOKUP_PASSES times, and gives back the sum of the answers'
+	* addresses so the two ways of looking can be compared and neither can be optimized away. */
+// ------------------------------------------------------------------------------------------------
+UnsignedInt64 Object::timeModuleInterfaceLookups( Int64& nanos )
+{
+	enum { LOOKUP_PASSES = 16 };
+
+	UnsignedInt64 sum = 0;
+	Int64 start = moduleInterfaceLookupNanos();
+	for (Int pass = 0; pass < LOOKUP_PASSES; ++pass)
+	{
+		sum += (UnsignedInt64)(uintptr_t)getProductionUpdateInterface();
+		sum += (UnsignedInt64)(uintptr_t)getDockUpdateInterface();
+		sum += (UnsignedInt64)(uintptr_t)getSpawnBehaviorInterface();
+		sum += (UnsignedInt64)(uintptr_t)getProjectileUpdateInterface();
+		sum += (UnsignedInt64)(uintptr_t)getSlavedUpdateInterface();
+	}
+	nanos += moduleInterfaceLookupNanos() - start;
+	return sum;
+}
+
+// ------------------------------------------------------------------------------------------------
+/** The counts, then every live Object's lookups timed both ways: through a layout built from its
+	* own modules, and by searching them.  The two take turns going first. */
+// ------------------------------------------------------------------------------------------------
+AsciiString Object::reportModuleInterfaceLookups( Int frames )
+{
+	UnsignedInt64 total = s_indexedInterfaceLookups + s_scannedInterfaceLookups;
+	AsciiString report;
+	report.format("  module interface lookups: %llu (%.1f/frame), %llu from the template layout, %llu by searching\n",
+		(unsigned long long)total, frames > 0 ? (double)total / frames : 0.0,
+		(unsigned long long)s_indexedInterfaceLookups, (unsigned long long)s_scannedInterfaceLookups);
+
+	UnsignedInt64 indexedBefore = s_indexedInterfaceLookups;
+	UnsignedInt64 scannedBefore = s_scannedInterfaceLookups;
+
+	Int objects = 0;
+	Int differed = 0;
+	Int64 indexedNanos = 0;
+	Int64 scannedNanos = 0;
+	ModuleInterfaceLayout layout;
+	for (Object *obj = TheGameLogic ? TheGameLogic->getFirstObject() : NULL; obj; obj = obj->getNextObject())
+	{
+		if (obj->m_behaviors == NULL || *obj->m_behaviors == NULL)
+			continue;
+
+		buildModuleInterfaceLayout(obj->m_behaviors, layout);
+		const ModuleInterfaceLayout *ownLayout = obj->m_moduleInterfaceLayout;
+
+		UnsignedInt64 indexedSum, scannedSum;
+		if (objects & 1)
+		{
+			obj->m_moduleInterfaceLayout = NULL;
+			scannedSum = obj->timeModuleInterfaceLookups(scannedNanos);
+			obj->m_moduleInterfaceLayout = &layout;
+			indexedSum = obj->timeModuleInterfaceLookups(indexedNanos);
+		}
+		else
+		{
+			obj->m_moduleInterfaceLayout = &layout;
+			indexedSum = obj->timeModuleInterfaceLookups(indexedNanos);
+			obj->m_moduleInterfaceLayout = NULL;
+			scannedSum = obj->timeModuleInterfaceLookups(scannedNanos);
+		}
+		obj->m_moduleInterfaceLayout = ownLayout;
+
+		++objects;
+		if (indexedSum != scannedSum)
+			++differed;
+	}
+
+	s_indexedInterfaceLookups = indexedBefore;
+	s_scannedInterfaceLookups = scannedBefore;
+
+	AsciiString line;
+	if (objects > 0)
+	{
+		// five interfaces, sixteen passes each, per Object
+		double lookups = objects * 5.0 * 16.0;
+		line.format("  module interface lookup timing: %d objects, template layout %.1f ns, searching %.1f ns per lookup, %d differed\n",
+			objects, indexedNanos / lookups, scannedNanos / lookups, differed);
+	}
+	else
+	{
+		line.format("  module interface lookup timing: no live Object has any modules to look through\n");
+	}
+	report.concat(line);
+	return report;
+}
+
+// ------------------------------------------------------------------------------------------------
+// ------------------------------------------------------------------------------------------------
+void Object::resetModuleInterfaceLookups( void )
+{
+	s_indexedInterfaceLookups = 0;
+	s_scannedInterfaceLookups = 0;
+}
+
 // ------------------------------------------------------------------------------------------------
 // Simply find the special power module that is currently allowing plotting of positions to target.
 // ------------------------------------------------------------------------------------------------
 SpecialPowerUpdateInterface* Object::findSpecialPowerWithOverridableDestinationActive( SpecialPowerType /* type */ ) const
 {
+	if( m_moduleInterfaceLayout )
+	{
+		++s_indexedInterfaceLookups;
+		const std::vector<Short>& slots = m_moduleInterfaceLayout->m_specialPowerUpdateSlots;
+		for( std::vector<Short>::const_iterator it = slots.begin(); it != slots.end(); ++it )
+		{
+			SpecialPowerUpdateInterface *spInterface = m_behaviors[*it]->getSpecialPowerUpdateInterface();
+			if( spInterface->doesSpecialPowerHaveOverridableDestinationActive() )
+			{
+				return spInterface;
+			}
+		}
+		return NULL;
+	}
+
+	++s_scannedInterfaceLookups;
 	for( BehaviorModule** u = m_behaviors; *u; ++u )
 	{
 		SpecialPowerUpdateInterface *spInterface = (*u)->getSpecialPowerUpdateInterface();
@@ -1051,14 +1051,10 @@ DEBUG_CRASH(("GenericObjectCreationNugget: doStuffToObj not yet implemented!"));
 			body->setInitialHealth(healthPercent * 100.0f);
 
 		// If they have a SlavedUpdate, then I have to tell them who their daddy is from now on.
-		for (BehaviorModule** update = obj->getBehaviorModules(); *update; ++update)
+		SlavedUpdateInterface* sdu = obj->getSlavedUpdateInterface();
+		if (sdu != NULL)
 		{
-			SlavedUpdateInterface* sdu = (*update)->getSlavedUpdateInterface();
-			if (sdu != NULL)
-			{
-				sdu->onEnslave( sourceObj );
-				break;
-			}
+			sdu->onEnslave( sourceObj );
 		}
 
 		if (m_ini.m_inheritsVeterancy && sourceObj && obj->getExperienceTracker()->isTrainable())
@@ -88,6 +88,12 @@
 #include "Common/MapObject.h"
 #endif
 
+#include <chrono>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #ifdef DUMP_PERF_STATS
 	long s_countInClosestObjects = 0;
 	long s_countInClosestObjectsThisFrame = 0;
@@ -949,6 +955,9 @@ static Bool distCalcProc_BoundaryAndBoundary_3D(
 //         Private Data                                                     
 //-----------------------------------------------------------------------------
 
+// how many candidates at a time getClosestObjects & co. hand to the PartitionPositionCache
+static const Int POSITION_CACHE_BATCH = 32;
+
 static DistCalcProc theDistCalcProcs[] = 
 { 
 	distCalcProc_CenterAndCenter_2D, 
@@ -1556,6 +1565,254 @@ void PartitionCell::loadPostProcess( void )
 //-----------------------------------------------------------------------------
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+PartitionPositionCache::PartitionPositionCache()
+{
+}
+
+//-----------------------------------------------------------------------------
+Int PartitionPositionCache::allocSlot()
+{
+	Int slot;
+	if (m_freeSlots.empty())
+	{
+		slot = static_cast<Int>(m_x.size());
+		m_x.push_back(0.0f);
+		m_y.push_back(0.0f);
+		m_radius.push_back(HUGE_DIST);
+	}
+	else
+	{
+		slot = m_freeSlots.back();
+		m_freeSlots.pop_back();
+		setSlot(slot, 0.0f, 0.0f, HUGE_DIST);
+	}
+	return slot;
+}
+
+//-----------------------------------------------------------------------------
+void PartitionPositionCache::freeSlot(Int slot)
+{
+	DEBUG_ASSERTCRASH(slot >= 0 && slot < static_cast<Int>(m_x.size()), ("bad position slot %d", slot));
+	m_freeSlots.push_back(slot);
+}
+
+//-----------------------------------------------------------------------------
+void PartitionPositionCache::setSlot(Int slot, Real x, Real y, Real radius)
+{
+	m_x[(size_t)slot] = x;
+	m_y[(size_t)slot] = y;
+	m_radius[(size_t)slot] = radius;
+}
+
+//-----------------------------------------------------------------------------
+/**
+	The limit is padded generously, since the real distance calculations
+	subtract radii and take square roots, and we must never reject anything
+	that they would let through.
+*/
+void PartitionPositionCache::findMaybeInRange(const Int *slots, Int count, Real x, Real y, Real reach, Bool useRadius, UnsignedByte *maybe) const
+{
+	const Real SLACK_SCALE = 1.01f;
+	const Real SLACK_ADD = 1.0f;
+
+	Int i = 0;
+
+#if defined(__SSE2__)
+	const __m128 qx = _mm_set1_ps(x);
+	const __m128 qy = _mm_set1_ps(y);
+	const __m128 qReach = _mm_set1_ps(reach);
+	const __m128 hugeRadius = _mm_set1_ps(HUGE_DIST);
+	const __m128 slackScale = _mm_set1_ps(SLACK_SCALE);
+	const __m128 slackAdd = _mm_set1_ps(SLACK_ADD);
+	const __m128 allRadii = _mm_castsi128_ps(_mm_set1_epi32(useRadius ? -1 : 0));
+
+	for (; i + 4 <= count; i += 4)
+	{
+		// a PartitionData without a slot can't be looked up, so leave the rest of the batch to the loop below
+		if ((slots[i] | slots[i + 1] | slots[i + 2] | slots[i + 3]) < 0)
+			break;
+
+		const size_t s0 = (size_t)slots[i], s1 = (size_t)slots[i + 1], s2 = (size_t)slots[i + 2], s3 = (size_t)slots[i + 3];
+		__m128 dx = _mm_sub_ps(_mm_setr_ps(m_x[s0], m_x[s1], m_x[s2], m_x[s3]), qx);
+		__m128 dy = _mm_sub_ps(_mm_setr_ps(m_y[s0], m_y[s1], m_y[s2], m_y[s3]), qy);
+		__m128 radius = _mm_setr_ps(m_radius[s0], m_radius[s1], m_radius[s2], m_radius[s3]);
+
+		// a slot that hasn't been refreshed yet has a huge radius, which we always honor.
+		radius = _mm_and_ps(radius, _mm_or_ps(allRadii, _mm_cmpge_ps(radius, hugeRadius)));
+
+		__m128 limit = _mm_add_ps(_mm_mul_ps(_mm_add_ps(qReach, radius), slackScale), slackAdd);
+		__m128 distSqr = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+		Int inRange = _mm_movemask_ps(_mm_cmple_ps(distSqr, _mm_mul_ps(limit, limit)));
+
+		maybe[i] = (UnsignedByte)(inRange & 1);
+		maybe[i + 1] = (UnsignedByte)((inRange >> 1) & 1);
+		maybe[i + 2] = (UnsignedByte)((inRange >> 2) & 1);
+		maybe[i + 3] = (UnsignedByte)((inRange >> 3) & 1);
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		if (slots[i] < 0)
+		{
+			maybe[i] = 1;
+			continue;
+		}
+
+		const size_t slot = (size_t)slots[i];
+		Real dx = m_x[slot] - x;
+		Real dy = m_y[slot] - y;
+		Real radius = m_radius[slot];
+		if (!useRadius && radius < HUGE_DIST)
+			radius = 0.0f;
+
+		Real limit = (reach + radius) * SLACK_SCALE + SLACK_ADD;
+		maybe[i] = (dx * dx + dy * dy <= limit * limit) ? 1 : 0;
+	}
+}
+
+//-----------------------------------------------------------------------------
+static inline UnsignedInt hashPartitionData(const PartitionData *data)
+{
+	// PartitionDatas are pool-allocated, so the low bits are all alike; fold in the high ones.
+	unsigned long long bits = reinterpret_cast<uintptr_t>(data);
+	return static_cast<UnsignedInt>(((bits >> 4) * 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+//-----------------------------------------------------------------------------
+static inline Bool isQueryHitBefore(IterOrderType order, const PartitionQueryHit& a, const PartitionQueryHit& b)
+{
+	switch (order)
+	{
+		case ITER_SORTED_NEAR_TO_FAR:
+			return a.m_distSqr < b.m_distSqr;
+		case ITER_SORTED_FAR_TO_NEAR:
+			return a.m_distSqr > b.m_distSqr;
+		case ITER_SORTED_CHEAP_TO_EXPENSIVE:
+			return a.m_object->getTemplate()->friend_getBuildCost() < b.m_object->getTemplate()->friend_getBuildCost();
+		case ITER_SORTED_EXPENSIVE_TO_CHEAP:
+			return a.m_object->getTemplate()->friend_getBuildCost() > b.m_object->getTemplate()->friend_getBuildCost();
+		default:
+			return false;
+	}
+}
+
+//-----------------------------------------------------------------------------
+PartitionQueryScratch::PartitionQueryScratch()
+{
+}
+
+//-----------------------------------------------------------------------------
+void PartitionQueryScratch::begin()
+{
+	m_hits.clear();
+	m_seenCount = 0;
+
+	if (m_seen.empty())
+	{
+		const SeenSlot empty = { NULL, 0 };
+		m_seen.assign(64, empty);
+	}
+
+	// bumping the stamp empties the seen set without touching it... unless the
+	// stamp wraps, in which case stale slots could look current again.
+	if (++m_stamp == 0)
+	{
+		for (size_t i = 0; i < m_seen.size(); ++i)
+			m_seen[i].m_stamp = 0;
+		m_stamp = 1;
+	}
+}
+
+//-----------------------------------------------------------------------------
+Bool PartitionQueryScratch::markSeen(const PartitionData *data)
+{
+	if ((m_seenCount + 1) * 2 > m_seen.size())
+		growSeen();
+
+	const size_t mask = m_seen.size() - 1;
+	for (size_t i = hashPartitionData(data) & mask; ; i = (i + 1) & mask)
+	{
+		SeenSlot& slot = m_seen[i];
+		if (slot.m_stamp != m_stamp)
+		{
+			slot.m_data = data;
+			slot.m_stamp = m_stamp;
+			++m_seenCount;
+			return true;
+		}
+		if (slot.m_data == data)
+			return false;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void PartitionQueryScratch::growSeen()
+{
+	std::vector<SeenSlot> old;
+	old.swap(m_seen);
+
+	const SeenSlot empty = { NULL, 0 };
+	m_seen.assign(old.size() * 2, empty);
+	m_seenCount = 0;
+
+	for (std::vector<SeenSlot>::const_iterator it = old.begin(); it != old.end(); ++it)
+	{
+		if (it->m_stamp == m_stamp)
+			markSeen(it->m_data);
+	}
+}
+
+//-----------------------------------------------------------------------------
+/**
+	A bottom-up merge sort, stable like SimpleObjectIterator::sort (so ties come out
+	in the same order), but with m_sortTemp as its buffer, where std::stable_sort
+	would allocate one of its own.
+*/
+void PartitionQueryScratch::sort(IterOrderType order)
+{
+	const size_t count = m_hits.size();
+	if (order == ITER_FASTEST || count < 2)
+		return;
+
+	m_sortTemp.resize(count);
+
+	PartitionQueryHit *src = m_hits.data();
+	PartitionQueryHit *dst = m_sortTemp.data();
+	for (size_t width = 1; width < count; width *= 2)
+	{
+		for (size_t lo = 0; lo < count; lo += width * 2)
+		{
+			const size_t mid = std::min(lo + width, count);
+			const size_t hi = std::min(lo + width * 2, count);
+			size_t a = lo, b = mid, out = lo;
+			while (a < mid && b < hi)
+				dst[out++] = isQueryHitBefore(order, src[b], src[a]) ? src[b++] : src[a++];
+			while (a < mid)
+				dst[out++] = src[a++];
+			while (b < hi)
+				dst[out++] = src[b++];
+		}
+		std::swap(src, dst);
+	}
+
+	if (src != m_hits.data())
+		std::copy(src, src + count, m_hits.data());
+}
+
+//-----------------------------------------------------------------------------
+PartitionQueryScratchHolder::PartitionQueryScratchHolder() :
+	m_scratch(ThePartitionManager->allocQueryScratch())
+{
+}
+
+//-----------------------------------------------------------------------------
+PartitionQueryScratchHolder::~PartitionQueryScratchHolder()
+{
+	ThePartitionManager->releaseQueryScratch(m_scratch);
+}
+
 //-----------------------------------------------------------------------------
 PartitionData::PartitionData()
 {
@@ -1570,6 +1827,7 @@ PartitionData::PartitionData()
 	m_coiArray = NULL;
 	m_coiInUseCount = 0;
 	m_doneFlag = 0;
+	m_positionSlot = ThePartitionManager ? ThePartitionManager->friend_getPositionCache().allocSlot() : -1;
 	m_dirtyStatus = NOT_DIRTY;
 	m_lastCell = NULL;
 	for (int i = 0; i < MAX_PLAYER_COUNT; ++i)
@@ -1593,8 +1851,23 @@ PartitionData::~PartitionData()
 		ThePartitionManager->removeFromDirtyModules(this);
 		//DEBUG_ASSERTCRASH(!ThePartitionManager->isInListDirtyModules(this), ("hmm\n"));
 	}
+	if (ThePartitionManager && m_positionSlot >= 0)
+		ThePartitionManager->friend_getPositionCache().freeSlot(m_positionSlot);
 } 
 
+//-----------------------------------------------------------------------------
+void PartitionData::friend_refreshPositionCache()
+{
+	const Object *obj = getObject();
+	if (obj == NULL || m_positionSlot < 0 || ThePartitionManager == NULL)
+		return;
+
+	const Coord3D *pos = obj->getPosition();
+	const GeometryInfo& geom = obj->getGeometryInfo();
+	Real radius = maxReal(geom.getBoundingCircleRadius(), geom.getBoundingSphereRadius());
+	ThePartitionManager->friend_getPositionCache().setSlot(m_positionSlot, pos->x, pos->y, radius);
+}
+
 //-----------------------------------------------------------------------------
 Int PartitionData::getControllingPlayerIndex() const
 {
@@ -2074,6 +2347,8 @@ void PartitionData::updateCellsTouched()
 		minorRadius = m_ghostObject->getGeometryMinorRadius();
 	}
 
+	friend_refreshPositionCache();
+
 	removeAllTouchedCells();
 	if (isSmall)
 	{
@@ -2783,6 +3058,12 @@ PartitionManager::~PartitionManager()
 
 	shutdown();
 
+	DEBUG_ASSERTCRASH(m_freeQueryScratch.size() == m_allQueryScratch.size(), ("query scratch still borrowed"));
+	for (std::vector<PartitionQueryScratch *>::iterator it = m_allQueryScratch.begin(); it != m_allQueryScratch.end(); ++it)
+		delete *it;
+	m_allQueryScratch.clear();
+	m_freeQueryScratch.clear();
+
 }  // end ~PartitionManager
 
 //-----------------------------------------------------------------------------
@@ -3420,6 +3701,21 @@ void PartitionManager::calcRadiusVec()
 }
 #endif
 
+//-----------------------------------------------------------------------------
+/**
+	How far from the query point the position cache must look for a query of the
+	given kind, and whether it must allow for each candidate's own radius.
+*/
+static Real calcPositionCacheReach(const Object *objToUse, Real maxDist, DistanceCalculationType dc, Bool& useRadius)
+{
+	useRadius = (dc == FROM_BOUNDINGSPHERE_2D || dc == FROM_BOUNDINGSPHERE_3D);
+
+	Real reach = maxDist;
+	if (useRadius && objToUse)
+		reach += maxReal(objToUse->getGeometryInfo().getBoundingCircleRadius(), objToUse->getGeometryInfo().getBoundingSphereRadius());
+	return reach;
+}
+
 //-----------------------------------------------------------------------------
 //DECLARE_PERF_TIMER(getClosestObjects)
 Object *PartitionManager::getClosestObjects(
@@ -3502,6 +3798,10 @@ Object *PartitionManager::getClosestObjects(
 	static Int theIterFlag = 1;	// nonzero, thanks
 	++theIterFlag;
 
+	Bool positionCacheUseRadius;
+	Real positionCacheReach = calcPositionCacheReach(objToUse, maxDist, dc, positionCacheUseRadius);
+	Bool usePositionCache = maxDist < HUGE_DIST;
+
 	/*
 		m_radiusVec[curRadius] contains a list of the cells (foo) that could
 		contain objects that are <= (curRadius * cellSize) distance away from cell (0,0).
@@ -3517,53 +3817,79 @@ Object *PartitionManager::getClosestObjects(
 			if (thisCell == NULL)
 				continue;
 
-			for (CellAndObjectIntersection *thisCoi = thisCell->getFirstCoiInCell(); thisCoi; thisCoi = thisCoi->getNextCoi())
+			CellAndObjectIntersection *thisCoi = thisCell->getFirstCoiInCell();
+			while (thisCoi)
 			{
-				PartitionData *thisMod = thisCoi->getModule();
-				Object *thisObj = thisMod->getObject();
+				PartitionData *batch[POSITION_CACHE_BATCH];
+				Int batchSlots[POSITION_CACHE_BATCH];
+				UnsignedByte batchMaybe[POSITION_CACHE_BATCH];
+				Int batchCount = 0;
+				for (; thisCoi && batchCount < POSITION_CACHE_BATCH; thisCoi = thisCoi->getNextCoi())
+				{
+					PartitionData *thisMod = thisCoi->getModule();
+					Object *thisObj = thisMod->getObject();
+
+					// never compare against ourself.
+					if (thisObj == obj || thisObj == NULL) 
+						continue;
+
+					// since an object can exist in multiple COIs, we use this to avoid processing
+					// the same one more than once.
+					if (thisMod->friend_getDoneFlag() == theIterFlag)
+						continue;
+					thisMod->friend_setDoneFlag(theIterFlag);
+
+					batch[batchCount] = thisMod;
+					batchSlots[batchCount] = thisMod->friend_getPositionSlot();
+					++batchCount;
+				}
 
-				// never compare against ourself.
-				if (thisObj == obj || thisObj == NULL) 
-					continue;
+				// throw out the ones that are certainly too far away before we go poking at their Objects.
+				if (usePositionCache)
+					m_positionCache.findMaybeInRange(batchSlots, batchCount, objPos->x, objPos->y, positionCacheReach, positionCacheUseRadius, batchMaybe);
+				else
+					memset(batchMaybe, 1, (size_t)batchCount);
 
-				// since an object can exist in multiple COIs, we use this to avoid processing
-				// the same one more than once.
-				if (thisMod->friend_getDoneFlag() == theIterFlag)
-					continue;
-				thisMod->friend_setDoneFlag(theIterFlag);
+				for (Int batchIndex = 0; batchIndex < batchCount; ++batchIndex)
+				{
+					if (!batchMaybe[batchIndex])
+						continue;
+
+					Object *thisObj = batch[batchIndex]->getObject();
 			
-				Real thisDistSqr;
-				Coord3D distVec;
-				if (!(*distProc)(objPos, objToUse, thisObj->getPosition(), thisObj, thisDistSqr, distVec, closestDistSqr))
-					continue;
+					Real thisDistSqr;
+					Coord3D distVec;
+					if (!(*distProc)(objPos, objToUse, thisObj->getPosition(), thisObj, thisDistSqr, distVec, closestDistSqr))
+						continue;
 
-				if (!filtersAllow(filters, thisObj))
-					continue;
+					if (!filtersAllow(filters, thisObj))
+						continue;
 
-				// ok, this is within the range, and the filters allow it.
-				// add it to the iter, if we have one....
-				if (iterArg)
-				{
-					iterArg->insert(thisObj, thisDistSqr);
-				}
-				else
-				{
-					// hey, this is the new closest object! cool.
-					// (note that we can't break out now 'cuz we have to finish examining the
-					// rest of curRadius)
-					closestObj = thisObj;
-					closestDistSqr = thisDistSqr;
-					closestVec = distVec;
-
-					if (!foundAny)
+					// ok, this is within the range, and the filters allow it.
+					// add it to the iter, if we have one....
+					if (iterArg)
 					{
-						// if not adding to iterArg, we want to stop once we have the closest object. 
-						maxRadiusLimit = curRadius;
+						iterArg->insert(thisObj, thisDistSqr);
+					}
+					else
+					{
+						// hey, this is the new closest object! cool.
+						// (note that we can't break out now 'cuz we have to finish examining the
+						// rest of curRadius)
+						closestObj = thisObj;
+						closestDistSqr = thisDistSqr;
+						closestVec = distVec;
+
+						if (!foundAny)
+						{
+							// if not adding to iterArg, we want to stop once we have the closest object. 
+							maxRadiusLimit = curRadius;
+						}
+						foundAny = true;
 					}
-					foundAny = true;
-				}
 
-			} // next coi
+				}
+			}
 		}	// next cell in this radius
   } // next radius
 
@@ -3854,6 +4180,325 @@ SimpleObjectIterator *PartitionManager::iterateObjectsInRange(
 	return iter;
 }
 
+//-----------------------------------------------------------------------------
+PartitionQueryResult PartitionManager::queryObjectsInRange(
+	PartitionQueryScratch& scratch,
+	const Object *obj, 
+	Real maxDist, 
+	DistanceCalculationType dc, 
+	PartitionFilter **filters, 
+	IterOrderType order
+)
+{
+	if (TheGlobalData->m_data.m_partitionQueryBenchmark)
+		benchmarkQueryObjects(scratch, obj, NULL, maxDist, dc, filters, order);
+	else
+		queryObjects(scratch, obj, NULL, maxDist, dc, filters, order);
+	return scratch.getResult();
+}
+
+//-----------------------------------------------------------------------------
+PartitionQueryResult PartitionManager::queryObjectsInRange(
+	PartitionQueryScratch& scratch,
+	const Coord3D *pos, 
+	Real maxDist, 
+	DistanceCalculationType dc, 
+	PartitionFilter **filters, 
+	IterOrderType order
+)
+{
+	if (TheGlobalData->m_data.m_partitionQueryBenchmark)
+		benchmarkQueryObjects(scratch, NULL, pos, maxDist, dc, filters, order);
+	else
+		queryObjects(scratch, NULL, pos, maxDist, dc, filters, order);
+	return scratch.getResult();
+}
+
+//-----------------------------------------------------------------------------
+/**
+	This walks the cells exactly the way getClosestObjects does when it is given an
+	iterator, so the same objects come out in the same order; the difference is that
+	the "already seen this one" bookkeeping lives in the scratch rather than in the
+	PartitionDatas themselves.
+*/
+void PartitionManager::queryObjects(
+	PartitionQueryScratch& scratch,
+	const Object *obj, 
+	const Coord3D *pos, 
+	Real maxDist, 
+	DistanceCalculationType dc, 
+	PartitionFilter **filters, 
+	IterOrderType order
+)
+{
+	DEBUG_ASSERTCRASH((obj==NULL) != (pos == NULL), ("either obj or pos must be null"));
+
+	scratch.begin();
+
+	DistCalcProc distProc = theDistCalcProcs[dc];
+
+	const Coord3D *objPos = pos ? pos : obj->getPosition();
+	const Object *objToUse = pos ? NULL : obj;
+
+	Int cellCenterX, cellCenterY;
+	worldToCell(objPos->x, objPos->y, &cellCenterX, &cellCenterY);
+
+	Real maxDistSqr = maxDist * maxDist;
+
+#ifdef FASTER_GCO
+
+	Int maxRadius = m_maxGcoRadius;
+	if (maxDist < HUGE_DIST)
+	{
+		// don't go outwards any farther than necessary.
+		maxRadius = minInt(m_maxGcoRadius, worldToCellDist(maxDist));
+	}
+
+	Bool positionCacheUseRadius;
+	Real positionCacheReach = calcPositionCacheReach(objToUse, maxDist, dc, positionCacheUseRadius);
+	Bool usePositionCache = maxDist < HUGE_DIST;
+
+	for (Int curRadius = 0; curRadius <= maxRadius; ++curRadius)
+	{
+		const OffsetVec& offsets = m_radiusVec.data()[curRadius];
+		for (OffsetVec::const_iterator it = offsets.begin(); it != offsets.end(); ++it)
+		{
+			PartitionCell* thisCell = getCellAt(cellCenterX + it->x, cellCenterY + it->y);
+			if (thisCell == NULL)
+				continue;
+
+			CellAndObjectIntersection *thisCoi = thisCell->getFirstCoiInCell();
+			while (thisCoi)
+			{
+				PartitionData *batch[POSITION_CACHE_BATCH];
+				Int batchSlots[POSITION_CACHE_BATCH];
+				UnsignedByte batchMaybe[POSITION_CACHE_BATCH];
+				Int batchCount = 0;
+				for (; thisCoi && batchCount < POSITION_CACHE_BATCH; thisCoi = thisCoi->getNextCoi())
+				{
+					PartitionData *thisMod = thisCoi->getModule();
+					Object *thisObj = thisMod->getObject();
+
+					// never compare against ourself.
+					if (thisObj == obj || thisObj == NULL) 
+						continue;
+
+					// an object can exist in multiple COIs.
+					if (!scratch.markSeen(thisMod))
+						continue;
+
+					batch[batchCount] = thisMod;
+					batchSlots[batchCount] = thisMod->friend_getPositionSlot();
+					++batchCount;
+				}
+
+				if (usePositionCache)
+					m_positionCache.findMaybeInRange(batchSlots, batchCount, objPos->x, objPos->y, positionCacheReach, positionCacheUseRadius, batchMaybe);
+				else
+					memset(batchMaybe, 1, (size_t)batchCount);
+
+				for (Int batchIndex = 0; batchIndex < batchCount; ++batchIndex)
+				{
+					if (!batchMaybe[batchIndex])
+						continue;
+
+					Object *thisObj = batch[batchIndex]->getObject();
+
+					Real thisDistSqr;
+					Coord3D distVec;
+					if (!(*distProc)(objPos, objToUse, thisObj->getPosition(), thisObj, thisDistSqr, distVec, maxDistSqr))
+						continue;
+
+					if (!filtersAllow(filters, thisObj))
+						continue;
+
+					PartitionQueryHit hit = { thisObj, thisDistSqr };
+					scratch.m_hits.push_back(hit);
+				}
+			}
+		}
+	}
+
+#else // not FASTER_GCO
+
+	CellOutwardIterator iter(this, cellCenterX, cellCenterY);
+	if (maxDist < HUGE_DIST)
+	{
+		Int max = worldToCellDist(maxDist) + 1;
+		if (max < iter.getMaxRadius())
+			iter.setMaxRadius(max);
+	}
+
+	PartitionCell *thisCell;
+	while ((thisCell = iter.nextNonEmpty()) != NULL)
+	{
+		for (CellAndObjectIntersection *thisCoi = thisCell->getFirstCoiInCell(); thisCoi; thisCoi = thisCoi->getNextCoi())
+		{
+			PartitionData *thisMod = thisCoi->getModule();
+			Object *thisObj = thisMod->getObject();
+
+			if (thisObj == obj || thisObj == NULL) 
+				continue;
+
+			if (!scratch.markSeen(thisMod))
+				continue;
+
+			Real thisDistSqr;
+			Coord3D distVec;
+			if (!(*distProc)(objPos, objToUse, thisObj->getPosition(), thisObj, thisDistSqr, distVec, maxDistSqr))
+				continue;
+
+			if (!filtersAllow(filters, thisObj))
+				continue;
+
+			PartitionQueryHit hit = { thisObj, thisDistSqr };
+			scratch.m_hits.push_back(hit);
+		}
+	}
+
+#endif // not FASTER_GCO
+
+	// SimpleObjectIterator::insert puts each object at the head of its list, so
+	// iterateObjectsInRange hands them back newest-first. match it.
+	std::reverse(scratch.m_hits.begin(), scratch.m_hits.end());
+	scratch.sort(order);
+}
+
+//-----------------------------------------------------------------------------
+// Counted for ReplayBenchmark, per iteration order; see PartitionManager::reportQueryBenchmark.
+struct QueryBenchmarkCounts
+{
+	UnsignedInt64	m_queries;
+	UnsignedInt64	m_hits;
+	UnsignedInt64	m_mismatches;			///< queries where the two paths gave different objects, or a different order
+	Int64					m_iteratorNanos;
+	Int64					m_scratchNanos;
+};
+
+static const Int QUERY_ORDER_COUNT = ITER_SORTED_EXPENSIVE_TO_CHEAP + 1;
+static QueryBenchmarkCounts s_queryBenchmark[QUERY_ORDER_COUNT];
+
+static Int64 queryBenchmarkNanos()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//-----------------------------------------------------------------------------
+/**
+	Runs the query both ways: through a SimpleObjectIterator, exactly as iterateObjectsInRange
+	would, and through the scratch. The two take turns going first, so neither always gets the
+	warm cache. The scratch's result is the one the caller gets.
+*/
+void PartitionManager::benchmarkQueryObjects(
+	PartitionQueryScratch& scratch,
+	const Object *obj, 
+	const Coord3D *pos, 
+	Real maxDist, 
+	DistanceCalculationType dc, 
+	PartitionFilter **filters, 
+	IterOrderType order
+)
+{
+	QueryBenchmarkCounts& counts = s_queryBenchmark[order];
+	Bool scratchFirst = (counts.m_queries & 1) != 0;
+
+	Int64 scratchNanos = 0;
+	if (scratchFirst)
+	{
+		scratchNanos = queryBenchmarkNanos();
+		queryObjects(scratch, obj, pos, maxDist, dc, filters, order);
+		scratchNanos = queryBenchmarkNanos() - scratchNanos;
+	}
+
+	Int64 iteratorNanos = queryBenchmarkNanos();
+	SimpleObjectIterator *iter = newInstance(SimpleObjectIterator);
+	getClosestObjects(obj, pos, maxDist, dc, filters, iter, NULL, NULL);
+	iter->sort(order);
+	iteratorNanos = queryBenchmarkNanos() - iteratorNanos;
+
+	if (!scratchFirst)
+	{
+		scratchNanos = queryBenchmarkNanos();
+		queryObjects(scratch, obj, pos, maxDist, dc, filters, order);
+		scratchNanos = queryBenchmarkNanos() - scratchNanos;
+	}
+
+	PartitionQueryResult result = scratch.getResult();
+	Bool same = TRUE;
+	PartitionQueryResult::iterator it = result.begin();
+	for (Object *other = iter->first(); other; other = iter->next(), ++it)
+	{
+		if (it == result.end() || it->m_object != other)
+		{
+			same = FALSE;
+			break;
+		}
+	}
+	if (it != result.end())
+		same = FALSE;
+	iter->deleteInstance();
+
+	++counts.m_queries;
+	counts.m_hits += result.size();
+	counts.m_iteratorNanos += iteratorNanos;
+	counts.m_scratchNanos += scratchNanos;
+	if (!same)
+		++counts.m_mismatches;
+}
+
+//-----------------------------------------------------------------------------
+AsciiString PartitionManager::reportQueryBenchmark( Int frames )
+{
+	static const char *const s_orderNames[QUERY_ORDER_COUNT] = 
+	{
+		"unsorted", "near to far", "far to near", "cheap to expensive", "expensive to cheap"
+	};
+
+	AsciiString report;
+	for (Int order = 0; order < QUERY_ORDER_COUNT; ++order)
+	{
+		const QueryBenchmarkCounts& counts = s_queryBenchmark[order];
+		if (counts.m_queries == 0)
+			continue;
+
+		double queries = (double)counts.m_queries;
+		AsciiString line;
+		line.format("  range queries, %s: %llu (%.1f/frame, %.1f hits each), iterator %.2f us, scratch %.2f us per query, %llu differed\n",
+			s_orderNames[order], (unsigned long long)counts.m_queries, frames > 0 ? queries / frames : 0.0, counts.m_hits / queries,
+			counts.m_iteratorNanos / queries / 1000.0, counts.m_scratchNanos / queries / 1000.0, (unsigned long long)counts.m_mismatches);
+		report.concat(line);
+	}
+	return report;
+}
+
+//-----------------------------------------------------------------------------
+void PartitionManager::resetQueryBenchmark( void )
+{
+	memset(s_queryBenchmark, 0, sizeof(s_queryBenchmark));
+}
+
+//-----------------------------------------------------------------------------
+PartitionQueryScratch *PartitionManager::allocQueryScratch()
+{
+	if (m_freeQueryScratch.empty())
+	{
+		PartitionQueryScratch *scratch = NEW PartitionQueryScratch;
+		m_allQueryScratch.push_back(scratch);
+		return scratch;
+	}
+
+	PartitionQueryScratch *scratch = m_freeQueryScratch.back();
+	m_freeQueryScratch.pop_back();
+	return scratch;
+}
+
+//-----------------------------------------------------------------------------
+void PartitionManager::releaseQueryScratch(PartitionQueryScratch *scratch)
+{
+	DEBUG_ASSERTCRASH(std::find(m_freeQueryScratch.begin(), m_freeQueryScratch.end(), scratch) == m_freeQueryScratch.end(), ("scratch released twice"));
+	m_freeQueryScratch.push_back(scratch);
+}
+
 //-----------------------------------------------------------------------------
 SimpleObjectIterator* PartitionManager::iteratePotentialCollisions(
 	const Coord3D* pos, 
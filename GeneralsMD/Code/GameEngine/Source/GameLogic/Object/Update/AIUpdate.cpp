@@ -3493,7 +3493,10 @@ void AIUpdateInterface::privateAttackObject( Object *victim, Int maxShotsToFire,
 	// do this after setting it as the current state, as the max-shots-to-fire is reset in AttackState::onEnter()
 	Weapon* weapon = getObject()->getCurrentWeapon();
 	if (weapon)
+	{
+		getObject()->markCRCDirty();
 		weapon->setMaxShotCount(maxShotsToFire);
+	}
 }
 
 //-----------------------------------------------------------------------------------------
@@ -3511,7 +3514,10 @@ void AIUpdateInterface::privateForceAttackObject( Object *victim, Int maxShotsTo
 	// do this after setting it as the current state, as the max-shots-to-fire is reset in AttackState::onEnter()
 	Weapon* weapon = getObject()->getCurrentWeapon();
 	if (weapon)
+	{
+		getObject()->markCRCDirty();
 		weapon->setMaxShotCount(maxShotsToFire);
+	}
 }
 
 //-----------------------------------------------------------------------------------------
@@ -3530,7 +3536,10 @@ void AIUpdateInterface::privateGuardRetaliate( Object *victim, const Coord3D *po
 	// do this after setting it as the current state, as the max-shots-to-fire is reset in AttackState::onEnter()
 	Weapon* weapon = getObject()->getCurrentWeapon();
 	if (weapon)
+	{
+		getObject()->markCRCDirty();
 		weapon->setMaxShotCount(maxShotsToFire);
+	}
 }
 
 //----------------------------------------------------------------------------------------
@@ -3553,7 +3562,10 @@ void AIUpdateInterface::privateAttackTeam( const Team *team, Int maxShotsToFire,
 	// do this after setting it as the current state, as the max-shots-to-fire is reset in AttackState::onEnter()
 	Weapon* weapon = getObject()->getCurrentWeapon();
 	if (weapon)
+	{
+		getObject()->markCRCDirty();
 		weapon->setMaxShotCount(maxShotsToFire);
+	}
 }
 
 //----------------------------------------------------------------------------------------
@@ -3627,7 +3639,10 @@ void AIUpdateInterface::privateAttackPosition( const Coord3D *pos, Int maxShotsT
 	// do this after setting it as the current state, as the max-shots-to-fire is reset in AttackState::onEnter()
 	weapon = getObject()->getCurrentWeapon();
 	if (weapon)
+	{
+		getObject()->markCRCDirty();
 		weapon->setMaxShotCount(maxShotsToFire);
+	}
 }
 
 //----------------------------------------------------------------------------------------
@@ -3653,7 +3668,10 @@ void AIUpdateInterface::privateAttackMoveToPosition( const Coord3D *pos, Int max
 	// do this after setting it as the current state, as the max-shots-to-fire is reset in AttackState::onEnter()
 	Weapon* weapon = getObject()->getCurrentWeapon();
 	if (weapon)
+	{
+		getObject()->markCRCDirty();
 		weapon->setMaxShotCount(maxShotsToFire);
+	}
 }
 
 //----------------------------------------------------------------------------------------
@@ -3679,7 +3697,10 @@ void AIUpdateInterface::privateAttackFollowWaypointPath( const Waypoint *way, In
 	// do this after setting it as the current state, as the max-shots-to-fire is reset in AttackState::onEnter()
 	Weapon* weapon = getObject()->getCurrentWeapon();
 	if (weapon)
+	{
+		getObject()->markCRCDirty();
 		weapon->setMaxShotCount(maxShotsToFire);
+	}
 }
 
 
@@ -1492,6 +1492,7 @@ public:
 			if (w == NULL)
 				continue;
 			
+			jet->markCRCDirty();
 			if (now >= m_reloadDoneFrame)
 				w->setClipPercentFull(1.0f, false);
 			else
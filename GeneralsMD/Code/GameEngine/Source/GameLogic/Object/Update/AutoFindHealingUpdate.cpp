@@ -157,11 +157,12 @@ Object* AutoFindHealingUpdate::scanClosestTarget()
 	Object *bestTarget = NULL;
 	Real closestDistSqr=0;
 
-	ObjectIterator *iter = ThePartitionManager->iterateObjectsInRange( me->getPosition(), data->m_ini.m_scanRange, FROM_CENTER_2D );
-	MemoryPoolObjectHolder hold(iter);
+	PartitionQueryScratchHolder scratch;
+	PartitionQueryResult candidates = ThePartitionManager->queryObjectsInRange( scratch.get(), me->getPosition(), data->m_ini.m_scanRange, FROM_CENTER_2D );
 
-	for( Object *other = iter->first(); other; other = iter->next() )
+	for( PartitionQueryResult::iterator it = candidates.begin(); it != candidates.end(); ++it )
 	{
+		Object *other = it->m_object;
 		if( !other->isKindOf( KINDOF_HEAL_PAD ) )
 		{
 			//Not a valid target.
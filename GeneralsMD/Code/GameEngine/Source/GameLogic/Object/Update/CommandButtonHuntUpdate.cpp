@@ -304,9 +304,10 @@ Object* CommandButtonHuntUpdate::scanClosestTarget(void)
 		}
 	}
 
-	ObjectIterator *iter = ThePartitionManager->iterateObjectsInRange( me->getPosition(), data->m_ini.m_scanRange, 
+	// the loop below makes queries of its own, so this one needs a scratch rather than the shared state
+	PartitionQueryScratchHolder scratch;
+	PartitionQueryResult candidates = ThePartitionManager->queryObjectsInRange( scratch.get(), me->getPosition(), data->m_ini.m_scanRange, 
 		FROM_CENTER_2D, filters, ITER_SORTED_NEAR_TO_FAR );
-	MemoryPoolObjectHolder hold(iter);
 
 	Object *bestTarget = NULL;
 	Int			effectivePriority=0;
@@ -319,8 +320,9 @@ Object* CommandButtonHuntUpdate::scanClosestTarget(void)
 	SpecialPowerModuleInterface *mod = me->getSpecialPowerModule( spTemplate );
 	if( mod )
 	{
-		for( Object *other = iter->first(); other; other = iter->next() )
+		for( PartitionQueryResult::iterator it = candidates.begin(); it != candidates.end(); ++it )
 		{
+			Object *other = it->m_object;
 			if (other->isDisabled() && isBlackLotusVehicleHack) {
 				// The hack disables the vehicle, so we don't want to do it again.
 				continue;
@@ -375,8 +377,9 @@ Object* CommandButtonHuntUpdate::scanClosestTarget(void)
 	else if( isEnter )
 	{
 		Bool valid = FALSE;
-		for( Object *other = iter->first(); other; other = iter->next() )
+		for( PartitionQueryResult::iterator it = candidates.begin(); it != candidates.end(); ++it )
 		{
+			Object *other = it->m_object;
 			switch( m_commandButton->getCommandType() )
 			{
 				case GUICOMMANDMODE_HIJACK_VEHICLE:
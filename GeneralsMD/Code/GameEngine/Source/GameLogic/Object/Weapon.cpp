@@ -1346,9 +1346,9 @@ DEBUG_CRASH(("WeaponTemplate::dealDamageInternal not yet implemented!"));
 	ObjectStatusTypes damageStatusType = getDamageStatusType();
 	if (getProjectileTemplate() == NULL || isProjectileDetonation)
 	{
-		SimpleObjectIterator *iter;
-		Object *curVictim;
-		Real curVictimDistSqr;
+		PartitionQueryScratchHolder scratch;
+		PartitionQueryHit primaryHit = { primaryVictim, 0.0f };
+		PartitionQueryResult victims;
 
 		Real primaryRadius = getPrimaryDamageRadius(bonus);
 		Real secondaryRadius = getSecondaryDamageRadius(bonus);
@@ -1362,8 +1362,7 @@ DEBUG_CRASH(("WeaponTemplate::dealDamageInternal not yet implemented!"));
 		Real radius = max(primaryRadius, secondaryRadius);
 		if (radius > 0.0f)
 		{
-			iter = ThePartitionManager->iterateObjectsInRange(pos, radius, DAMAGE_RANGE_CALC_TYPE);
-			curVictim = iter->firstWithNumeric(&curVictimDistSqr);
+			victims = ThePartitionManager->queryObjectsInRange(scratch.get(), pos, radius, DAMAGE_RANGE_CALC_TYPE);
 		} 
 		else
 		{
@@ -1371,9 +1370,8 @@ DEBUG_CRASH(("WeaponTemplate::dealDamageInternal not yet implemented!"));
 			// check against victimID rather than primaryVictim, since we may have targeted a legitimate victim
 			// that got killed before the damage was dealt... (srj)
 			//DEBUG_ASSERTCRASH(victimID != 0, ("weapons without radii should always pass in specific victims"));
-			iter = NULL;
-			curVictim = primaryVictim;
-			curVictimDistSqr = 0.0f;
+			if (primaryVictim != NULL)
+				victims = PartitionQueryResult(&primaryHit, 1);
 
 			if( affects & WEAPON_KILLS_SELF )
 			{
@@ -1388,10 +1386,12 @@ DEBUG_CRASH(("WeaponTemplate::dealDamageInternal not yet implemented!"));
 				return;
 			}
 		}
-		MemoryPoolObjectHolder hold(iter);
 
-		for (; curVictim != NULL; curVictim = iter ? iter->nextWithNumeric(&curVictimDistSqr) : NULL)
+		for (PartitionQueryResult::iterator it = victims.begin(); it != victims.end(); ++it)
 		{
+			Object *curVictim = it->m_object;
+			Real curVictimDistSqr = it->m_distSqr;
+
 			Bool killSelf = false;
 			if (source != NULL)
 			{
@@ -1965,6 +1965,7 @@ void Weapon::rebuildScatterTargets()
 //-------------------------------------------------------------------------------------------------
 void Weapon::reloadWithBonus(const Object *sourceObj, const WeaponBonus& bonus, Bool loadInstantly)
 {
+	sourceObj->markCRCDirty();
 	if (m_template->getClipSize() > 0 
 			&& m_ammoInClip == (UnsignedInt)m_template->getClipSize()
 			&& !sourceObj->isReloadTimeShared())
@@ -2026,6 +2027,8 @@ static void clipToTerrainExtent(Coord3D& approachTargetPos)
 //-------------------------------------------------------------------------------------------------
 void Weapon::onWeaponBonusChange(const Object *source)
 {
+	source->markCRCDirty();
+
 	// We are concerned with our reload times being off if our ROF just changed.
 
 	WeaponBonus bonus;
@@ -2640,6 +2643,7 @@ DEBUG_CRASH(("Weapon::privateFireWeapon not yet implemented!"));
 return false;
 #if 0
 	//CRCDEBUG_LOG(("Weapon::privateFireWeapon() for %s\n", DescribeObject(sourceObj).str()));
+	sourceObj->markCRCDirty();
 	//USE_PERF_TIMER(fireWeapon)
 	if (projectileID)
 		*projectileID = INVALID_ID;
@@ -2854,6 +2858,7 @@ return false;
 //-------------------------------------------------------------------------------------------------
 void Weapon::preFireWeapon( const Object *source, const Object *victim )
 {
+	source->markCRCDirty();
 	Int delay = getPreAttackDelay( source, victim );
 	if( delay > 0 )
 	{
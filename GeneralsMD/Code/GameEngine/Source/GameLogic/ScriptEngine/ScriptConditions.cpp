@@ -1102,11 +1102,12 @@ Bool ScriptConditions::evaluateEnemySighted(Parameter *pItemParm, Parameter *pAl
 
 	Real visionRange = theObj->getVisionRange();
 
-	SimpleObjectIterator *iter = ThePartitionManager->iterateObjectsInRange(
-								theObj, visionRange, FROM_CENTER_2D, filters); 
-	MemoryPoolObjectHolder hold(iter);
-	for (Object *them = iter->first(); them; them = iter->next())
+	PartitionQueryScratchHolder scratch;
+	PartitionQueryResult sighted = ThePartitionManager->queryObjectsInRange(
+								scratch.get(), theObj, visionRange, FROM_CENTER_2D, filters); 
+	for (PartitionQueryResult::iterator it = sighted.begin(); it != sighted.end(); ++it)
 	{
+		Object *them = it->m_object;
 		if (them->getControllingPlayer() == pPlayer) {
 			return true;
 		}
@@ -1147,11 +1148,12 @@ Bool ScriptConditions::evaluateTypeSighted(Parameter *pItemParm, Parameter *pTyp
 
 	Real visionRange = theObj->getVisionRange();
 
-	SimpleObjectIterator *iter = ThePartitionManager->iterateObjectsInRange(
-								theObj, visionRange, FROM_CENTER_2D, filters); 
-	MemoryPoolObjectHolder hold(iter);
-	for (Object *them = iter->first(); them; them = iter->next())
+	PartitionQueryScratchHolder scratch;
+	PartitionQueryResult sighted = ThePartitionManager->queryObjectsInRange(
+								scratch.get(), theObj, visionRange, FROM_CENTER_2D, filters); 
+	for (PartitionQueryResult::iterator it = sighted.begin(); it != sighted.end(); ++it)
 	{
+		Object *them = it->m_object;
 		if (them->getControllingPlayer() == pPlayer) {
 			if (types.m_types->isInSet(them->getTemplate()->getName()))
 				return true;
@@ -5227,6 +5227,27 @@ void ScriptEngine::init( void )
 	curTemplate->m_numUiStrings = 1;
 	curTemplate->m_uiStrings[0] = "Show Weather = ";
 
+	// Declare what the conditions that only look at script engine state read, so their clauses are
+	// only evaluated again once some of it has changed. Anything not declared here looks at the
+	// world, and is evaluated every time.
+	auto declareStateRead = [this](Condition::ConditionType type, UnsignedInt stateRead) {
+		m_conditionTemplates[type].m_stateDeclared = TRUE;
+		m_conditionTemplates[type].m_stateRead = stateRead;
+	};
+	declareStateRead(Condition::CONDITION_FALSE, 0);
+	declareStateRead(Condition::CONDITION_TRUE, 0);
+	declareStateRead(Condition::MISSION_ATTEMPTS, 0);	// not implemented, always false
+	declareStateRead(Condition::COUNTER, SCRIPT_STATE_BIT(SCRIPT_STATE_COUNTERS));	// and timer ticks, see getConditionStateRead
+	declareStateRead(Condition::FLAG, SCRIPT_STATE_BIT(SCRIPT_STATE_FLAGS) | SCRIPT_STATE_BIT(SCRIPT_STATE_UI_INTERACTIONS));
+	declareStateRead(Condition::TIMER_EXPIRED, SCRIPT_STATE_BIT(SCRIPT_STATE_COUNTERS) | SCRIPT_STATE_BIT(SCRIPT_STATE_TIMERS_EXPIRED));
+	declareStateRead(Condition::HAS_FINISHED_VIDEO, SCRIPT_STATE_BIT(SCRIPT_STATE_VIDEOS));
+	declareStateRead(Condition::PLAYER_TRIGGERED_SPECIAL_POWER, SCRIPT_STATE_BIT(SCRIPT_STATE_SPECIAL_POWERS));
+	declareStateRead(Condition::PLAYER_MIDWAY_SPECIAL_POWER, SCRIPT_STATE_BIT(SCRIPT_STATE_SPECIAL_POWERS));
+	declareStateRead(Condition::PLAYER_COMPLETED_SPECIAL_POWER, SCRIPT_STATE_BIT(SCRIPT_STATE_SPECIAL_POWERS));
+	declareStateRead(Condition::PLAYER_BUILT_UPGRADE, SCRIPT_STATE_BIT(SCRIPT_STATE_UPGRADES));
+	declareStateRead(Condition::PLAYER_ACQUIRED_SCIENCE, SCRIPT_STATE_BIT(SCRIPT_STATE_SCIENCES));
+	// The _FROM_NAMED variants also look up a unit, so they aren't declared.
+
 	Int i;
 	for (i=0; i<Condition::NUM_ITEMS; i++) {
 		AsciiString str;
@@ -5256,6 +5277,10 @@ void ScriptEngine::reset( void )
 	if (TheGameEngine && TheGlobalData)
 		TheGameEngine->setFramesPerSecondLimit(TheGlobalData->m_data.m_framesPerSecondLimit);
 
+	reportEvaluationStats();
+	m_evaluationStats = ScriptEvaluationStats();
+	invalidateScriptState();
+
 	if (TheScriptActions) {
 		TheScriptActions->reset();	 
 	}
@@ -5288,6 +5313,8 @@ void ScriptEngine::reset( void )
 		m_flags[i].value = false;
 		m_flags[i].name.clear();
 	}
+	m_counterIndex.clear();
+	m_flagIndex.clear();
 
 	m_breezeInfo.m_direction = PI/3;
 	m_breezeInfo.m_directionVec.x = Sin(m_breezeInfo.m_direction);
@@ -5374,12 +5401,12 @@ void ScriptEngine::reset( void )
 	m_namedReveals.clear();
 	
 	// Clear the named objects list.
- 	m_namedObjects.clear();
+ 	clearNamedObjects();
 
 	m_completedVideo.clear();
 	m_testingSpeech.clear();
 	m_testingAudio.clear();
-	m_uiInteractions.clear();
+	clearUIInteractions();
 	for (i=0; i<MAX_PLAYER_COUNT; ++i)
 	{
 		m_triggeredSpecialPowers[i].clear();
@@ -5421,6 +5448,8 @@ void ScriptEngine::newMap( void )
 		m_flags[i].value = false;
 		m_flags[i].name.clear();
 	}
+	m_counterIndex.clear();
+	m_flagIndex.clear();
 	m_endGameTimer = -1;
 	m_closeWindowTimer = -1;
 #ifdef SPECIAL_SCRIPT_PROFILING
@@ -5434,7 +5463,7 @@ void ScriptEngine::newMap( void )
 	m_completedVideo.clear();
 	m_testingSpeech.clear();
 	m_testingAudio.clear();
-	m_uiInteractions.clear();
+	clearUIInteractions();
 	for (i=0; i<MAX_PLAYER_COUNT; ++i)
 	{
 		m_triggeredSpecialPowers[i].clear();
@@ -5443,6 +5472,7 @@ void ScriptEngine::newMap( void )
 		m_acquiredSciences[i].clear();
 		m_completedUpgrades[i].clear();
 	}
+	invalidateScriptState();
 
 	/* Run through scripts & set condition team names. */
 	for (i=0; i<TheSidesList->getNumSides(); i++) {
@@ -5533,6 +5563,8 @@ void ScriptEngine::update( void )
 	if (m_endGameTimer>=0) {
 		return; // we are just timing down 
 	}
+
+	auto evaluationStart {std::chrono::steady_clock::now()};
 	
 	if (TheScriptActions) {
 		TheScriptActions->update();
@@ -5543,14 +5575,26 @@ void ScriptEngine::update( void )
 	// Update any countdown timers.
 	Int i;
 	// Note - counters start at 1.  0 means not assigned.
+	Bool anyTimerTicked = false;
+	Bool anyTimerExpired = false;
 	for (i=1; i<m_numCounters; i++) {
 		if (m_counters[i].isCountdownTimer) {
 			// If counter has any time left, decrement.  Counters go to -1 and stop.
 			if (m_counters[i].value >= 0) {
 				m_counters[i].value--;
+				anyTimerTicked = true;
+				if (m_counters[i].value == 0) {
+					anyTimerExpired = true;
+				}
 			}
 		}
 	}
+	if (anyTimerTicked) {
+		notifyOfScriptStateChange(SCRIPT_STATE_TIMER_TICKS);
+	}
+	if (anyTimerExpired) {
+		notifyOfScriptStateChange(SCRIPT_STATE_TIMERS_EXPIRED);
+	}
 
 	// Evaluate the scripts.
 	for (i=0; i<TheSidesList->getNumSides(); i++) {
@@ -5576,11 +5620,17 @@ void ScriptEngine::update( void )
 	ThePlayerList->updateTeamStates();
 
 	// Clear the UI Interaction flags.
-	m_uiInteractions.clear();
+	if (!m_uiInteractions.empty()) {
+		clearUIInteractions();
+		notifyOfScriptStateChange(SCRIPT_STATE_UI_INTERACTIONS);
+	}
 
 	// update all sequential stuff.
 	evaluateAndProgressAllSequentialScripts();
 
+	m_evaluationStats.frames++;
+	m_evaluationStats.updateNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - evaluationStart).count();
+
 	// Script debugger stuff
 	st_CurrentFrame++;
 #if 0
@@ -5751,11 +5801,10 @@ void ScriptEngine::clearFlag(const AsciiString &name)
 		AsciiString modName;
 		modName.format("%s%d", name.str(), j);
 		// Note - flags start at 1.  0 means not assigned.
-		Int i;
-		for (i=1; i<m_numFlags; i++) {
-			if ((modName==m_flags[i].name)) {
-				m_flags[i].value = FALSE;
-			}
+		Int i = findFlag(modName);
+		if (i != 0 && m_flags[i].value) {
+			m_flags[i].value = FALSE;
+			notifyOfScriptStateChange(SCRIPT_STATE_FLAGS);
 		}
 	}
 }  // end clearFlag
@@ -5984,10 +6033,9 @@ Object * ScriptEngine::getUnitNamed(const AsciiString& unitName)
 		return m_conditionObject;
 	}
 
-	for (VecNamedRequestsIt it = m_namedObjects.begin(); it != m_namedObjects.end(); ++it) {
-		if (unitName == (it->first)) {
-			return it->second;
-		}
+	Int entry = findNamedObject(unitName);
+	if (entry >= 0) {
+		return m_namedObjects[(size_t)entry].second;
 	}
 	return NULL;
 }
@@ -5997,10 +6045,9 @@ Object * ScriptEngine::getUnitNamed(const AsciiString& unitName)
 //-------------------------------------------------------------------------------------------------
 Bool ScriptEngine::didUnitExist(const AsciiString& unitName)
 {
-	for (VecNamedRequestsIt it = m_namedObjects.begin(); it != m_namedObjects.end(); ++it) {
-		if (unitName == (it->first)) {
-			return (it->second == NULL);
-		}
+	Int entry = findNamedObject(unitName);
+	if (entry >= 0) {
+		return (m_namedObjects[(size_t)entry].second == NULL);
 	}
 	return false;
 }
@@ -6111,17 +6158,16 @@ void ScriptEngine::runObjectScript(const AsciiString& scriptName, Object *pThisO
 //-------------------------------------------------------------------------------------------------
 Int ScriptEngine::allocateCounter( const AsciiString& name)
 {
-	Int i;
 	// Note - counters start at 1.  0 means not assigned.
-	for (i=1; i<m_numCounters; i++) {
-		if (name==m_counters[i].name) {
-			return i;
-		}
+	Int i = findCounter(name);
+	if (i != 0) {
+		return i;
 	}
 	DEBUG_ASSERTCRASH(m_numCounters<MAX_COUNTERS, ("Too many counters, failed to make '%s'.\n", name.str()));
 	if (m_numCounters < MAX_COUNTERS) {
 		m_counters[m_numCounters].name = name;
 		i = m_numCounters;
+		m_counterIndex.emplace(NAMEKEY(name), i);
 		m_numCounters++;
 		return(i);
 	}
@@ -6133,17 +6179,50 @@ Int ScriptEngine::allocateCounter( const AsciiString& name)
 //-------------------------------------------------------------------------------------------------
 const TCounter *ScriptEngine::getCounter(const AsciiString& counterName)
 {
-	Int i;
-	for (i=1; i<m_numCounters; i++)
+	Int i = findCounter(counterName);
+	if (i != 0)
 	{
-		if (counterName == m_counters[i].name)
-		{
-			return &(m_counters[i]);
-		}
+		return &(m_counters[i]);
 	}
 	return NULL;
 }
 
+//-------------------------------------------------------------------------------------------------
+/** Finds a counter by name, 0 if there isn't one. */
+//-------------------------------------------------------------------------------------------------
+Int ScriptEngine::findCounter( const AsciiString& name ) const
+{
+	NameKeyIndexMap::const_iterator it = m_counterIndex.find(NAMEKEY(name));
+	return it != m_counterIndex.end() ? it->second : 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Finds a flag by name, 0 if there isn't one. */
+//-------------------------------------------------------------------------------------------------
+Int ScriptEngine::findFlag( const AsciiString& name ) const
+{
+	NameKeyIndexMap::const_iterator it = m_flagIndex.find(NAMEKEY(name));
+	return it != m_flagIndex.end() ? it->second : 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Rebuilds the name lookups for counters and flags, after loading them. */
+//-------------------------------------------------------------------------------------------------
+void ScriptEngine::indexCountersAndFlags( void )
+{
+	m_counterIndex.clear();
+	m_flagIndex.clear();
+	// Note - counters and flags start at 1.  0 means not assigned.  If a name somehow appears
+	// twice, the first one is the one found, as it was when these were searched in order.
+	Int i;
+	for (i=1; i<m_numCounters; i++) {
+		m_counterIndex.emplace(NAMEKEY(m_counters[i].name), i);
+	}
+	for (i=1; i<m_numFlags; i++) {
+		m_flagIndex.emplace(NAMEKEY(m_flags[i].name), i);
+	}
+}
+
 //-------------------------------------------------------------------------------------------------
 void ScriptEngine::createNamedMapReveal(const AsciiString& revealName, const AsciiString& waypointName, Real radiusToReveal, const AsciiString& playerName)
 {
@@ -6249,17 +6328,16 @@ void ScriptEngine::removeNamedMapReveal(const AsciiString& revealName)
 //-------------------------------------------------------------------------------------------------
 Int ScriptEngine::allocateFlag( const AsciiString& name)
 {
-	Int i;
 	// Note - flags start at 1.  0 means not assigned.
-	for (i=1; i<m_numFlags; i++) {
-		if ((name==m_flags[i].name)) {
-			return i;
-		}
+	Int i = findFlag(name);
+	if (i != 0) {
+		return i;
 	}
 	DEBUG_ASSERTCRASH(m_numFlags < MAX_FLAGS, ("Too many flags, failed to make '%s'..\n", name.str()));
 	if (m_numFlags < MAX_FLAGS) {
 		m_flags[m_numFlags].name = name;
 		i = m_numFlags;
+		m_flagIndex.emplace(NAMEKEY(name), i);
 		m_numFlags++;
 		return(i);
 	}
@@ -6348,7 +6426,10 @@ void ScriptEngine::setCounter( ScriptAction *pAction )
 		pAction->getParameter(0)->friend_setInt(counterNdx);
 	}
 	Int value = pAction->getParameter(1)->getInt();
-	m_counters[counterNdx].value = value;
+	if (m_counters[counterNdx].value != value) {
+		m_counters[counterNdx].value = value;
+		notifyOfScriptStateChange(SCRIPT_STATE_COUNTERS);
+	}
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -6417,6 +6498,7 @@ void ScriptEngine::addCounter( ScriptAction *pAction )
 		pAction->getParameter(1)->friend_setInt(counterNdx);
 	}
 	m_counters[counterNdx].value += value;
+	notifyOfScriptStateChange(SCRIPT_STATE_COUNTERS);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -6432,6 +6514,7 @@ void ScriptEngine::subCounter( ScriptAction *pAction )
 		pAction->getParameter(1)->friend_setInt(counterNdx);
 	}
 	m_counters[counterNdx].value -= value;
+	notifyOfScriptStateChange(SCRIPT_STATE_COUNTERS);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -6454,11 +6537,9 @@ Bool ScriptEngine::evaluateFlag( Condition *pCondition )
 		return true;
 	}
 
-	for (ListAsciiStringIt it = m_uiInteractions.begin(); it != m_uiInteractions.end(); ++it) {
-		if (it->compare(pCondition->getParameter(0)->getString()) == 0) {
-			// just return. This flag will be cleared up at the end of the ScriptEngine::update() call
-			return true;
-		}
+	if (!m_uiInteractionKeys.empty() && m_uiInteractionKeys.count(NAMEKEY(pCondition->getParameter(0)->getString())) != 0) {
+		// just return. This flag will be cleared up at the end of the ScriptEngine::update() call
+		return true;
 	}
 	return false;
 }
@@ -6475,7 +6556,10 @@ void ScriptEngine::setFlag( ScriptAction *pAction )
 		pAction->getParameter(0)->friend_setInt(flagNdx);
 	}
 	Bool value = pAction->getParameter(1)->getInt();
-	m_flags[flagNdx].value = value;
+	if (m_flags[flagNdx].value != value) {
+		m_flags[flagNdx].value = value;
+		notifyOfScriptStateChange(SCRIPT_STATE_FLAGS);
+	}
 }
 
 
@@ -6738,6 +6822,7 @@ void ScriptEngine::setTimer( ScriptAction *pAction, Bool millisecondTimer, Bool
 		m_counters[counterNdx].value = value;
 	}
 	m_counters[counterNdx].isCountdownTimer = true;
+	notifyOfScriptStateChange(SCRIPT_STATE_COUNTERS);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -6752,6 +6837,7 @@ void ScriptEngine::pauseTimer( ScriptAction *pAction )
 		pAction->getParameter(0)->friend_setInt(counterNdx);
 	}
 	m_counters[counterNdx].isCountdownTimer = false;
+	notifyOfScriptStateChange(SCRIPT_STATE_COUNTERS);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -6767,6 +6853,7 @@ void ScriptEngine::restartTimer( ScriptAction *pAction )
 	}
 	if (m_counters[counterNdx].value > 0) {
 		m_counters[counterNdx].isCountdownTimer = true;
+		notifyOfScriptStateChange(SCRIPT_STATE_COUNTERS);
 	}
 }
 
@@ -6792,6 +6879,7 @@ void ScriptEngine::adjustTimer( ScriptAction *pAction, Bool millisecondTimer, Bo
 			value = -value;
 		m_counters[counterNdx].value += value;
 	}
+	notifyOfScriptStateChange(SCRIPT_STATE_COUNTERS);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -7081,35 +7169,40 @@ void ScriptEngine::addObjectToCache(Object* pNewObject)
 		return;
 	}
 
-	for (VecNamedRequestsIt it = m_namedObjects.begin(); it != m_namedObjects.end(); ++it) {
-		if (it->first == objName) {
-			if (it->second == NULL) {
-				AsciiString newNameForDead;
-				newNameForDead.format("Reassigning dead object's name '%s' to object (%d) of type '%s'\n", objName.str(), pNewObject->getID(), pNewObject->getTemplate()->getName().str());
-				TheScriptEngine->AppendDebugMessage(newNameForDead, FALSE);
-				DEBUG_LOG((newNameForDead.str()));
-				it->second = pNewObject;
-				return;
-			} else {
-				DEBUG_CRASH(("Attempting to assign the name '%s' to object (%d) of type '%s'," 
-										 " but object (%d) of type '%s' already has that name\n",
-										 objName.str(), pNewObject->getID(), pNewObject->getTemplate()->getName().str(), 
-										 it->second->getID(), it->second->getTemplate()->getName().str()));
-				return;
-			}
-		}
-
-		if (pNewObject == (it->second)) {
-			it->first = objName;
+	Int entry = findNamedObject(objName);
+	if (entry >= 0) {
+		NamedRequest &req = m_namedObjects[(size_t)entry];
+		if (req.second == NULL) {
+			AsciiString newNameForDead;
+			newNameForDead.format("Reassigning dead object's name '%s' to object (%d) of type '%s'\n", objName.str(), pNewObject->getID(), pNewObject->getTemplate()->getName().str());
+			TheScriptEngine->AppendDebugMessage(newNameForDead, FALSE);
+			DEBUG_LOG((newNameForDead.str()));
+			req.second = pNewObject;
+			m_namedObjectEntries[pNewObject] = entry;
+			return;
+		} else {
+			DEBUG_CRASH(("Attempting to assign the name '%s' to object (%d) of type '%s'," 
+									 " but object (%d) of type '%s' already has that name\n",
+									 objName.str(), pNewObject->getID(), pNewObject->getTemplate()->getName().str(), 
+									 req.second->getID(), req.second->getTemplate()->getName().str()));
 			return;
 		}
 	}
 
-	NamedRequest req;
-	req.first = objName;
-	req.second = pNewObject;
+	ObjectIndexMap::iterator renamed = m_namedObjectEntries.find(pNewObject);
+	if (renamed != m_namedObjectEntries.end()) {
+		// The object was known by another name; it keeps its place under the new one.
+		NamedRequest &req = m_namedObjects[(size_t)renamed->second];
+		NameKeyIndexMap::iterator oldName = m_namedObjectIndex.find(NAMEKEY(req.first));
+		if (oldName != m_namedObjectIndex.end() && oldName->second == renamed->second) {
+			m_namedObjectIndex.erase(oldName);
+		}
+		req.first = objName;
+		m_namedObjectIndex.emplace(NAMEKEY(objName), renamed->second);
+		return;
+	}
 
-	m_namedObjects.push_back(req);
+	addNamedObject(objName, pNewObject);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -7117,14 +7210,53 @@ void ScriptEngine::addObjectToCache(Object* pNewObject)
 //-------------------------------------------------------------------------------------------------
 void ScriptEngine::removeObjectFromCache( Object* pDeadObject )
 {
-	for (VecNamedRequestsIt it = m_namedObjects.begin(); it != m_namedObjects.end(); ++it) {
-		if (pDeadObject == (it->second)) {
-			it->second = NULL;	// Don't remove it, cause we want to check whether we ever knew a name later
-			break;
-		}
+	ObjectIndexMap::iterator it = m_namedObjectEntries.find(pDeadObject);
+	if (it != m_namedObjectEntries.end()) {
+		m_namedObjects[(size_t)it->second].second = NULL;	// Don't remove it, cause we want to check whether we ever knew a name later
+		m_namedObjectEntries.erase(it);
 	}
 }
 
+//-------------------------------------------------------------------------------------------------
+/** Finds the entry for a name in the named object cache, or -1 if the name was never seen. */
+//-------------------------------------------------------------------------------------------------
+Int ScriptEngine::findNamedObject( const AsciiString& name ) const
+{
+	NameKeyIndexMap::const_iterator it = m_namedObjectIndex.find(NAMEKEY(name));
+	return it != m_namedObjectIndex.end() ? it->second : -1;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Appends an entry to the named object cache.  obj may be NULL, for a name whose object died. */
+//-------------------------------------------------------------------------------------------------
+void ScriptEngine::addNamedObject( const AsciiString& name, Object *obj )
+{
+	Int entry = (Int)m_namedObjects.size();
+	m_namedObjects.push_back(NamedRequest(name, obj));
+	// Lookups have always found the first entry with a name, and the first for an object.
+	m_namedObjectIndex.emplace(NAMEKEY(name), entry);
+	if (obj) {
+		m_namedObjectEntries.emplace(obj, entry);
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+void ScriptEngine::clearNamedObjects( void )
+{
+	m_namedObjects.clear();
+	m_namedObjectIndex.clear();
+	m_namedObjectEntries.clear();
+}
+
+//-------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------
+void ScriptEngine::clearUIInteractions( void )
+{
+	m_uiInteractions.clear();
+	m_uiInteractionKeys.clear();
+}
+
 //-------------------------------------------------------------------------------------------------
 /** Kris:
 		Looks for existing cached object with same name and replaces that object point with the supplied one. 
@@ -7150,26 +7282,30 @@ void ScriptEngine::transferObjectName( const AsciiString& unitName, Object *pNew
 
 	pNewObject->setName(unitName); // make sure it's named the name.
 
-	//Loop through the cached list and find the string entry. If found, change the object
+	//Find the string entry in the cached list. If found, change the object
 	//so it's pointing to the new one.
-	for( VecNamedRequestsIt it = m_namedObjects.begin(); it != m_namedObjects.end(); ++it )
+	Int entry = findNamedObject( unitName );
+	if( entry >= 0 )
 	{
-		if( !unitName.compare( it->first ) )
+		NamedRequest &req = m_namedObjects[ (size_t)entry ];
+		Object* pOldObj = req.second;
+		if( pOldObj )
 		{
-			Object* pOldObj = it->second;
-			if( pOldObj )
+			// if you are transferring your name, you should also transfer any custom indicator color you have.
+			if (pOldObj->hasCustomIndicatorColor())
+				pNewObject->setCustomIndicatorColor(pOldObj->getIndicatorColor());
+			else
+				pNewObject->removeCustomIndicatorColor();
+
+			ObjectIndexMap::iterator oldEntry = m_namedObjectEntries.find( pOldObj );
+			if( oldEntry != m_namedObjectEntries.end() && oldEntry->second == entry )
 			{
-				// if you are transferring your name, you should also transfer any custom indicator color you have.
-				if (pOldObj->hasCustomIndicatorColor())
-					pNewObject->setCustomIndicatorColor(pOldObj->getIndicatorColor());
-				else
-					pNewObject->removeCustomIndicatorColor();
+				m_namedObjectEntries.erase( oldEntry );
 			}
-
-			it->second = pNewObject;
-
-			return;
 		}
+
+		req.second = pNewObject;
+		m_namedObjectEntries[ pNewObject ] = entry;
 	}
 
 }
@@ -7198,6 +7334,7 @@ void ScriptEngine::notifyOfObjectDestruction( Object *pDeadObject )
 void ScriptEngine::notifyOfCompletedVideo( const AsciiString& completedVideo ) 
 {
 	m_completedVideo.push_back(completedVideo);
+	notifyOfScriptStateChange(SCRIPT_STATE_VIDEOS);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -7206,6 +7343,7 @@ void ScriptEngine::notifyOfCompletedVideo( const AsciiString& completedVideo )
 void ScriptEngine::notifyOfTriggeredSpecialPower( Int playerIndex, const AsciiString& completedPower, ObjectID sourceObj )
 {
 	m_triggeredSpecialPowers[playerIndex].push_back(AsciiStringObjectIDPair(completedPower, sourceObj));
+	notifyOfScriptStateChange(SCRIPT_STATE_SPECIAL_POWERS);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -7214,6 +7352,7 @@ void ScriptEngine::notifyOfTriggeredSpecialPower( Int playerIndex, const AsciiSt
 void ScriptEngine::notifyOfMidwaySpecialPower( Int playerIndex, const AsciiString& completedPower, ObjectID sourceObj )
 {
 	m_midwaySpecialPowers[playerIndex].push_back(AsciiStringObjectIDPair(completedPower, sourceObj));
+	notifyOfScriptStateChange(SCRIPT_STATE_SPECIAL_POWERS);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -7222,6 +7361,7 @@ void ScriptEngine::notifyOfMidwaySpecialPower( Int playerIndex, const AsciiStrin
 void ScriptEngine::notifyOfCompletedSpecialPower( Int playerIndex, const AsciiString& completedPower, ObjectID sourceObj )
 {
 	m_finishedSpecialPowers[playerIndex].push_back(AsciiStringObjectIDPair(completedPower, sourceObj));
+	notifyOfScriptStateChange(SCRIPT_STATE_SPECIAL_POWERS);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -7230,6 +7370,7 @@ void ScriptEngine::notifyOfCompletedSpecialPower( Int playerIndex, const AsciiSt
 void ScriptEngine::notifyOfCompletedUpgrade( Int playerIndex, const AsciiString& upgrade, ObjectID sourceObj )
 {
 	m_completedUpgrades[playerIndex].push_back(AsciiStringObjectIDPair(upgrade, sourceObj));
+	notifyOfScriptStateChange(SCRIPT_STATE_UPGRADES);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -7238,6 +7379,7 @@ void ScriptEngine::notifyOfCompletedUpgrade( Int playerIndex, const AsciiString&
 void ScriptEngine::notifyOfAcquiredScience( Int playerIndex, ScienceType science )
 {
 	m_acquiredSciences[playerIndex].push_back(science);
+	notifyOfScriptStateChange(SCRIPT_STATE_SCIENCES);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -7246,6 +7388,8 @@ void ScriptEngine::notifyOfAcquiredScience( Int playerIndex, ScienceType science
 void ScriptEngine::signalUIInteract(const AsciiString& hookName)
 {
 	m_uiInteractions.push_front(hookName);
+	m_uiInteractionKeys.insert(NAMEKEY(hookName));
+	notifyOfScriptStateChange(SCRIPT_STATE_UI_INTERACTIONS);
 #ifdef DEBUG_LOGGING
 	AppendDebugMessage(hookName, false); // don't bother in Release
 #endif
@@ -7260,6 +7404,7 @@ Bool ScriptEngine::isVideoComplete( const AsciiString& completedVideo, Bool remo
 	if (findIt != m_completedVideo.end()) {
 		if (removeFromList) {
 			m_completedVideo.erase(findIt);
+			notifyOfScriptStateChange(SCRIPT_STATE_VIDEOS);
 		}
 		return true;
 	}
@@ -7353,6 +7498,7 @@ Bool ScriptEngine::isSpecialPowerTriggered( Int playerIndex, const AsciiString&
 		{
 			if (removeFromList) {
 				specialList->erase(findIt);
+				notifyOfScriptStateChange(SCRIPT_STATE_SPECIAL_POWERS);
 			}
 			return TRUE;
 		}
@@ -7378,6 +7524,7 @@ Bool ScriptEngine::isSpecialPowerMidway( Int playerIndex, const AsciiString& com
 		{
 			if (removeFromList) {
 				specialList->erase(findIt);
+				notifyOfScriptStateChange(SCRIPT_STATE_SPECIAL_POWERS);
 			}
 			return TRUE;
 		}
@@ -7403,6 +7550,7 @@ Bool ScriptEngine::isSpecialPowerComplete( Int playerIndex, const AsciiString& c
 		{
 			if (removeFromList) {
 				specialList->erase(findIt);
+				notifyOfScriptStateChange(SCRIPT_STATE_SPECIAL_POWERS);
 			}
 			return TRUE;
 		}
@@ -7428,6 +7576,7 @@ Bool ScriptEngine::isUpgradeComplete( Int playerIndex, const AsciiString& upgrad
 		{
 			if (removeFromList) {
 				specialList->erase(findIt);
+				notifyOfScriptStateChange(SCRIPT_STATE_UPGRADES);
 			}
 			return TRUE;
 		}
@@ -7479,6 +7628,7 @@ Bool ScriptEngine::isScienceAcquired( Int playerIndex, ScienceType science, Bool
 			if (removeFromList) 
 			{
 				specialList->erase(it);
+				notifyOfScriptStateChange(SCRIPT_STATE_SCIENCES);
 			}
 			return TRUE;
 		}
@@ -7579,12 +7729,38 @@ Bool ScriptEngine::evaluateConditions( Script *pScript, Team *thisTeam, Player *
 		Condition *pCondition = pCurCondition->getFirstAndCondition();
 		if (!pCondition) continue; // No conditions, so go to the next or.
 		Bool andTerm = true; 
-		while (pCondition && andTerm) {
-			if (!evaluateCondition(pCondition)) {
-				andTerm = false;
-				break; // Short circuit the and evauation - after the first false, we can quit.
+		if (isClauseCurrent(pCurCondition)) {
+			// Nothing this clause looked at last time has changed since, so neither has its value.
+			andTerm = pCurCondition->getCachedValue();
+			m_evaluationStats.clausesSkipped++;
+			m_evaluationStats.conditionsAvoided += (UnsignedInt64)pCurCondition->getCachedConditionCount();
+		} else {
+			// Anything changed while evaluating (a consumed event, say) makes the clause stale again.
+			UnsignedInt stateSerial = m_scriptStateSerial;
+			UnsignedInt stateRead = 0;
+			Bool cacheable = true;
+			Int conditionCount = 0;
+			while (pCondition && andTerm) {
+				UnsignedInt conditionRead;
+				if (getConditionStateRead(pCondition, &conditionRead)) {
+					stateRead |= conditionRead;
+				} else {
+					cacheable = false;
+				}
+				conditionCount++;
+				if (!evaluateCondition(pCondition)) {
+					andTerm = false;
+					break; // Short circuit the and evauation - after the first false, we can quit.
+				}
+				pCondition = pCondition->getNext();
+			}
+			m_evaluationStats.clausesEvaluated++;
+			m_evaluationStats.conditionsEvaluated += (UnsignedInt64)conditionCount;
+			if (cacheable) {
+				pCurCondition->setCachedValue(andTerm, stateRead, stateSerial, conditionCount, m_currentPlayer);
+			} else {
+				pCurCondition->clearCachedValue();
 			}
-			pCondition = pCondition->getNext();
 		}
 		if (andTerm) { // The outer list is OR'ed - so any true inner means we are true.
 			testValue = true;
@@ -7603,6 +7779,161 @@ Bool ScriptEngine::evaluateConditions( Script *pScript, Team *thisTeam, Player *
 
 
 
+//-------------------------------------------------------------------------------------------------
+/** Returns the script state a condition reads, or false if it reads something that isn't tracked
+		(the world, objects, teams) and so has to be evaluated every time. */
+//-------------------------------------------------------------------------------------------------
+Bool ScriptEngine::getConditionStateRead( Condition *pCondition, UnsignedInt *stateRead )
+{
+	Condition::ConditionType type = pCondition->getConditionType();
+	if (type < 0 || type >= Condition::NUM_ITEMS) {
+		return false;
+	}
+	const ConditionTemplate *conditionTemplate = &m_conditionTemplates[type];
+	if (!conditionTemplate->m_stateDeclared) {
+		return false;
+	}
+	*stateRead = conditionTemplate->m_stateRead;
+
+	Int i;
+	for (i=0; i<pCondition->getNumParameters(); i++) {
+		Parameter *pParm = pCondition->getParameter(i);
+		// The nearest enemy changes as the game goes on.
+		if (pParm->getParameterType() == Parameter::SIDE && pParm->getString() == THIS_PLAYER_ENEMY) {
+			return false;
+		}
+	}
+
+	if (type == Condition::COUNTER) {
+		// Counters that are running as timers change every frame without anyone setting them.
+		Int counterNdx = pCondition->getParameter(0)->getInt();
+		if (counterNdx <= 0 || counterNdx >= m_numCounters || m_counters[counterNdx].isCountdownTimer) {
+			*stateRead |= SCRIPT_STATE_BIT(SCRIPT_STATE_TIMER_TICKS);
+		}
+	}
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** True if the clause has a cached value that nothing it read has changed since. */
+//-------------------------------------------------------------------------------------------------
+Bool ScriptEngine::isClauseCurrent( const OrCondition *pClause ) const
+{
+	if (!pClause->hasCachedValue() || pClause->getCachedPlayer() != m_currentPlayer) {
+		return false;
+	}
+	UnsignedInt stateRead = pClause->getCachedStateRead();
+	UnsignedInt stateSerial = pClause->getCachedStateSerial();
+	Int i;
+	for (i=0; i<SCRIPT_STATE_COUNT; i++) {
+		if ((stateRead & SCRIPT_STATE_BIT(i)) && m_scriptStateChanged[i] > stateSerial) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Marks all script state as changed, so every clause is evaluated again. */
+//-------------------------------------------------------------------------------------------------
+void ScriptEngine::invalidateScriptState( void )
+{
+	++m_scriptStateSerial;
+	Int i;
+	for (i=0; i<SCRIPT_STATE_COUNT; i++) {
+		m_scriptStateChanged[i] = m_scriptStateSerial;
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Reports how much condition evaluation was saved on the map just played. */
+//-------------------------------------------------------------------------------------------------
+void ScriptEngine::reportEvaluationStats( void )
+{
+	const ScriptEvaluationStats &stats = m_evaluationStats;
+	if (stats.frames == 0) {
+		return;
+	}
+	AsciiString mapName;
+	if (TheGlobalData) {
+		mapName = TheGlobalData->m_data.m_mapName;
+	}
+	Real totalMS = (Real)stats.updateNanos / 1000000.0f;
+	UnsignedInt64 clauses = stats.clausesEvaluated + stats.clausesSkipped;
+	Real skippedPercent = clauses ? 100.0f * (Real)stats.clausesSkipped / (Real)clauses : 0.0f;
+
+	AsciiString report;
+	report.format("Script evaluation on %s: %u frames, %.2f ms total, %.4f ms/frame; "
+		"clauses evaluated %llu, skipped %llu (%.1f%%); conditions evaluated %llu, avoided %llu\n",
+		mapName.str(), stats.frames, totalMS, totalMS / (Real)stats.frames,
+		(unsigned long long)stats.clausesEvaluated, (unsigned long long)stats.clausesSkipped, skippedPercent,
+		(unsigned long long)stats.conditionsEvaluated, (unsigned long long)stats.conditionsAvoided);
+	DEBUG_LOG(("%s", report.str()));
+	if (TheGlobalData && TheGlobalData->m_data.m_headless) {
+		printf("%s", report.str());
+		fflush(stdout);
+	}
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Name 'units' units the way a scripted map does, then time looking up every name, and as many
+	* names that were never given, through the name key index against the scan of m_namedObjects
+	* that getUnitNamed and didUnitExist used to do. (-scriptNameBenchmark) */
+//-------------------------------------------------------------------------------------------------
+void ScriptEngine::reportNamedObjectBenchmark( Int units )
+{
+	enum { PASSES = 200 };
+
+	clearNamedObjects();
+	std::vector<AsciiString> names;
+	for (Int i = 0; i < units; ++i) {
+		AsciiString name;
+		name.format("BenchmarkUnit%04d", i);
+		// the lookups never touch the object, so a name whose unit died is as good as a live one
+		addNamedObject(name, NULL);
+		names.push_back(name);
+		// a name that was never given has to scan the whole cache
+		name.format("BenchmarkUnnamed%04d", i);
+		names.push_back(name);
+	}
+
+	Int indexFound = 0;
+	auto indexStart {std::chrono::steady_clock::now()};
+	for (Int pass = 0; pass < PASSES; ++pass) {
+		for (std::vector<AsciiString>::const_iterator name = names.begin(); name != names.end(); ++name) {
+			if (findNamedObject(*name) >= 0) {
+				++indexFound;
+			}
+		}
+	}
+	Int64 indexNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - indexStart).count();
+
+	Int scanFound = 0;
+	auto scanStart {std::chrono::steady_clock::now()};
+	for (Int pass = 0; pass < PASSES; ++pass) {
+		for (std::vector<AsciiString>::const_iterator name = names.begin(); name != names.end(); ++name) {
+			for (VecNamedRequestsIt it = m_namedObjects.begin(); it != m_namedObjects.end(); ++it) {
+				if (*name == it->first) {
+					++scanFound;
+					break;
+				}
+			}
+		}
+	}
+	Int64 scanNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - scanStart).count();
+
+	clearNamedObjects();
+
+	Real lookups = (Real)names.size() * (Real)PASSES;
+	printf("Script named unit benchmark: %d named units, %d lookups of which half miss\n", units, (Int)lookups);
+	printf("  name key index: %.2f ms, %.1f ns per lookup, %d found\n",
+		(Real)indexNanos / 1000000.0f, (Real)indexNanos / lookups, indexFound);
+	printf("  scan:           %.2f ms, %.1f ns per lookup, %d found\n",
+		(Real)scanNanos / 1000000.0f, (Real)scanNanos / lookups, scanFound);
+	fflush(stdout);
+	DEBUG_ASSERTCRASH(indexFound == scanFound, ("named unit lookups disagree: index found %d, scan found %d\n", indexFound, scanFound));
+}
+
 //-------------------------------------------------------------------------------------------------
 /** Execute a linked list of actions */
 //-------------------------------------------------------------------------------------------------
@@ -7692,7 +8023,7 @@ const ConditionTemplate * ScriptEngine::getConditionTemplate( Int ndx )
 //-------------------------------------------------------------------------------------------------
 void ScriptEngine::createNamedCache( void )
 {
-	m_namedObjects.clear();
+	clearNamedObjects();
 
 	if( !TheGameLogic )
 	{
@@ -7702,10 +8033,7 @@ void ScriptEngine::createNamedCache( void )
 
 	while (pObj) {
 		if (!pObj->getName().isEmpty()) {
-			NamedRequest req;
-			req.first = pObj->getName();
-			req.second = pObj;
-			m_namedObjects.push_back(req);
+			addNamedObject(pObj->getName(), pObj);
 		}
 		pObj = pObj->getNextObject();
 	}
@@ -8931,6 +9259,9 @@ void ScriptEngine::xfer( Xfer *xfer )
 	// num flags
 	xfer->xferInt( &m_numFlags );
 
+	if( xfer->getXferMode() == XFER_LOAD )
+		indexCountersAndFlags();
+
 	// attack priority info
 	UnsignedShort attackPriorityInfoSize = m_numAttackInfo;
 	xfer->xferUnsignedShort( &attackPriorityInfoSize );
@@ -8984,13 +9315,11 @@ void ScriptEngine::xfer( Xfer *xfer )
 	}  // end if, save
 	else
 	{
-		NamedRequest req;
-
 		//
 		// list should be empty, it is legal for it to not be empty at this point
 		// according to John M., so we're clearing it now
 		//
-		m_namedObjects.clear();
+		clearNamedObjects();
 
 		// read each element
 		for( UnsignedShort i = 0; i < namedObjectsCount; ++i )
@@ -9011,9 +9340,7 @@ void ScriptEngine::xfer( Xfer *xfer )
 			}  // end if
 
 			// assign
-			req.first = namedObjectName;
-			req.second = obj;
-			m_namedObjects.push_back( req );
+			addNamedObject( namedObjectName, obj );
 
 		}  // end for, i
 
@@ -9057,6 +9384,12 @@ void ScriptEngine::xfer( Xfer *xfer )
 
 	// ui interactions
 	xferListAsciiString( xfer, &m_uiInteractions );
+	if( xfer->getXferMode() == XFER_LOAD )
+	{
+		m_uiInteractionKeys.clear();
+		for( ListAsciiStringIt it = m_uiInteractions.begin(); it != m_uiInteractions.end(); ++it )
+			m_uiInteractionKeys.insert( NAMEKEY( *it ) );
+	}
 
 	// triggered special powers
 	UnsignedShort triggeredSpecialPowersSize = MAX_PLAYER_COUNT;
@@ -9305,6 +9638,8 @@ void ScriptEngine::xfer( Xfer *xfer )
 // ------------------------------------------------------------------------------------------------
 void ScriptEngine::loadPostProcess( void )
 {
+	// Flags, counters and the rest were all just loaded.
+	invalidateScriptState();
 
 	// Now that we've loaded everything, go through and set them all back in sync with what we
 	// currently think they should be.
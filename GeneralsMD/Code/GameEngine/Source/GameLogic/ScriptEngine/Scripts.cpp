@@ -1391,6 +1391,7 @@ OrCondition *OrCondition::duplicateAndQualify(const AsciiString& qualifier,
 
 Condition *OrCondition::removeCondition(Condition *pCond)
 {
+	m_hasCachedValue = false;
 	Condition *pPrev = NULL;
 	Condition *pCur = m_firstAnd;
 	while (pCond != pCur) {
@@ -29,6 +29,8 @@
 
 #include "PreRTS.h"	// This must go first in EVERY cpp file int the GameEngine
 
+#include <chrono>
+
 #include "Common/AudioAffect.h"
 // #include "Common/AudioHandleSpecialValues.h"
 // #include "Common/BuildAssistant.h"
@@ -39,7 +41,7 @@
 // #include "Common/GameLOD.h"
 #include "Common/GameState.h"
 // #include "Common/INI.h"
-// #include "Common/LatchRestore.h"
+#include "Common/LatchRestore.h"
 // #include "Common/MapObject.h"
 // #include "Common/MultiplayerSettings.h"
 #include "Common/PerfTimer.h"
@@ -47,8 +49,9 @@
 #include "Common/PlayerList.h"
 // #include "Common/PlayerTemplate.h"
 // #include "Common/Radar.h"
-// #include "Common/RandomValue.h"
-// #include "Common/Recorder.h"
+#include "Common/RandomValue.h"
+#include "Common/Recorder.h"
+#include "Common/ReplayBenchmark.h"
 // #include "Common/StatsCollector.h"
 // #include "Common/ThingFactory.h"
 // #include "Common/Team.h"
@@ -56,9 +59,9 @@
 // #include "GameClient/Water.h"
 // #include "GameClient/Snow.h"
 #include "Common/WellKnownKeys.h"
-// #include "Common/Xfer.h"
-// #include "Common/XferCRC.h"
-// #include "Common/XferDeepCRC.h"
+#include "Common/Xfer.h"
+#include "Common/XferCRC.h"
+#include "Common/XferDeepCRC.h"
 // #include "Common/GameSpyMiscPreferences.h"
 
 #include "GameClient/ControlBar.h"
@@ -110,6 +113,7 @@
 // #include "GameNetwork/GameSpy/ThreadUtils.h"
 // #include "GameNetwork/LANAPICallbacks.h"
 // #include "GameNetwork/NetworkInterface.h"
+#include "GameNetwork/GameInfo.h"
 // #include "GameNetwork/GameSpy/PersistentStorageThread.h"
 
 // #include <rts/profile.h>
@@ -3713,17 +3717,18 @@ void GameLogic::update( void )
 	{
 		TheTerrainLogic->UPDATE();
 	}
+#endif // if 0
 
 	// force CRC calculation, so we can keep a cache of the last N CRCs.  We do this right where the recorder
 	// would be getting the CRC anyway, so replays can get the CRCs from the exact instant in time as the original.
 	Bool isMPGameOrReplay = (TheRecorder && TheRecorder->isMultiplayer() && getGameMode() != GAME_SHELL && getGameMode() != GAME_NONE);
 	Bool isSoloGameOrReplay = (TheRecorder && !TheRecorder->isMultiplayer() && getGameMode() != GAME_SHELL && getGameMode() != GAME_NONE);
-	Bool generateForMP = (isMPGameOrReplay && (m_frame % TheGameInfo->getCRCInterval()) == 0);
+	Bool generateForMP = (isMPGameOrReplay && (m_frame % (UnsignedInt)TheGameInfo->getCRCInterval()) == 0);
 #if defined(_DEBUG) || defined(_INTERNAL)
 	Bool generateForSolo = isSoloGameOrReplay && ((m_frame && (m_frame%100 == 0)) ||
-		(getFrame() > TheCRCFirstFrameToLog && getFrame() < TheCRCLastFrameToLog && ((m_frame % REPLAY_CRC_INTERVAL) == 0)));
+		((Int)getFrame() > TheCRCFirstFrameToLog && getFrame() < TheCRCLastFrameToLog && ((m_frame % (UnsignedInt)REPLAY_CRC_INTERVAL) == 0)));
 #else
-	Bool generateForSolo = isSoloGameOrReplay && ((m_frame % REPLAY_CRC_INTERVAL) == 0);
+	Bool generateForSolo = isSoloGameOrReplay && ((m_frame % (UnsignedInt)REPLAY_CRC_INTERVAL) == 0);
 #endif // defined(_DEBUG) || defined(_INTERNAL)
 
 	if (generateForSolo || generateForMP)
@@ -3732,30 +3737,31 @@ void GameLogic::update( void )
 		if (isMPGameOrReplay)
 		{
 			GameMessage *msg = TheMessageStream->appendMessage( GameMessage::MSG_LOGIC_CRC );
-			msg->appendIntegerArgument( m_CRC );
+			msg->appendIntegerArgument( (Int)m_CRC );
 			msg->appendBooleanArgument( (TheRecorder && TheRecorder->getMode() == RECORDERMODETYPE_PLAYBACK) ); // playback CRC
 			//DEBUG_LOG(("Appended CRC of %8.8X on frame %d\n", m_CRC, m_frame));
 		}
 		else
 		{
 			GameMessage *msg = TheMessageStream->appendMessage( GameMessage::MSG_LOGIC_CRC );
-			msg->appendIntegerArgument( m_CRC );
+			msg->appendIntegerArgument( (Int)m_CRC );
 			msg->appendBooleanArgument( (TheRecorder && TheRecorder->getMode() == RECORDERMODETYPE_PLAYBACK) ); // playback CRC
 			//DEBUG_LOG(("Appended Playback CRC of %8.8X on frame %d\n", m_CRC, m_frame));
 		}
 	}
 
+#if 0
 	// collect stats
 	if(TheStatsCollector)
 	{
 		TheStatsCollector->update();
 	}
+#endif // if 0
 
 	// Update the Recorder
 	{
 		TheRecorder->UPDATE();
 	}
-#endif // if 0
 
 	// process client commands
 	{
@@ -3781,6 +3787,7 @@ void GameLogic::update( void )
 				#else
 					u->update();
 				#endif
+				u->friend_getObject()->markCRCDirty();
 
 				m_curUpdateModule = NULL;
 			}
@@ -3817,6 +3824,7 @@ void GameLogic::update( void )
 				m_curUpdateModule = u;
 
 				sleepLen = u->update();
+				u->friend_getObject()->markCRCDirty();
 				DEBUG_ASSERTCRASH(sleepLen > 0, ("you may not return 0 from update"));
 				if (sleepLen < 1) 
 					sleepLen = UPDATE_SLEEP_NONE;
@@ -4083,20 +4091,63 @@ void GameLogic::destroyObject( Object *obj )
 
 }  // end destroyObject
 
+// ------------------------------------------------------------------------------------------------
+// Incremental object CRCs checked against a full recompute, for ReplayBenchmark and debug builds;
+// see GameLogic::reportIncrementalCRC.
+// ------------------------------------------------------------------------------------------------
+struct IncrementalCRCCounts
+{
+	UnsignedInt		m_checks;
+	UnsignedInt		m_mismatches;
+	Int64					m_incrementalNanos;
+	Int64					m_fullNanos;
+	UnsignedInt		m_frameMismatches;	///< whole frame CRCs that differed from a non-incremental recompute
+	Int64					m_frameNanos;				///< the incremental getCRC() calls
+	Int64					m_referenceNanos;		///< the non-incremental recomputes of them
+};
+static IncrementalCRCCounts s_incrementalCRC;
+static Bool s_referenceCRC = FALSE;	///< set while getCRC() recomputes a frame CRC the slow way to check it
+
+static Int64 incrementalCRCNanos()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ------------------------------------------------------------------------------------------------
+AsciiString GameLogic::reportIncrementalCRC( Int frames )
+{
+	AsciiString report;
+	if (s_incrementalCRC.m_checks == 0)
+		return report;
+
+	double checks = (double)s_incrementalCRC.m_checks;
+	report.format("  object CRCs: %u checked (%.2f/frame), incremental %.1f us, full %.1f us per CRC, %u differed\n",
+		s_incrementalCRC.m_checks, frames > 0 ? checks / frames : 0.0, s_incrementalCRC.m_incrementalNanos / checks / 1000.0,
+		s_incrementalCRC.m_fullNanos / checks / 1000.0, s_incrementalCRC.m_mismatches);
+
+	AsciiString frameReport;
+	frameReport.format("  frame CRCs: incremental %.1f us, non-incremental reference %.1f us per CRC, %u differed\n",
+		s_incrementalCRC.m_frameNanos / checks / 1000.0, s_incrementalCRC.m_referenceNanos / checks / 1000.0,
+		s_incrementalCRC.m_frameMismatches);
+	report.concat(frameReport);
+	return report;
+}
+
+// ------------------------------------------------------------------------------------------------
+void GameLogic::resetIncrementalCRC( void )
+{
+	memset(&s_incrementalCRC, 0, sizeof(s_incrementalCRC));
+}
+
 // ------------------------------------------------------------------------------------------------
 // ------------------------------------------------------------------------------------------------
 Bool inCRCGen = FALSE;
 UnsignedInt GameLogic::getCRC( Int mode, AsciiString deepCRCFileName )
 {
-(void) mode;
-(void) deepCRCFileName;
-DEBUG_CRASH(("GameLogic::getCRC not yet implemented!"));
-return false;
-#if 0
 	if (mode != CRC_RECALC)
 		return m_CRC;
 
-	setFPMode();
+	// setFPMode();
 
 	LatchRestore<Bool> latch(inCRCGen, !isInGameLogicUpdate());
 
@@ -4117,7 +4168,7 @@ return false;
 			crcName.format("logicFrame%d.crc", (m_frame%5));
 		}
 		else
-#endif DEBUG_CRC
+#endif // DEBUG_CRC
 		{
 			xferCRC = NEW XferCRC;
 			crcName = "lightCRC";
@@ -4133,11 +4184,65 @@ return false;
 		CRCGEN_LOG(("CRC at start of frame %d is 0x%8.8X\n", m_frame, xferCRC->getCRC()));
 	}
 
+	// in incremental mode, objects that haven't been marked dirty fold the words they folded last
+	// time instead of running their crc() again.  Deep CRCs always do the real thing.
+	Bool incremental = TheGlobalData->m_data.m_incrementalCRC && xferCRC->getXferMode() == XFER_CRC && !s_referenceCRC;
+
+	// replays and debug builds check every incremental CRC against a full recompute; anything
+	// that changes an object without marking it dirty will show up as a mismatch
+	Bool compareFull = incremental && TheReplayBenchmark != NULL;
+#ifdef _DEBUG
+	compareFull = incremental;
+#endif
+
+	Int64 frameNanos = compareFull ? incrementalCRCNanos() : 0;
+	Int64 checkNanos = 0;
 	marker = "MARKER:Objects";
 	xferCRC->xferAsciiString(&marker);
+	Int64 incrementalNanos = compareFull ? incrementalCRCNanos() : 0;
 	for( obj = m_objList; obj; obj=obj->getNextObject() )
 	{
-		xferCRC->xferSnapshot( obj );
+		if (incremental)
+			obj->friend_xferIncrementalCRC( xferCRC );
+		else
+			xferCRC->xferSnapshot( obj );
+	}
+
+	if (compareFull)
+	{
+		incrementalNanos = incrementalCRCNanos() - incrementalNanos;
+		checkNanos = incrementalCRCNanos();
+
+		// every object is clean now, so this folds exactly the words the loop above folded; they
+		// go into their own CRCs so the real one is the same whether or not we're checking
+		XferCRC cachedCRC;
+		cachedCRC.open("cachedObjectCRC");
+		for( obj = m_objList; obj; obj=obj->getNextObject() )
+		{
+			obj->friend_xferIncrementalCRC( &cachedCRC );
+		}
+		cachedCRC.close();
+
+		XferCRC fullCRC;
+		fullCRC.open("fullObjectCRC");
+		Int64 fullNanos = incrementalCRCNanos();
+		for( obj = m_objList; obj; obj=obj->getNextObject() )
+		{
+			fullCRC.xferSnapshot( obj );
+		}
+		fullNanos = incrementalCRCNanos() - fullNanos;
+		fullCRC.close();
+
+		++s_incrementalCRC.m_checks;
+		s_incrementalCRC.m_incrementalNanos += incrementalNanos;
+		s_incrementalCRC.m_fullNanos += fullNanos;
+		if (fullCRC.getCRC() != cachedCRC.getCRC())
+		{
+			++s_incrementalCRC.m_mismatches;
+			DEBUG_CRASH(("Incremental object CRC 0x%8.8X doesn't match a full recompute (0x%8.8X) on frame %d - an object changed without calling markCRCDirty()",
+				cachedCRC.getCRC(), fullCRC.getCRC(), m_frame));
+		}
+		checkNanos = incrementalCRCNanos() - checkNanos;
 	}
 	UnsignedInt seed = GetGameLogicRandomSeedCRC();
 	if (isInGameLogicUpdate())
@@ -4173,7 +4278,7 @@ return false;
 			CRCGEN_LOG(("CRC after module factory for frame %d is 0x%8.8X\n", m_frame, xferCRC->getCRC()));
 		}
 	}
-#endif DEBUG_CRC
+#endif // DEBUG_CRC
 
 	marker = "MARKER:ThePlayerList";
 	xferCRC->xferAsciiString(&marker);
@@ -4209,8 +4314,28 @@ return false;
 	{
 		CRCGEN_LOG(("CRC for frame %d is 0x%8.8X\n", m_frame, theCRC));
 	}
+
+	if (compareFull && deepCRCFileName.isEmpty())
+	{
+		s_incrementalCRC.m_frameNanos += incrementalCRCNanos() - frameNanos - checkNanos;
+
+		// the object check above only covers the object section; check the whole CRC the same way
+		// by running all of it again with every object folded through its crc()
+		UnsignedInt referenceCRC;
+		{
+			LatchRestore<Bool> reference(s_referenceCRC, TRUE);
+			Int64 referenceNanos = incrementalCRCNanos();
+			referenceCRC = getCRC( CRC_RECALC );
+			s_incrementalCRC.m_referenceNanos += incrementalCRCNanos() - referenceNanos;
+		}
+		if (referenceCRC != theCRC)
+		{
+			++s_incrementalCRC.m_frameMismatches;
+			DEBUG_CRASH(("Incremental CRC 0x%8.8X doesn't match a non-incremental recompute (0x%8.8X) on frame %d",
+				theCRC, referenceCRC, m_frame));
+		}
+	}
 	return theCRC;
-#endif // if 0
 }
 
 #if 0
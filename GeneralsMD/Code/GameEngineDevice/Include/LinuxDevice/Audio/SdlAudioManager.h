@@ -20,16 +20,23 @@
 // Matthew Gill, April 2025
 //////////////////////////////////////////////////
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 #include "Common/AsciiString.h"
 #include "Common/GameAudio.h"
+#include "LinuxDevice/Audio/SdlAudioMixer.h"
 #include "LinuxDevice/Common/SdlFileStream.h"
 #include <SDL3/SDL.h>
 #include <SDL3_sound/SDL_sound.h>
 
 using HSAMPLE = UnsignedInt;
+using H3DSAMPLE = UnsignedInt;
 using HSTREAM = Sound_Sample*;
 // FIXME: Temporary types until I figure them out.
-typedef void* H3DSAMPLE;
 typedef void* HDIGDRIVER;
 typedef int H3DPOBJECT;
 typedef void* HPROVIDER;
@@ -37,6 +44,7 @@ typedef int HAUDIO;
 
 
 class AudioEventRTS;
+struct OpenAudioFile;
 
 enum { MAXPROVIDERS = 64 };
 
@@ -72,15 +80,14 @@ public:
    H3DSAMPLE m_3DSample {};
    HSTREAM m_stream {};
 
-   SDL_AudioStream* m_sdlStream;
-   UnsignedInt m_audioLen;
+   MixerVoiceID m_voice;
    Bool m_streamEof;
    SdlFileStream* m_streamFileStream;
 
    PlayingAudioType m_type {};
    volatile PlayingStatus m_status {}; // This member is adjusted by another running thread.
    AudioEventRTS* m_audioEventRTS {};
-   UnsignedByte* m_audioBuf {};
+   OpenAudioFile* m_openFile {};    ///< samples only; may still be decoding when the sound is started
    Bool m_requestStop {};
    Bool m_cleanupAudioEventRTS {};
    Int m_framesFaded {};
@@ -89,8 +96,7 @@ public:
       m_sample(0),
       m_3DSample(0),
       m_stream(nullptr),
-      m_sdlStream(nullptr),
-      m_audioLen(0),
+      m_voice(INVALID_MIXER_VOICE),
       m_streamEof(false),
       m_streamFileStream(nullptr),
       m_type(PAT_INVALID),
@@ -121,18 +127,47 @@ struct ProviderInfo
 
 struct OpenAudioFile
 {
-   SDL_AudioSpec m_audioSpec;
-   UnsignedByte* m_audioBuf;
-   UnsignedInt m_audioLen;
-   UnsignedInt m_openCount;
+   SDL_AudioSpec m_audioSpec {};
+   UnsignedByte* m_audioBuf {};       ///< NULL until the decode has finished
+   UnsignedInt m_audioLen {};
+   UnsignedInt m_openCount {};
+   AsciiString m_fileName {};         ///< our key in the cache
+   Bool m_loading {};                 ///< queued on, or being decoded by, the worker
+   Bool m_failed {};                  ///< couldn't be decoded, or there was no room for it
+   Bool m_idle {};                    ///< loaded and not open, so on the least recently used list
+   std::list<OpenAudioFile*>::iterator m_idleIt {};
+   Uint64 m_requestTime {};           ///< performance counter when the decode was queued
 
    // Note: OpenAudioFile does not own this m_eventInfo, and should not delete it.
-   const AudioEventInfo* m_eventInfo;  // Not mutable, unlike the one on AudioEventRTS.
+   const AudioEventInfo* m_eventInfo {};  // Not mutable, unlike the one on AudioEventRTS.
 };
 
-typedef std::unordered_map<AsciiString, OpenAudioFile, rts::hash<AsciiString>, rts::equal_to<AsciiString>> OpenFilesHash;
+typedef std::unordered_map< AsciiString, OpenAudioFile, rts::hash<AsciiString>, rts::equal_to<AsciiString> > OpenFilesHash;
 typedef OpenFilesHash::iterator OpenFilesHashIt;
 
+struct AudioCacheStats
+{
+   UnsignedInt m_hits {};             ///< opens of a file that was already cached or on its way
+   UnsignedInt m_misses {};           ///< opens that had to queue a decode
+   UnsignedInt m_decodes {};          ///< decodes picked up by update()
+   UnsignedInt m_decodeFailures {};
+   UnsignedInt m_evictions {};
+   UnsignedInt m_evictedInUse {};     ///< evictions that cut off a playing sound
+   UnsignedInt64 m_evictedBytes {};
+   Real m_totalDecodeMS {};           ///< worker time spent decoding
+   Real m_maxDecodeMS {};
+   Real m_totalLatencyMS {};          ///< from queueing a decode to the file being ready to play
+   Real m_maxLatencyMS {};
+
+   Real getHitRate() const { return m_hits + m_misses ? static_cast<Real>(m_hits) / static_cast<Real>(m_hits + m_misses) : 0.0f; }
+   Real getAverageLatencyMS() const { return m_decodes ? m_totalLatencyMS / static_cast<Real>(m_decodes) : 0.0f; }
+   Real getAverageDecodeMS() const { return m_decodes ? m_totalDecodeMS / static_cast<Real>(m_decodes) : 0.0f; }
+};
+
+/** Decoded sound effects, shared by every sound playing them. Files are decoded by a worker
+  * thread, so opening one that isn't cached yet returns at once and the sound starts when the
+  * decode is picked up by update(), usually on the next frame. Files nobody has open are
+  * evicted least recently used first whenever the cache goes over its byte budget. */
 class AudioFileCache
 {
 public:
@@ -145,8 +180,10 @@ public:
    // Protected by mutex
    virtual ~AudioFileCache();
 
+   /// Adds a reference, which closeFile drops. Check m_loading and m_failed before playing it.
    OpenAudioFile* openFile(AudioEventRTS* eventToOpenFrom);
-   void releaseBuffer(UnsignedByte* buffer);
+   void closeFile(OpenAudioFile* file);
+   void update();                     ///< pick up finished decodes; call once a frame
    void setMaxSize(UnsignedInt size);
    // End Protected by mutex
 
@@ -155,17 +192,48 @@ public:
    // outside the audio cache. They should be used as a rough estimate only.
    UnsignedInt getCurrentlyUsedSize() const { return m_currentlyUsedSize; }
    UnsignedInt getMaxSize() const { return m_maxSize; }
+   const AudioCacheStats& getStats() const { return m_stats; }
+   void resetStats();
 
 protected:
+   // AsciiString's reference count isn't thread safe, so the worker only ever sees a copy of the name
+   struct DecodeJob {
+      std::string m_fileName {};
+      std::vector<UnsignedByte> m_source {};     ///< the whole file, read on the game thread
+   };
+
+   struct DecodeResult {
+      std::string m_fileName {};
+      SDL_AudioSpec m_audioSpec {};
+      UnsignedByte* m_audioBuf {};              ///< SDL_malloc'd; NULL if the decode failed
+      UnsignedInt m_audioLen {};
+      Real m_decodeMS {};
+   };
+
+   void threadMain();
+   static void decode(const DecodeJob& job, DecodeResult& result);   ///< runs on the worker, must not touch the engine
+
    void releaseOpenAudioFile(OpenAudioFile* fileToRelease);
+   void removeFromIdle(OpenAudioFile* file);
+   void eraseFile(OpenAudioFile* file);
 
    // This function will return TRUE if it was able to free enough space, and FALSE otherwise.
    Bool freeEnoughSpaceForSample(const OpenAudioFile& sampleThatNeedsSpace);
 
    OpenFilesHash m_openFiles {};
+   std::list<OpenAudioFile*> m_idleFiles {};    ///< least recently used first
    UnsignedInt m_currentlyUsedSize {};
    UnsignedInt m_maxSize {};
+   AudioCacheStats m_stats {};
    SDL_Mutex* m_mutex {};
+
+   // Shared with the worker
+   std::mutex m_jobMutex {};
+   std::condition_variable m_wake {};           ///< signalled when a job is queued or we're quitting
+   std::deque<DecodeJob> m_jobs {};
+   std::vector<DecodeResult> m_finished {};
+   Bool m_quit {};
+   std::thread m_thread {};
 };
 
 class SdlAudioManager: public AudioManager
@@ -232,6 +300,9 @@ public:
    virtual UnsignedInt getNum3DSamples() const;
    virtual UnsignedInt getNumStreams() const;
 
+   virtual void resetCacheStats();
+   virtual AsciiString reportCacheStats(Int frames) const;
+
    virtual Bool doesViolateLimit(AudioEventRTS* event) const;
    virtual Bool isPlayingLowerPriority(AudioEventRTS* event) const;
    virtual Bool isPlayingAlready(AudioEventRTS* event) const;
@@ -277,7 +348,7 @@ protected:
 
    void playStream(AudioEventRTS* event, PlayingAudio* audio, Real volume);
    void playSample(AudioEventRTS* event, PlayingAudio* audio);
-   void* playSample3D(AudioEventRTS* event, H3DSAMPLE sample3D);
+   void playSample3D(AudioEventRTS* event, PlayingAudio* audio);
 
 protected:
    void buildProviderList();
@@ -292,7 +363,8 @@ protected:
    void pauseAudioEvent(AudioHandle handle);
 
    OpenAudioFile* loadFileForRead(AudioEventRTS* eventToLoadFrom);
-   void releaseBuffer(UnsignedByte* buffer);
+   void startSample(PlayingAudio* audio);
+   void startSample3D(PlayingAudio* audio);
 
    PlayingAudio* allocatePlayingAudio();
    void releaseHandle(PlayingAudio* release);
@@ -310,10 +382,12 @@ protected:
 
 protected:
    void initFilters(PlayingAudio* sample, const AudioEventRTS* eventInfo);
-   void initFilters3D(H3DSAMPLE sample, const AudioEventRTS* eventInfo, const Coord3D* pos);
+   void initFilters3D(PlayingAudio* sample, AudioEventRTS* eventInfo, const Coord3D* pos);
+   Real getPan(const Coord3D* pos) const;
 
 protected:
    SDL_AudioDeviceID m_device {};
+   SdlAudioMixer m_mixer {};
 
    ProviderInfo m_provider3D[MAXPROVIDERS] {};
    UnsignedInt m_providerCount {};
@@ -0,0 +1,162 @@
+/*
+** Command & Conquer Generals Zero Hour(tm)
+** Copyright 2025 Electronic Arts Inc.
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+///// SdlAudioMixer.h ////////////////////////////
+// Mixes every playing sound into the one audio
+// stream bound to the device.  Samples are read
+// straight out of the audio cache's buffers and
+// resampled here; streams are decoded by the
+// manager and queued into a converter per voice.
+//
+// Mixing runs on SDL's audio device thread, from
+// the device stream's get callback.
+//////////////////////////////////////////////////
+
+#pragma once
+
+#ifndef __SDL_AUDIO_MIXER_H
+#define __SDL_AUDIO_MIXER_H
+
+#include <vector>
+#include "Lib/BaseType.h"
+#include <SDL3/SDL.h>
+
+/// Names a voice started on the mixer. Once a voice has finished, been stopped or been stolen its
+/// ID is simply ignored, so the manager never has to worry about holding on to a stale one.
+typedef UnsignedInt MixerVoiceID;
+enum { INVALID_MIXER_VOICE = 0 };
+
+//===============================
+// SdlAudioMixer
+//===============================
+
+class SdlAudioMixer {
+public:
+   enum {
+      MAX_VOICES = 128,          ///< past this, new samples steal the lowest priority sample voice
+      MIX_CHANNELS = 2,
+      MIX_BLOCK_FRAMES = 512,    ///< most frames mixed in one pass
+   };
+
+   SdlAudioMixer();
+   ~SdlAudioMixer();
+
+   // No copies allowed!
+   SdlAudioMixer(const SdlAudioMixer&) = delete;
+   SdlAudioMixer& operator=(const SdlAudioMixer&) = delete;
+
+   Bool open(SDL_AudioDeviceID device, Int rate);   ///< bind the mix stream and start mixing
+   void close();                                    ///< stops every voice
+   Bool isOpen() const { return m_rate != 0; }
+
+   /// Voices start paused, so gain and pitch can be set before the first frame is heard.
+   /// data must stay valid until the voice is stopped.
+   MixerVoiceID playSample(const SDL_AudioSpec& spec, const UnsignedByte* data, UnsignedInt length, Int priority);
+   MixerVoiceID playStream(const SDL_AudioSpec& spec, Int priority);
+
+   void queueStreamData(MixerVoiceID voice, const void* data, Int length);
+   void flushStream(MixerVoiceID voice);              ///< no more data is coming; let the converter drain
+   Int getStreamQueued(MixerVoiceID voice);           ///< source bytes not yet converted
+   Int getStreamAvailable(MixerVoiceID voice);        ///< converted bytes not yet mixed
+
+   void setVoiceGain(MixerVoiceID voice, Real volume, Real pan);  ///< pan runs from -1 (left) to 1 (right)
+   void setVoiceVolume(MixerVoiceID voice, Real volume);          ///< keeps the current pan
+   void setVoicePitch(MixerVoiceID voice, Real pitch);
+   void setVoiceLowPass(MixerVoiceID voice, Real cutoff);         ///< cutoff as a fraction of the highest frequency, 1 for none
+   void setVoicePaused(MixerVoiceID voice, Bool paused);
+   void stopVoice(MixerVoiceID voice);
+   Bool isVoiceDone(MixerVoiceID voice);  ///< sample played out, or the voice was stopped or stolen
+
+   void mix(float* out, Int frames);      ///< interleaved stereo, overwrites out
+
+   // For the debug display only; not locked.
+   UnsignedInt getVoiceCount() const { return m_voiceCount; }
+   UnsignedInt getStolenCount() const { return m_stolenCount; }
+
+   /// Mix voiceCount voices into a null sink for the given number of seconds and report the CPU
+   /// cost (-mixerBenchmark). Needs no audio device.
+   static void benchmark(UnsignedInt voiceCount, Real seconds, Int rate);
+
+private:
+   enum VoiceState {
+      VS_Free,
+      VS_Playing,
+      VS_Paused,
+      VS_Done,
+   };
+
+   struct Voice {
+      Voice() { }
+
+      // No copies allowed!
+      Voice(const Voice&) = delete;
+      Voice& operator=(const Voice&) = delete;
+
+      MixerVoiceID m_id {};
+      VoiceState m_state {VS_Free};
+      Int m_priority {};
+      UnsignedInt m_startOrder {};            ///< older voices are stolen first among equal priorities
+
+      // Samples
+      const UnsignedByte* m_data {};
+      UnsignedInt m_frames {};
+      SDL_AudioFormat m_format {SDL_AUDIO_UNKNOWN};
+      Int m_channels {};
+      Int m_sourceRate {};
+      Uint64 m_position {};                   ///< 32.32 fixed point source frame
+      Uint64 m_step {};                       ///< source frames per output frame, 32.32
+
+      // Streams
+      SDL_AudioStream* m_stream {};           ///< converts to the mix format; not bound to the device
+
+      Real m_volume {};
+      Real m_pan {};
+      Bool m_started {};                      ///< until it is first mixed, gain changes apply at once
+      Real m_gain[MIX_CHANNELS] {};           ///< gains reached at the end of the last pass
+      Real m_targetGain[MIX_CHANNELS] {};
+
+      Real m_lowPass {1.0f};                  ///< one pole low pass coefficient, 1 for none
+      Real m_filtered[MIX_CHANNELS] {};       ///< low pass output for the last frame mixed
+   };
+
+   static void SDLCALL deviceCallback(void* userdata, SDL_AudioStream* stream, Int additional, Int total);
+   static Bool isSupportedFormat(SDL_AudioFormat format);
+   static UnsignedInt getSampleSize(SDL_AudioFormat format);   ///< bytes in one channel of one frame
+
+   Voice* allocateVoice(Int priority, Bool canSteal);
+   Voice* findVoice(MixerVoiceID voice);
+   void freeVoice(Voice* voice);
+   void updateTargetGain(Voice* voice);
+   void mixSampleVoice(Voice* voice, float* out, Int frames);
+   void mixStreamVoice(Voice* voice, float* out, Int frames);
+
+   SDL_Mutex* m_mutex {};                     ///< guards m_voices; held for a whole mixing pass
+   SDL_AudioStream* m_deviceStream {};
+   Int m_rate {};
+   Voice m_voices[MAX_VOICES] {};
+   UnsignedInt m_nextSerial {};
+   UnsignedInt m_nextStartOrder {};
+   UnsignedInt m_voiceCount {};
+   UnsignedInt m_stolenCount {};
+
+   // Only touched by the mixing thread
+   std::vector<float> m_mixBuffer {};
+   std::vector<float> m_streamBuffer {};
+};
+
+#endif // __SDL_AUDIO_MIXER_H
@@ -59,6 +59,9 @@ public:
    virtual void update();                                  ///< update the game engine
    virtual void checkForEvents();                          ///< check for SDL events
 
+   void setHeadless(Bool headless) { m_headless = headless; }  ///< run without a renderer, window events or audio device
+   void setHeadlessAudio(Bool audio) { m_headlessAudio = audio; }  ///< keep the audio manager in a headless run
+
 protected:
 
    virtual GameLogic* createGameLogic();                   ///< factory for game logic
@@ -77,6 +80,8 @@ protected:
 
 protected:
    // UINT m_previousErrorMode;
+   Bool m_headless {};     ///< set before init, since the renderer is created ahead of the command line parse
+   Bool m_headlessAudio {};
 };  // end LinuxGameEngine
 
 // INLINE -----------------------------------------------------------------------------------------
@@ -94,6 +99,6 @@ inline NetworkInterface* LinuxGameEngine::createNetwork() { printf("Creating NUL
 inline Radar* LinuxGameEngine::createRadar() { return NEW LinuxRadar; }
 // inline WebBrowser* LinuxGameEngine::createWebBrowser() { return NEW CComObject<W3DWebBrowser>; }
 inline WebBrowser* LinuxGameEngine::createWebBrowser() { printf("Creating NULL WebBrowser!\n"); return nullptr; }
-inline AudioManager* LinuxGameEngine::createAudioManager() { return NEW SdlAudioManager; }
+inline AudioManager* LinuxGameEngine::createAudioManager() { if (m_headless && !m_headlessAudio) return NEW AudioManagerDummy; return NEW SdlAudioManager; }
 
 #endif  // end __LINUXGAMEENGINE_H_
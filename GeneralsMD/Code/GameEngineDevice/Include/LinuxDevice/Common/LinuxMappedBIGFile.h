@@ -0,0 +1,116 @@
+/*
+** Command & Conquer Generals Zero Hour(tm)
+** Copyright 2025 Electronic Arts Inc.
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/////// LinuxMappedBIGFile.h //////////////////////////////
+// Memory-mapped BIG archive.  The table of contents is parsed straight out
+// of the mapping into a flat open-addressed hash of normalized paths, and
+// read-only files are handed out as views into the mapping, not copies.
+///////////////////////////////////////////////////////////
+
+#pragma once
+
+#ifndef __LINUXMAPPEDBIGFILE_H
+#define __LINUXMAPPEDBIGFILE_H
+
+#include <vector>
+#include "Common/ArchiveFile.h"
+#include "Common/AsciiString.h"
+#include "Common/RAMFile.h"
+
+//===============================
+// MappedArchiveFileView
+//===============================
+/**
+  * A read-only RAMFile whose data lives in an archive's memory mapping.
+  * The view never owns its data, so it must not outlive the archive it
+  * was opened from.
+  */
+//===============================
+
+class MappedArchiveFileView: public RAMFile {
+   MEMORY_POOL_GLUE_WITH_USERLOOKUP_CREATE(MappedArchiveFileView, "MappedArchiveFileView")
+public:
+   MappedArchiveFileView();
+
+   // No copies allowed!
+   MappedArchiveFileView(const MappedArchiveFileView&) = delete;
+   MappedArchiveFileView& operator=(const MappedArchiveFileView&) = delete;
+
+   Bool openFromMapping(const Char *data, const AsciiString& filename, Int size); ///< point this file at size bytes of mapped archive data.
+
+   virtual void close(void);
+   virtual char* readEntireAndClose();
+};
+
+//===============================
+// LinuxMappedBIGFile
+//===============================
+
+class LinuxMappedBIGFile: public ArchiveFile {
+public:
+   LinuxMappedBIGFile();
+   virtual ~LinuxMappedBIGFile();
+
+   // No copies allowed!
+   LinuxMappedBIGFile(const LinuxMappedBIGFile&) = delete;
+   LinuxMappedBIGFile& operator=(const LinuxMappedBIGFile&) = delete;
+
+   Bool map(const Char *filename); ///< map the BIG file and index its table of contents.
+
+   virtual Bool         getFileInfo(const AsciiString& filename, FileInfo *fileInfo) const;  ///< fill in the fileInfo struct with info about the requested file.
+   virtual Bool         getFileOffset(const AsciiString& filename, UnsignedInt *offset) const; ///< where the requested file's data starts within the BIG file.
+   virtual File*        openFile(const Char *filename, Int access = 0);                      ///< Open the specified file within the BIG file
+   virtual void         closeAllFiles(void);                                                 ///< Close all file opened in this BIG file
+   virtual AsciiString  getName(void);                                                       ///< Returns the name of the BIG file
+   virtual AsciiString  getPath(void);                                                       ///< Returns full path and name of BIG file
+   virtual void         setSearchPriority(Int new_priority);                                 ///< Set this BIG file's search priority
+   virtual void         close(void);                                                         ///< Close this BIG file
+
+   using ArchiveFile::getFileListInDirectory;
+   virtual void getFileListInDirectory(const AsciiString& currentDirectory, const AsciiString& originalDirectory, const AsciiString& searchName, FilenameList &filenameList, Bool searchSubdirectories) const;
+
+   Int getEntryCount(void) const { return static_cast<Int>(m_entries.size()); }
+
+protected:
+   struct Entry {
+      UnsignedInt m_hash;        ///< hash of the normalized path
+      UnsignedInt m_pathOffset;  ///< start of the normalized path in m_paths
+      UnsignedInt m_pathLength;  ///< length of the normalized path
+      UnsignedInt m_nameOffset;  ///< start of the file name within the normalized path
+      UnsignedInt m_offset;      ///< start of the file data within the mapping
+      UnsignedInt m_size;        ///< size of the file data
+   };
+
+   static UnsignedInt normalizePath(const Char *src, const Char *srcEnd, Char *dst, UnsignedInt dstSize);
+   static UnsignedInt hashPath(const Char *path, UnsignedInt length);
+
+   Bool parseTableOfContents(void);
+   void insertEntry(const Entry& entry);
+   const Entry* findEntry(const Char *filename) const;
+   void unmap(void);
+
+   AsciiString m_name {};                 ///< BIG file name
+   AsciiString m_path {};                 ///< BIG file path
+   const Char* m_mapping {};              ///< start of the read-only mapping
+   size_t m_mappingSize {};               ///< size of the mapping in bytes
+   std::vector<Entry> m_entries {};       ///< one entry per archived file
+   std::vector<Int> m_slots {};           ///< open-addressed table of indices into m_entries, -1 when empty
+   std::vector<Char> m_paths {};          ///< normalized, null-terminated paths of every entry
+};
+
+#endif // __LINUXMAPPEDBIGFILE_H
@@ -29,10 +29,13 @@
 #include "LinuxDevice/GameClient/LinuxFileSystem.h"
 #include <SDL3/SDL.h>
 
+class LinuxTextureLoader;
+
 struct Texture {
    GameFileClass* gameFile {};
    SDL_Texture* texture {};
    Bool loaded {};
+   Bool requested {};   ///< handed to the texture loader, drawn as a placeholder until it's loaded
    Bool dds {};
 };
 
@@ -53,6 +56,10 @@ public:
    LinuxDisplay();
    virtual ~LinuxDisplay();
 
+   // No copies allowed!
+   LinuxDisplay(const LinuxDisplay&) = delete;
+   LinuxDisplay& operator=(const LinuxDisplay&) = delete;
+
    virtual void init();    ///< initialize or re-initialize the system
    // virtual void reset();   ///< Reset system
 
@@ -111,9 +118,12 @@ public:
    virtual Int getLastFrameDrawCalls(void);     ///< returns the number of draw calls issued in the previous frame
 
 protected:
+   void uploadFinishedTextures();               ///< turn everything the texture loader has decoded into textures
+
    IRegion2D m_clipRegion {}; ///< the clipping region for images
    Bool m_isClippedEnabled {};
    TextureCache m_textureCache {};
+   LinuxTextureLoader* m_textureLoader {};      ///< decodes images off the main thread, not created when headless
    std::vector<DisplayMode> m_displayModes {};
 };
 
@@ -25,6 +25,7 @@
 #ifndef __LINUXGAMECLIENT_H
 #define __LINUXGAMECLIENT_H
 
+#include "Common/GlobalData.h"
 #include "GameClient/GameClient.h"
 #include "LinuxDevice/GameClient/LinuxDisplay.h"
 #include "LinuxDevice/GameClient/LinuxInGameUI.h"
@@ -73,7 +74,8 @@ protected:
    /// Manager for display strings
    virtual DisplayStringManager *createDisplayStringManager() { return NEW LinuxDisplayStringManager; }
 
-   virtual VideoPlayerInterface *createVideoPlayer() { return NEW FFmpegVideoPlayer; }
+   /// when headless, the common player parses the video INIs but never decodes anything
+   virtual VideoPlayerInterface *createVideoPlayer() { if (TheGlobalData->m_data.m_headless) return NEW VideoPlayer; return NEW FFmpegVideoPlayer; }
 
    /// factory for creating the TerrainVisual
    virtual TerrainVisual *createTerrainVisual() { return NEW LinuxTerrainVisual; }
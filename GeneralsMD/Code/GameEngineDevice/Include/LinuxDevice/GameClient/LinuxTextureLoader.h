@@ -0,0 +1,120 @@
+/*
+** Command & Conquer Generals Zero Hour(tm)
+** Copyright 2025 Electronic Arts Inc.
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+///// LinuxTextureLoader.h ///////////////////////
+// Decodes DDS and Targa images on a pool of worker
+// threads.  The display reads the source file on the
+// main thread, queues it here, and turns finished
+// pixels into SDL textures at the start of each frame.
+//
+// With -textureCache, decoded pixels are also kept
+// in the user data directory, keyed by source path,
+// size and timestamp, so later runs skip decoding.
+//////////////////////////////////////////////////
+
+#pragma once
+
+#ifndef __LINUX_TEXTURE_LOADER_H
+#define __LINUX_TEXTURE_LOADER_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Common/AsciiString.h"
+#include <SDL3/SDL.h>
+
+class FileClass;
+
+//===============================
+// DecodedTexture
+//===============================
+
+struct DecodedTexture {
+   std::string m_name {};                       ///< image file name the display keys its textures on
+   std::vector<UnsignedByte> m_pixels {};
+   Int m_width {};
+   Int m_height {};
+   Int m_pitch {};
+   SDL_PixelFormat m_format {SDL_PIXELFORMAT_UNKNOWN};
+   Bool m_ok {};
+   Bool m_fromCache {};                         ///< read back from the texture cache rather than decoded
+   Bool m_dxt1Alpha {};                         ///< a DXT1 image with transparent texels, which DXT1 shouldn't have
+   const char *m_error {};                      ///< why it couldn't be decoded; a literal, workers can't log
+   long m_targaError {};                        ///< Targa::Load's error code, for Targa_Error_Handler
+   Real m_milliseconds {};                      ///< time the worker spent on it
+};
+
+//===============================
+// LinuxTextureLoader
+//===============================
+
+class LinuxTextureLoader {
+public:
+   /// an empty cacheDirectory turns the disk cache off
+   LinuxTextureLoader(Int threadCount, const AsciiString& cacheDirectory);
+   ~LinuxTextureLoader();                       ///< abandons queued requests, waits for the ones in progress
+
+   // No copies allowed!
+   LinuxTextureLoader(const LinuxTextureLoader&) = delete;
+   LinuxTextureLoader& operator=(const LinuxTextureLoader&) = delete;
+
+   /// read file on this thread and queue it to be decoded
+   Bool request(const AsciiString& name, FileClass *file, const AsciiString& sourcePath, Bool dds);
+
+   void takeFinished(std::vector<DecodedTexture>& finished);   ///< swap out every texture finished so far
+   Int getPendingCount();
+
+   static Int getDefaultThreadCount();          ///< a core each, leaving one for the main thread
+
+   /// decode every DXT image in the file system, timing whole-level decoding against
+   /// block-at-a-time decoding and checking they agree (-ddsDecodeBenchmark)
+   static void benchmarkDDS();
+   /// load every DDS and Targa file inline and through the loader, with and without the
+   /// cache, timing the main thread's share and checking the pixels agree (-ddsDecodeBenchmark)
+   static void benchmarkLoader();
+
+private:
+   struct Job {
+      std::string m_name {};                    ///< not AsciiString, its reference counts aren't thread safe
+      std::string m_cachePath {};               ///< empty when the cache is off
+      std::string m_sourcePath {};
+      UnsignedInt64 m_sourceSize {};
+      UnsignedInt64 m_sourceTimestamp {};
+      std::vector<UnsignedByte> m_source {};
+      Bool m_dds {};
+   };
+
+   void threadMain();
+   static void decode(Job& job, DecodedTexture& result);             ///< runs on a worker, must not touch the engine or log
+   static Bool readCache(const Job& job, DecodedTexture& result);
+   static void writeCache(const Job& job, const DecodedTexture& result);
+
+   std::string m_cacheDirectory {};
+   std::mutex m_mutex {};
+   std::condition_variable m_wake {};           ///< signalled when a job is queued or we're quitting
+   std::deque<Job> m_jobs {};
+   std::vector<DecodedTexture> m_finished {};
+   Int m_busy {};                               ///< jobs being worked on right now
+   Bool m_quit {};
+   std::vector<std::thread> m_threads {};
+};
+
+#endif // __LINUX_TEXTURE_LOADER_H
@@ -27,6 +27,7 @@
 #ifndef __LINUXTERRAINLOGIC_H_
 #define __LINUXTERRAINLOGIC_H_
 
+#include <vector>
 #include "GameLogic/TerrainLogic.h"
 
 //-------------------------------------------------------------------------------------------------
@@ -72,9 +73,14 @@ protected:
    virtual void xfer( Xfer *xfer );
    virtual void loadPostProcess( void );
 
+   Real sampleHeightData( Real x, Real y, Coord3D* normal ) const;  ///< height and normal from m_heightData
+
    Real m_mapMinZ;	///< Minimum terrain z value.
    Real m_mapMaxZ;	///< Maximum terrain z value.
 
+   std::vector<UnsignedByte> m_heightData {};  ///< logic copy of the height samples, m_mapDX by m_mapDY
+   Int m_heightBorder {};                      ///< border size of m_heightData, in samples
+
 };  // end LinuxTerrainLogic
 
 #endif  // end __LINUXTERRAINLOGIC_H_
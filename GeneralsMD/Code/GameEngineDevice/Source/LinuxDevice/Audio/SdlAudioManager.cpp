@@ -41,6 +41,7 @@
 // #include "GameClient/DebugDisplay.h"
 // #include "GameClient/Drawable.h"
 #include "GameClient/GameClient.h"
+#include "GameClient/View.h"
 #include "GameClient/VideoPlayer.h"
 // #include "GameClient/View.h"
 
@@ -456,6 +457,7 @@ void SdlAudioManager::update()
 {
    AudioManager::update();
    // setDeviceListenerPosition();
+   m_audioCache->update();
    processRequestList();
    processPlayingList();
    processFadingList();
@@ -485,16 +487,15 @@ void SdlAudioManager::stopAudio(AudioAffect which)
       }
    }
 
-   // if (BitTest(which, AudioAffect_Sound3D)) {
-   //    for (it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); ++it) {
-   //       playing = *it;
-   //       if (playing) {
-   //          AIL_register_3D_EOS_callback(playing->m_3DSample, NULL);
-   //          AIL_stop_3D_sample(playing->m_3DSample);
-   //          playing->m_status = PS_Stopped;
-   //       }
-   //    }
-   // }
+   if (BitTest(which, AudioAffect_Sound3D)) {
+      for (it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); ++it) {
+         playing = *it;
+         if (playing) {
+            m_mixer.stopVoice(playing->m_voice);
+            playing->m_status = PS_Stopped;
+         }
+      }
+   }
 
    if (BitTest(which, AudioAffect_Speech | AudioAffect_Music)) {
       for (it = m_playingStreams.begin(); it != m_playingStreams.end(); ++it) {
@@ -518,109 +519,105 @@ void SdlAudioManager::stopAudio(AudioAffect which)
 //-------------------------------------------------------------------------------------------------
 void SdlAudioManager::pauseAudio( AudioAffect which )
 {
-   (void) which;
-   DEBUG_LOG(("### SdlAudioManager::pauseAudio\n"));
-   // std::list<PlayingAudio *>::iterator it;
+   std::list<PlayingAudio *>::iterator it;
 
-   // PlayingAudio *playing = NULL;
-   // if (BitTest(which, AudioAffect_Sound)) {
-   //    for (it = m_playingSounds.begin(); it != m_playingSounds.end(); ++it) {
-   //       playing = *it;
-   //       if (playing) {
-   //          AIL_stop_sample(playing->m_sample);
-   //       }
-   //    }
-   // }
+   PlayingAudio *playing = NULL;
+   if (BitTest(which, AudioAffect_Sound)) {
+      for (it = m_playingSounds.begin(); it != m_playingSounds.end(); ++it) {
+         playing = *it;
+         if (playing) {
+            m_mixer.setVoicePaused(playing->m_voice, true);
+         }
+      }
+   }
 
-   // if (BitTest(which, AudioAffect_Sound3D)) {
-   //    for (it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); ++it) {
-   //       playing = *it;
-   //       if (playing) {
-   //          AIL_stop_3D_sample(playing->m_3DSample);
-   //       }
-   //    }
-   // }
+   if (BitTest(which, AudioAffect_Sound3D)) {
+      for (it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); ++it) {
+         playing = *it;
+         if (playing) {
+            m_mixer.setVoicePaused(playing->m_voice, true);
+         }
+      }
+   }
 
-   // if (BitTest(which, AudioAffect_Speech | AudioAffect_Music)) {
-   //    for (it = m_playingStreams.begin(); it != m_playingStreams.end(); ++it) {
-   //       playing = *it;
-   //       if (playing) {
-   //          if (playing->m_audioEventRTS->getAudioEventInfo()->m_soundType == AT_Music) {
-   //             if (!BitTest(which, AudioAffect_Music)) {
-   //                continue;
-   //             }
-   //          } else {
-   //             if (!BitTest(which, AudioAffect_Speech)) {
-   //                continue;
-   //             }
-   //          }
+   if (BitTest(which, AudioAffect_Speech | AudioAffect_Music)) {
+      for (it = m_playingStreams.begin(); it != m_playingStreams.end(); ++it) {
+         playing = *it;
+         if (playing) {
+            if (playing->m_audioEventRTS->getAudioEventInfo()->m_data.m_soundType == AT_Music) {
+               if (!BitTest(which, AudioAffect_Music)) {
+                  continue;
+               }
+            } else {
+               if (!BitTest(which, AudioAffect_Speech)) {
+                  continue;
+               }
+            }
 
-   //          AIL_pause_stream(playing->m_stream, 1);
-   //       }
-   //    }
-   // }
+            m_mixer.setVoicePaused(playing->m_voice, true);
+         }
+      }
+   }
    
-   // //Get rid of PLAY audio requests when pausing audio.
-   // std::list<AudioRequest*>::iterator ait;
-   // for (ait = m_audioRequests.begin(); ait != m_audioRequests.end(); /* empty */) 
-   // {
-   //    AudioRequest *req = (*ait);
-   //    if( req && req->m_request == AR_Play ) 
-   //    {
-   //       req->deleteInstance();
-   //       ait = m_audioRequests.erase(ait);
-   //    }
-   //    else
-   //    {
-   //       ait++;
-   //    }
-   // }
+   //Get rid of PLAY audio requests when pausing audio.
+   std::list<AudioRequest*>::iterator ait;
+   for (ait = m_audioRequests.begin(); ait != m_audioRequests.end(); /* empty */) 
+   {
+      AudioRequest *req = (*ait);
+      if( req && req->m_request == AR_Play ) 
+      {
+         req->deleteInstance();
+         ait = m_audioRequests.erase(ait);
+      }
+      else
+      {
+         ait++;
+      }
+   }
 }
 
 
 //-------------------------------------------------------------------------------------------------
 void SdlAudioManager::resumeAudio( AudioAffect which )
 {
-   (void) which;
-   DEBUG_LOG(("### SdlAudioManager::resumeAudio\n"));
-   // std::list<PlayingAudio *>::iterator it;
+   std::list<PlayingAudio *>::iterator it;
 
-   // PlayingAudio *playing = NULL;
-   // if (BitTest(which, AudioAffect_Sound)) {
-   //    for (it = m_playingSounds.begin(); it != m_playingSounds.end(); ++it) {
-   //       playing = *it;
-   //       if (playing) {
-   //          AIL_resume_sample(playing->m_sample);
-   //       }
-   //    }
-   // }
+   PlayingAudio *playing = NULL;
+   if (BitTest(which, AudioAffect_Sound)) {
+      for (it = m_playingSounds.begin(); it != m_playingSounds.end(); ++it) {
+         playing = *it;
+         if (playing) {
+            m_mixer.setVoicePaused(playing->m_voice, false);
+         }
+      }
+   }
 
-   // if (BitTest(which, AudioAffect_Sound3D)) {
-   //    for (it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); ++it) {
-   //       playing = *it;
-   //       if (playing) {
-   //          AIL_resume_3D_sample(playing->m_3DSample);
-   //       }
-   //    }
-   // }
+   if (BitTest(which, AudioAffect_Sound3D)) {
+      for (it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); ++it) {
+         playing = *it;
+         if (playing) {
+            m_mixer.setVoicePaused(playing->m_voice, false);
+         }
+      }
+   }
 
-   // if (BitTest(which, AudioAffect_Speech | AudioAffect_Music)) {
-   //    for (it = m_playingStreams.begin(); it != m_playingStreams.end(); ++it) {
-   //       playing = *it;
-   //       if (playing) {
-   //          if (playing->m_audioEventRTS->getAudioEventInfo()->m_soundType == AT_Music) {
-   //             if (!BitTest(which, AudioAffect_Music)) {
-   //                continue;
-   //             }
-   //          } else {
-   //             if (!BitTest(which, AudioAffect_Speech)) {
-   //                continue;
-   //             }
-   //          }
-   //          AIL_pause_stream(playing->m_stream, 0);
-   //       }
-   //    }
-   // }
+   if (BitTest(which, AudioAffect_Speech | AudioAffect_Music)) {
+      for (it = m_playingStreams.begin(); it != m_playingStreams.end(); ++it) {
+         playing = *it;
+         if (playing) {
+            if (playing->m_audioEventRTS->getAudioEventInfo()->m_data.m_soundType == AT_Music) {
+               if (!BitTest(which, AudioAffect_Music)) {
+                  continue;
+               }
+            } else {
+               if (!BitTest(which, AudioAffect_Speech)) {
+                  continue;
+               }
+            }
+            m_mixer.setVoicePaused(playing->m_voice, false);
+         }
+      }
+   }
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -717,72 +714,69 @@ void SdlAudioManager::playAudioEvent(AudioEventRTS* event)
          #ifdef INTENSIVE_AUDIO_DEBUG
             DEBUG_LOG((" Positional\n"));
          #endif
-//             Bool foundSoundToReplace = false;
-//             if (handleToKill) 
-//             {
-//                for (it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); ++it) {
-//                   playing = (*it);
-//                   if (!playing) {
-//                      continue;
-//                   }
-
-//                   if( playing->m_audioEventRTS && playing->m_audioEventRTS->getPlayingHandle() == handleToKill ) 
-//                   {
-//                      //Release this 3D sound channel immediately because we are going to play another sound in it's place.
-//                      releasePlayingAudio(playing);
-//                      m_playing3DSounds.erase(it);
-//                      foundSoundToReplace = true;
-//                      break;
-//                   }
-//                }
-//             }
+            Bool foundSoundToReplace = false;
+            if (handleToKill) 
+            {
+               for (it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); ++it) {
+                  playing = (*it);
+                  if (!playing) {
+                     continue;
+                  }
+
+                  if( playing->m_audioEventRTS && playing->m_audioEventRTS->getPlayingHandle() == handleToKill ) 
+                  {
+                     //Release this 3D sound channel immediately because we are going to play another sound in it's place.
+                     releasePlayingAudio(playing);
+                     m_playing3DSounds.erase(it);
+                     foundSoundToReplace = true;
+                     break;
+                  }
+               }
+            }
             
-//             H3DSAMPLE sample3D;
-//             if( !handleToKill || foundSoundToReplace )
-//             {
-//                sample3D = getFirst3DSample( event );
-//                if( !sample3D )
-//                {
-//                   //If we don't have an available sample, kill the lowest priority assuming we have one that is lower
-//                   //than the sound we are trying to add. One possibility for strangeness is when an interrupt sound
-//                   //that wants to kill a handle to replace it, it's possible that another request already killed it,
-//                   //in which case we need to attempt to find another sound to kill.
-//                   if( killLowestPrioritySoundImmediately( event ) )
-//                   {
-//                      sample3D = getFirst3DSample( event );
-//                   }
-//                }
-//             } 
-//             else 
-//             {
-//                sample3D = NULL;
-//             }
-//             // Push it onto the list of playing things
-//             audio->m_audioEventRTS = event; 
-//             audio->m_3DSample = sample3D;
-//             audio->m_file = NULL;
-//             audio->m_type = PAT_3DSample;
-//             m_playing3DSounds.push_back(audio);
-
-//             if (sample3D) {
-//                audio->m_file = playSample3D(event, sample3D);
-//                m_sound->notifyOf3DSampleStart();
-//             }
-
-//             if( !audio->m_file ) 
-//             {
-//                m_playing3DSounds.pop_back();
-//                #ifdef INTENSIVE_AUDIO_DEBUG
-//                   DEBUG_LOG((" Killed (no handles available)\n"));
-//                #endif
-//             } 
-//             else 
-//             {
-//                audio = NULL;
-//                #ifdef INTENSIVE_AUDIO_DEBUG
-//                   DEBUG_LOG((" Playing.\n"));
-//                #endif
-//             }
+            H3DSAMPLE sample3D {0};
+            if( !handleToKill || foundSoundToReplace )
+            {
+               sample3D = getFirst3DSample( event );
+               if( !sample3D )
+               {
+                  //If we don't have an available sample, kill the lowest priority assuming we have one that is lower
+                  //than the sound we are trying to add. One possibility for strangeness is when an interrupt sound
+                  //that wants to kill a handle to replace it, it's possible that another request already killed it,
+                  //in which case we need to attempt to find another sound to kill.
+                  if( killLowestPrioritySoundImmediately( event ) )
+                  {
+                     sample3D = getFirst3DSample( event );
+                  }
+               }
+            } 
+
+            // Push it onto the list of playing things
+            audio->m_audioEventRTS = event; 
+            audio->m_3DSample = sample3D;
+            audio->m_openFile = NULL;
+            audio->m_type = PAT_3DSample;
+            m_playing3DSounds.push_back(audio);
+
+            if (sample3D) {
+               playSample3D(event, audio); // Will set audio->m_openFile
+               m_sound->notifyOf3DSampleStart();
+            }
+
+            if( !audio->m_openFile ) 
+            {
+               m_playing3DSounds.pop_back();
+               #ifdef INTENSIVE_AUDIO_DEBUG
+                  DEBUG_LOG((" Killed (no handles available)\n"));
+               #endif
+            } 
+            else 
+            {
+               audio = NULL;
+               #ifdef INTENSIVE_AUDIO_DEBUG
+                  DEBUG_LOG((" Playing.\n"));
+               #endif
+            }
          } 
          else 
          {
@@ -830,16 +824,16 @@ void SdlAudioManager::playAudioEvent(AudioEventRTS* event)
             // Push it onto the list of playing things
             audio->m_audioEventRTS = event; 
             audio->m_sample = sample;
-            audio->m_audioBuf = NULL;
+            audio->m_openFile = NULL;
             audio->m_type = PAT_Sample;
             m_playingSounds.push_back(audio);
 
             if (sample) {
-               playSample(event, audio); // Will set audio->m_audioBuf
+               playSample(event, audio); // Will set audio->m_openFile
                m_sound->notifyOf2DSampleStart();
             }
 
-            if (!audio->m_audioBuf) {
+            if (!audio->m_openFile) {
                #ifdef INTENSIVE_AUDIO_DEBUG
                   DEBUG_LOG((" - Sound killed (no handles available)\n"));
                #endif
@@ -955,21 +949,21 @@ void SdlAudioManager::killAudioEventImmediately(AudioHandle audioEvent)
 
    //Look for matching 3D sound to kill
    std::list<PlayingAudio *>::iterator it;
-   // for( it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); it++ ) 
-   // {
-   //    PlayingAudio *audio = (*it);
-   //    if( !audio ) 
-   //    {
-   //       continue;
-   //    }
+   for( it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); it++ ) 
+   {
+      PlayingAudio *audio = (*it);
+      if( !audio ) 
+      {
+         continue;
+      }
 
-   //    if( audio->m_audioEventRTS->getPlayingHandle() == audioEvent ) 
-   //    {
-   //       releasePlayingAudio( audio );
-   //       m_playing3DSounds.erase( it );
-   //       return;
-   //    }
-   // }
+      if( audio->m_audioEventRTS->getPlayingHandle() == audioEvent ) 
+      {
+         releasePlayingAudio( audio );
+         m_playing3DSounds.erase( it );
+         return;
+      }
+   }
 
    //Look for matching 2D sound to kill
    for (it = m_playingSounds.begin(); it != m_playingSounds.end(); it++) {
@@ -1015,12 +1009,6 @@ OpenAudioFile* SdlAudioManager::loadFileForRead(AudioEventRTS* eventToLoadFrom)
    return m_audioCache->openFile(eventToLoadFrom);
 }
 
-//-------------------------------------------------------------------------------------------------
-void SdlAudioManager::releaseBuffer(UnsignedByte* buffer)
-{
-   m_audioCache->releaseBuffer(buffer);
-}
-
 
 //-------------------------------------------------------------------------------------------------
 PlayingAudio *SdlAudioManager::allocatePlayingAudio( void )
@@ -1035,7 +1023,7 @@ PlayingAudio *SdlAudioManager::allocatePlayingAudio( void )
 void SdlAudioManager::releaseHandle(PlayingAudio* release)
 {
 #ifdef INTENSIVE_AUDIO_DEBUG
-   DEBUG_LOG(("SdlAudioManager::releaseHandle: 2D = %d, 3D = ?, Stream = 0x%lx ", release->m_sample, reinterpret_cast<intptr_t>(release->m_stream)));
+   DEBUG_LOG(("SdlAudioManager::releaseHandle: 2D = %d, 3D = %d, Stream = 0x%lx ", release->m_sample, release->m_3DSample, reinterpret_cast<intptr_t>(release->m_stream)));
 #endif
    switch (release->m_type)
    {
@@ -1045,9 +1033,7 @@ void SdlAudioManager::releaseHandle(PlayingAudio* release)
    DEBUG_LOG(("(type = 2D)\n"));
 #endif
          if (release->m_sample) {
-            // FIXME: Stop the audio for this stream.
-            // AIL_stop_sample(release->m_sample);
-            SDL_DestroyAudioStream(release->m_sdlStream);
+            m_mixer.stopVoice(release->m_voice);
             m_availableSamples.push_back(release->m_sample);
          }
          break;
@@ -1057,11 +1043,10 @@ void SdlAudioManager::releaseHandle(PlayingAudio* release)
 #ifdef INTENSIVE_AUDIO_DEBUG
    DEBUG_LOG(("(type = 3D)\n"));
 #endif
-         // if (release->m_3DSample) {
-         //    AIL_register_3D_EOS_callback(release->m_3DSample, NULL);
-         //    AIL_stop_3D_sample(release->m_3DSample);
-         //    m_available3DSamples.push_back(release->m_3DSample);
-         // }
+         if (release->m_3DSample) {
+            m_mixer.stopVoice(release->m_voice);
+            m_available3DSamples.push_back(release->m_3DSample);
+         }
          break;
       }
       case PAT_Stream:
@@ -1069,6 +1054,7 @@ void SdlAudioManager::releaseHandle(PlayingAudio* release)
 #ifdef INTENSIVE_AUDIO_DEBUG
    DEBUG_LOG(("(type = Stream)\n"));
 #endif
+         m_mixer.stopVoice(release->m_voice);
          if (release->m_stream) {
             Sound_FreeSample(release->m_stream);
          }
@@ -1080,6 +1066,7 @@ void SdlAudioManager::releaseHandle(PlayingAudio* release)
 #endif
          break;
    }
+   release->m_voice = INVALID_MIXER_VOICE;
    release->m_type = PAT_INVALID;
 }
 
@@ -1098,7 +1085,10 @@ void SdlAudioManager::releasePlayingAudio(PlayingAudio* release)
       }
    }
    releaseHandle(release); // forces stop of this audio
-   releaseBuffer(release->m_audioBuf);
+   if (release->m_openFile) {
+      m_audioCache->closeFile(release->m_openFile);
+      release->m_openFile = NULL;
+   }
    if (release->m_cleanupAudioEventRTS) {
       releaseAudioEventRTS(release->m_audioEventRTS);
    }
@@ -1178,9 +1168,6 @@ void SdlAudioManager::freeAllHandles()
    
    std::list<H3DSAMPLE>::iterator it3D;
    for ( it3D = m_available3DSamples.begin(); it3D != m_available3DSamples.end(); /* empty */ ) {
-      // FIXME: Maybe need to release_sample_handle
-      // H3DSAMPLE sample3D = *it3D;
-      // AIL_release_3D_sample_handle(sample3D);
       it3D = m_available3DSamples.erase(it3D);
    }
    m_num3DSamples = 0;
@@ -1202,18 +1189,16 @@ HSAMPLE SdlAudioManager::getFirst2DSample(AudioEventRTS* /* event */)
 }
 
 //-------------------------------------------------------------------------------------------------
-H3DSAMPLE SdlAudioManager::getFirst3DSample( AudioEventRTS *event )
+H3DSAMPLE SdlAudioManager::getFirst3DSample( AudioEventRTS * /* event */ )
 {
-   (void) event;
-   DEBUG_LOG(("### SdlAudioManager::getFirst3DSample\n"));
-   // if (m_available3DSamples.begin() != m_available3DSamples.end()) {
-   //    H3DSAMPLE retSample = *m_available3DSamples.begin();
-   //    m_available3DSamples.erase(m_available3DSamples.begin());
-   //    return (retSample);
-   // }
+   if (m_available3DSamples.begin() != m_available3DSamples.end()) {
+      H3DSAMPLE retSample = *m_available3DSamples.begin();
+      m_available3DSamples.erase(m_available3DSamples.begin());
+      return (retSample);
+   }
 
    // Find the first sample of lower priority than my augmented priority that is interruptable and take its handle
-   return NULL;
+   return 0;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -1224,22 +1209,14 @@ void SdlAudioManager::adjustPlayingVolume(PlayingAudio *audio)
 #endif
    Real desiredVolume = audio->m_audioEventRTS->getVolume() * audio->m_audioEventRTS->getVolumeShift();
    if (audio->m_type == PAT_Sample) {
-      if (!SDL_SetAudioStreamGain(audio->m_sdlStream, m_soundVolume * desiredVolume)) {
-         DEBUG_CRASH(("SdlAudioManager::adjustPlayingVolume: couldn't set audio stream volume: %s\n", SDL_GetError()));
-      }
+      m_mixer.setVoiceVolume(audio->m_voice, m_soundVolume * desiredVolume);
    } else if (audio->m_type == PAT_3DSample) { 
-      if (!SDL_SetAudioStreamGain(audio->m_sdlStream, m_sound3DVolume * desiredVolume)) {
-         DEBUG_CRASH(("SdlAudioManager::adjustPlayingVolume: couldn't set audio stream volume: %s\n", SDL_GetError()));
-      }
+      // Positional sounds have their volume recomputed every frame in processPlayingList.
    } else if (audio->m_type == PAT_Stream) {
       if (audio->m_audioEventRTS->getAudioEventInfo()->m_data.m_soundType == AT_Music ) {
-         if (!SDL_SetAudioStreamGain(audio->m_sdlStream, m_musicVolume * desiredVolume)) {
-            DEBUG_CRASH(("SdlAudioManager::adjustPlayingVolume: couldn't set audio stream volume: %s\n", SDL_GetError()));
-         }
+         m_mixer.setVoiceVolume(audio->m_voice, m_musicVolume * desiredVolume);
       } else {
-         if (!SDL_SetAudioStreamGain(audio->m_sdlStream, m_speechVolume * desiredVolume)) {
-            DEBUG_CRASH(("SdlAudioManager::adjustPlayingVolume: couldn't set audio stream volume: %s\n", SDL_GetError()));
-         }
+         m_mixer.setVoiceVolume(audio->m_voice, m_speechVolume * desiredVolume);
       }
    }
 }
@@ -1277,18 +1254,14 @@ void SdlAudioManager::initFilters(PlayingAudio* playing, const AudioEventRTS* ev
 #endif
 
    // set the sample volume
-   if (!SDL_SetAudioStreamGain(playing->m_sdlStream, volume)) {
-      DEBUG_CRASH(("SdlAudioManager::initFilters: couldn't set audio stream volume: %s\n", SDL_GetError()));
-   }
+   m_mixer.setVoiceGain(playing->m_voice, volume, 0.0f);
 
    // pitch shift
    Real pitchShift = event->getPitchShift();
    if (pitchShift == 0.0f) {
       DEBUG_CRASH(("Invalid Pitch shift in sound: '%s'", event->getEventName().str()) );
    } else {
-      if (!SDL_SetAudioStreamFrequencyRatio(playing->m_sdlStream, pitchShift)) {
-         DEBUG_CRASH(("SdlAudioManager::initFilters: couldn't set audio stream pitch: %s\n", SDL_GetError()));
-      }
+      m_mixer.setVoicePitch(playing->m_voice, pitchShift);
    }
 
    // set up delay filter, if applicable
@@ -1306,28 +1279,57 @@ void SdlAudioManager::initFilters(PlayingAudio* playing, const AudioEventRTS* ev
 }
 
 //-------------------------------------------------------------------------------------------------
-void SdlAudioManager::initFilters3D( H3DSAMPLE sample, const AudioEventRTS *event, const Coord3D *pos )
+void SdlAudioManager::initFilters3D( PlayingAudio *sample, AudioEventRTS *event, const Coord3D *pos )
 {
-   (void) sample;
-   (void) event;
-   (void) pos;
-   DEBUG_LOG(("### SdlAudioManager::initFilters3D\n"));
-   // // set the sample volume
-   // Real volume = event->getVolume() * event->getVolumeShift() * m_sound3DVolume;
-   // AIL_set_3D_sample_volume(sample, volume);
+   // set the sample volume and position
+   m_mixer.setVoiceGain(sample->m_voice, getEffectiveVolume(event), getPan(pos));
 
-   // // pitch shift
-   // Real pitchShift = event->getPitchShift();
-   // if (pitchShift == 0.0f) {
-   //    DEBUG_CRASH(("Invalid Pitch shift in sound: '%s'", event->getEventName().str()) );
-   // } else {
-   //    AIL_set_3D_sample_playback_rate(sample, REAL_TO_INT(AIL_3D_sample_playback_rate(sample) * pitchShift));
-   // }
+   // pitch shift
+   Real pitchShift = event->getPitchShift();
+   if (pitchShift == 0.0f) {
+      DEBUG_CRASH(("Invalid Pitch shift in sound: '%s'", event->getEventName().str()) );
+   } else {
+      m_mixer.setVoicePitch(sample->m_voice, pitchShift);
+   }
    
-   // // Low pass filter
-   // if (event->getAudioEventInfo()->m_lowPassFreq > 0 && !isOnScreen(pos) ) {
-   //    AIL_set_3D_sample_occlusion(sample, 1.0f - event->getAudioEventInfo()->m_lowPassFreq);
-   // }
+   // Low pass filter; off screen sounds are muffled down to their LowPassCutoff.
+   if (event->getAudioEventInfo()->m_data.m_lowPassFreq > 0 && !isOnScreen(pos) ) {
+      m_mixer.setVoiceLowPass(sample->m_voice, event->getAudioEventInfo()->m_data.m_lowPassFreq);
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Where pos sits between the listener's left (-1) and right (1). Sounds inside their minimum
+  * distance are pulled towards the middle, so one right on top of the listener doesn't jump from
+  * ear to ear. */
+Real SdlAudioManager::getPan(const Coord3D *pos) const
+{
+   if (!pos) {
+      return 0.0f;
+   }
+
+   Real dx = pos->x - m_listenerPosition.x;
+   Real dy = pos->y - m_listenerPosition.y;
+   Real planarDistance = sqrtf(dx * dx + dy * dy);
+   if (planarDistance < 1.0f) {
+      return 0.0f;
+   }
+
+   // The listener looks along m_listenerOrientation with +z up, so its right hand is (y, -x).
+   Real facingLength = sqrtf(m_listenerOrientation.x * m_listenerOrientation.x + m_listenerOrientation.y * m_listenerOrientation.y);
+   if (facingLength <= 0.0f) {
+      return 0.0f;
+   }
+
+   Real side = (dx * m_listenerOrientation.y - dy * m_listenerOrientation.x) / facingLength;
+   Real pan = side / planarDistance;
+
+   Real minDistance = getAudioSettings()->m_globalMinRange;
+   if (minDistance > 0.0f && planarDistance < minDistance) {
+      pan *= planarDistance / minDistance;
+   }
+
+   return clamp(-1.0f, pan, 1.0f);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -1488,6 +1490,11 @@ void SdlAudioManager::openDevice( void )
    }
 #endif
 
+   if (m_device && !m_mixer.open(m_device, audioSettings->m_outputRate)) {
+      SDL_CloseAudioDevice(m_device);
+      m_device = 0;
+   }
+
    if (m_device) {
       buildProviderList();
    } else {
@@ -1512,6 +1519,7 @@ void SdlAudioManager::closeDevice()
 {
    freeAllHandles();
    unselectProvider();
+   m_mixer.close();
    SDL_CloseAudioDevice(m_device);
 }
 
@@ -1607,7 +1615,7 @@ void SdlAudioManager::notifyOfAudioCompletion(uintptr_t audioCompleted, Unsigned
    //    } 
    // }
 
-   if (playing->m_type == PAT_Stream) {
+   if (playing->m_type == PAT_Stream && playing->m_stream && !m_mixer.isVoiceDone(playing->m_voice)) {
       if (playing->m_audioEventRTS->getAudioEventInfo()->m_data.m_soundType == AT_Music) {
       #ifdef INTENSIVE_AUDIO_DEBUG
          DEBUG_LOG(("Restarting music: %s\n", playing->m_audioEventRTS->getFilename().str()));
@@ -1618,7 +1626,7 @@ void SdlAudioManager::notifyOfAudioCompletion(uintptr_t audioCompleted, Unsigned
          }
          playing->m_streamEof = false;
          UnsignedInt bytesDecoded {Sound_Decode(playing->m_stream)};
-         SDL_PutAudioStreamData(playing->m_sdlStream, playing->m_stream->buffer, static_cast<int>(bytesDecoded));
+         m_mixer.queueStreamData(playing->m_voice, playing->m_stream->buffer, static_cast<int>(bytesDecoded));
 
          return;
       }
@@ -1643,15 +1651,15 @@ PlayingAudio *SdlAudioManager::findPlayingAudioFrom(uintptr_t audioCompleted, Un
       }
    }
 
-   // if (flags == PAT_3DSample) {
-   //    H3DSAMPLE sample3D = (H3DSAMPLE) audioCompleted;
-   //    for (it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); ++it) {
-   //       playing = *it;
-   //       if (playing && playing->m_3DSample == sample3D) {
-   //          return playing;
-   //       }
-   //    }
-   // }
+   if (flags == PAT_3DSample) {
+      H3DSAMPLE sample3D = (H3DSAMPLE) audioCompleted;
+      for (it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); ++it) {
+         playing = *it;
+         if (playing && playing->m_3DSample == sample3D) {
+            return playing;
+         }
+      }
+   }
 
    if (flags == PAT_Stream) {
       HSTREAM stream = (HSTREAM) audioCompleted;
@@ -1887,6 +1895,36 @@ UnsignedInt SdlAudioManager::getNumStreams() const
    return m_numStreams;
 }
 
+//-------------------------------------------------------------------------------------------------
+void SdlAudioManager::resetCacheStats()
+{
+   if (m_audioCache) {
+      m_audioCache->resetStats();
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+AsciiString SdlAudioManager::reportCacheStats(Int frames) const
+{
+   AsciiString report;
+   if (!m_audioCache) {
+      return report;
+   }
+
+   const AudioCacheStats& stats = m_audioCache->getStats();
+   UnsignedInt opens = stats.m_hits + stats.m_misses;
+   if (opens == 0) {
+      return report;
+   }
+
+   report.format("  audio cache: %u opens (%.2f/frame), %u hits, %u misses, %.1f%% hit rate, %u decode failures, %u evictions (%u in use)\n"
+      "  audio cache: %u decodes, %.2fms average, %.2fms max; ready after %.2fms average, %.2fms max\n",
+      opens, frames > 0 ? (double)opens / frames : 0.0, stats.m_hits, stats.m_misses, stats.getHitRate() * 100.0f,
+      stats.m_decodeFailures, stats.m_evictions, stats.m_evictedInUse,
+      stats.m_decodes, stats.getAverageDecodeMS(), stats.m_maxDecodeMS, stats.getAverageLatencyMS(), stats.m_maxLatencyMS);
+   return report;
+}
+
 //-------------------------------------------------------------------------------------------------
 Bool SdlAudioManager::doesViolateLimit(AudioEventRTS* event) const
 {
@@ -1974,7 +2012,6 @@ Bool SdlAudioManager::doesViolateLimit(AudioEventRTS* event) const
 //-------------------------------------------------------------------------------------------------
 Bool SdlAudioManager::isPlayingAlready( AudioEventRTS *event ) const
 {
-   DEBUG_LOG(("### SdlAudioManager::isPlayingAlready\n"));
    std::list<PlayingAudio *>::const_iterator it;
    if (!event->isPositionalAudio()) {
       // 2-D
@@ -1983,13 +2020,13 @@ Bool SdlAudioManager::isPlayingAlready( AudioEventRTS *event ) const
             return true;
          }
       }
-   // } else {
-   //    // 3-D
-   //    for ( it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); ++it ) {
-   //       if ((*it)->m_audioEventRTS->getEventName() == event->getEventName()) {
-   //          return true;
-   //       }
-   //    }
+   } else {
+      // 3-D
+      for ( it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); ++it ) {
+         if ((*it)->m_audioEventRTS->getEventName() == event->getEventName()) {
+            return true;
+         }
+      }
    }
 
    return false;
@@ -1998,7 +2035,6 @@ Bool SdlAudioManager::isPlayingAlready( AudioEventRTS *event ) const
 //-------------------------------------------------------------------------------------------------
 Bool SdlAudioManager::isObjectPlayingVoice(UnsignedInt objID) const
 {
-   DEBUG_LOG(("### SdlAudioManager::isObjectPlayingVoice\n"));
    if (objID == 0) {
       return false;
    }
@@ -2011,12 +2047,12 @@ Bool SdlAudioManager::isObjectPlayingVoice(UnsignedInt objID) const
       }
    }
 
-   // // 3-D
-   // for ( it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); ++it ) {
-   //    if ((*it)->m_audioEventRTS->getObjectID() == objID && (*it)->m_audioEventRTS->getAudioEventInfo()->m_type & ST_VOICE) {
-   //       return true;
-   //    }
-   // }
+   // 3-D
+   for ( it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); ++it ) {
+      if ((*it)->m_audioEventRTS->getObjectID() == objID && (*it)->m_audioEventRTS->getAudioEventInfo()->m_data.m_type & ST_VOICE) {
+         return true;
+      }
+   }
 
    return false;
 }
@@ -2024,7 +2060,6 @@ Bool SdlAudioManager::isObjectPlayingVoice(UnsignedInt objID) const
 //-------------------------------------------------------------------------------------------------
 AudioEventRTS* SdlAudioManager::findLowestPrioritySound(AudioEventRTS *event)
 {
-   DEBUG_LOG(("### SdlAudioManager::findLowestPrioritySound\n"));
    AudioPriority priority = event->getAudioEventInfo()->m_data.m_priority;
    if( priority == AP_LOWEST )
    {
@@ -2035,49 +2070,25 @@ AudioEventRTS* SdlAudioManager::findLowestPrioritySound(AudioEventRTS *event)
    AudioEventRTS *lowestPriorityEvent = NULL;
    AudioPriority lowestPriority;
 
+   const std::list<PlayingAudio *>& playingList = event->isPositionalAudio() ? m_playing3DSounds : m_playingSounds;
    std::list<PlayingAudio *>::const_iterator it;
-   // if( event->isPositionalAudio() ) 
-   // {
-   //    //3D
-   //    for( it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); ++it ) 
-   //    {
-   //       AudioEventRTS *itEvent = (*it)->m_audioEventRTS;
-   //       AudioPriority itPriority = itEvent->getAudioEventInfo()->m_priority;
-   //       if( itPriority < priority ) 
-   //       {
-   //          if( !lowestPriorityEvent || lowestPriority > itPriority )
-   //          {
-   //             lowestPriorityEvent = itEvent;
-   //             lowestPriority = itPriority;
-   //             if( lowestPriority == AP_LOWEST )
-   //             {
-   //                return lowestPriorityEvent;
-   //             }
-   //          }
-   //       }
-   //    }
-   // } 
-   // else 
-   // {
-      //2D
-      for( it = m_playingSounds.begin(); it != m_playingSounds.end(); ++it ) 
+   for( it = playingList.begin(); it != playingList.end(); ++it ) 
+   {
+      AudioEventRTS *itEvent = (*it)->m_audioEventRTS;
+      AudioPriority itPriority = itEvent->getAudioEventInfo()->m_data.m_priority;
+      if( itPriority < priority ) 
       {
-         AudioEventRTS *itEvent = (*it)->m_audioEventRTS;
-         AudioPriority itPriority = itEvent->getAudioEventInfo()->m_data.m_priority;
-         if( itPriority < priority ) 
+         if( !lowestPriorityEvent || lowestPriority > itPriority )
          {
-            if( !lowestPriorityEvent || lowestPriority > itPriority )
+            lowestPriorityEvent = itEvent;
+            lowestPriority = itPriority;
+            if( lowestPriority == AP_LOWEST )
             {
-               lowestPriorityEvent = itEvent;
-               lowestPriority = itPriority;
-               if( lowestPriority == AP_LOWEST )
-               {
-                  return lowestPriorityEvent;
-               }
+               return lowestPriorityEvent;
             }
          }
       }
-   // }
+   }
    return lowestPriorityEvent;
 }
 
@@ -2123,51 +2134,29 @@ Bool SdlAudioManager::isPlayingLowerPriority( AudioEventRTS *event ) const
 //-------------------------------------------------------------------------------------------------
 Bool SdlAudioManager::killLowestPrioritySoundImmediately( AudioEventRTS *event )
 {
-   DEBUG_LOG(("### SdlAudioManager::killLowestPrioritySoundImmediately\n"));
    //Actually, we want to kill the LOWEST PRIORITY SOUND, not the first "lower" priority
    //sound we find, because it could easily be 
    AudioEventRTS *lowestPriorityEvent = findLowestPrioritySound( event );
    if( lowestPriorityEvent )
    {
+      std::list<PlayingAudio *>& playingList = event->isPositionalAudio() ? m_playing3DSounds : m_playingSounds;
       std::list<PlayingAudio *>::iterator it;
-   //    if( event->isPositionalAudio() )
-   //    {
-   //       for( it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); ++it ) 
-   //       {
-   //          PlayingAudio *playing = (*it);
-   //          if( !playing ) 
-   //          {
-   //             continue;
-   //          }
-
-   //          if( playing->m_audioEventRTS && playing->m_audioEventRTS == lowestPriorityEvent ) 
-   //          {
-   //             //Release this 3D sound channel immediately because we are going to play another sound in it's place.
-   //             releasePlayingAudio( playing );
-   //             m_playing3DSounds.erase( it );
-   //             return TRUE;
-   //          }
-   //       }
-   //    }
-   //    else
-   //    {
-         for( it = m_playingSounds.begin(); it != m_playingSounds.end(); ++it ) 
+      for( it = playingList.begin(); it != playingList.end(); ++it ) 
+      {
+         PlayingAudio *playing = (*it);
+         if( !playing ) 
          {
-            PlayingAudio *playing = (*it);
-            if( !playing ) 
-            {
-               continue;
-            }
+            continue;
+         }
 
-            if( playing->m_audioEventRTS && playing->m_audioEventRTS == lowestPriorityEvent ) 
-            {
-               //Release this 3D sound channel immediately because we are going to play another sound in it's place.
-               releasePlayingAudio( playing );
-               m_playing3DSounds.erase( it );
-               return TRUE;
-            }
+         if( playing->m_audioEventRTS && playing->m_audioEventRTS == lowestPriorityEvent ) 
+         {
+            //Release this sound channel immediately because we are going to play another sound in it's place.
+            releasePlayingAudio( playing );
+            playingList.erase( it );
+            return TRUE;
          }
-   //    }
+      }
    }
    return FALSE;
 }
@@ -2176,8 +2165,6 @@ Bool SdlAudioManager::killLowestPrioritySoundImmediately( AudioEventRTS *event )
 //-------------------------------------------------------------------------------------------------
 void SdlAudioManager::adjustVolumeOfPlayingAudio(AsciiString eventName, Real newVolume)
 {
-   DEBUG_LOG(("### SdlAudioManager::adjustVolumeOfPlayingAudio\n"));
-   // Real pan;
    std::list<PlayingAudio *>::iterator it;
 
    PlayingAudio *playing = NULL;
@@ -2187,21 +2174,17 @@ void SdlAudioManager::adjustVolumeOfPlayingAudio(AsciiString eventName, Real new
          // Adjust it
          playing->m_audioEventRTS->setVolume(newVolume);
          Real desiredVolume = playing->m_audioEventRTS->getVolume() * playing->m_audioEventRTS->getVolumeShift();
-         if (!SDL_SetAudioStreamGain(playing->m_sdlStream, desiredVolume)) {
-            DEBUG_CRASH(("SdlAudioManager::adjustVolumeOfPlayingAudio: couldn't set audio stream volume: %s\n", SDL_GetError()));
-         }
+         m_mixer.setVoiceVolume(playing->m_voice, desiredVolume);
       }
    }
 
-   // for (it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); ++it) {
-   //    playing = *it;
-   //    if (playing && playing->m_audioEventRTS->getEventName() == eventName) {
-   //       // Adjust it
-   //       playing->m_audioEventRTS->setVolume(newVolume);
-   //       Real desiredVolume = playing->m_audioEventRTS->getVolume() * playing->m_audioEventRTS->getVolumeShift();
-   //       AIL_set_3D_sample_volume(playing->m_3DSample, desiredVolume);
-   //    }
-   // }
+   for (it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); ++it) {
+      playing = *it;
+      if (playing && playing->m_audioEventRTS->getEventName() == eventName) {
+         // Adjust it. The distance is applied on top of this in processPlayingList.
+         playing->m_audioEventRTS->setVolume(newVolume);
+      }
+   }
 
    for (it = m_playingStreams.begin(); it != m_playingStreams.end(); ++it) {
       playing = *it;
@@ -2209,9 +2192,7 @@ void SdlAudioManager::adjustVolumeOfPlayingAudio(AsciiString eventName, Real new
          // Adjust it
          playing->m_audioEventRTS->setVolume(newVolume);
          Real desiredVolume = playing->m_audioEventRTS->getVolume() * playing->m_audioEventRTS->getVolumeShift();
-         if (!SDL_SetAudioStreamGain(playing->m_sdlStream, desiredVolume)) {
-            DEBUG_CRASH(("SdlAudioManager::adjustVolumeOfPlayingAudio: couldn't set audio stream volume: %s\n", SDL_GetError()));
-         }
+         m_mixer.setVoiceVolume(playing->m_voice, desiredVolume);
       }
    }
 }
@@ -2220,7 +2201,6 @@ void SdlAudioManager::adjustVolumeOfPlayingAudio(AsciiString eventName, Real new
 //-------------------------------------------------------------------------------------------------
 void SdlAudioManager::removePlayingAudio(AsciiString eventName)
 {
-   DEBUG_LOG(("### SdlAudioManager::removePlayingAudio\n"));
    std::list<PlayingAudio *>::iterator it;
 
    PlayingAudio *playing = NULL;
@@ -2234,19 +2214,19 @@ void SdlAudioManager::removePlayingAudio(AsciiString eventName)
       }
    }
 
-   // for( it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); ) 
-   // {
-   //    playing = *it;
-   //    if( playing && playing->m_audioEventRTS->getEventName() == eventName ) 
-   //    {
-   //       releasePlayingAudio( playing );
-   //       it = m_playing3DSounds.erase(it);
-   //    }
-   //    else
-   //    {
-   //       it++;
-   //    }
-   // }
+   for( it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); ) 
+   {
+      playing = *it;
+      if( playing && playing->m_audioEventRTS->getEventName() == eventName ) 
+      {
+         releasePlayingAudio( playing );
+         it = m_playing3DSounds.erase(it);
+      }
+      else
+      {
+         it++;
+      }
+   }
 
    for (it = m_playingStreams.begin(); it != m_playingStreams.end();) {
       playing = *it;
@@ -2262,7 +2242,6 @@ void SdlAudioManager::removePlayingAudio(AsciiString eventName)
 //-------------------------------------------------------------------------------------------------
 void SdlAudioManager::removeAllDisabledAudio()
 {
-   DEBUG_LOG(("### SdlAudioManager::removeAllDisabledAudio\n"));
    std::list<PlayingAudio *>::iterator it;
 
    PlayingAudio *playing = NULL;
@@ -2276,19 +2255,19 @@ void SdlAudioManager::removeAllDisabledAudio()
       }
    }
 
-   // for( it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); ) 
-   // {
-   //    playing = *it;
-   //    if( playing && playing->m_audioEventRTS->getVolume() == 0.0f ) 
-   //    {
-   //       releasePlayingAudio( playing );
-   //       it = m_playing3DSounds.erase(it);
-   //    }
-   //    else
-   //    {
-   //       it++;
-   //    }
-   // }
+   for( it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); ) 
+   {
+      playing = *it;
+      if( playing && playing->m_audioEventRTS->getVolume() == 0.0f ) 
+      {
+         releasePlayingAudio( playing );
+         it = m_playing3DSounds.erase(it);
+      }
+      else
+      {
+         it++;
+      }
+   }
 
    for (it = m_playingStreams.begin(); it != m_playingStreams.end();) {
       playing = *it;
@@ -2343,9 +2322,16 @@ void SdlAudioManager::processPlayingList()
          continue;
       }
 
-      int bytesAvailable {SDL_GetAudioStreamAvailable(playing->m_sdlStream)};
-      DEBUG_ASSERTCRASH(bytesAvailable >= 0, ("SdlAudioManager::processPlayingList: couldn't get audio stream queue length: %s\n", SDL_GetError()));
-      if (bytesAvailable == 0) {
+      if (playing->m_status == PS_Playing && playing->m_voice == INVALID_MIXER_VOICE && playing->m_openFile) {
+         // Still waiting on the cache to decode the file.
+         if (playing->m_openFile->m_loading) {
+            ++it;
+            continue;
+         }
+         startSample(playing);
+      }
+
+      if (playing->m_status == PS_Playing && m_mixer.isVoiceDone(playing->m_voice)) {
          TheAudio->notifyOfAudioCompletion((uintptr_t) playing->m_sample, PAT_Sample);
       }
 
@@ -2365,72 +2351,75 @@ void SdlAudioManager::processPlayingList()
       }
    }
 
-   // for (it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); ) 
-   // {
-   //    playing = (*it);
-   //    if (!playing) 
-   //    {
-   //       it = m_playing3DSounds.erase(it);
-   //       continue;
-   //    }
+   for (it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); ) 
+   {
+      playing = (*it);
+      if (!playing) 
+      {
+         it = m_playing3DSounds.erase(it);
+         continue;
+      }
 
-   //    if (playing->m_status == PS_Stopped) 
-   //    {
-   //       //m_stoppedAudio.push_back(playing);			
-   //       releasePlayingAudio( playing );
-   //       it = m_playing3DSounds.erase(it);
-   //    } 
-   //    else 
-   //    {
-   //       if (m_volumeHasChanged) 
-   //       {
-   //          adjustPlayingVolume(playing);
-   //       }
+      if (playing->m_status == PS_Playing && playing->m_voice == INVALID_MIXER_VOICE && playing->m_openFile) {
+         if (playing->m_openFile->m_loading) {
+            ++it;
+            continue;
+         }
+         startSample3D(playing);
+      }
 
-   //       const Coord3D *pos = getCurrentPositionFromEvent(playing->m_audioEventRTS);
-   //       if (pos) 
-   //       {
-   //          if( playing->m_audioEventRTS->isDead() )
-   //          {
-   //             stopAudioEvent( playing->m_audioEventRTS->getPlayingHandle() );
-   //             it++;
-   //             continue;
-   //          }
-   //          else
-   //          {
-   //             Real volForConsideration = getEffectiveVolume(playing->m_audioEventRTS);
-   //             volForConsideration /= (m_sound3DVolume > 0.0f ? m_soundVolume : 1.0f);
-   //             Bool playAnyways = BitTest( playing->m_audioEventRTS->getAudioEventInfo()->m_type, ST_GLOBAL) || playing->m_audioEventRTS->getAudioEventInfo()->m_priority == AP_CRITICAL;
-   //             if( volForConsideration < m_audioSettings->m_minVolume && !playAnyways ) 
-   //             {
-   //                // don't want to get an additional callback for this sample
-   //                AIL_register_3D_EOS_callback(playing->m_3DSample, NULL);
-   //                //m_stoppedAudio.push_back(playing);
-   //                releasePlayingAudio( playing );
-   //                it = m_playing3DSounds.erase(it);
-   //                continue;
-   //             } 
-   //             else 
-   //             {
-   //                Real x = pos->x;
-   //                Real y = pos->y;
-   //                Real z = pos->z;
-   //                AIL_set_3D_position( playing->m_3DSample, x, y, z );
-   //             }
-   //          }
-   //       } 
-   //       else 
-   //       {
-   //          AIL_register_3D_EOS_callback(playing->m_3DSample, NULL);
-   //          //m_stoppedAudio.push_back(playing);
-   //          releasePlayingAudio( playing );
-   //          it = m_playing3DSounds.erase(it);
-   //          continue;
-   //       }
+      if (playing->m_status == PS_Playing && m_mixer.isVoiceDone(playing->m_voice)) {
+         TheAudio->notifyOfAudioCompletion((uintptr_t) playing->m_3DSample, PAT_3DSample);
+      }
 
-   //       ++it;
-   //    }
-   // }
+      if (playing->m_status == PS_Stopped) 
+      {
+         //m_stoppedAudio.push_back(playing);			
+         releasePlayingAudio( playing );
+         it = m_playing3DSounds.erase(it);
+      } 
+      else 
+      {
+         const Coord3D *pos = getCurrentPositionFromEvent(playing->m_audioEventRTS);
+         if (pos) 
+         {
+            if( playing->m_audioEventRTS->isDead() )
+            {
+               stopAudioEvent( playing->m_audioEventRTS->getPlayingHandle() );
+               it++;
+               continue;
+            }
+            else
+            {
+               // The volume falls off with distance, so it has to follow the sound and the
+               // listener every frame, whether or not the volume settings changed.
+               Real volume = getEffectiveVolume(playing->m_audioEventRTS);
+               Real volForConsideration = volume / (m_sound3DVolume > 0.0f ? m_sound3DVolume : 1.0f);
+               Bool playAnyways = BitTest( playing->m_audioEventRTS->getAudioEventInfo()->m_data.m_type, ST_GLOBAL) || playing->m_audioEventRTS->getAudioEventInfo()->m_data.m_priority == AP_CRITICAL;
+               if( volForConsideration < getAudioSettings()->m_minVolume && !playAnyways ) 
+               {
+                  //m_stoppedAudio.push_back(playing);
+                  releasePlayingAudio( playing );
+                  it = m_playing3DSounds.erase(it);
+                  continue;
+               } 
+               else 
+               {
+                  m_mixer.setVoiceGain(playing->m_voice, volume, getPan(pos));
+               }
+            }
+         } 
+         else 
+         {
+            //m_stoppedAudio.push_back(playing);
+            releasePlayingAudio( playing );
+            it = m_playing3DSounds.erase(it);
+            continue;
+         }
+
+         ++it;
+      }
+   }
 
    for (it = m_playingStreams.begin(); it != m_playingStreams.end(); ) {
       playing = (*it);
@@ -2440,21 +2429,21 @@ void SdlAudioManager::processPlayingList()
          continue;
       }
 
-      int bytesQueued {SDL_GetAudioStreamQueued(playing->m_sdlStream)};
-      DEBUG_ASSERTCRASH(bytesQueued >= 0, ("SdlAudioManager::processPlayingList: couldn't get audio stream queue length: %s\n", SDL_GetError()));
-      if (bytesQueued < STREAMING_BUFFER_LOW && !playing->m_streamEof) {
+      if (playing->m_stream && m_mixer.getStreamQueued(playing->m_voice) < STREAMING_BUFFER_LOW && !playing->m_streamEof) {
          UnsignedInt bytesDecoded {Sound_Decode(playing->m_stream)};
          if (bytesDecoded > 0) {
-            SDL_PutAudioStreamData(playing->m_sdlStream, playing->m_stream->buffer, static_cast<int>(bytesDecoded));
+            m_mixer.queueStreamData(playing->m_voice, playing->m_stream->buffer, static_cast<int>(bytesDecoded));
          }
          if ((playing->m_stream->flags & SOUND_SAMPLEFLAG_EOF) || (playing->m_stream->flags & SOUND_SAMPLEFLAG_ERROR)) {
             playing->m_streamEof = true;
+            // Let the converter hand over the last of its data
+            m_mixer.flushStream(playing->m_voice);
          }
       }
 
-      int bytesAvailable {SDL_GetAudioStreamAvailable(playing->m_sdlStream)};
-      DEBUG_ASSERTCRASH(bytesAvailable >= 0, ("SdlAudioManager::processPlayingList: couldn't get audio stream available bytes: %s\n", SDL_GetError()));
-      if (bytesAvailable == 0) {
+      // A stream the mixer couldn't start counts as done straight away.
+      Bool streamDone {playing->m_streamEof || !playing->m_stream || m_mixer.isVoiceDone(playing->m_voice)};
+      if (streamDone && playing->m_status == PS_Playing && m_mixer.getStreamAvailable(playing->m_voice) == 0) {
          TheAudio->notifyOfAudioCompletion((uintptr_t) playing->m_stream, PAT_Stream);
       }
 
@@ -2492,27 +2481,26 @@ void SdlAudioManager::processPlayingList()
 
 Bool SdlAudioManager::has3DSensitiveStreamsPlaying( void ) const
 {
-   DEBUG_LOG(("### SdlAudioManager::has3DSensitiveStreamsPlaying\n"));
-//   if ( m_playingStreams.empty() )
-//     return FALSE;
+  if ( m_playingStreams.empty() )
+    return FALSE;
 
-//    for ( std::list< PlayingAudio* >::const_iterator it = m_playingStreams.begin(); it != m_playingStreams.end(); ++it ) 
-//   {
-//       const PlayingAudio *playing = (*it);
+   for ( std::list< PlayingAudio* >::const_iterator it = m_playingStreams.begin(); it != m_playingStreams.end(); ++it ) 
+  {
+      const PlayingAudio *playing = (*it);
 
-//     if ( ! playing )
-//       continue;
+    if ( ! playing )
+      continue;
 
-//     if ( playing->m_audioEventRTS->getAudioEventInfo()->m_soundType != AT_Music )
-//     {
-//       return TRUE;
-//     }
+    if ( playing->m_audioEventRTS->getAudioEventInfo()->m_data.m_soundType != AT_Music )
+    {
+      return TRUE;
+    }
 
-//     if ( playing->m_audioEventRTS->getEventName().startsWith("Game_") == FALSE ) 
-//     {
-//       return TRUE;
-//     }
-//   }
+    if ( playing->m_audioEventRTS->getEventName().startsWith("Game_") == FALSE ) 
+    {
+      return TRUE;
+    }
+  }
 
   return FALSE; 
 
@@ -2547,24 +2535,10 @@ void SdlAudioManager::processFadingList()
       switch(playing->m_type)
       {
          case PAT_Sample:
-         {
-            if (!SDL_SetAudioStreamGain(playing->m_sdlStream, volume)) {
-               DEBUG_CRASH(("SdlAudioManager::processFadingList: couldn't set audio stream volume: %s\n", SDL_GetError()));
-            }
-            break;
-         }
-
          case PAT_3DSample:
-         {
-            // AIL_set_3D_sample_volume(playing->m_3DSample, volume);
-            break;
-         }
-
          case PAT_Stream:
          {
-            if (!SDL_SetAudioStreamGain(playing->m_sdlStream, volume)) {
-               DEBUG_CRASH(("SdlAudioManager::processFadingList: couldn't set audio stream volume: %s\n", SDL_GetError()));
-            }
+            m_mixer.setVoiceVolume(playing->m_voice, volume);
             break;
          }
 
@@ -2721,38 +2695,21 @@ Real SdlAudioManager::getFileLengthMS(AsciiString strToLoad) const
 //-------------------------------------------------------------------------------------------------
 void SdlAudioManager::closeAnySamplesUsingFile(const void *fileToClose)
 {
-   (void) fileToClose;
-   DEBUG_LOG(("### SdlAudioManager::closeAnySamplesUsingFile\n"));
-   // std::list<PlayingAudio *>::iterator it;
-   // PlayingAudio *playing;
-   
-   // for (it = m_playingSounds.begin(); it != m_playingSounds.end(); ) {
-   //    playing = *it;
-   //    if (!playing) {
-   //       continue;
-   //    }
-
-   //    if (playing->m_file == fileToClose) {
-   //       releasePlayingAudio(playing);
-   //       it = m_playingSounds.erase(it);
-   //    } else {
-   //       ++it;
-   //    }
-   // }
-
-   // for (it = m_playing3DSounds.begin(); it != m_playing3DSounds.end(); ) {
-   //    playing = *it;
-   //    if (!playing) {
-   //       continue;
-   //    }
-
-   //    if (playing->m_file == fileToClose) {
-   //       releasePlayingAudio(playing);
-   //       it = m_playing3DSounds.erase(it);
-   //    } else {
-   //       ++it;
-   //    }
-   // }
+   // The mixer reads samples straight out of the cache's buffers, so anything still playing one
+   // that's about to be freed has to go first.
+   std::list<PlayingAudio *>* lists[] = { &m_playingSounds, &m_playing3DSounds, &m_fadingAudio };
+   for (std::list<PlayingAudio *>* playingList : lists) {
+      std::list<PlayingAudio *>::iterator it;
+      for (it = playingList->begin(); it != playingList->end(); ) {
+         PlayingAudio *playing = *it;
+         if (playing && playing->m_openFile == fileToClose) {
+            releasePlayingAudio(playing);
+            it = playingList->erase(it);
+         } else {
+            ++it;
+         }
+      }
+   }
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -2772,25 +2729,24 @@ void SdlAudioManager::setDeviceListenerPosition()
 //-------------------------------------------------------------------------------------------------
 const Coord3D *SdlAudioManager::getCurrentPositionFromEvent(AudioEventRTS *event)
 {
-   (void) event;
-   DEBUG_LOG(("### SdlAudioManager::getCurrentPositionFromEvent\n"));
-   // if (!event->isPositionalAudio()) {
-   //    return NULL;
-   // }
+   if (!event->isPositionalAudio()) {
+      return NULL;
+   }
 
-   // return event->getCurrentPosition();
-   return nullptr;
+   return event->getCurrentPosition();
 }
 
 //-------------------------------------------------------------------------------------------------
+/** A view that can't project the point yet can't say it's off screen, so such sounds are taken
+  * to be on screen, and aren't muffled. */
 Bool SdlAudioManager::isOnScreen(const Coord3D *pos) const
 {
-   (void) pos;
-   DEBUG_LOG(("### SdlAudioManager::isOnScreen\n"));
-   // static ICoord2D dummy;
-   // // WorldToScreen will return True if the point is onscreen and false if it is offscreen.
-   // return TheTacticalView->worldToScreen(pos, &dummy);
-   return false;
+   if (!pos || !TheTacticalView) {
+      return true;
+   }
+
+   ICoord2D dummy;
+   return TheTacticalView->worldToScreenTriReturn(pos, &dummy) != View::WTS_OUTSIDE_FRUSTUM;
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -2928,19 +2884,14 @@ void SdlAudioManager::playStream(AudioEventRTS *event, PlayingAudio* audio, Real
    DEBUG_LOG(("Streaming file format: %d channel, %d bit, %d Hz\n", spec.channels, bits, spec.freq));
 #endif
 
-   audio->m_sdlStream = SDL_CreateAudioStream(&spec, NULL);
-   if (!audio->m_sdlStream) {
-      DEBUG_CRASH(("SdlAudioManager::playStream: couldn't create audio stream: %s\n", SDL_GetError()));
-   } else if (!SDL_BindAudioStream(m_device, audio->m_sdlStream)) {
-      DEBUG_CRASH(("SdlAudioManager::playStream: couldn't bind audio stream: %s\n", SDL_GetError()));
-   } else {
+   audio->m_voice = m_mixer.playStream(spec, event->getAudioEventInfo()->m_data.m_priority);
+   if (audio->m_voice != INVALID_MIXER_VOICE) {
       UnsignedInt bytesDecoded {Sound_Decode(audio->m_stream)};
-      // Start playback
-      SDL_PutAudioStreamData(audio->m_sdlStream, audio->m_stream->buffer, static_cast<int>(bytesDecoded));
+      m_mixer.queueStreamData(audio->m_voice, audio->m_stream->buffer, static_cast<int>(bytesDecoded));
+      m_mixer.setVoiceGain(audio->m_voice, volume, 0.0f);
 
-      if (!SDL_SetAudioStreamGain(audio->m_sdlStream, volume)) {
-         DEBUG_CRASH(("SdlAudioManager::playStream: couldn't set audio stream volume: %s\n", SDL_GetError()));
-      }
+      // Start playback
+      m_mixer.setVoicePaused(audio->m_voice, false);
    }
 
    if (event->getAudioEventInfo()->m_data.m_soundType == AT_Music) {
@@ -2951,66 +2902,77 @@ void SdlAudioManager::playStream(AudioEventRTS *event, PlayingAudio* audio, Real
 //-------------------------------------------------------------------------------------------------
 void SdlAudioManager::playSample(AudioEventRTS *event, PlayingAudio* audio)
 {
-   // Load the file in
-   OpenAudioFile* openAudio {loadFileForRead(event)};
-   if (!openAudio) {
+   // Load the file in. If it isn't cached yet, processPlayingList starts it once it is decoded.
+   audio->m_openFile = loadFileForRead(event);
+   if (audio->m_openFile && !audio->m_openFile->m_loading) {
+      startSample(audio);
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+void SdlAudioManager::startSample(PlayingAudio* audio)
+{
+   const OpenAudioFile* openAudio {audio->m_openFile};
+   AudioEventRTS* event {audio->m_audioEventRTS};
+   if (openAudio->m_failed || !openAudio->m_audioBuf) {
+      audio->m_status = PS_Stopped;
       return;
    }
 
-   audio->m_audioBuf = openAudio->m_audioBuf;
-   audio->m_audioLen = openAudio->m_audioLen;
-   if (audio->m_audioBuf) {
-      audio->m_sdlStream = SDL_CreateAudioStream(&openAudio->m_audioSpec, NULL);
-      if (!audio->m_sdlStream) {
-         DEBUG_CRASH(("SdlAudioManager::playSample: couldn't create audio stream: %s\n", SDL_GetError()));
-      } else if (!SDL_BindAudioStream(m_device, audio->m_sdlStream)) {
-         DEBUG_CRASH(("SdlAudioManager::playSample: couldn't bind audio stream: %s\n", SDL_GetError()));
-      } else {
-         // Prep any sort of filtering, etc, here
-         initFilters(audio, event);
-         // Start playback
-         SDL_PutAudioStreamData(audio->m_sdlStream, audio->m_audioBuf, static_cast<int>(audio->m_audioLen));
-      }
+   audio->m_voice = m_mixer.playSample(openAudio->m_audioSpec, openAudio->m_audioBuf, openAudio->m_audioLen, event->getAudioEventInfo()->m_data.m_priority);
+   if (audio->m_voice == INVALID_MIXER_VOICE) {
+      audio->m_status = PS_Stopped;
+      return;
+   }
+
+   // Prep any sort of filtering, etc, here
+   initFilters(audio, event);
+   // Start playback
+   m_mixer.setVoicePaused(audio->m_voice, false);
+}
+
+//-------------------------------------------------------------------------------------------------
+void SdlAudioManager::playSample3D( AudioEventRTS *event, PlayingAudio *audio )
+{
+   if (!getCurrentPositionFromEvent(event)) {
+      return;
+   }
+
+   // Load the file in. If it isn't cached yet, processPlayingList starts it once it is decoded.
+   audio->m_openFile = loadFileForRead(event);
+   if (audio->m_openFile && !audio->m_openFile->m_loading) {
+      startSample3D(audio);
    }
 }
 
 //-------------------------------------------------------------------------------------------------
-void *SdlAudioManager::playSample3D( AudioEventRTS *event, H3DSAMPLE sample3D )
+void SdlAudioManager::startSample3D(PlayingAudio* audio)
 {
-   (void) event;
-   (void) sample3D;
-   DEBUG_LOG(("### SdlAudioManager::playSample3D\n"));
-   // const Coord3D *pos = getCurrentPositionFromEvent(event);
-   // if (pos) {
-   //    // Load the file in
-   //    void *fileBuffer = loadFileForRead(event);
-   //    if (fileBuffer) {
-   //       AIL_set_3D_sample_file(sample3D, fileBuffer);
+   const OpenAudioFile* openAudio {audio->m_openFile};
+   AudioEventRTS* event {audio->m_audioEventRTS};
+   const Coord3D *pos = getCurrentPositionFromEvent(event);
+   if (!pos || openAudio->m_failed || !openAudio->m_audioBuf) {
+      audio->m_status = PS_Stopped;
+      return;
+   }
 
-   //       // Prep any sort of filtering, etc, here
-   //       AIL_register_3D_EOS_callback(sample3D, set3DSampleCompleted);
+   if (openAudio->m_audioSpec.channels > 1) {
+      DEBUG_CRASH(("Requested Positional Play of audio '%s', but it is in stereo.", openAudio->m_fileName.str()));
+      audio->m_status = PS_Stopped;
+      return;
+   }
 
-   //       // Set the position values of the sample here
-   //       if (event->getAudioEventInfo()->m_type & ST_GLOBAL) {
-   //          AIL_set_3D_sample_distances(sample3D, TheAudio->getAudioSettings()->m_globalMinRange, TheAudio->getAudioSettings()->m_globalMaxRange );
-   //       } else {
-   //          AIL_set_3D_sample_distances(sample3D, event->getAudioEventInfo()->m_minDistance, event->getAudioEventInfo()->m_maxDistance );
-   //       }
-         
-   //       // Set the position of the sample here
-   //       Real x = pos->x;
-   //       Real y = pos->y;
-   //       Real z = pos->z;
-   //       AIL_set_3D_position( sample3D, x, y, z );
-   //       initFilters3D(sample3D, event, pos);
-         
-   //       // Start playback
-   //       AIL_start_3D_sample(sample3D);
-   //    }
-   //    return fileBuffer;
-   // }
+   audio->m_voice = m_mixer.playSample(openAudio->m_audioSpec, openAudio->m_audioBuf, openAudio->m_audioLen, event->getAudioEventInfo()->m_data.m_priority);
+   if (audio->m_voice == INVALID_MIXER_VOICE) {
+      audio->m_status = PS_Stopped;
+      return;
+   }
 
-   return NULL;
+   // Set the volume and position of the sample here
+   initFilters3D(audio, event, pos);
+
+   // Start playback
+   m_mixer.setVoicePaused(audio->m_voice, false);
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -3084,7 +3046,8 @@ void SdlAudioManager::initSamplePools()
    //    return;
    // }
 
-   // Let's just assume that we can have as many SDL_AudioStreams as we want.
+   // Handles only count what's playing; the mixer has a voice for each of them, and steals the
+   // quietest sounds if it ever runs out.
    UnsignedInt sampleCount2D {0};
    for (int i = 0; i < getAudioSettings()->m_sampleCount2D; ++i) {
       HSAMPLE sample = ++sampleCount2D;
@@ -3092,15 +3055,12 @@ void SdlAudioManager::initSamplePools()
       ++m_num2DSamples;
    }
 
-   // for (i = 0; i < getAudioSettings()->m_sampleCount3D; ++i) {
-   //    H3DSAMPLE sample = AIL_allocate_3D_sample_handle(m_provider3D[m_selectedProvider].id);
-   //    DEBUG_ASSERTCRASH(sample, ("Couldn't get %d 3D samples\n", i + 1));
-   //    if (sample) {
-   //       AIL_set_3D_user_data(sample, 0, i + 1);
-   //       m_available3DSamples.push_back(sample);
-   //       ++m_num3DSamples;
-   //    }
-   // }
+   UnsignedInt sampleCount3D {0};
+   for (int i = 0; i < getAudioSettings()->m_sampleCount3D; ++i) {
+      H3DSAMPLE sample = ++sampleCount3D;
+      m_available3DSamples.push_back(sample);
+      ++m_num3DSamples;
+   }
 
    // Streams are basically free, so we can just allocate the appropriate number
    m_numStreams = static_cast<UnsignedInt>(getAudioSettings()->m_streamCount);
@@ -3234,11 +3194,25 @@ void SdlAudioManager::friend_forcePlayAudioEventRTS(const AudioEventRTS* eventTo
 AudioFileCache::AudioFileCache()
 {
    m_mutex = SDL_CreateMutex();
+   m_thread = std::thread(&AudioFileCache::threadMain, this);
 }
 
 //-------------------------------------------------------------------------------------------------
 AudioFileCache::~AudioFileCache()
 {
+   {
+      std::lock_guard<std::mutex> lock(m_jobMutex);
+      m_jobs.clear();
+      m_quit = TRUE;
+   }
+   m_wake.notify_all();
+   m_thread.join();
+
+   for (DecodeResult& result : m_finished) {
+      SDL_free(result.m_audioBuf);
+   }
+   m_finished.clear();
+
    {
       ScopedMutex mut(m_mutex);
 
@@ -3246,18 +3220,34 @@ AudioFileCache::~AudioFileCache()
       OpenFilesHashIt it;
       for (it = m_openFiles.begin(); it != m_openFiles.end(); ++it) {
          if (it->second.m_openCount > 0) {
-            DEBUG_CRASH(("Sample '%s' is still playing (open count = %u), and we're trying to quit.\n", it->second.m_eventInfo->m_data.m_audioName.str(), it->second.m_openCount));
+            DEBUG_CRASH(("Sample '%s' is still playing (open count = %u), and we're trying to quit.\n", it->second.m_fileName.str(), it->second.m_openCount));
          }
 
-         releaseOpenAudioFile(&it->second);
-         // Don't erase it from the map, cause it makes this whole process way more complicated, and 
-         // we're about to go away anyways.
+         // Everything has been stopped by now, so just free the buffers rather than going through
+         // releaseOpenAudioFile.
+         SDL_free(it->second.m_audioBuf);
+         it->second.m_audioBuf = NULL;
       }
+      m_openFiles.clear();
+      m_idleFiles.clear();
    }
 
+   DEBUG_LOG(("AudioFileCache: %u hits, %u misses (%.1f%% hit rate), %u decode failures, %u evictions (%u in use, %llu bytes)\n",
+      m_stats.m_hits, m_stats.m_misses, m_stats.getHitRate() * 100.0f, m_stats.m_decodeFailures,
+      m_stats.m_evictions, m_stats.m_evictedInUse, m_stats.m_evictedBytes));
+   DEBUG_LOG(("AudioFileCache: decode %.2fms average, %.2fms max; ready after %.2fms average, %.2fms max\n",
+      m_stats.getAverageDecodeMS(), m_stats.m_maxDecodeMS, m_stats.getAverageLatencyMS(), m_stats.m_maxLatencyMS));
+
    SDL_DestroyMutex(m_mutex);
 }
 
+//-------------------------------------------------------------------------------------------------
+void AudioFileCache::resetStats()
+{
+   ScopedMutex mut(m_mutex);
+   m_stats = AudioCacheStats();
+}
+
 //-------------------------------------------------------------------------------------------------
 OpenAudioFile* AudioFileCache::openFile(AudioEventRTS* eventToOpenFrom)
 {
@@ -3291,20 +3281,28 @@ OpenAudioFile* AudioFileCache::openFile(AudioEventRTS* eventToOpenFrom)
       return NULL;
    }
 
-   OpenFilesHash::iterator it;
-   it = m_openFiles.find(strToFind);
+   OpenFilesHashIt it {m_openFiles.find(strToFind)};
 
    if (it != m_openFiles.end()) {
+      OpenAudioFile* cached {&it->second};
+      if (cached->m_failed) {
+         // Still held by sounds that are about to be stopped; don't hand it out again.
+         return NULL;
+      }
+
 #ifdef INTENSIVE_AUDIO_DEBUG
       DEBUG_LOG(("(cached)\n"));
 #endif
-      ++it->second.m_openCount;
-      return &it->second;
+      ++m_stats.m_hits;
+      removeFromIdle(cached);
+      ++cached->m_openCount;
+      return cached;
    }
 
-   // Couldn't find the file, so actually open it.
+   // Couldn't find the file, so read it in here (the file system isn't thread safe) and let the
+   // worker decode it.
 #ifdef INTENSIVE_AUDIO_DEBUG
-   DEBUG_LOG(("(loaded from disk)\n"));
+   DEBUG_LOG(("(queued for decode)\n"));
 #endif
    File *file = TheFileSystem->openFile(strToFind.str());
    if (!file) {
@@ -3312,53 +3310,130 @@ OpenAudioFile* AudioFileCache::openFile(AudioEventRTS* eventToOpenFrom)
       return NULL;
    }
 
-   OpenAudioFile openedAudioFile {};
+   DecodeJob job {};
+   job.m_fileName = strToFind.str();
+   Int size {file->size()};
+   if (size > 0) {
+      job.m_source.resize(static_cast<size_t>(size));
+      if (file->read(job.m_source.data(), size) != size) {
+         job.m_source.clear();
+      }
+   }
+   file->close();
+
+   if (job.m_source.empty()) {
+      DEBUG_CRASH(("AudioFileCache::openFile: could not read sound file '%s'\n", strToFind.str()));
+      return NULL;
+   }
+
+   ++m_stats.m_misses;
+
+   OpenAudioFile& openedAudioFile {m_openFiles[strToFind]};
+   openedAudioFile.m_fileName = strToFind;
    openedAudioFile.m_eventInfo = eventToOpenFrom->getAudioEventInfo();
    openedAudioFile.m_openCount = 1;
-   SdlFileStream fileStream {file};
-   SDL_IOStream* sdlStream {SDL_OpenIO(fileStream.interface(), &fileStream)};
-   DEBUG_ASSERTCRASH(sdlStream, (("AudioFileCache::openFile: SDL stream is NULL\n")));
-   if (!SDL_LoadWAV_IO(sdlStream, true, &openedAudioFile.m_audioSpec, &openedAudioFile.m_audioBuf, &openedAudioFile.m_audioLen)) {
-      DEBUG_CRASH(("AudioFileCache::openFile: could not load sound file: %s\n", SDL_GetError()));
+   openedAudioFile.m_loading = TRUE;
+   openedAudioFile.m_requestTime = SDL_GetPerformanceCounter();
+
+   {
+      std::lock_guard<std::mutex> lock(m_jobMutex);
+      m_jobs.push_back(std::move(job));
    }
+   m_wake.notify_one();
 
-   if (eventToOpenFrom->isPositionalAudio()) {
-      if (openedAudioFile.m_audioSpec.channels > 1) {
-         DEBUG_CRASH(("Requested Positional Play of audio '%s', but it is in stereo.", strToFind.str()));
-         SDL_free(openedAudioFile.m_audioBuf);
-         return NULL;
-      }
+   return &openedAudioFile;
+}
+
+//-------------------------------------------------------------------------------------------------
+void AudioFileCache::closeFile(OpenAudioFile* file)
+{
+   if (!file) {
+      return;
    }
 
-   m_currentlyUsedSize += openedAudioFile.m_audioLen;
-   if (m_currentlyUsedSize > m_maxSize) {
-      // We need to free some samples, or we're not going to be able to play this sound.
-      if (!freeEnoughSpaceForSample(openedAudioFile)) {
-         m_currentlyUsedSize -= openedAudioFile.m_audioLen;
-         SDL_free(openedAudioFile.m_audioBuf);
-         return NULL;
-      }
+   // Protect the entire closeFile function
+   ScopedMutex mut(m_mutex);
+
+   DEBUG_ASSERTCRASH(file->m_openCount > 0, ("AudioFileCache::closeFile: '%s' isn't open\n", file->m_fileName.str()));
+   if (file->m_openCount == 0 || --file->m_openCount > 0) {
+      return;
    }
 
-   m_openFiles[strToFind] = openedAudioFile;
-   return &m_openFiles[strToFind];
+   if (file->m_failed) {
+      eraseFile(file);
+   } else if (!file->m_loading) {
+      // Most recently used goes on the back. Files still loading are put on the list by update().
+      file->m_idleIt = m_idleFiles.insert(m_idleFiles.end(), file);
+      file->m_idle = TRUE;
+   }
 }
 
 //-------------------------------------------------------------------------------------------------
-void AudioFileCache::releaseBuffer(UnsignedByte* buffer)
+void AudioFileCache::update()
 {
-   if (!buffer) {
+   std::vector<DecodeResult> finished;
+   {
+      std::lock_guard<std::mutex> lock(m_jobMutex);
+      finished.swap(m_finished);
+   }
+
+   if (finished.empty()) {
       return;
    }
 
-   // Protect the entire closeFile function
    ScopedMutex mut(m_mutex);
 
-   OpenFilesHash::iterator it;
-   for (it = m_openFiles.begin(); it != m_openFiles.end(); ++it) {
-      if (it->second.m_audioBuf == buffer) {
-         --it->second.m_openCount;
-         return;
+   Uint64 now {SDL_GetPerformanceCounter()};
+   Real msPerTick {1000.0f / static_cast<Real>(SDL_GetPerformanceFrequency())};
+
+   for (DecodeResult& result : finished) {
+      OpenFilesHashIt it {m_openFiles.find(AsciiString(result.m_fileName.c_str()))};
+      if (it == m_openFiles.end() || !it->second.m_loading) {
+         SDL_free(result.m_audioBuf);
+         continue;
+      }
+
+      OpenAudioFile* file {&it->second};
+      file->m_loading = FALSE;
+
+      if (!result.m_audioBuf) {
+         DEBUG_CRASH(("AudioFileCache::update: could not decode sound file '%s'\n", file->m_fileName.str()));
+         ++m_stats.m_decodeFailures;
+         file->m_failed = TRUE;
+         if (file->m_openCount == 0) {
+            eraseFile(file);
+         }
+         continue;
+      }
+
+      Real latencyMS {static_cast<Real>(now - file->m_requestTime) * msPerTick};
+      ++m_stats.m_decodes;
+      m_stats.m_totalDecodeMS += result.m_decodeMS;
+      m_stats.m_maxDecodeMS = max(m_stats.m_maxDecodeMS, result.m_decodeMS);
+      m_stats.m_totalLatencyMS += latencyMS;
+      m_stats.m_maxLatencyMS = max(m_stats.m_maxLatencyMS, latencyMS);
+
+      m_currentlyUsedSize += result.m_audioLen;
+      if (m_currentlyUsedSize > m_maxSize) {
+         // We need to free some samples, or we're not going to be able to play this sound.
+         if (!freeEnoughSpaceForSample(*file)) {
+            m_currentlyUsedSize -= result.m_audioLen;
+            SDL_free(result.m_audioBuf);
+            file->m_failed = TRUE;
+            if (file->m_openCount == 0) {
+               eraseFile(file);
+            }
+            continue;
+         }
+      }
+
+      file->m_audioSpec = result.m_audioSpec;
+      file->m_audioBuf = result.m_audioBuf;
+      file->m_audioLen = result.m_audioLen;
+
+      if (file->m_openCount == 0) {
+         file->m_idleIt = m_idleFiles.insert(m_idleFiles.end(), file);
+         file->m_idle = TRUE;
       }
    }
 }
@@ -3372,24 +3447,84 @@ void AudioFileCache::setMaxSize(UnsignedInt size)
    m_maxSize = size;
 }
 
+//-------------------------------------------------------------------------------------------------
+void AudioFileCache::threadMain()
+{
+   for (;;) {
+      DecodeJob job;
+      {
+         std::unique_lock<std::mutex> lock(m_jobMutex);
+         m_wake.wait(lock, [this] { return m_quit || !m_jobs.empty(); });
+         if (m_quit) {
+            return;
+         }
+         job = std::move(m_jobs.front());
+         m_jobs.pop_front();
+      }
+
+      DecodeResult result {};
+      decode(job, result);
+
+      std::lock_guard<std::mutex> lock(m_jobMutex);
+      m_finished.push_back(result);
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+void AudioFileCache::decode(const DecodeJob& job, DecodeResult& result)
+{
+   Uint64 start {SDL_GetPerformanceCounter()};
+
+   result.m_fileName = job.m_fileName;
+   SDL_IOStream* sdlStream {SDL_IOFromConstMem(job.m_source.data(), job.m_source.size())};
+   if (!sdlStream || !SDL_LoadWAV_IO(sdlStream, true, &result.m_audioSpec, &result.m_audioBuf, &result.m_audioLen)) {
+      result.m_audioBuf = NULL;
+      result.m_audioLen = 0;
+   }
+
+   result.m_decodeMS = static_cast<Real>(SDL_GetPerformanceCounter() - start) * 1000.0f / static_cast<Real>(SDL_GetPerformanceFrequency());
+}
+
 //-------------------------------------------------------------------------------------------------
 void AudioFileCache::releaseOpenAudioFile(OpenAudioFile* fileToRelease)
 {
 #ifdef INTENSIVE_AUDIO_DEBUG
-   DEBUG_LOG(("AudioFileCache::releaseOpenAudioFile: %s\n", fileToRelease->m_eventInfo->m_data.m_audioName.str()));
+   DEBUG_LOG(("AudioFileCache::releaseOpenAudioFile: %s\n", fileToRelease->m_fileName.str()));
 #endif
    if (fileToRelease->m_openCount > 0) {
-      // This thing needs to be terminated IMMEDIATELY.
-      TheAudio->closeAnySamplesUsingFile(fileToRelease->m_audioBuf);
+      // This thing needs to be terminated IMMEDIATELY. Closing the sounds puts it on the idle list.
+      TheAudio->closeAnySamplesUsingFile(fileToRelease);
    }
 
+   removeFromIdle(fileToRelease);
+
    if (fileToRelease->m_audioBuf) {
+      m_currentlyUsedSize -= fileToRelease->m_audioLen;
       SDL_free(fileToRelease->m_audioBuf);
       fileToRelease->m_audioBuf = NULL;
-      fileToRelease->m_eventInfo = NULL;
+      fileToRelease->m_audioLen = 0;
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+void AudioFileCache::removeFromIdle(OpenAudioFile* file)
+{
+   if (file->m_idle) {
+      m_idleFiles.erase(file->m_idleIt);
+      file->m_idle = FALSE;
    }
 }
 
+//-------------------------------------------------------------------------------------------------
+void AudioFileCache::eraseFile(OpenAudioFile* file)
+{
+   releaseOpenAudioFile(file);
+
+   // the key lives in the node being erased, so look it up with a copy
+   AsciiString fileName {file->m_fileName};
+   m_openFiles.erase(fileName);
+}
+
 //-------------------------------------------------------------------------------------------------
 Bool AudioFileCache::freeEnoughSpaceForSample(const OpenAudioFile& sampleThatNeedsSpace)
 {
@@ -3397,21 +3532,13 @@ Bool AudioFileCache::freeEnoughSpaceForSample(const OpenAudioFile& sampleThatNee
    UnsignedInt spaceRequired {m_currentlyUsedSize - m_maxSize};
    UnsignedInt runningTotal {0};
 
-   std::list<AsciiString> filesToClose;
-   // First, search for any samples that have ref counts of 0. They are low-hanging fruit, and 
-   // should be considered immediately.
-   OpenFilesHashIt it;
-   for (it = m_openFiles.begin(); it != m_openFiles.end(); ++it) {
-      if (it->second.m_openCount == 0) {
-         // This is said low-hanging fruit.
-         filesToClose.push_back(it->first);
-
-         runningTotal += it->second.m_audioLen;
-
-         if (runningTotal >= spaceRequired) {
-            break;
-         }
-      }
+   std::vector<OpenAudioFile*> filesToClose;
+   // First, take samples nobody has open, least recently used first. They are low-hanging fruit,
+   // and should be considered immediately.
+   std::list<OpenAudioFile*>::iterator idleIt;
+   for (idleIt = m_idleFiles.begin(); idleIt != m_idleFiles.end() && runningTotal < spaceRequired; ++idleIt) {
+      filesToClose.push_back(*idleIt);
+      runningTotal += (*idleIt)->m_audioLen;
    }
 
    // If we don't have enough space yet, then search through the events who have a count of 1 or more
@@ -3419,11 +3546,13 @@ Bool AudioFileCache::freeEnoughSpaceForSample(const OpenAudioFile& sampleThatNee
    // Mical said that at this point, sounds shouldn't care if other sounds are interruptable or not.
    // Kill any files of lower priority necessary to clear out the buffer.
    if (runningTotal < spaceRequired) {
+      OpenFilesHashIt it;
       for (it = m_openFiles.begin(); it != m_openFiles.end(); ++it) {
-         if (it->second.m_openCount > 0) {
-            if (it->second.m_eventInfo->m_data.m_priority < sampleThatNeedsSpace.m_eventInfo->m_data.m_priority) {
-               filesToClose.push_back(it->first);
-               runningTotal += it->second.m_audioLen;
+         const OpenAudioFile& candidate {it->second};
+         if (candidate.m_openCount > 0 && candidate.m_audioBuf) {
+            if (candidate.m_eventInfo->m_data.m_priority < sampleThatNeedsSpace.m_eventInfo->m_data.m_priority) {
+               filesToClose.push_back(&it->second);
+               runningTotal += candidate.m_audioLen;
             
                if (runningTotal >= spaceRequired) {
                   break;
@@ -3438,14 +3567,13 @@ Bool AudioFileCache::freeEnoughSpaceForSample(const OpenAudioFile& sampleThatNee
       return FALSE;
    }
 
-   std::list<AsciiString>::iterator ait;
-   for (ait = filesToClose.begin(); ait != filesToClose.end(); ++ait) {
-      OpenFilesHashIt itToErase = m_openFiles.find(*ait);
-      if (itToErase != m_openFiles.end()) {
-         releaseOpenAudioFile(&itToErase->second);
-         m_currentlyUsedSize -= itToErase->second.m_audioLen;
-         m_openFiles.erase(itToErase);
+   for (OpenAudioFile* file : filesToClose) {
+      ++m_stats.m_evictions;
+      m_stats.m_evictedBytes += file->m_audioLen;
+      if (file->m_openCount > 0) {
+         ++m_stats.m_evictedInUse;
       }
+      eraseFile(file);
    }
 
    return TRUE;
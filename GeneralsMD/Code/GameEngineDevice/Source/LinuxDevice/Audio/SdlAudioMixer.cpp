@@ -0,0 +1,692 @@
+/*
+** Command & Conquer Generals Zero Hour(tm)
+** Copyright 2025 Electronic Arts Inc.
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+///// SdlAudioMixer.cpp //////////////////////////
+// Mixes every playing sound into the one audio
+// stream bound to the device.
+//////////////////////////////////////////////////
+
+#include "PreRTS.h"	// This must go first in EVERY cpp file int the GameEngine
+#include "LinuxDevice/Audio/SdlAudioMixer.h"
+
+#include <algorithm>
+#include <cmath>
+#include "Common/ScopedMutex.h"
+
+// The mixer thread must not call DEBUG_LOG or use AsciiString; anything it reports goes through
+// members the game thread reads.
+
+static const SDL_AudioSpec MixSpec {SDL_AUDIO_F32, SdlAudioMixer::MIX_CHANNELS, 0};
+
+//-------------------------------------------------------------------------------------------------
+static inline Real sampleToReal(Uint8 sample) { return (static_cast<Real>(sample) - 128.0f) * (1.0f / 128.0f); }
+static inline Real sampleToReal(Sint8 sample) { return static_cast<Real>(sample) * (1.0f / 128.0f); }
+static inline Real sampleToReal(Sint16 sample) { return static_cast<Real>(sample) * (1.0f / 32768.0f); }
+static inline Real sampleToReal(Sint32 sample) { return static_cast<Real>(sample) * (1.0f / 2147483648.0f); }
+static inline Real sampleToReal(float sample) { return sample; }
+
+//-------------------------------------------------------------------------------------------------
+/// Resample one sample voice into out with linear interpolation, ramping the gains by gainStep
+/// per frame, and low pass filtering it if LowPass. Returns the number of frames mixed, which is
+/// short of frames if the sample ends.
+template <typename SampleType, Int Channels, Bool LowPass>
+static Int mixSampleFrames(const SampleType* data, UnsignedInt frameCount, Uint64& position, Uint64 step,
+   float* out, Int frames, Real* gain, const Real* gainStep, Real lowPass, Real* filtered)
+{
+   const Uint64 end {static_cast<Uint64>(frameCount) << 32};
+   Uint64 pos {position};
+   Real left {gain[0]};
+   Real right {gain[1]};
+   Real filteredLeft {filtered[0]};
+   Real filteredRight {filtered[1]};
+
+   Int i {0};
+   for (; i < frames && pos < end; ++i) {
+      UnsignedInt index {static_cast<UnsignedInt>(pos >> 32)};
+      UnsignedInt next {index + 1 < frameCount ? index + 1 : index};
+      Real frac {static_cast<Real>(pos & 0xFFFFFFFFu) * (1.0f / 4294967296.0f)};
+
+      Real a, b;
+      if constexpr (Channels == 1) {
+         Real s0 {sampleToReal(data[index])};
+         a = b = s0 + (sampleToReal(data[next]) - s0) * frac;
+      } else {
+         Real l0 {sampleToReal(data[index * 2])};
+         Real r0 {sampleToReal(data[index * 2 + 1])};
+         a = l0 + (sampleToReal(data[next * 2]) - l0) * frac;
+         b = r0 + (sampleToReal(data[next * 2 + 1]) - r0) * frac;
+      }
+
+      if constexpr (LowPass) {
+         filteredLeft += (a - filteredLeft) * lowPass;
+         filteredRight += (b - filteredRight) * lowPass;
+         a = filteredLeft;
+         b = filteredRight;
+      }
+
+      out[i * 2] += a * left;
+      out[i * 2 + 1] += b * right;
+      left += gainStep[0];
+      right += gainStep[1];
+      pos += step;
+   }
+
+   position = pos;
+   gain[0] = left;
+   gain[1] = right;
+   filtered[0] = filteredLeft;
+   filtered[1] = filteredRight;
+   return i;
+}
+
+//-------------------------------------------------------------------------------------------------
+template <typename SampleType>
+static Int mixSampleChannels(const UnsignedByte* data, Int channels, UnsignedInt frameCount, Uint64& position,
+   Uint64 step, float* out, Int frames, Real* gain, const Real* gainStep, Real lowPass, Real* filtered)
+{
+   const SampleType* samples {reinterpret_cast<const SampleType*>(data)};
+   if (lowPass < 1.0f) {
+      if (channels == 1) {
+         return mixSampleFrames<SampleType, 1, true>(samples, frameCount, position, step, out, frames, gain, gainStep, lowPass, filtered);
+      }
+      return mixSampleFrames<SampleType, 2, true>(samples, frameCount, position, step, out, frames, gain, gainStep, lowPass, filtered);
+   }
+   if (channels == 1) {
+      return mixSampleFrames<SampleType, 1, false>(samples, frameCount, position, step, out, frames, gain, gainStep, lowPass, filtered);
+   }
+   return mixSampleFrames<SampleType, 2, false>(samples, frameCount, position, step, out, frames, gain, gainStep, lowPass, filtered);
+}
+
+//-------------------------------------------------------------------------------------------------
+/// One pole low pass coefficient for a cutoff given as a fraction of the highest frequency the
+/// mix can hold, half its rate.
+static Real computeLowPass(Real cutoff)
+{
+   if (cutoff >= 1.0f) {
+      return 1.0f;
+   }
+   return 1.0f - expf(-PI * std::max(cutoff, 0.0f));
+}
+
+//-------------------------------------------------------------------------------------------------
+static Uint64 computeStep(Int sourceRate, Real pitch, Int rate)
+{
+   if (pitch <= 0.0f || rate <= 0) {
+      pitch = 1.0f;
+   }
+   return static_cast<Uint64>(static_cast<double>(sourceRate) * pitch / std::max(rate, 1) * 4294967296.0);
+}
+
+//-------------------------------------------------------------------------------------------------
+SdlAudioMixer::SdlAudioMixer()
+{
+   m_mutex = SDL_CreateMutex();
+   m_mixBuffer.resize(MIX_BLOCK_FRAMES * MIX_CHANNELS);
+   m_streamBuffer.resize(MIX_BLOCK_FRAMES * MIX_CHANNELS);
+}
+
+//-------------------------------------------------------------------------------------------------
+SdlAudioMixer::~SdlAudioMixer()
+{
+   close();
+   SDL_DestroyMutex(m_mutex);
+}
+
+//-------------------------------------------------------------------------------------------------
+Bool SdlAudioMixer::open(SDL_AudioDeviceID device, Int rate)
+{
+   close();
+
+   SDL_AudioSpec spec {MixSpec};
+   spec.freq = rate;
+   m_deviceStream = SDL_CreateAudioStream(&spec, NULL);
+   if (!m_deviceStream) {
+      DEBUG_CRASH(("SdlAudioMixer::open: couldn't create audio stream: %s\n", SDL_GetError()));
+      return false;
+   }
+
+   // The rate has to be in place before the device can ask for the first block.
+   m_rate = rate;
+   if (!SDL_SetAudioStreamGetCallback(m_deviceStream, deviceCallback, this) || !SDL_BindAudioStream(device, m_deviceStream)) {
+      DEBUG_CRASH(("SdlAudioMixer::open: couldn't bind audio stream: %s\n", SDL_GetError()));
+      SDL_DestroyAudioStream(m_deviceStream);
+      m_deviceStream = NULL;
+      m_rate = 0;
+      return false;
+   }
+
+   return true;
+}
+
+//-------------------------------------------------------------------------------------------------
+void SdlAudioMixer::close()
+{
+   // Destroying the stream unbinds it, so the device can't be in the callback once this returns.
+   if (m_deviceStream) {
+      SDL_DestroyAudioStream(m_deviceStream);
+      m_deviceStream = NULL;
+   }
+
+   ScopedMutex lock(m_mutex);
+   for (Int i = 0; i < MAX_VOICES; ++i) {
+      if (m_voices[i].m_state != VS_Free) {
+         freeVoice(&m_voices[i]);
+      }
+   }
+   m_rate = 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+Bool SdlAudioMixer::isSupportedFormat(SDL_AudioFormat format)
+{
+   switch (format) {
+      case SDL_AUDIO_U8:
+      case SDL_AUDIO_S8:
+      case SDL_AUDIO_S16:
+      case SDL_AUDIO_S32:
+      case SDL_AUDIO_F32:
+         return true;
+      default:
+         return false;
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+UnsignedInt SdlAudioMixer::getSampleSize(SDL_AudioFormat format)
+{
+   switch (format) {
+      case SDL_AUDIO_U8:
+      case SDL_AUDIO_S8:
+         return 1;
+      case SDL_AUDIO_S16:
+         return 2;
+      default:
+         return 4;
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+MixerVoiceID SdlAudioMixer::playSample(const SDL_AudioSpec& spec, const UnsignedByte* data, UnsignedInt length, Int priority)
+{
+   if (!isOpen() || !data) {
+      return INVALID_MIXER_VOICE;
+   }
+
+   if (!isSupportedFormat(spec.format) || spec.channels < 1 || spec.channels > 2 || spec.freq <= 0) {
+      DEBUG_CRASH(("SdlAudioMixer::playSample: can't mix format 0x%x with %d channels at %d Hz\n", spec.format, spec.channels, spec.freq));
+      return INVALID_MIXER_VOICE;
+   }
+
+   ScopedMutex lock(m_mutex);
+   Voice* voice {allocateVoice(priority, true)};
+   if (!voice) {
+      return INVALID_MIXER_VOICE;
+   }
+
+   voice->m_data = data;
+   const UnsignedInt frameSize {getSampleSize(spec.format) * static_cast<UnsignedInt>(spec.channels)};
+   voice->m_frames = length / frameSize;
+   voice->m_format = spec.format;
+   voice->m_channels = spec.channels;
+   voice->m_sourceRate = spec.freq;
+   voice->m_position = 0;
+   voice->m_step = computeStep(spec.freq, 1.0f, m_rate);
+   return voice->m_id;
+}
+
+//-------------------------------------------------------------------------------------------------
+MixerVoiceID SdlAudioMixer::playStream(const SDL_AudioSpec& spec, Int priority)
+{
+   if (!isOpen()) {
+      return INVALID_MIXER_VOICE;
+   }
+
+   SDL_AudioSpec mixSpec {MixSpec};
+   mixSpec.freq = m_rate;
+   SDL_AudioStream* stream {SDL_CreateAudioStream(&spec, &mixSpec)};
+   if (!stream) {
+      DEBUG_CRASH(("SdlAudioMixer::playStream: couldn't create audio stream: %s\n", SDL_GetError()));
+      return INVALID_MIXER_VOICE;
+   }
+
+   ScopedMutex lock(m_mutex);
+   Voice* voice {allocateVoice(priority, false)};
+   if (!voice) {
+      SDL_DestroyAudioStream(stream);
+      return INVALID_MIXER_VOICE;
+   }
+
+   voice->m_stream = stream;
+   return voice->m_id;
+}
+
+//-------------------------------------------------------------------------------------------------
+void SdlAudioMixer::queueStreamData(MixerVoiceID voiceID, const void* data, Int length)
+{
+   ScopedMutex lock(m_mutex);
+   Voice* voice {findVoice(voiceID)};
+   if (voice && voice->m_stream && length > 0) {
+      SDL_PutAudioStreamData(voice->m_stream, data, length);
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+void SdlAudioMixer::flushStream(MixerVoiceID voiceID)
+{
+   ScopedMutex lock(m_mutex);
+   Voice* voice {findVoice(voiceID)};
+   if (voice && voice->m_stream) {
+      SDL_FlushAudioStream(voice->m_stream);
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+Int SdlAudioMixer::getStreamQueued(MixerVoiceID voiceID)
+{
+   ScopedMutex lock(m_mutex);
+   Voice* voice {findVoice(voiceID)};
+   if (!voice || !voice->m_stream) {
+      return 0;
+   }
+   return std::max(SDL_GetAudioStreamQueued(voice->m_stream), 0);
+}
+
+//-------------------------------------------------------------------------------------------------
+Int SdlAudioMixer::getStreamAvailable(MixerVoiceID voiceID)
+{
+   ScopedMutex lock(m_mutex);
+   Voice* voice {findVoice(voiceID)};
+   if (!voice || !voice->m_stream) {
+      return 0;
+   }
+   return std::max(SDL_GetAudioStreamAvailable(voice->m_stream), 0);
+}
+
+//-------------------------------------------------------------------------------------------------
+void SdlAudioMixer::setVoiceGain(MixerVoiceID voiceID, Real volume, Real pan)
+{
+   ScopedMutex lock(m_mutex);
+   Voice* voice {findVoice(voiceID)};
+   if (voice) {
+      voice->m_volume = volume;
+      voice->m_pan = std::clamp(pan, -1.0f, 1.0f);
+      updateTargetGain(voice);
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+void SdlAudioMixer::setVoiceVolume(MixerVoiceID voiceID, Real volume)
+{
+   ScopedMutex lock(m_mutex);
+   Voice* voice {findVoice(voiceID)};
+   if (voice) {
+      voice->m_volume = volume;
+      updateTargetGain(voice);
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+void SdlAudioMixer::setVoicePitch(MixerVoiceID voiceID, Real pitch)
+{
+   ScopedMutex lock(m_mutex);
+   Voice* voice {findVoice(voiceID)};
+   if (voice && !voice->m_stream) {
+      voice->m_step = computeStep(voice->m_sourceRate, pitch, m_rate);
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+void SdlAudioMixer::setVoiceLowPass(MixerVoiceID voiceID, Real cutoff)
+{
+   ScopedMutex lock(m_mutex);
+   Voice* voice {findVoice(voiceID)};
+   if (voice) {
+      voice->m_lowPass = computeLowPass(cutoff);
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+void SdlAudioMixer::setVoicePaused(MixerVoiceID voiceID, Bool paused)
+{
+   ScopedMutex lock(m_mutex);
+   Voice* voice {findVoice(voiceID)};
+   if (voice && (voice->m_state == VS_Playing || voice->m_state == VS_Paused)) {
+      voice->m_state = paused ? VS_Paused : VS_Playing;
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+void SdlAudioMixer::stopVoice(MixerVoiceID voiceID)
+{
+   ScopedMutex lock(m_mutex);
+   Voice* voice {findVoice(voiceID)};
+   if (voice) {
+      freeVoice(voice);
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+Bool SdlAudioMixer::isVoiceDone(MixerVoiceID voiceID)
+{
+   ScopedMutex lock(m_mutex);
+   Voice* voice {findVoice(voiceID)};
+   return !voice || voice->m_state == VS_Done;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Pick a slot for a new voice: a free one, else one that has finished but not been stopped yet,
+  * else (if allowed) the lowest priority sample voice that is strictly below priority, oldest
+  * first. Streams are never stolen; the manager already limits how many of them there are.
+  * Must be called with m_mutex held. */
+SdlAudioMixer::Voice* SdlAudioMixer::allocateVoice(Int priority, Bool canSteal)
+{
+   Voice* slot {NULL};
+   for (Int i = 0; i < MAX_VOICES; ++i) {
+      Voice* voice {&m_voices[i]};
+      if (voice->m_state == VS_Free) {
+         slot = voice;
+         break;
+      }
+      if (voice->m_state == VS_Done && !slot) {
+         slot = voice;
+      }
+   }
+
+   if (!slot && canSteal) {
+      for (Int i = 0; i < MAX_VOICES; ++i) {
+         Voice* voice {&m_voices[i]};
+         if (voice->m_stream || voice->m_priority >= priority) {
+            continue;
+         }
+         if (!slot || voice->m_priority < slot->m_priority
+            || (voice->m_priority == slot->m_priority && voice->m_startOrder < slot->m_startOrder)) {
+            slot = voice;
+         }
+      }
+
+      if (slot) {
+         ++m_stolenCount;
+      }
+   }
+
+   if (!slot) {
+      return NULL;
+   }
+
+   if (slot->m_state != VS_Free) {
+      freeVoice(slot);
+   }
+
+   UnsignedInt index {static_cast<UnsignedInt>(slot - m_voices)};
+   slot->m_id = (++m_nextSerial << 8) | (index + 1);
+   slot->m_state = VS_Paused;
+   slot->m_priority = priority;
+   slot->m_startOrder = m_nextStartOrder++;
+   slot->m_volume = 1.0f;
+   slot->m_pan = 0.0f;
+   slot->m_started = false;
+   slot->m_lowPass = 1.0f;
+   slot->m_filtered[0] = 0.0f;
+   slot->m_filtered[1] = 0.0f;
+   updateTargetGain(slot);
+   ++m_voiceCount;
+   return slot;
+}
+
+//-------------------------------------------------------------------------------------------------
+SdlAudioMixer::Voice* SdlAudioMixer::findVoice(MixerVoiceID voiceID)
+{
+   UnsignedInt index {voiceID & 0xFF};
+   if (index == 0 || index > MAX_VOICES) {
+      return NULL;
+   }
+
+   Voice* voice {&m_voices[index - 1]};
+   if (voice->m_id != voiceID || voice->m_state == VS_Free) {
+      return NULL;
+   }
+   return voice;
+}
+
+//-------------------------------------------------------------------------------------------------
+void SdlAudioMixer::freeVoice(Voice* voice)
+{
+   if (voice->m_stream) {
+      SDL_DestroyAudioStream(voice->m_stream);
+      voice->m_stream = NULL;
+   }
+
+   voice->m_id = INVALID_MIXER_VOICE;
+   voice->m_state = VS_Free;
+   voice->m_data = NULL;
+   voice->m_frames = 0;
+   voice->m_position = 0;
+   --m_voiceCount;
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Pan keeps both channels at full volume in the middle and fades out the far channel towards
+  * the edges, so 2-D sounds play exactly as loud as they used to. */
+void SdlAudioMixer::updateTargetGain(Voice* voice)
+{
+   Real pan {voice->m_pan};
+   voice->m_targetGain[0] = voice->m_volume * (pan > 0.0f ? cosf(pan * PI * 0.5f) : 1.0f);
+   voice->m_targetGain[1] = voice->m_volume * (pan < 0.0f ? cosf(-pan * PI * 0.5f) : 1.0f);
+
+   // Nothing to ramp from before the voice is first heard.
+   if (!voice->m_started) {
+      voice->m_gain[0] = voice->m_targetGain[0];
+      voice->m_gain[1] = voice->m_targetGain[1];
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+void SdlAudioMixer::mixSampleVoice(Voice* voice, float* out, Int frames)
+{
+   // Ramp to the new gains over the pass, so volume and position changes don't click.
+   Real gain[MIX_CHANNELS] {voice->m_gain[0], voice->m_gain[1]};
+   Real gainStep[MIX_CHANNELS] {
+      (voice->m_targetGain[0] - gain[0]) / static_cast<Real>(frames),
+      (voice->m_targetGain[1] - gain[1]) / static_cast<Real>(frames)
+   };
+
+   switch (voice->m_format) {
+      case SDL_AUDIO_U8:
+         mixSampleChannels<Uint8>(voice->m_data, voice->m_channels, voice->m_frames, voice->m_position, voice->m_step, out, frames, gain, gainStep,
+            voice->m_lowPass, voice->m_filtered);
+         break;
+      case SDL_AUDIO_S8:
+         mixSampleChannels<Sint8>(voice->m_data, voice->m_channels, voice->m_frames, voice->m_position, voice->m_step, out, frames, gain, gainStep,
+            voice->m_lowPass, voice->m_filtered);
+         break;
+      case SDL_AUDIO_S16:
+         mixSampleChannels<Sint16>(voice->m_data, voice->m_channels, voice->m_frames, voice->m_position, voice->m_step, out, frames, gain, gainStep,
+            voice->m_lowPass, voice->m_filtered);
+         break;
+      case SDL_AUDIO_S32:
+         mixSampleChannels<Sint32>(voice->m_data, voice->m_channels, voice->m_frames, voice->m_position, voice->m_step, out, frames, gain, gainStep,
+            voice->m_lowPass, voice->m_filtered);
+         break;
+      case SDL_AUDIO_F32:
+         mixSampleChannels<float>(voice->m_data, voice->m_channels, voice->m_frames, voice->m_position, voice->m_step, out, frames, gain, gainStep,
+            voice->m_lowPass, voice->m_filtered);
+         break;
+      default:
+         voice->m_position = static_cast<Uint64>(voice->m_frames) << 32;
+         break;
+   }
+
+   voice->m_gain[0] = voice->m_targetGain[0];
+   voice->m_gain[1] = voice->m_targetGain[1];
+
+   if ((voice->m_position >> 32) >= voice->m_frames) {
+      voice->m_state = VS_Done;
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+void SdlAudioMixer::mixStreamVoice(Voice* voice, float* out, Int frames)
+{
+   const Int frameSize {MIX_CHANNELS * static_cast<Int>(sizeof(float))};
+   Int bytes {SDL_GetAudioStreamData(voice->m_stream, m_streamBuffer.data(), frames * frameSize)};
+   Int count {bytes > 0 ? bytes / frameSize : 0};
+
+   Real left {voice->m_gain[0]};
+   Real right {voice->m_gain[1]};
+   Real leftStep {(voice->m_targetGain[0] - left) / static_cast<Real>(frames)};
+   Real rightStep {(voice->m_targetGain[1] - right) / static_cast<Real>(frames)};
+
+   float* in {m_streamBuffer.data()};
+   if (voice->m_lowPass < 1.0f) {
+      Real lowPass {voice->m_lowPass};
+      Real filteredLeft {voice->m_filtered[0]};
+      Real filteredRight {voice->m_filtered[1]};
+      for (Int i = 0; i < count; ++i) {
+         filteredLeft += (in[i * 2] - filteredLeft) * lowPass;
+         filteredRight += (in[i * 2 + 1] - filteredRight) * lowPass;
+         in[i * 2] = filteredLeft;
+         in[i * 2 + 1] = filteredRight;
+      }
+      voice->m_filtered[0] = filteredLeft;
+      voice->m_filtered[1] = filteredRight;
+   }
+
+   for (Int i = 0; i < count; ++i) {
+      out[i * 2] += in[i * 2] * left;
+      out[i * 2 + 1] += in[i * 2 + 1] * right;
+      left += leftStep;
+      right += rightStep;
+   }
+
+   voice->m_gain[0] = voice->m_targetGain[0];
+   voice->m_gain[1] = voice->m_targetGain[1];
+}
+
+//-------------------------------------------------------------------------------------------------
+void SdlAudioMixer::mix(float* out, Int frames)
+{
+   const Int count {frames * MIX_CHANNELS};
+   std::fill(out, out + count, 0.0f);
+
+   {
+      ScopedMutex lock(m_mutex);
+      for (Int i = 0; i < MAX_VOICES; ++i) {
+         Voice* voice {&m_voices[i]};
+         if (voice->m_state != VS_Playing) {
+            continue;
+         }
+
+         voice->m_started = true;
+         if (voice->m_stream) {
+            mixStreamVoice(voice, out, frames);
+         } else {
+            mixSampleVoice(voice, out, frames);
+         }
+      }
+   }
+
+   for (Int i = 0; i < count; ++i) {
+      out[i] = std::clamp(out[i], -1.0f, 1.0f);
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Runs on SDL's audio device thread whenever the device wants more data. */
+void SDLCALL SdlAudioMixer::deviceCallback(void* userdata, SDL_AudioStream* stream, Int additional, Int /* total */)
+{
+   SdlAudioMixer* mixer {static_cast<SdlAudioMixer*>(userdata)};
+   const Int frameSize {MIX_CHANNELS * static_cast<Int>(sizeof(float))};
+
+   Int frames {(additional + frameSize - 1) / frameSize};
+   while (frames > 0) {
+      Int count {std::min<Int>(frames, MIX_BLOCK_FRAMES)};
+      mixer->mix(mixer->m_mixBuffer.data(), count);
+      SDL_PutAudioStreamData(stream, mixer->m_mixBuffer.data(), count * frameSize);
+      frames -= count;
+   }
+}
+
+//-------------------------------------------------------------------------------------------------
+/** Keeps voiceCount voices going (restarting each as it finishes) and mixes them into a buffer
+  * nobody listens to. Three in four are mono 22kHz positional sounds at assorted pitches and pans,
+  * a third of those low passed as if off screen; the rest are stereo 44kHz, like most of the
+  * game's 2-D sounds. */
+void SdlAudioMixer::benchmark(UnsignedInt voiceCount, Real seconds, Int rate)
+{
+   voiceCount = std::min<UnsignedInt>(voiceCount, MAX_VOICES);
+
+   SdlAudioMixer mixer;
+   mixer.m_rate = rate;
+
+   const Int monoRate {22050};
+   const Int stereoRate {44100};
+   std::vector<Sint16> mono(static_cast<size_t>(monoRate));
+   std::vector<Sint16> stereo(static_cast<size_t>(stereoRate) * 2);
+   for (size_t i = 0; i < mono.size(); ++i) {
+      mono[i] = static_cast<Sint16>(8000.0f * sinf(TWO_PI * 440.0f * static_cast<Real>(i) / monoRate));
+   }
+   for (size_t i = 0; i < stereo.size() / 2; ++i) {
+      stereo[i * 2] = static_cast<Sint16>(8000.0f * sinf(TWO_PI * 330.0f * static_cast<Real>(i) / stereoRate));
+      stereo[i * 2 + 1] = static_cast<Sint16>(8000.0f * sinf(TWO_PI * 550.0f * static_cast<Real>(i) / stereoRate));
+   }
+
+   const SDL_AudioSpec monoSpec {SDL_AUDIO_S16, 1, monoRate};
+   const SDL_AudioSpec stereoSpec {SDL_AUDIO_S16, 2, stereoRate};
+   const UnsignedInt monoBytes {static_cast<UnsignedInt>(mono.size() * sizeof(Sint16))};
+   const UnsignedInt stereoBytes {static_cast<UnsignedInt>(stereo.size() * sizeof(Sint16))};
+
+   std::vector<MixerVoiceID> voices(voiceCount, INVALID_MIXER_VOICE);
+   std::vector<float> out(MIX_BLOCK_FRAMES * MIX_CHANNELS);
+
+   const Int totalFrames {static_cast<Int>(seconds * static_cast<Real>(rate))};
+   UnsignedInt restarts {0};
+
+   Uint64 start {SDL_GetPerformanceCounter()};
+   for (Int mixed = 0; mixed < totalFrames; mixed += MIX_BLOCK_FRAMES) {
+      for (UnsignedInt i = 0; i < voiceCount; ++i) {
+         if (!mixer.isVoiceDone(voices[i])) {
+            continue;
+         }
+
+         mixer.stopVoice(voices[i]);
+         if (i % 4 == 3) {
+            voices[i] = mixer.playSample(stereoSpec, reinterpret_cast<const UnsignedByte*>(stereo.data()), stereoBytes, 0);
+            mixer.setVoiceGain(voices[i], 0.5f, 0.0f);
+         } else {
+            voices[i] = mixer.playSample(monoSpec, reinterpret_cast<const UnsignedByte*>(mono.data()), monoBytes, 0);
+            mixer.setVoiceGain(voices[i], 0.5f, -1.0f + 2.0f * static_cast<Real>(i % 16) / 15.0f);
+            mixer.setVoicePitch(voices[i], 0.8f + 0.4f * static_cast<Real>(i % 8) / 7.0f);
+            if (i % 4 == 0) {
+               mixer.setVoiceLowPass(voices[i], 0.5f);
+            }
+         }
+         mixer.setVoicePaused(voices[i], false);
+         ++restarts;
+      }
+
+      mixer.mix(out.data(), MIX_BLOCK_FRAMES);
+   }
+   Uint64 elapsed {SDL_GetPerformanceCounter() - start};
+
+   double cpuSeconds {static_cast<double>(elapsed) / static_cast<double>(SDL_GetPerformanceFrequency())};
+   double mixedSeconds {static_cast<double>(totalFrames) / rate};
+   printf("Mixer benchmark: %u voices (%u starts), %.1f seconds at %d Hz mixed in %.3f seconds\n",
+      voiceCount, restarts, mixedSeconds, rate, cpuSeconds);
+   printf("Mixer benchmark: %.3f ms of CPU per mixed second (%.2f%% of one core)\n",
+      1000.0 * cpuSeconds / mixedSeconds, 100.0 * cpuSeconds / mixedSeconds);
+}
@@ -30,6 +30,7 @@
 #include "Common/LocalFileSystem.h"
 #include "LinuxDevice/Common/LinuxBIGFile.h"
 #include "LinuxDevice/Common/LinuxBIGFileSystem.h"
+#include "LinuxDevice/Common/LinuxMappedBIGFile.h"
 #include "Common/Registry.h"
 
 #ifdef _INTERNAL
@@ -79,6 +80,17 @@ void LinuxBIGFileSystem::postProcessLoad() {
 }
 
 ArchiveFile * LinuxBIGFileSystem::openArchiveFile(const Char *filename) {
+   // Prefer mapping the archive: its table of contents is indexed in place and
+   // files opened from it are views into the mapping rather than RAM copies.
+   LinuxMappedBIGFile *mappedFile = NEW LinuxMappedBIGFile;
+   if (mappedFile->map(filename)) {
+      return mappedFile;
+   }
+   delete mappedFile;
+   mappedFile = NULL;
+
+   DEBUG_LOG(("LinuxBIGFileSystem::openArchiveFile - could not map %s, reading it instead\n", filename));
+
    File *fp = TheLocalFileSystem->openFile(filename, File::READ | File::BINARY);
    AsciiString archiveFileName;
    archiveFileName = filename;
@@ -24,8 +24,10 @@
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "LinuxDevice/Common/LinuxGameEngine.h"
+#include "LinuxDevice/GameClient/LinuxTextureLoader.h"
 #include "LinuxDevice/GameClient/SdlKeyboard.h"
 #include "LinuxDevice/GameClient/SdlMouse.h"
+#include "Common/GlobalData.h"
 #include "Common/PerfTimer.h"
 #include "OpenGLRenderer.h"
 #include <SDL3/SDL.h>
@@ -55,14 +57,22 @@ LinuxGameEngine::~LinuxGameEngine() {
 //-------------------------------------------------------------------------------------------------
 void LinuxGameEngine::init(int argc, char* argv[]) {
 
-   TheOpenGLRenderer = NEW OpenGLRenderer();
-   TheOpenGLRenderer->init();
+   if (!m_headless) {
+      TheOpenGLRenderer = NEW OpenGLRenderer();
+      TheOpenGLRenderer->init();
 
-   TheOpenGLRenderer->drawSplashImage();
+      TheOpenGLRenderer->drawSplashImage();
+   }
 
    // extending functionality
    GameEngine::init(argc, argv);
 
+   if (TheGlobalData->m_data.m_ddsDecodeBenchmark) {
+      LinuxTextureLoader::benchmarkDDS();
+      LinuxTextureLoader::benchmarkLoader();
+      setQuitting(TRUE);
+   }
+
 }  // end init
 
 //-------------------------------------------------------------------------------------------------
@@ -115,7 +125,9 @@ void LinuxGameEngine::update(void) {
    // }
 
    // Check for SDL events.
-   checkForEvents();
+   if (!m_headless) {
+      checkForEvents();
+   }
 
 }  // end update
 
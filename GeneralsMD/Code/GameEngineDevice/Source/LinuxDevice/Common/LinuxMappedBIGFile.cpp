@@ -0,0 +1,515 @@
+/*
+** Command & Conquer Generals Zero Hour(tm)
+** Copyright 2025 Electronic Arts Inc.
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+////// LinuxMappedBIGFile.cpp ///////////////////////
+/////////////////////////////////////////////////////
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <climits>
+#include <cstring>
+#include "Common/LocalFileSystem.h"
+#include "Common/GameMemory.h"
+#include "LinuxDevice/Common/LinuxMappedBIGFile.h"
+
+static const char *BIGFileIdentifier = "BIGF";
+static const UnsignedInt BIGHeaderSize = 0x10;
+
+//============================================================================
+// MappedArchiveFileView::MappedArchiveFileView
+//============================================================================
+
+MappedArchiveFileView::MappedArchiveFileView(): RAMFile() {
+}
+
+//============================================================================
+// MappedArchiveFileView::~MappedArchiveFileView
+//============================================================================
+
+MappedArchiveFileView::~MappedArchiveFileView() {
+   // the data belongs to the archive's mapping, so don't let RAMFile free it.
+   m_data = NULL;
+}
+
+//============================================================================
+// MappedArchiveFileView::openFromMapping
+//============================================================================
+
+Bool MappedArchiveFileView::openFromMapping(const Char *data, const AsciiString& filename, Int size) {
+   if (data == NULL || size < 0) {
+      return FALSE;
+   }
+
+   if (File::open(filename.str(), File::READ | File::BINARY) == FALSE) {
+      return FALSE;
+   }
+
+   // The mapping is read-only; RAMFile never writes through m_data.
+   m_data = const_cast<Char*>(data);
+   m_size = size;
+   m_pos = 0;
+   m_nameStr = filename;
+
+   return TRUE;
+}
+
+//============================================================================
+// MappedArchiveFileView::close
+//============================================================================
+
+void MappedArchiveFileView::close(void) {
+   m_data = NULL;
+   RAMFile::close();
+}
+
+//============================================================================
+// MappedArchiveFileView::readEntireAndClose
+//============================================================================
+/**
+   The caller owns the returned buffer, so this is the one place a view has
+   to copy its data out of the mapping.
+*/
+char* MappedArchiveFileView::readEntireAndClose() {
+   if (m_data == NULL) {
+      DEBUG_CRASH(("m_data is NULL in MappedArchiveFileView::readEntireAndClose -- should not happen!\n"));
+      return NEW char[1];  // just to avoid crashing...
+   }
+
+   char* tmp = MSGNEW("RAMFILE") char [m_size];
+   memcpy(tmp, m_data, static_cast<size_t>(m_size));
+
+   close();
+
+   return tmp;
+}
+
+//============================================================================
+// LinuxMappedBIGFile::LinuxMappedBIGFile
+//============================================================================
+
+LinuxMappedBIGFile::LinuxMappedBIGFile() {
+}
+
+//============================================================================
+// LinuxMappedBIGFile::~LinuxMappedBIGFile
+//============================================================================
+
+LinuxMappedBIGFile::~LinuxMappedBIGFile() {
+   unmap();
+}
+
+//============================================================================
+// LinuxMappedBIGFile::map
+//============================================================================
+
+Bool LinuxMappedBIGFile::map(const Char *filename) {
+   unmap();
+
+   int fd = ::open(filename, O_RDONLY);
+   if (fd < 0) {
+      DEBUG_LOG(("LinuxMappedBIGFile::map - could not open %s\n", filename));
+      return FALSE;
+   }
+
+   struct stat st;
+   if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(BIGHeaderSize)) {
+      ::close(fd);
+      DEBUG_CRASH(("Could not read archive file %s", filename));
+      return FALSE;
+   }
+
+   size_t mappingSize = static_cast<size_t>(st.st_size);
+   void *mapping = mmap(NULL, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+   // the mapping keeps its own reference to the file.
+   ::close(fd);
+
+   if (mapping == MAP_FAILED) {
+      DEBUG_LOG(("LinuxMappedBIGFile::map - could not map %s\n", filename));
+      return FALSE;
+   }
+
+   m_mapping = static_cast<const Char*>(mapping);
+   m_mappingSize = mappingSize;
+   m_path = filename;
+   const char *lastSlash = strrchr(filename, '/');
+   m_name = (lastSlash != NULL) ? lastSlash + 1 : filename;
+
+   if (!parseTableOfContents()) {
+      DEBUG_CRASH(("Error reading BIG file table of contents in file %s", filename));
+      unmap();
+      return FALSE;
+   }
+
+   DEBUG_LOG(("LinuxMappedBIGFile::map - mapped %s, %d bytes, %d files\n", filename, static_cast<Int>(m_mappingSize), getEntryCount()));
+
+   return TRUE;
+}
+
+//============================================================================
+// LinuxMappedBIGFile::unmap
+//============================================================================
+
+void LinuxMappedBIGFile::unmap(void) {
+   if (m_mapping != NULL) {
+      munmap(const_cast<Char*>(m_mapping), m_mappingSize);
+      m_mapping = NULL;
+      m_mappingSize = 0;
+   }
+   m_entries.clear();
+   m_slots.clear();
+   m_paths.clear();
+}
+
+//============================================================================
+// LinuxMappedBIGFile::normalizePath
+//============================================================================
+/**
+   Lower-case the path, use back slashes throughout and drop leading and
+   doubled separators, so that "Data/INI//Object.ini" and
+   "data\ini\object.ini" name the same entry.  Returns the normalized length,
+   or UINT_MAX if it doesn't fit in dst.
+*/
+UnsignedInt LinuxMappedBIGFile::normalizePath(const Char *src, const Char *srcEnd, Char *dst, UnsignedInt dstSize) {
+   UnsignedInt length = 0;
+   Bool lastWasSeparator = TRUE;
+
+   for (; src != srcEnd && *src != 0; ++src) {
+      Char c = *src;
+      if (c == '/' || c == '\\') {
+         if (lastWasSeparator) {
+            continue;
+         }
+         c = '\\';
+         lastWasSeparator = TRUE;
+      } else {
+         if (c >= 'A' && c <= 'Z') {
+            c = static_cast<Char>(c - 'A' + 'a');
+         }
+         lastWasSeparator = FALSE;
+      }
+
+      if (length + 1 >= dstSize) {
+         return UINT_MAX;
+      }
+      dst[length++] = c;
+   }
+
+   dst[length] = 0;
+   return length;
+}
+
+//============================================================================
+// LinuxMappedBIGFile::hashPath
+//============================================================================
+
+UnsignedInt LinuxMappedBIGFile::hashPath(const Char *path, UnsignedInt length) {
+   // FNV-1a
+   UnsignedInt hash = 2166136261u;
+   for (UnsignedInt i = 0; i < length; ++i) {
+      hash ^= static_cast<UnsignedByte>(path[i]);
+      hash *= 16777619u;
+   }
+   return hash;
+}
+
+//============================================================================
+// LinuxMappedBIGFile::parseTableOfContents
+//============================================================================
+
+Bool LinuxMappedBIGFile::parseTableOfContents(void) {
+   if (memcmp(m_mapping, BIGFileIdentifier, 4) != 0) {
+      return FALSE;
+   }
+
+   // the file count is stored big-endian.
+   UnsignedInt numLittleFiles = 0;
+   memcpy(&numLittleFiles, m_mapping + 8, 4);
+   numLittleFiles = ntohl(numLittleFiles);
+
+   // every entry needs at least two words and a terminator.
+   if (numLittleFiles > (m_mappingSize - BIGHeaderSize) / 9) {
+      return FALSE;
+   }
+
+   UnsignedInt capacity = 16;
+   while (capacity < numLittleFiles * 2) {
+      capacity <<= 1;
+   }
+   m_slots.assign(capacity, -1);
+   m_entries.reserve(numLittleFiles);
+
+   const Char *cur = m_mapping + BIGHeaderSize;
+   const Char *end = m_mapping + m_mappingSize;
+   Char buffer[PATH_MAX];
+
+   for (UnsignedInt i = 0; i < numLittleFiles; ++i) {
+      if (end - cur < 8) {
+         return FALSE;
+      }
+
+      Entry entry;
+      memcpy(&entry.m_offset, cur, 4);
+      memcpy(&entry.m_size, cur + 4, 4);
+      entry.m_offset = ntohl(entry.m_offset);
+      entry.m_size = ntohl(entry.m_size);
+      cur += 8;
+
+      const Char *nameEnd = static_cast<const Char*>(memchr(cur, 0, static_cast<size_t>(end - cur)));
+      if (nameEnd == NULL) {
+         return FALSE;
+      }
+
+      if (entry.m_offset > m_mappingSize || entry.m_size > m_mappingSize - entry.m_offset) {
+         DEBUG_CRASH(("Entry %s lies outside of archive %s", cur, m_path.str()));
+         return FALSE;
+      }
+
+      UnsignedInt length = normalizePath(cur, nameEnd, buffer, PATH_MAX);
+      cur = nameEnd + 1;
+      if (length == UINT_MAX || length == 0) {
+         continue;
+      }
+
+      entry.m_hash = hashPath(buffer, length);
+      entry.m_pathOffset = static_cast<UnsignedInt>(m_paths.size());
+      entry.m_pathLength = length;
+      entry.m_nameOffset = 0;
+      for (UnsignedInt c = 0; c < length; ++c) {
+         if (buffer[c] == '\\') {
+            entry.m_nameOffset = c + 1;
+         }
+      }
+      m_paths.insert(m_paths.end(), buffer, buffer + length + 1);
+
+      insertEntry(entry);
+   }
+
+   return TRUE;
+}
+
+//============================================================================
+// LinuxMappedBIGFile::insertEntry
+//============================================================================
+/**
+   Linear probing over a power-of-two table that is kept at most half full.
+   A later entry with the same path replaces the earlier one, as the nested
+   directory maps used to.
+*/
+void LinuxMappedBIGFile::insertEntry(const Entry& entry) {
+   size_t mask = m_slots.size() - 1;
+   size_t slot = entry.m_hash & mask;
+   const Char *path = &m_paths[entry.m_pathOffset];
+
+   while (m_slots[slot] >= 0) {
+      Entry& existing = m_entries[static_cast<size_t>(m_slots[slot])];
+      if (existing.m_hash == entry.m_hash && existing.m_pathLength == entry.m_pathLength &&
+            memcmp(&m_paths[existing.m_pathOffset], path, entry.m_pathLength) == 0) {
+         existing.m_offset = entry.m_offset;
+         existing.m_size = entry.m_size;
+         return;
+      }
+      slot = (slot + 1) & mask;
+   }
+
+   m_slots[slot] = static_cast<Int>(m_entries.size());
+   m_entries.push_back(entry);
+}
+
+//============================================================================
+// LinuxMappedBIGFile::findEntry
+//============================================================================
+
+const LinuxMappedBIGFile::Entry* LinuxMappedBIGFile::findEntry(const Char *filename) const {
+   if (filename == NULL || m_slots.empty()) {
+      return NULL;
+   }
+
+   Char buffer[PATH_MAX];
+   UnsignedInt length = normalizePath(filename, NULL, buffer, PATH_MAX);
+   if (length == UINT_MAX || length == 0) {
+      return NULL;
+   }
+
+   UnsignedInt hash = hashPath(buffer, length);
+   size_t mask = m_slots.size() - 1;
+   size_t slot = hash & mask;
+
+   while (m_slots[slot] >= 0) {
+      const Entry& entry = m_entries[static_cast<size_t>(m_slots[slot])];
+      if (entry.m_hash == hash && entry.m_pathLength == length &&
+            memcmp(&m_paths[entry.m_pathOffset], buffer, length) == 0) {
+         return &entry;
+      }
+      slot = (slot + 1) & mask;
+   }
+
+   return NULL;
+}
+
+//============================================================================
+// LinuxMappedBIGFile::openFile
+//============================================================================
+
+File* LinuxMappedBIGFile::openFile(const Char* filename, Int access) {
+   const Entry* entry {findEntry(filename)};
+
+   if (entry == NULL) {
+      return NULL;
+   }
+
+   AsciiString name {&m_paths[entry->m_pathOffset + entry->m_nameOffset]};
+
+   MappedArchiveFileView *view = newInstance(MappedArchiveFileView);
+   view->deleteOnClose();
+   if (view->openFromMapping(m_mapping + entry->m_offset, name, static_cast<Int>(entry->m_size)) == FALSE) {
+      view->close();
+      return NULL;
+   }
+
+   if ((access & File::WRITE) == 0) {
+      // requesting read only access. Just return the view; streaming files are
+      // already paged in on demand by the mapping.
+      return view;
+   }
+
+   // whoever is opening this file wants write access, so copy the file to the local disk
+   // and return that file pointer.
+
+   File* localFile {TheLocalFileSystem->openFile(filename, access)};
+   if (localFile != NULL) {
+      view->copyDataToFile(localFile);
+   }
+
+   view->close();
+
+   return localFile;
+}
+
+//============================================================================
+// LinuxMappedBIGFile::getFileListInDirectory
+//============================================================================
+/**
+   Walks the flat entry list instead of a directory tree.  Like the tree walk
+   in ArchiveFile, subdirectories are always searched and only the file name
+   part is matched against searchName.
+*/
+void LinuxMappedBIGFile::getFileListInDirectory(const AsciiString&, const AsciiString& originalDirectory, const AsciiString& searchName, FilenameList &filenameList, Bool) const {
+   Char prefix[PATH_MAX];
+   UnsignedInt prefixLength = normalizePath(originalDirectory.str(), NULL, prefix, PATH_MAX - 1);
+   if (prefixLength == UINT_MAX) {
+      return;
+   }
+   if (prefixLength > 0 && prefix[prefixLength - 1] != '\\') {
+      prefix[prefixLength++] = '\\';
+      prefix[prefixLength] = 0;
+   }
+
+   AsciiString directory {originalDirectory};
+   if ((directory.getLength() > 0) && (!directory.endsWith("\\")) && (!directory.endsWith("/"))) {
+      directory.concat('\\');
+   }
+
+   for (const Entry& entry : m_entries) {
+      const Char *path = &m_paths[entry.m_pathOffset];
+      if (entry.m_pathLength <= prefixLength || memcmp(path, prefix, prefixLength) != 0) {
+         continue;
+      }
+
+      if (!SearchStringMatches(AsciiString(path + entry.m_nameOffset), searchName)) {
+         continue;
+      }
+
+      AsciiString tempfilename {directory};
+      tempfilename.concat(path + prefixLength);
+      filenameList.insert(tempfilename);
+   }
+}
+
+//============================================================================
+// LinuxMappedBIGFile::getFileInfo
+//============================================================================
+
+Bool LinuxMappedBIGFile::getFileInfo(const AsciiString& filename, FileInfo *fileInfo) const {
+   const Entry *entry = findEntry(filename.str());
+
+   if (entry == NULL) {
+      return FALSE;
+   }
+
+   TheLocalFileSystem->getFileInfo(m_path, fileInfo);
+
+   fileInfo->size = entry->m_size;
+
+   return TRUE;
+}
+
+//============================================================================
+// LinuxMappedBIGFile::getFileOffset
+//============================================================================
+
+Bool LinuxMappedBIGFile::getFileOffset(const AsciiString& filename, UnsignedInt *offset) const {
+   const Entry *entry = findEntry(filename.str());
+
+   if (entry == NULL) {
+      return FALSE;
+   }
+
+   *offset = entry->m_offset;
+
+   return TRUE;
+}
+
+//============================================================================
+// LinuxMappedBIGFile::closeAllFiles
+//============================================================================
+
+void LinuxMappedBIGFile::closeAllFiles(void) {
+}
+
+//============================================================================
+// LinuxMappedBIGFile::getName
+//============================================================================
+
+AsciiString LinuxMappedBIGFile::getName(void) {
+   return m_name;
+}
+
+//============================================================================
+// LinuxMappedBIGFile::getPath
+//============================================================================
+
+AsciiString LinuxMappedBIGFile::getPath(void) {
+   return m_path;
+}
+
+//============================================================================
+// LinuxMappedBIGFile::setSearchPriority
+//============================================================================
+
+void LinuxMappedBIGFile::setSearchPriority(Int) {
+}
+
+//============================================================================
+// LinuxMappedBIGFile::close
+//============================================================================
+
+void LinuxMappedBIGFile::close(void) {
+}
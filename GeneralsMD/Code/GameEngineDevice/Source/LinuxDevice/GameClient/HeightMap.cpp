@@ -189,7 +189,8 @@ inline Int IABS(Int x) { if (x>=0) return x; return -x; };
 //=============================================================================
 void HeightMapRenderObjClass::freeIndexVertexBuffers(void)
 {
-	glDeleteBuffers(1, &m_indexBuffer);
+	if (m_indexBuffer)
+		glDeleteBuffers(1, &m_indexBuffer);
 	m_indexBuffer = 0;
 	if (m_vertexBufferTiles) {
 		glDeleteBuffers(m_numVertexBufferTiles, m_vertexBufferTiles);
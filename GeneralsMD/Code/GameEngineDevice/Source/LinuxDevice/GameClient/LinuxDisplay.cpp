@@ -22,19 +22,22 @@
 
 #include "LinuxDevice/GameClient/LinuxDisplay.h"
 #include "LinuxDevice/GameClient/LinuxFileSystem.h"
+#include "LinuxDevice/GameClient/LinuxTextureLoader.h"
 #include "GameClient/Image.h"
 #include "GameClient/InGameUI.h"
 #include "Common/FileSystem.h"
+#include "Common/GlobalData.h"
 #include "LinuxDevice/Common/SdlFileStream.h"
 #include "OpenGLRenderer.h"
 #include "TARGA.H"
-#include "ddsfile.h"
 #include <SDL3_image/SDL_image.h>
+#include <algorithm>
 #include <set>
 
 // DEFINES ////////////////////////////////////////////////////////////////////
 #define MIN_DISPLAY_RESOLUTION_X 800
 #define MIN_DISPLAY_RESOLUTION_Y 600
+#define TEXTURE_PLACEHOLDER_COLOR GameMakeColor(0, 0, 0, 96)   ///< drawn in place of an image that's still loading
 
 // PRIVATE FUNCTIONS //////////////////////////////////////////////////////////////////////////////
 Bool isFourByThreeAspect(Int x, Int y) {
@@ -46,32 +49,6 @@ Bool isFourByThreeAspect(Int x, Int y) {
    return ((aspectRatio > 1.332f) && (aspectRatio < 1.334f));
 }
 
-//-------------------------------------------------------------------------------------------------
-void yFlipTarga(Targa* targa) {
-   /* Pixel depth in bytes. */
-   char depth = TGA_BytesPerPixel(targa->Header.PixelDepth);
-
-   for (int y = 0; y < (targa->Header.Height >> 1); y++)
-   {
-      /* Compute address of lines to exchange. */
-      char* ptr = (targa->GetImage() + ((targa->Header.Width * y) * depth));
-      char* ptr1 = (targa->GetImage() + ((targa->Header.Width * (targa->Header.Height - 1)) * depth));
-      ptr1 -= ((targa->Header.Width * y) * depth);
-
-      /* Exchange all the pixels on this scan line. */
-
-      for (int x = 0; x < (targa->Header.Width * depth); x++)
-      {
-         char v = *ptr;
-         char v1 = *ptr1;
-         *ptr = v1;
-         *ptr1 = v;
-         ptr++;
-         ptr1++;
-      }
-   } 
-} 
-
 //-------------------------------------------------------------------------------------------------
 // fileExtensionDDS
 // Typically used to change the extension of a Targa file name from .tga to .dds.
@@ -96,8 +73,11 @@ LinuxDisplay::LinuxDisplay()
 
 LinuxDisplay::~LinuxDisplay()
 {
+   delete m_textureLoader;
+   m_textureLoader = NULL;
+
    for (const auto& [key, value] : m_textureCache) {
-      if (value.loaded) {
+      if (value.texture) {
          SDL_DestroyTexture(value.texture);
       }
       if (value.gameFile) {
@@ -146,6 +126,26 @@ void LinuxDisplay::init()
 
    TheMappedImageCollection->iterate(storeTexturePath);
 
+   // no video subsystem to ask about display modes, and nothing is ever drawn
+   if (TheGlobalData->m_data.m_headless) {
+      return;
+   }
+
+   // a re-init drops whatever the old loader still had queued, so ask again for those
+   delete m_textureLoader;
+   m_textureLoader = NULL;
+   for (auto& [name, texture] : m_textureCache) {
+      if (!texture.loaded) {
+         texture.requested = FALSE;
+      }
+   }
+
+   AsciiString cacheDirectory {};
+   if (TheGlobalData->m_data.m_useTextureCache) {
+      cacheDirectory.format("%sTextureCache/", TheGlobalData->getPath_UserData().str());
+   }
+   m_textureLoader = NEW LinuxTextureLoader(LinuxTextureLoader::getDefaultThreadCount(), cacheDirectory);
+
    // MG: Hmm... what to do with multiple displays?  I guess we'll use just the first one.
    SDL_DisplayID displayID {SDL_GetPrimaryDisplay()};
    if (displayID == 0) {
@@ -236,8 +236,14 @@ void LinuxDisplay::setClipRegion( IRegion2D *region )
 //============================================================================
 void LinuxDisplay::draw()
 {
+   if (TheGlobalData->m_data.m_headless) {
+      return;
+   }
+
    updateViews();
 
+   uploadFinishedTextures();
+
    TheOpenGLRenderer->beginRender();
 
    // draw all views of the world
@@ -397,44 +403,29 @@ void LinuxDisplay::drawImage( const Image *image, Int startX, Int startY, Int en
    if (!m_textureCache.contains(image->getFilename())) {
       DEBUG_CRASH(("LinuxDisplay::drawImage: Texture not found for image called '%s'.\n", image->getFilename().str()));
    }
-   Texture tex {m_textureCache[image->getFilename()]};
+   Texture& tex {m_textureCache[image->getFilename()]};
    if (!tex.gameFile->Is_Available()) {
       DEBUG_CRASH(("LinuxDisplay::drawImage: Image called '%s' is not available.\n", image->getFilename().str()));
    }
    if (!tex.loaded) {
-      DEBUG_LOG(("Loading texture %s (%s)\n", image->getFilename().str(), tex.gameFile->File_Path()));
-      if (tex.dds) {
-         DDSFileClass dds {tex.gameFile};
-         DEBUG_ASSERTCRASH(dds.Load(tex.gameFile), ("LinuxDisplay::drawImage: Failed to load .dds file\n"));
-         SDL_Surface* surface {SDL_CreateSurface(static_cast<int>(dds.Get_Full_Width()), static_cast<int>(dds.Get_Full_Height()), SDL_PIXELFORMAT_ABGR8888)};
-         dds.Copy_Level_To_Surface(0, WW3D_FORMAT_A8R8G8B8, dds.Get_Full_Width(), dds.Get_Full_Height(), static_cast<unsigned char*>(surface->pixels), dds.Get_Full_Width() * 4);
-         tex.texture = SDL_CreateTextureFromSurface(renderer, surface);
-         SDL_DestroySurface(surface);
-         tex.loaded = TRUE;
-         m_textureCache[image->getFilename()] = tex;
-      } else {
-         Targa targa {};
-         long status {targa.Load(tex.gameFile, TGAF_IMAGE, false)};
-         if (status == 0) {
-            yFlipTarga(&targa);
-            SDL_PixelFormat format {SDL_PIXELFORMAT_UNKNOWN};
-            int pitch {0};
-            if (targa.Header.PixelDepth == 32) {
-               format = SDL_PIXELFORMAT_BGRA32;
-               pitch = targa.Header.Width * 4;
-            } else if (targa.Header.PixelDepth == 24) {
-               format = SDL_PIXELFORMAT_BGR24;
-               pitch = targa.Header.Width * 3;
-            } else {
-               DEBUG_CRASH(("LinuxDisplay::drawImage: Invalid Targa pixel depth: %d\n", targa.Header.PixelDepth));
-            }
-            SDL_Surface* surface {SDL_CreateSurfaceFrom(targa.Header.Width, targa.Header.Height, format, targa.GetImage(), pitch)};
-            tex.texture = SDL_CreateTextureFromSurface(renderer, surface);
-            SDL_DestroySurface(surface);
+      if (m_textureLoader == NULL) {
+         return;
+      }
+      if (!tex.requested) {
+         DEBUG_LOG(("Loading texture %s (%s)\n", image->getFilename().str(), tex.gameFile->File_Path()));
+         tex.requested = TRUE;
+         if (!m_textureLoader->request(image->getFilename(), tex.gameFile, AsciiString(tex.gameFile->File_Path()), tex.dds)) {
+            DEBUG_LOG(("LinuxDisplay::drawImage: could not read %s\n", tex.gameFile->File_Path()));
             tex.loaded = TRUE;
-            m_textureCache[image->getFilename()] = tex;
          }
       }
+      if (!tex.loaded) {
+         drawFillRect(startX, startY, endX - startX, endY - startY, TEXTURE_PLACEHOLDER_COLOR);
+      }
+      return;
+   }
+   if (tex.texture == NULL) {
+      return;
    }
 
    SDL_FRect src {};
@@ -450,6 +441,45 @@ void LinuxDisplay::drawImage( const Image *image, Int startX, Int startY, Int en
    SDL_RenderTexture(renderer, tex.texture, &src, &dest);
 }  // end drawImage
 
+// LinuxDisplay::uploadFinishedTextures ======================================
+/** Images are decoded on the texture loader's threads; only the upload to
+   * the renderer has to happen here. */
+//=============================================================================
+void LinuxDisplay::uploadFinishedTextures()
+{
+   if (m_textureLoader == NULL) {
+      return;
+   }
+
+   std::vector<DecodedTexture> finished {};
+   m_textureLoader->takeFinished(finished);
+   for (DecodedTexture& decoded : finished) {
+      TextureCache::iterator it {m_textureCache.find(AsciiString(decoded.m_name.c_str()))};
+      if (it == m_textureCache.end()) {
+         continue;
+      }
+      Texture& tex {it->second};
+      tex.loaded = TRUE;
+      // the workers can't log, so report what they found here
+      if (decoded.m_targaError != 0) {
+         Targa_Error_Handler(decoded.m_targaError, decoded.m_name.c_str());
+      }
+      if (!decoded.m_ok) {
+         DEBUG_LOG(("LinuxDisplay::uploadFinishedTextures: could not decode %s: %s\n", decoded.m_name.c_str(),
+            decoded.m_error != NULL ? decoded.m_error : "Targa load failed"));
+         continue;
+      }
+      if (decoded.m_dxt1Alpha) {
+         DEBUG_LOG(("Warning: DXT1 format should not contain alpha information - file %s\n", decoded.m_name.c_str()));
+      }
+      SDL_Surface* surface {SDL_CreateSurfaceFrom(decoded.m_width, decoded.m_height, decoded.m_format, decoded.m_pixels.data(), decoded.m_pitch)};
+      tex.texture = SDL_CreateTextureFromSurface(renderer, surface);
+      SDL_DestroySurface(surface);
+      DEBUG_LOG(("Loaded texture %s, %s in %.2f ms\n", decoded.m_name.c_str(),
+         decoded.m_fromCache ? "read from the texture cache" : "decoded", decoded.m_milliseconds));
+   }
+}
+
 //============================================================================
 // LinuxDisplay::drawVideoBuffer
 //============================================================================
@@ -0,0 +1,672 @@
+/*
+** Command & Conquer Generals Zero Hour(tm)
+** Copyright 2025 Electronic Arts Inc.
+**
+** This program is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** This program is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+////// LinuxTextureLoader.cpp ///////////////////////
+/////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include "Common/FileSystem.h"
+#include "Common/GlobalData.h"
+#include "Common/INICache.h"
+#include "LinuxDevice/GameClient/LinuxTextureLoader.h"
+#include "RAMFILE.H"
+#include "TARGA.H"
+#include "ddsfile.h"
+#include "formconv.h"
+
+#define MAX_TEXTURE_LOADER_THREADS 4
+
+static const char TextureCacheMagic[4] = { 'T', 'E', 'X', 'C' };
+
+// bump this whenever the cache file layout or the decoders' output changes
+static const UnsignedInt TextureCacheVersion = 1;
+
+//-------------------------------------------------------------------------------------------------
+static void yFlipTarga(Targa* targa) {
+   /* Pixel depth in bytes. */
+   char depth = TGA_BytesPerPixel(targa->Header.PixelDepth);
+
+   for (int y = 0; y < (targa->Header.Height >> 1); y++)
+   {
+      /* Compute address of lines to exchange. */
+      char* ptr = (targa->GetImage() + ((targa->Header.Width * y) * depth));
+      char* ptr1 = (targa->GetImage() + ((targa->Header.Width * (targa->Header.Height - 1)) * depth));
+      ptr1 -= ((targa->Header.Width * y) * depth);
+
+      /* Exchange all the pixels on this scan line. */
+
+      for (int x = 0; x < (targa->Header.Width * depth); x++)
+      {
+         char v = *ptr;
+         char v1 = *ptr1;
+         *ptr = v1;
+         *ptr1 = v;
+         ptr++;
+         ptr1++;
+      }
+   } 
+} 
+
+//-------------------------------------------------------------------------------------------------
+/** Everything DDSFileClass would assert on, checked from the raw file so a worker can
+  * refuse it quietly.  Returns NULL if the top level can be decoded. */
+//-------------------------------------------------------------------------------------------------
+static const char *checkDDS(const std::vector<UnsignedByte>& source) {
+   const size_t header = 4 + sizeof(LegacyDDSURFACEDESC2);
+   if (source.size() <= header || memcmp(source.data(), "DDS ", 4) != 0) {
+      return "not a DDS file";
+   }
+   LegacyDDSURFACEDESC2 desc;
+   memcpy(&desc, source.data() + 4, sizeof(desc));
+   if (desc.Size != sizeof(LegacyDDSURFACEDESC2)) {
+      return "unexpected DDS header size";
+   }
+
+   WW3DFormat format = D3DFormat_To_WW3DFormat(static_cast<D3DFORMAT>(desc.PixelFormat.FourCC));
+   if (format != WW3D_FORMAT_DXT1 && format != WW3D_FORMAT_DXT3 && format != WW3D_FORMAT_DXT5) {
+      return "only DXT1, DXT3 and DXT5 DDS files are supported";
+   }
+   if (desc.Width == 0 || desc.Height == 0 || desc.Width > 16384 || desc.Height > 16384 || desc.MipMapCount > 32) {
+      return "bad DDS dimensions";
+   }
+
+   // DDSFileClass won't read past the end, but the top level has to be all there to decode it
+   size_t blocks = static_cast<size_t>((desc.Width + 3) / 4) * ((desc.Height + 3) / 4);
+   if (source.size() - header < blocks * (format == WW3D_FORMAT_DXT1 ? 8 : 16)) {
+      return "DDS file is truncated";
+   }
+   return NULL;
+}
+
+//============================================================================
+// LinuxTextureLoader::LinuxTextureLoader
+//============================================================================
+
+LinuxTextureLoader::LinuxTextureLoader(Int threadCount, const AsciiString& cacheDirectory) {
+   if (!cacheDirectory.isEmpty()) {
+      std::error_code error;
+      std::filesystem::create_directories(cacheDirectory.str(), error);
+      if (error) {
+         DEBUG_LOG(("LinuxTextureLoader - could not create texture cache %s, not caching\n", cacheDirectory.str()));
+      } else {
+         m_cacheDirectory = cacheDirectory.str();
+      }
+   }
+
+   for (Int i = 0; i < threadCount; ++i) {
+      m_threads.emplace_back(&LinuxTextureLoader::threadMain, this);
+   }
+}
+
+//============================================================================
+// LinuxTextureLoader::~LinuxTextureLoader
+//============================================================================
+
+LinuxTextureLoader::~LinuxTextureLoader() {
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_jobs.clear();
+      m_quit = TRUE;
+   }
+   m_wake.notify_all();
+
+   for (std::thread& thread : m_threads) {
+      thread.join();
+   }
+}
+
+//============================================================================
+// LinuxTextureLoader::getDefaultThreadCount
+//============================================================================
+
+Int LinuxTextureLoader::getDefaultThreadCount() {
+   return std::clamp(static_cast<Int>(std::thread::hardware_concurrency()) - 1, 1, MAX_TEXTURE_LOADER_THREADS);
+}
+
+//============================================================================
+// LinuxTextureLoader::request
+//============================================================================
+
+Bool LinuxTextureLoader::request(const AsciiString& name, FileClass *file, const AsciiString& sourcePath, Bool dds) {
+   Job job;
+   job.m_name = name.str();
+   job.m_sourcePath = sourcePath.str();
+   job.m_dds = dds;
+
+   // archives are memory mapped, so this is a copy rather than a wait on the disk
+   if (!file->Open()) {
+      return FALSE;
+   }
+   Int size = file->Size();
+   if (size > 0) {
+      job.m_source.resize(static_cast<size_t>(size));
+      if (file->Read(job.m_source.data(), size) != size) {
+         job.m_source.clear();
+      }
+   }
+   file->Close();
+   if (job.m_source.empty()) {
+      return FALSE;
+   }
+
+   if (!m_cacheDirectory.empty()) {
+      FileInfo info {};
+      if (TheFileSystem->getFileInfo(sourcePath, &info)) {
+         job.m_sourceSize = info.size;
+         job.m_sourceTimestamp = info.timestamp;
+      } else {
+         job.m_sourceSize = static_cast<UnsignedInt64>(size);
+      }
+
+      char leaf[32];
+      snprintf(leaf, sizeof(leaf), "%08x.tex", INICache::hashBytes(sourcePath.str(), sourcePath.getLength()));
+      job.m_cachePath = m_cacheDirectory + leaf;
+   }
+
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_jobs.push_back(std::move(job));
+   }
+   m_wake.notify_one();
+   return TRUE;
+}
+
+//============================================================================
+// LinuxTextureLoader::takeFinished
+//============================================================================
+
+void LinuxTextureLoader::takeFinished(std::vector<DecodedTexture>& finished) {
+   finished.clear();
+   std::lock_guard<std::mutex> lock(m_mutex);
+   finished.swap(m_finished);
+}
+
+//============================================================================
+// LinuxTextureLoader::getPendingCount
+//============================================================================
+
+Int LinuxTextureLoader::getPendingCount() {
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return static_cast<Int>(m_jobs.size()) + m_busy;
+}
+
+//============================================================================
+// LinuxTextureLoader::threadMain
+//============================================================================
+
+void LinuxTextureLoader::threadMain() {
+   for (;;) {
+      Job job;
+      {
+         std::unique_lock<std::mutex> lock(m_mutex);
+         m_wake.wait(lock, [this] { return m_quit || !m_jobs.empty(); });
+         if (m_quit) {
+            return;
+         }
+         job = std::move(m_jobs.front());
+         m_jobs.pop_front();
+         ++m_busy;
+      }
+
+      DecodedTexture result;
+      result.m_name = job.m_name;
+
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      if (!job.m_cachePath.empty() && readCache(job, result)) {
+         result.m_fromCache = TRUE;
+      } else {
+         decode(job, result);
+         if (result.m_ok && !job.m_cachePath.empty()) {
+            writeCache(job, result);
+         }
+      }
+      result.m_milliseconds = std::chrono::duration<Real, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_finished.push_back(std::move(result));
+      --m_busy;
+   }
+}
+
+//============================================================================
+// LinuxTextureLoader::decode
+//============================================================================
+
+void LinuxTextureLoader::decode(Job& job, DecodedTexture& result) {
+   RAMFileClass file(job.m_source.data(), static_cast<int>(job.m_source.size()));
+
+   if (job.m_dds) {
+      // DDSFileClass asserts on a bad header and Copy_Level_To_Surface logs, neither
+      // of which may happen here, so check the file first and decode the level directly
+      result.m_error = checkDDS(job.m_source);
+      if (result.m_error != NULL) {
+         return;
+      }
+      DDSFileClass dds {&file};
+      if (!dds.Load(&file)) {
+         result.m_error = "DDS data could not be read";
+         return;
+      }
+      // the decoder writes whole 4x4 blocks, so round the surface up to them
+      unsigned width = dds.Get_Full_Width();
+      unsigned height = dds.Get_Full_Height();
+      unsigned pitch = ((width + 3) & ~3u) * 4;
+      result.m_width = static_cast<Int>(width);
+      result.m_height = static_cast<Int>(height);
+      result.m_pitch = static_cast<Int>(pitch);
+      result.m_format = SDL_PIXELFORMAT_ABGR8888;
+      result.m_pixels.resize(static_cast<size_t>(pitch) * ((height + 3) & ~3u));
+      Bool alpha = dds.Decode_DXT_Level(0, result.m_pixels.data(), pitch);
+      result.m_pixels.resize(static_cast<size_t>(pitch) * height);
+      result.m_dxt1Alpha = alpha && dds.Get_Format() == WW3D_FORMAT_DXT1;
+      result.m_ok = TRUE;
+   } else {
+      Targa targa {};
+      result.m_targaError = targa.Load(&file, TGAF_IMAGE, false);
+      if (result.m_targaError != 0) {
+         return;
+      }
+      yFlipTarga(&targa);
+      Int bytesPerPixel {0};
+      if (targa.Header.PixelDepth == 32) {
+         result.m_format = SDL_PIXELFORMAT_BGRA32;
+         bytesPerPixel = 4;
+      } else if (targa.Header.PixelDepth == 24) {
+         result.m_format = SDL_PIXELFORMAT_BGR24;
+         bytesPerPixel = 3;
+      } else {
+         result.m_error = "only 24 and 32 bit Targa files are supported";
+         return;
+      }
+      result.m_width = targa.Header.Width;
+      result.m_height = targa.Header.Height;
+      result.m_pitch = result.m_width * bytesPerPixel;
+      const UnsignedByte *image = reinterpret_cast<const UnsignedByte*>(targa.GetImage());
+      result.m_pixels.assign(image, image + static_cast<size_t>(result.m_pitch) * static_cast<size_t>(result.m_height));
+      result.m_ok = TRUE;
+   }
+}
+
+//============================================================================
+// LinuxTextureLoader::benchmarkDDS
+//============================================================================
+
+static Int64 ddsBenchmarkNanos() {
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void LinuxTextureLoader::benchmarkDDS() {
+   FilenameList names;
+   TheFileSystem->getFileListInDirectory(AsciiString(""), AsciiString("*.dds"), names, TRUE);
+
+   Int images {0};
+   Int unreadable {0};
+   Int levels {0};
+   Int checkedLevels {0};
+   Int mismatches {0};
+   UnsignedInt64 levelBytes {0};
+   UnsignedInt64 compressedBytes {0};
+   UnsignedInt64 checkedBytes {0};
+   Int64 levelNanos {0};
+   Int64 blockNanos {0};
+   std::vector<UnsignedByte> source;
+   std::vector<UnsignedByte> transcoded;
+   std::vector<UnsignedByte> decoded;
+   std::vector<UnsignedByte> reference;
+
+   for (FilenameList::const_iterator it = names.begin(); it != names.end(); ++it) {
+      FileClass *file = _TheFileFactory->Get_File(it->str());
+      Bool read = file != NULL && file->Open();
+      if (read) {
+         Int size = file->Size();
+         source.resize(static_cast<size_t>(std::max(size, 0)));
+         read = size > 0 && file->Read(source.data(), size) == size;
+         file->Close();
+      }
+      if (file != NULL) {
+         _TheFileFactory->Return_File(file);
+      }
+      if (!read) {
+         ++unreadable;
+         continue;
+      }
+
+      RAMFileClass ram(source.data(), static_cast<int>(source.size()));
+      DDSFileClass dds {&ram};
+      if (!dds.Load(&ram)) {
+         ++unreadable;
+         continue;
+      }
+      ++images;
+
+      WW3DFormat format = dds.Get_Format();
+      if (format != WW3D_FORMAT_DXT1 && format != WW3D_FORMAT_DXT3 && format != WW3D_FORMAT_DXT5) {
+         continue;
+      }
+
+      // Get_4x4_Block doesn't do DXT3, but DXT3 and DXT5 share the colour half of
+      // each block. Give it a DXT5 copy whose alpha halves all decode to 255, then
+      // put the explicit DXT3 alphas back into its output.
+      DDSFileClass *colors = &dds;
+      RAMFileClass *transcodedRam = NULL;
+      DDSFileClass *transcodedDds = NULL;
+      if (format == WW3D_FORMAT_DXT3) {
+         const size_t header = 4 + sizeof(LegacyDDSURFACEDESC2);
+         transcoded = source;
+         unsigned fourCC = WW3DFormat_To_D3DFormat(WW3D_FORMAT_DXT5);
+         memcpy(transcoded.data() + 4 + offsetof(LegacyDDSURFACEDESC2, PixelFormat) + offsetof(LegacyDDPIXELFORMAT, FourCC),
+            &fourCC, sizeof(fourCC));
+         for (size_t block = header; block + 16 <= transcoded.size(); block += 16) {
+            static const UnsignedByte opaque[8] {255, 0, 0, 0, 0, 0, 0, 0};
+            memcpy(transcoded.data() + block, opaque, sizeof(opaque));
+         }
+         transcodedRam = new RAMFileClass(transcoded.data(), static_cast<int>(transcoded.size()));
+         transcodedDds = new DDSFileClass {transcodedRam};
+         if (!transcodedDds->Load(transcodedRam)) {
+            delete transcodedDds;
+      delete transcodedRam;
+            transcodedDds = NULL;
+         }
+         colors = transcodedDds;
+      }
+
+      for (unsigned level = 0; level < dds.Get_Mip_Level_Count(); ++level) {
+         // both decoders write whole 4x4 blocks, even for the smallest mips
+         unsigned width = (dds.Get_Width(level) + 3) & ~3u;
+         unsigned height = (dds.Get_Height(level) + 3) & ~3u;
+         unsigned pitch = width * 4;
+         UnsignedInt64 bytes = static_cast<UnsignedInt64>(pitch) * height;
+         decoded.assign(static_cast<size_t>(bytes), 0);
+
+         Int64 start = ddsBenchmarkNanos();
+         dds.Decode_DXT_Level(level, decoded.data(), pitch);
+         levelNanos += ddsBenchmarkNanos() - start;
+         ++levels;
+         levelBytes += bytes;
+         compressedBytes += (width / 4) * (height / 4) * (format == WW3D_FORMAT_DXT1 ? 8u : 16u);
+
+         if (colors == NULL) {
+            continue;
+         }
+         reference.assign(static_cast<size_t>(bytes), 0);
+         start = ddsBenchmarkNanos();
+         for (unsigned y = 0; y < height; y += 4) {
+            for (unsigned x = 0; x < width; x += 4) {
+               colors->Get_4x4_Block(reference.data() + y * pitch + x * 4, pitch, WW3D_FORMAT_A8R8G8B8, level, x, y);
+            }
+         }
+         blockNanos += ddsBenchmarkNanos() - start;
+
+         if (format == WW3D_FORMAT_DXT3) {
+            // 4-bit alphas, low nibble first, stored in the top byte of each A8R8G8B8 pixel
+            const UnsignedByte *block = dds.Get_Memory_Pointer(level);
+            for (unsigned y = 0; y < height; y += 4) {
+               for (unsigned x = 0; x < width; x += 4, block += 16) {
+                  for (unsigned i = 0; i < 16; ++i) {
+                     UnsignedByte nibble = (i & 1) ? block[i / 2] >> 4 : block[i / 2] & 0x0f;
+                     reference[(y + i / 4) * pitch + (x + i % 4) * 4 + 3] = static_cast<UnsignedByte>(nibble * 17);
+                  }
+               }
+            }
+         }
+
+         ++checkedLevels;
+         checkedBytes += bytes;
+         if (reference != decoded) {
+            ++mismatches;
+         }
+      }
+      delete transcodedDds;
+      delete transcodedRam;
+   }
+
+   printf("DDS decode: %d images (%d unreadable), %d DXT mip levels\n", images, unreadable, levels);
+   printf("  whole level   %.3f ms (%.1f MB/s of DXT data in, %.1f MB/s of A8R8G8B8 out)\n", levelNanos / 1.0e6,
+      levelNanos > 0 ? compressedBytes * 1.0e3 / levelNanos : 0.0,
+      levelNanos > 0 ? levelBytes * 1.0e3 / levelNanos : 0.0);
+   printf("  4x4 blocks    %.3f ms (%.1f MB/s of A8R8G8B8 out) over %d compared levels\n", blockNanos / 1.0e6,
+      blockNanos > 0 ? checkedBytes * 1.0e3 / blockNanos : 0.0, checkedLevels);
+   printf("  %d levels decoded differently\n", mismatches);
+   fflush(stdout);
+}
+
+//============================================================================
+// LinuxTextureLoader::benchmarkLoader
+//============================================================================
+
+static UnsignedInt loaderBenchmarkHash(const DecodedTexture& decoded) {
+   if (!decoded.m_ok) {
+      return 0;
+   }
+   return INICache::hashBytes(reinterpret_cast<const char*>(decoded.m_pixels.data()), static_cast<Int>(decoded.m_pixels.size()));
+}
+
+/// Queue every file on a new loader and wait for all of them. Returns the time the main
+/// thread spent in request(), which is all drawImage pays for a new image.
+static Int64 loaderBenchmarkPass(const FilenameList& names, const AsciiString& cacheDirectory,
+   const std::map<std::string, UnsignedInt>& expected, Int64& wallNanos, Int& fromCache, Int& mismatches) {
+   LinuxTextureLoader loader(LinuxTextureLoader::getDefaultThreadCount(), cacheDirectory);
+   std::vector<DecodedTexture> finished;
+   Int64 requestNanos {0};
+   fromCache = 0;
+   mismatches = 0;
+
+   auto check {
+      [&]() {
+         loader.takeFinished(finished);
+         for (const DecodedTexture& decoded : finished) {
+            fromCache += decoded.m_fromCache ? 1 : 0;
+            std::map<std::string, UnsignedInt>::const_iterator it = expected.find(decoded.m_name);
+            if (it == expected.end() || it->second != loaderBenchmarkHash(decoded)) {
+               ++mismatches;
+            }
+         }
+      }
+   };
+
+   Int64 start = ddsBenchmarkNanos();
+   for (FilenameList::const_iterator it = names.begin(); it != names.end(); ++it) {
+      if (expected.find(it->str()) == expected.end()) {
+         continue;
+      }
+      FileClass *file = _TheFileFactory->Get_File(it->str());
+      if (file == NULL) {
+         ++mismatches;
+         continue;
+      }
+      Int64 requestStart = ddsBenchmarkNanos();
+      if (!loader.request(*it, file, *it, it->endsWithNoCase(".dds"))) {
+         ++mismatches;
+      }
+      requestNanos += ddsBenchmarkNanos() - requestStart;
+      _TheFileFactory->Return_File(file);
+   }
+   while (loader.getPendingCount() > 0) {
+      check();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+   }
+   wallNanos = ddsBenchmarkNanos() - start;
+   check();
+   return requestNanos;
+}
+
+void LinuxTextureLoader::benchmarkLoader() {
+   FilenameList names;
+   TheFileSystem->getFileListInDirectory(AsciiString(""), AsciiString("*.dds"), names, TRUE);
+   TheFileSystem->getFileListInDirectory(AsciiString(""), AsciiString("*.tga"), names, TRUE);
+
+   // what LinuxDisplay::drawImage used to do: read and decode on the main thread
+   std::map<std::string, UnsignedInt> expected;
+   Int failed {0};
+   Int64 inlineNanos {0};
+   for (FilenameList::const_iterator it = names.begin(); it != names.end(); ++it) {
+      Int64 start = ddsBenchmarkNanos();
+      FileClass *file = _TheFileFactory->Get_File(it->str());
+      Job job;
+      job.m_name = it->str();
+      job.m_dds = it->endsWithNoCase(".dds");
+      if (file != NULL && file->Open()) {
+         Int size = file->Size();
+         job.m_source.resize(static_cast<size_t>(std::max(size, 0)));
+         if (size <= 0 || file->Read(job.m_source.data(), size) != size) {
+            job.m_source.clear();
+         }
+         file->Close();
+      }
+      if (file != NULL) {
+         _TheFileFactory->Return_File(file);
+      }
+      DecodedTexture result;
+      if (!job.m_source.empty()) {
+         decode(job, result);
+      }
+      inlineNanos += ddsBenchmarkNanos() - start;
+      // the loader is only compared on what decodes
+      if (result.m_ok) {
+         expected[job.m_name] = loaderBenchmarkHash(result);
+      } else {
+         ++failed;
+      }
+   }
+   Int images = static_cast<Int>(expected.size());
+
+   Int64 queuedWall {0};
+   Int queuedCached {0};
+   Int queuedMismatches {0};
+   Int64 queuedNanos = loaderBenchmarkPass(names, AsciiString(), expected, queuedWall, queuedCached, queuedMismatches);
+
+   AsciiString cacheDirectory;
+   cacheDirectory.format("%sTextureCacheBenchmark/", TheGlobalData->getPath_UserData().str());
+   std::error_code error;
+   std::filesystem::remove_all(cacheDirectory.str(), error);
+   Int64 fillWall {0};
+   Int fillCached {0};
+   Int fillMismatches {0};
+   Int64 fillNanos = loaderBenchmarkPass(names, cacheDirectory, expected, fillWall, fillCached, fillMismatches);
+   Int64 readWall {0};
+   Int readCached {0};
+   Int readMismatches {0};
+   Int64 readNanos = loaderBenchmarkPass(names, cacheDirectory, expected, readWall, readCached, readMismatches);
+   std::filesystem::remove_all(cacheDirectory.str(), error);
+
+   printf("Texture loader: %d images (%d could not be decoded), %d worker threads\n", images, failed, getDefaultThreadCount());
+   printf("  inline        %.3f ms on the main thread\n", inlineNanos / 1.0e6);
+   printf("  queued        %.3f ms on the main thread, all decoded after %.3f ms\n", queuedNanos / 1.0e6, queuedWall / 1.0e6);
+   printf("  cache filled  %.3f ms on the main thread, all decoded after %.3f ms\n", fillNanos / 1.0e6, fillWall / 1.0e6);
+   printf("  cache read    %.3f ms on the main thread, all loaded after %.3f ms, %d from the cache\n", readNanos / 1.0e6, readWall / 1.0e6, readCached);
+   printf("  %d images loaded differently from inline\n", queuedMismatches + fillMismatches + readMismatches);
+   fflush(stdout);
+}
+
+//============================================================================
+// LinuxTextureLoader::readCache
+//============================================================================
+
+Bool LinuxTextureLoader::readCache(const Job& job, DecodedTexture& result) {
+   FILE *fp = fopen(job.m_cachePath.c_str(), "rb");
+   if (fp == NULL) {
+      return FALSE;
+   }
+
+   char magic[sizeof(TextureCacheMagic)] {};
+   UnsignedInt version {};
+   UnsignedInt pathLength {};
+   UnsignedInt64 sourceSize {};
+   UnsignedInt64 sourceTimestamp {};
+   Int format {};
+   Bool ok = fread(magic, sizeof(magic), 1, fp) == 1
+      && fread(&version, sizeof(version), 1, fp) == 1
+      && fread(&pathLength, sizeof(pathLength), 1, fp) == 1
+      && memcmp(magic, TextureCacheMagic, sizeof(magic)) == 0
+      && version == TextureCacheVersion
+      && pathLength == job.m_sourcePath.size();
+
+   // the name is hashed into the cache file name, so make sure it's really this file
+   if (ok) {
+      std::string path(pathLength, '\0');
+      ok = fread(path.data(), pathLength, 1, fp) == 1 && path == job.m_sourcePath;
+   }
+
+   ok = ok && fread(&sourceSize, sizeof(sourceSize), 1, fp) == 1
+      && fread(&sourceTimestamp, sizeof(sourceTimestamp), 1, fp) == 1
+      && sourceSize == job.m_sourceSize
+      && sourceTimestamp == job.m_sourceTimestamp
+      && fread(&format, sizeof(format), 1, fp) == 1
+      && fread(&result.m_width, sizeof(result.m_width), 1, fp) == 1
+      && fread(&result.m_height, sizeof(result.m_height), 1, fp) == 1
+      && fread(&result.m_pitch, sizeof(result.m_pitch), 1, fp) == 1
+      && result.m_width > 0 && result.m_height > 0 && result.m_pitch >= result.m_width;
+
+   if (ok) {
+      result.m_format = static_cast<SDL_PixelFormat>(format);
+      result.m_pixels.resize(static_cast<size_t>(result.m_pitch) * static_cast<size_t>(result.m_height));
+      ok = fread(result.m_pixels.data(), result.m_pixels.size(), 1, fp) == 1;
+   }
+
+   fclose(fp);
+
+   if (!ok) {
+      result.m_pixels.clear();
+      return FALSE;
+   }
+
+   result.m_ok = TRUE;
+   return TRUE;
+}
+
+//============================================================================
+// LinuxTextureLoader::writeCache
+//============================================================================
+
+void LinuxTextureLoader::writeCache(const Job& job, const DecodedTexture& result) {
+   // written beside the real name and renamed into place, so a reader never sees half a file
+   std::string tempPath = job.m_cachePath + ".tmp";
+   FILE *fp = fopen(tempPath.c_str(), "wb");
+   if (fp == NULL) {
+      return;
+   }
+
+   UnsignedInt pathLength = static_cast<UnsignedInt>(job.m_sourcePath.size());
+   Int format = static_cast<Int>(result.m_format);
+   Bool ok = fwrite(TextureCacheMagic, sizeof(TextureCacheMagic), 1, fp) == 1
+      && fwrite(&TextureCacheVersion, sizeof(TextureCacheVersion), 1, fp) == 1
+      && fwrite(&pathLength, sizeof(pathLength), 1, fp) == 1
+      && fwrite(job.m_sourcePath.data(), pathLength, 1, fp) == 1
+      && fwrite(&job.m_sourceSize, sizeof(job.m_sourceSize), 1, fp) == 1
+      && fwrite(&job.m_sourceTimestamp, sizeof(job.m_sourceTimestamp), 1, fp) == 1
+      && fwrite(&format, sizeof(format), 1, fp) == 1
+      && fwrite(&result.m_width, sizeof(result.m_width), 1, fp) == 1
+      && fwrite(&result.m_height, sizeof(result.m_height), 1, fp) == 1
+      && fwrite(&result.m_pitch, sizeof(result.m_pitch), 1, fp) == 1
+      && fwrite(result.m_pixels.data(), result.m_pixels.size(), 1, fp) == 1;
+
+   ok = (fclose(fp) == 0) && ok;
+
+   std::error_code error;
+   if (ok) {
+      std::filesystem::rename(tempPath, job.m_cachePath, error);
+   }
+   if (!ok || error) {
+      std::filesystem::remove(tempPath, error);
+   }
+}
@@ -75,6 +75,8 @@ void LinuxTerrainLogic::reset( void )
    m_mapDY = 0;
    m_mapMinZ = 0;
    m_mapMaxZ = 1;
+   m_heightData.clear();
+   m_heightBorder = 0;
    WorldHeightMap::freeListOfMapObjects();
 }  // end reset
 
@@ -160,6 +162,13 @@ Bool LinuxTerrainLogic::loadMap( AsciiString filename , Bool query )
       }
       m_mapMinZ = minHt * MAP_HEIGHT_SCALE;
       m_mapMaxZ = maxHt * MAP_HEIGHT_SCALE;
+
+      // keep our own copy of the samples, so ground height queries don't depend on the
+      // terrain render object (which doesn't exist when running headless)
+      const UnsignedByte *data = terrainHeightMap->getDataPtr();
+      m_heightData.assign(data, data + (size_t)m_mapDX * (size_t)m_mapDY);
+      m_heightBorder = terrainHeightMap->getBorderSizeInline();
+
       //release temporary object used for loading height values
       REF_PTR_RELEASE(terrainHeightMap);
    }
@@ -277,6 +286,9 @@ return false;
 //-------------------------------------------------------------------------------------------------
 Real LinuxTerrainLogic::getGroundHeight(Real x, Real y, Coord3D* normal) const
 {
+   if (!m_heightData.empty())
+      return sampleHeightData(x, y, normal);
+
 #define USE_THE_TERRAIN_OBJECT
 #ifdef USE_THE_TERRAIN_OBJECT
    if (TheTerrainRenderObject) {
@@ -293,6 +305,123 @@ Real LinuxTerrainLogic::getGroundHeight(Real x, Real y, Coord3D* normal) const
 #endif
 }  // end getHight
 
+//-------------------------------------------------------------------------------------------------
+/** Same sampling as BaseHeightMapRenderObjClass::getHeightMapHeight, but against the logic's
+  * own copy of the height data, so results match the client exactly. */
+//-------------------------------------------------------------------------------------------------
+Real LinuxTerrainLogic::sampleHeightData(Real x, Real y, Coord3D* normal) const
+{
+   //  3-----2
+   //  |    /|
+   //  |  /  |
+   //  |/    |
+   //  0-----1
+   const Real MAP_XY_FACTOR_INV = 1.0f / MAP_XY_FACTOR;
+
+   float xdiv = x * MAP_XY_FACTOR_INV;
+   float ydiv = y * MAP_XY_FACTOR_INV;
+
+   float ixf = FAST_REAL_FLOOR(xdiv);
+   float iyf = FAST_REAL_FLOOR(ydiv);
+
+   float fx = xdiv - ixf; //get fraction
+   float fy = ydiv - iyf; //get fraction
+
+   Int ix = (Int)fast_float2long_round(ixf) + m_heightBorder;
+   Int iy = (Int)fast_float2long_round(iyf) + m_heightBorder;
+   Int xExtent = m_mapDX;
+
+   const UnsignedByte* data = m_heightData.data();
+
+   // Check for extent-3, not extent-1: we go into the next row/column of data for smoothed triangle points.
+   if (ix > (xExtent-3) || iy > (m_mapDY-3) || iy < 1 || ix < 1)
+   {
+      if (normal)
+      {
+         // return a default normal pointing up
+         normal->x = 0.0f;
+         normal->y = 0.0f;
+         normal->z = 1.0f;
+      }
+      Int cx = ix < 0 ? 0 : (ix > xExtent-1 ? xExtent-1 : ix);
+      Int cy = iy < 0 ? 0 : (iy > m_mapDY-1 ? m_mapDY-1 : iy);
+      return data[cx + cy*xExtent] * MAP_HEIGHT_SCALE;
+   }
+
+   float height;
+   Int idx = ix + iy*xExtent;
+   float p0 = data[idx];
+   float p2 = data[idx + xExtent + 1];
+   if (fy > fx) // test if we are in the upper triangle
+   {
+      float p3 = data[idx + xExtent];
+      height = (p3 + (1.0f-fy)*(p0-p3) + fx*(p2-p3)) * MAP_HEIGHT_SCALE;
+   }
+   else
+   {
+      // we are in the lower triangle
+      float p1 = data[idx + 1];
+      height = (p1 + fy*(p2-p1) + (1.0f-fx)*(p0-p1)) * MAP_HEIGHT_SCALE;
+   }
+
+   if (normal)
+   {
+      //9            8
+      //
+      //10  3-----2  7
+      //    |    /|
+      //    |  /  |
+      //    |/    |
+      //11  0-----1  6
+      //
+      //4            5
+      Int idx4 = ix + (iy-1)*xExtent;
+      Int idx0 = ix + iy*xExtent;
+      Int idx3 = ix + iy*xExtent+xExtent;
+      Int idx9 = ix + (iy+2)*xExtent;
+      UnsignedByte d0 = data[idx0];
+      UnsignedByte d1 = data[idx0+1];
+      UnsignedByte d2 = data[idx3+1];
+      UnsignedByte d3 = data[idx3];
+      UnsignedByte d4 = data[idx4];
+      UnsignedByte d5 = data[idx4+1];
+      UnsignedByte d6 = data[idx0+2];
+      UnsignedByte d7 = data[idx3+2];
+      UnsignedByte d8 = data[idx9+1];
+      UnsignedByte d9 = data[idx9];
+      UnsignedByte d11 = data[idx0-1];
+
+      Real deltaZ_X0 = d1-d11;
+      Real deltaZ_X1 = d6-d0;
+      Real deltaZ_X2 = d7-d3;
+      Real deltaZ_X3 = d6-d0;
+
+      Real deltaZ_Y0 = d3-d4;
+      Real deltaZ_Y1 = d2-d5;
+      Real deltaZ_Y2 = d8-d1;
+      Real deltaZ_Y3 = d9-d0;
+
+      // Interpolate to get the smoothed value.
+      Real deltaZ_X_Left = deltaZ_X0*(1.0f-fx) + fx*deltaZ_X3;
+      Real deltaZ_X_Right = deltaZ_X1*(1.0f-fx) + fx*deltaZ_X2;
+      Real deltaZ_X = deltaZ_X_Left*(1.0-fy) + fy*deltaZ_X_Right;
+
+      Real deltaZ_Y_Left = deltaZ_Y0*(1.0f-fx) + fx*deltaZ_Y3;
+      Real deltaZ_Y_Right = deltaZ_Y1*(1.0f-fx) + fx*deltaZ_Y2;
+      Real deltaZ_Y = deltaZ_Y_Left*(1.0-fy) + fy*deltaZ_Y_Right;
+
+      Vector3 l2r, n2f, normalAtTexel;
+      l2r.Set(2*MAP_XY_FACTOR/MAP_HEIGHT_SCALE, 0, deltaZ_X);
+      n2f.Set(0, 2*MAP_XY_FACTOR/MAP_HEIGHT_SCALE, deltaZ_Y);
+      Vector3::Normalized_Cross_Product(l2r, n2f, &normalAtTexel);
+      normal->x = normalAtTexel.X;
+      normal->y = normalAtTexel.Y;
+      normal->z = normalAtTexel.Z;
+   }
+
+   return height;
+}  // end sampleHeightData
+
 //-------------------------------------------------------------------------------------------------
 /** Get the height considering the layer. */
 //-------------------------------------------------------------------------------------------------
@@ -24,6 +24,9 @@
 #include "bitmaphandler.h"
 #include "colorspace.h"
 #include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 // #include <ddraw.h>
 
 // ----------------------------------------------------------------------------
@@ -497,6 +500,14 @@ void DDSFileClass::Copy_Level_To_Surface
 					}
 				}
 			}
+			else if ((dest_format==WW3D_FORMAT_A8R8G8B8 || dest_format==WW3D_FORMAT_X8R8G8B8) &&
+				(Format==WW3D_FORMAT_DXT1 || Format==WW3D_FORMAT_DXT3 || Format==WW3D_FORMAT_DXT5)) {
+				// Decode the whole level in one pass
+				bool contains_alpha=Decode_DXT_Level(level,dest_surface,dest_pitch,hsv_shift);
+				if (Format==WW3D_FORMAT_DXT1 && contains_alpha) {
+					WWDEBUG_SAY(("Warning: DXT1 format should not contain alpha information - file %s\n",Name));
+				}
+			}
 			else {
 				unsigned dest_bpp=Get_Bytes_Per_Pixel(dest_format);
 
@@ -1274,3 +1285,206 @@ bool DDSFileClass::Get_4x4_Block(
 	return false;
 
 }
+
+// ----------------------------------------------------------------------------
+//
+// Bulk DXTn decoding. The four colors of a block are built once and then the
+// sixteen 2-bit indices are looked up from them, rather than going through a
+// switch and Write_B8G8R8A8 for every pixel. The colors are built with
+// Combine_Colors exactly as Get_4x4_Block builds them, so both give the same
+// pixels.
+//
+// ----------------------------------------------------------------------------
+
+static void Build_DXT_Colors(
+	const unsigned char* color_block,
+	bool allow_transparent,				// DXT1 blocks with col0<=col1 have three colors and transparent black
+	bool has_hsv_shift,
+	const Vector3& hsv_shift,
+	unsigned colors[4])
+{
+	unsigned col0=RGB565_To_ARGB8888((unsigned short)(color_block[0]|(color_block[1]<<8)));
+	unsigned col1=RGB565_To_ARGB8888((unsigned short)(color_block[2]|(color_block[3]<<8)));
+	bool four_colors=!allow_transparent || col0>col1;
+	if (has_hsv_shift) {
+		Recolor(col0,hsv_shift);
+		Recolor(col1,hsv_shift);
+	}
+
+	// DXT1 has no alpha of its own; DXT3 and DXT5 OR theirs in per pixel
+	unsigned opaque=allow_transparent ? 0xff000000 : 0;
+	if (four_colors) {
+		colors[0]=col0|opaque;
+		colors[1]=col1|opaque;
+		colors[2]=Combine_Colors(col1,col0,85)|opaque;
+		colors[3]=Combine_Colors(col0,col1,85)|opaque;
+	}
+	else {
+		colors[0]=col0|opaque;
+		colors[1]=col1|opaque;
+		colors[2]=Combine_Colors(col1,col0,128)|opaque;
+		colors[3]=0x00000000;
+	}
+}
+
+// ----------------------------------------------------------------------------
+
+static void Write_DXT_Block(
+	unsigned char* dest_ptr,
+	unsigned dest_pitch,
+	const unsigned colors[4],
+	unsigned indices,						// Sixteen 2-bit color indices, one byte per row
+	const unsigned char* alphas)		// Sixteen alpha values, or NULL if the colors already have alpha
+{
+#if defined(__SSE2__)
+	// Each row of four pixels is one register. A pixel's index is masked out of the row's index
+	// byte in place and compared against each of the four possible values, which selects its color.
+	const __m128i masks=_mm_setr_epi32(0x03,0x0c,0x30,0xc0);
+	const __m128i index1=_mm_setr_epi32(0x01,0x04,0x10,0x40);
+	const __m128i index2=_mm_setr_epi32(0x02,0x08,0x20,0x80);
+	const __m128i color0=_mm_set1_epi32(static_cast<int>(colors[0]));
+	const __m128i color1=_mm_set1_epi32(static_cast<int>(colors[1]));
+	const __m128i color2=_mm_set1_epi32(static_cast<int>(colors[2]));
+	const __m128i color3=_mm_set1_epi32(static_cast<int>(colors[3]));
+	const __m128i zero=_mm_setzero_si128();
+
+	for (unsigned y=0;y<4;++y,dest_ptr+=dest_pitch) {
+		__m128i line=_mm_and_si128(_mm_set1_epi32(static_cast<int>((indices>>(y*8))&0xff)),masks);
+		__m128i pixels=_mm_and_si128(_mm_cmpeq_epi32(line,zero),color0);
+		pixels=_mm_or_si128(pixels,_mm_and_si128(_mm_cmpeq_epi32(line,index1),color1));
+		pixels=_mm_or_si128(pixels,_mm_and_si128(_mm_cmpeq_epi32(line,index2),color2));
+		pixels=_mm_or_si128(pixels,_mm_and_si128(_mm_cmpeq_epi32(line,masks),color3));
+		if (alphas) {
+			int row_alphas;
+			memcpy(&row_alphas,alphas+y*4,sizeof(row_alphas));
+			__m128i alpha=_mm_cvtsi32_si128(row_alphas);
+			alpha=_mm_unpacklo_epi16(_mm_unpacklo_epi8(alpha,zero),zero);
+			pixels=_mm_or_si128(pixels,_mm_slli_epi32(alpha,24));
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dest_ptr),pixels);
+	}
+#else
+	for (unsigned y=0;y<4;++y,dest_ptr+=dest_pitch) {
+		unsigned line=indices>>(y*8);
+		unsigned row[4];
+		for (unsigned x=0;x<4;++x,line>>=2) {
+			row[x]=colors[line&3];
+			if (alphas) {
+				row[x]|=unsigned(alphas[y*4+x])<<24;
+			}
+		}
+		memcpy(dest_ptr,row,sizeof(row));
+	}
+#endif
+}
+
+// ----------------------------------------------------------------------------
+//
+// Uncompress a whole DXT1, DXT3 or DXT5 mip level to an A8R8G8B8 surface.
+//
+// Returns: true if any block contained alpha, false if not
+//
+// Note: Unlike Get_4x4_Block this also decodes DXT3.
+//
+// ----------------------------------------------------------------------------
+
+bool DDSFileClass::Decode_DXT_Level(
+	unsigned level,						// DDS mipmap level to copy from
+	unsigned char* dest_surface,		// Destination surface pointer
+	unsigned dest_pitch,					// Destination surface pitch, in bytes
+	const Vector3& hsv_shift) const
+{
+	WWASSERT(level<MipLevels);
+	WWASSERT(Format==WW3D_FORMAT_DXT1 || Format==WW3D_FORMAT_DXT3 || Format==WW3D_FORMAT_DXT5);
+
+	bool has_hsv_shift = hsv_shift[0]!=0.0f || hsv_shift[1]!=0.0f || hsv_shift[2]!=0.0f;
+	unsigned width=Get_Width(level);
+	unsigned height=Get_Height(level);
+	const unsigned char* block_memory=Get_Memory_Pointer(level);
+
+	bool contains_alpha=false;
+	unsigned colors[4];
+	unsigned char alphas[16];
+
+	for (unsigned y=0;y<height;y+=4) {
+		unsigned char* dest_ptr=dest_surface+y*dest_pitch;
+		for (unsigned x=0;x<width;x+=4,dest_ptr+=16) {
+			switch (Format) {
+			case WW3D_FORMAT_DXT1:
+				{
+					unsigned indices;
+					memcpy(&indices,block_memory+4,sizeof(indices));
+					Build_DXT_Colors(block_memory,true,has_hsv_shift,hsv_shift,colors);
+					// Index 3 is transparent in three color blocks
+					if (colors[3]==0 && (indices&(indices>>1)&0x55555555)!=0) {
+						contains_alpha=true;
+					}
+					Write_DXT_Block(dest_ptr,dest_pitch,colors,indices,NULL);
+					block_memory+=8;
+				}
+				break;
+			case WW3D_FORMAT_DXT3:
+				{
+					// Explicit 4-bit alphas, low nibble first
+					unsigned char alpha_and=0xff;
+					for (unsigned i=0;i<8;++i) {
+						unsigned char packed=block_memory[i];
+						alphas[i*2]=(unsigned char)((packed&0x0f)*17);
+						alphas[i*2+1]=(unsigned char)((packed>>4)*17);
+						alpha_and&=packed;
+					}
+					contains_alpha|=alpha_and!=0xff;
+
+					unsigned indices;
+					memcpy(&indices,block_memory+12,sizeof(indices));
+					Build_DXT_Colors(block_memory+8,false,has_hsv_shift,hsv_shift,colors);
+					Write_DXT_Block(dest_ptr,dest_pitch,colors,indices,alphas);
+					block_memory+=16;
+				}
+				break;
+			case WW3D_FORMAT_DXT5:
+				{
+					// Interpolated alphas, with the same rounding as Get_4x4_Block
+					unsigned alpha_values[8];
+					alpha_values[0]=block_memory[0];
+					alpha_values[1]=block_memory[1];
+					if (alpha_values[0]>alpha_values[1]) {
+						for (unsigned i=1;i<7;++i) {
+							alpha_values[i+1]=((7-i)*alpha_values[0]+i*alpha_values[1]+3) / 7;
+						}
+					}
+					else {
+						for (unsigned i=1;i<5;++i) {
+							alpha_values[i+1]=((5-i)*alpha_values[0]+i*alpha_values[1]+2) / 5;
+						}
+						alpha_values[6]=0;
+						alpha_values[7]=255;
+					}
+
+					// Sixteen 3-bit alpha indices packed into 48 bits
+					unsigned long long alpha_indices=0;
+					for (unsigned i=0;i<6;++i) {
+						alpha_indices|=(unsigned long long)block_memory[2+i]<<(i*8);
+					}
+					unsigned alpha_and=0xff;
+					for (unsigned i=0;i<16;++i,alpha_indices>>=3) {
+						alphas[i]=(unsigned char)alpha_values[alpha_indices&7];
+						alpha_and&=alphas[i];
+					}
+					contains_alpha|=alpha_and!=0xff;
+
+					unsigned indices;
+					memcpy(&indices,block_memory+12,sizeof(indices));
+					Build_DXT_Colors(block_memory+8,false,has_hsv_shift,hsv_shift,colors);
+					Write_DXT_Block(dest_ptr,dest_pitch,colors,indices,alphas);
+					block_memory+=16;
+				}
+				break;
+			default:
+				break;
+			}
+		}
+	}
+
+	return contains_alpha;
+}
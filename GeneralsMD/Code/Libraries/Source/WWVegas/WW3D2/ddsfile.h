@@ -288,6 +288,15 @@ public:
 		unsigned source_y,					// DDS y offset to copy from, must be aligned by 4!
 		const Vector3& hsv_shift=Vector3(0.0f,0.0f,0.0f)) const;
 
+// Uncompress a whole DXT1, DXT3 or DXT5 mip level to an A8R8G8B8 surface of the level's size.
+// Much faster than going through Get_4x4_Block for every block.
+// Returns: true if any block contained alpha, false if not
+	bool Decode_DXT_Level(
+		unsigned level,						// DDS mipmap level to copy from
+		unsigned char* dest_surface,		// Destination surface pointer
+		unsigned dest_pitch,					// Destination surface pitch, in bytes
+		const Vector3& hsv_shift=Vector3(0.0f,0.0f,0.0f)) const;
+
 	bool Load();
 	bool Load(FileClass* file);
 	bool Is_Available() const { return !!LevelSizes; }
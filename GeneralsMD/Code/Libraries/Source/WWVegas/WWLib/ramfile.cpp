@@ -48,7 +48,7 @@
  * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
 
 #include	"always.h"
-#include	"ramfile.h"
+#include	"RAMFILE.H"
 #include	<string.h>
 
 
@@ -313,7 +313,7 @@ int RAMFileClass::Read(void * buffer, int size)
 	}
 
 	int tocopy = (size < (Length-Offset)) ? size : (Length-Offset);
-	memmove(buffer, &Buffer[Offset], tocopy);
+	memmove(buffer, &Buffer[Offset], static_cast<size_t>(tocopy));
 	Offset += tocopy;
 
 	if (hasopened) {
@@ -439,7 +439,7 @@ int RAMFileClass::Write(void const * buffer, int size)
 
 	int maxwrite = MaxLength - Offset;
 	int towrite = (size < maxwrite) ? size : maxwrite;
-	memmove(&Buffer[Offset], buffer, towrite);
+	memmove(&Buffer[Offset], buffer, static_cast<size_t>(towrite));
 	Offset += towrite;
 
 	if (Offset > Length) {
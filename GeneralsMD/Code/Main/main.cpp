@@ -26,6 +26,7 @@
 
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_main.h>
+#include "LinuxDevice/Audio/SdlAudioMixer.h"
 #include "LinuxDevice/Common/LinuxGameEngine.h"
 #include "Common/CriticalSection.h"
 #include "Common/GameMemory.h"
@@ -37,7 +38,10 @@ SDL_Renderer* renderer {};
 SDL_Surface* surface {};
 SDL_Texture* splashTexture {};
 static SDL_GLContext glContext {};
-static CriticalSection critSec4 {};
+static CriticalSection critSec2 {}, critSec3 {}, critSec4 {}, critSec5 {};
+static bool headless {};
+static bool headlessAudio {};
+static UnsignedInt mixerBenchmarkVoices {};
 
 // What are these for?
 const Char *g_strFile = "data\\Generals.str";
@@ -119,6 +123,34 @@ void initialiseSdl(void) {
    }
 }
 
+// Headless runs get no window, GL context or audio device; text and images still draw
+// into an offscreen software renderer so the client code doesn't need to care. With
+// -headlessAudio the audio manager still runs, mixing into SDL's dummy device.
+void initialiseHeadless(void) {
+   if (headlessAudio) {
+      SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy");
+      if (!SDL_InitSubSystem(SDL_INIT_AUDIO)) {
+         SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Could not initialise SDL audio: %s", SDL_GetError());
+         headlessAudio = false;
+      }
+   }
+
+   surface = SDL_CreateSurface(1024, 1024, SDL_PIXELFORMAT_ABGR8888);
+   if (!surface) {
+      SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Could not create surface: %s", SDL_GetError());
+      SDL_Quit();
+      exit(1);
+   }
+
+   renderer = SDL_CreateSoftwareRenderer(surface);
+   if (!renderer) {
+      SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Could not create renderer: %s", SDL_GetError());
+      SDL_DestroySurface(surface);
+      SDL_Quit();
+      exit(1);
+   }
+}
+
 void cleanupSdl(void) {
    SDL_DestroyTexture(splashTexture);
    SDL_DestroySurface(surface);
@@ -128,16 +160,49 @@ void cleanupSdl(void) {
 }
 
 int main(int argc, char* argv[]) {
+   // as in WinMain, since the texture loader and save game writer threads allocate too
+   TheUnicodeStringCriticalSection = &critSec2;
+   TheDmaCriticalSection = &critSec3;
    TheMemoryPoolCriticalSection = &critSec4;
+   TheDebugLogCriticalSection = &critSec5;
+
+   // the renderer is created before GameEngine parses the command line, so look for this one early
+   for (int i {1}; i < argc; ++i) {
+      if (strcasecmp(argv[i], "-headless") == 0 || strcasecmp(argv[i], "-ddsDecodeBenchmark") == 0 ||
+          strcasecmp(argv[i], "-particleBenchmark") == 0) {
+         headless = true;
+      }
+      // -mixerBenchmark <voices> only times the audio mixer, so it never needs the window either
+      if (strcasecmp(argv[i], "-mixerBenchmark") == 0 && i + 1 < argc) {
+         mixerBenchmarkVoices = static_cast<UnsignedInt>(SDL_atoi(argv[++i]));
+         headless = true;
+      }
+      // -headlessAudio keeps sounds playing in a -headless run, e.g. so a replay benchmark
+      // reports on the audio cache
+      if (strcasecmp(argv[i], "-headlessAudio") == 0) {
+         headlessAudio = true;
+      }
+   }
 
-   initialiseSdl();
-
-   SDL_ShowWindow(window);
+   if (headless) {
+      initialiseHeadless();
+   } else {
+      initialiseSdl();
+      SDL_ShowWindow(window);
+   }
 
    DEBUG_INIT(DEBUG_FLAGS_DEFAULT);
    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Initialising memory manager.");
    initMemoryManager();
 
+   if (mixerBenchmarkVoices > 0) {
+      SdlAudioMixer::benchmark(mixerBenchmarkVoices, 10.0f, 44100);
+      shutdownMemoryManager();
+      DEBUG_SHUTDOWN();
+      SDL_Quit();
+      return 0;
+   }
+
    // Set up version info
    TheVersion = NEW Version;
    TheVersion->setVersion(VERSION_MAJOR, VERSION_MINOR, VERSION_BUILDNUM, VERSION_LOCALBUILDNUM,
@@ -174,6 +239,8 @@ GameEngine* CreateGameEngine(void) {
    LinuxGameEngine *engine;
 
    engine = NEW LinuxGameEngine;
+   engine->setHeadless(headless);
+   engine->setHeadlessAudio(headless && headlessAudio);
    //game engine may not have existed when app got focus so make sure it
    //knows about current focus state.
    // engine->setIsActive(isWinMainActive);
@@ -183,12 +250,18 @@ GameEngine* CreateGameEngine(void) {
 }  // end CreateGameEngine
 
 int MessageBox(const char* text, const char* caption, UnsignedInt) {
+   if (headless) {
+      fprintf(stderr, "%s: %s\n", caption, text);
+      return 1;
+   }
    SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, caption, text, window);
    return 1;
 }
 
 void SetWindowText(const char* text) {
-   SDL_SetWindowTitle(window, text);
+   if (window) {
+      SDL_SetWindowTitle(window, text);
+   }
 }
 
 AsciiString GetRegistryLanguage() {